@@ -0,0 +1,83 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Arena.cpp
+
+Abstract:
+	Implementation of Arena methods.
+
+--*/
+
+#include "Arena.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace
+{
+	/**
+	 * @brief Blocks an arena is expected to need between resets.
+	 */
+	constexpr size_t expectedBlocks = 4;
+}
+
+yhkcatprint::Arena::Arena(size_t blockSize)
+	: m_blockSize(blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE), m_offset(0), m_used(0)
+{
+	m_blocks.reserve(expectedBlocks);
+}
+
+std::span<uint8_t> yhkcatprint::Arena::allocate(size_t size, size_t alignment)
+{
+	if (!std::has_single_bit(alignment))
+	{
+		throw std::invalid_argument("Alignment must be a power of two");
+	}
+
+	if (!m_blocks.empty())
+	{
+		PooledBuffer& block = m_blocks.back();
+		uintptr_t address = reinterpret_cast<uintptr_t>(block.data()) + m_offset;
+		size_t padding = (alignment - address % alignment) % alignment;
+		if (padding + size <= block.capacity() - m_offset)
+		{
+			uint8_t* data = block.data() + m_offset + padding;
+			m_offset += padding + size;
+			m_used += padding + size;
+			return { data, size };
+		}
+	}
+
+	// Pool buffers are aligned for any type, so padding is only needed for larger alignments.
+	size_t padding = alignment > alignof(std::max_align_t) ? alignment - 1 : 0;
+	m_blocks.push_back(BufferPool::instance().acquire(std::max(m_blockSize, size + padding)));
+
+	PooledBuffer& block = m_blocks.back();
+	uintptr_t address = reinterpret_cast<uintptr_t>(block.data());
+	padding = (alignment - address % alignment) % alignment;
+	m_offset = padding + size;
+	m_used += padding + size;
+	return { block.data() + padding, size };
+}
+
+void yhkcatprint::Arena::reset() noexcept
+{
+	while (m_blocks.size() > 1)
+	{
+		m_blocks.pop_back();
+	}
+	m_offset = 0;
+	m_used = 0;
+}
+
+size_t yhkcatprint::Arena::reserved() const noexcept
+{
+	size_t total = 0;
+	for (const PooledBuffer& block : m_blocks)
+	{
+		total += block.capacity();
+	}
+	return total;
+}
@@ -0,0 +1,111 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Arena.h
+
+Abstract:
+	Bump allocator over pooled blocks for per-print scratch memory.
+
+--*/
+
+#pragma once
+#include "BufferPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @file Arena.h
+ * @brief Bump allocator over pooled blocks for per-print scratch memory.
+ *
+ * This header defines Arena, which hands out scratch memory that lives
+ * until the next reset, such as the storage of the writers and readers a
+ * print sets up. A PrinterSession resets its arena at the start of every
+ * print, so the blocks are reused from one print to the next.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Bump allocator over pooled blocks.
+	 *
+	 * Allocations are carved one after another out of blocks taken from the
+	 * BufferPool and are not freed one by one; reset() releases them all at
+	 * once. Allocations that do not fit the current block go to a new one,
+	 * large enough for them. reset() keeps the first block and returns the
+	 * others to the pool, so an arena whose allocations fit one block takes
+	 * no memory after its first use.
+	 *
+	 * @note Not thread-safe.
+	 */
+	class Arena
+	{
+	public:
+		/**
+		 * @brief Default block size.
+		 */
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+		/**
+		 * @brief Constructs an empty Arena; no block is taken until the first allocation.
+		 *
+		 * @param blockSize Size of the blocks taken from the pool.
+		 */
+		explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+		// Disable copy semantics
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		/**
+		 * @brief Allocates memory valid until the next reset().
+		 *
+		 * @param size Number of bytes.
+		 * @param alignment Alignment of the first byte; must be a power of two.
+		 * @return Allocated bytes; their contents are unspecified.
+		 *
+		 * @throws std::invalid_argument if the alignment is not a power of two.
+		 * @throws std::bad_alloc if the heap is exhausted.
+		 */
+		std::span<uint8_t> allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/**
+		 * @brief Frees all allocations, keeping the first block for the next ones.
+		 */
+		void reset() noexcept;
+
+		/**
+		 * @brief Returns the number of bytes allocated since the last reset, including alignment padding.
+		 */
+		size_t used() const noexcept
+		{
+			return m_used;
+		}
+
+		/**
+		 * @brief Returns the number of bytes of the blocks held.
+		 */
+		size_t reserved() const noexcept;
+
+	private:
+		/**
+		 * @brief Size of the blocks taken from the pool.
+		 */
+		const size_t m_blockSize;
+		/**
+		 * @brief Blocks taken from the pool; the last one is allocated from.
+		 */
+		std::vector<PooledBuffer> m_blocks;
+		/**
+		 * @brief Bytes of the last block allocated.
+		 */
+		size_t m_offset;
+		/**
+		 * @brief Bytes allocated since the last reset.
+		 */
+		size_t m_used;
+	};
+}
@@ -0,0 +1,258 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BluetoothAddress.h
+
+Abstract:
+	48-bit Bluetooth device address value type.
+
+--*/
+
+#pragma once
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+/**
+ * @file BluetoothAddress.h
+ * @brief 48-bit Bluetooth device address value type.
+ *
+ * This header defines BluetoothAddress, which holds an address as an
+ * integer, so that addresses can be parsed, formatted, compared and hashed
+ * without allocating.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief 48-bit Bluetooth device address.
+	 *
+	 * The first octet of the text form "XX:XX:XX:XX:XX:XX" is the most
+	 * significant byte of value(), matching BTH_ADDR on Windows. Parsing
+	 * accepts either case; formatting produces lower case, like the
+	 * addresses reported by the adapters.
+	 *
+	 * The type is trivially copyable and all operations except toString()
+	 * are constexpr and do not allocate.
+	 */
+	class BluetoothAddress
+	{
+	public:
+		/**
+		 * @brief Length of the text form "XX:XX:XX:XX:XX:XX".
+		 */
+		static constexpr size_t TEXT_LENGTH = 17;
+
+		/**
+		 * @brief Constructs the null address 00:00:00:00:00:00.
+		 */
+		constexpr BluetoothAddress() noexcept
+			: m_value(0)
+		{
+		}
+
+		/**
+		 * @brief Constructs an address from its integer value.
+		 *
+		 * @param value Address in the low 48 bits; higher bits are ignored.
+		 */
+		constexpr explicit BluetoothAddress(uint64_t value) noexcept
+			: m_value(value & VALUE_MASK)
+		{
+		}
+
+		/**
+		 * @brief Returns the address as an integer in the low 48 bits.
+		 */
+		constexpr uint64_t value() const noexcept
+		{
+			return m_value;
+		}
+
+		/**
+		 * @brief Checks whether this is the null address, used for devices that are not Bluetooth devices.
+		 */
+		constexpr bool isNull() const noexcept
+		{
+			return m_value == 0;
+		}
+
+		/**
+		 * @brief Returns an octet in text order.
+		 *
+		 * @param index Octet index, 0 for the first octet of the text form.
+		 */
+		constexpr uint8_t octet(size_t index) const noexcept
+		{
+			return static_cast<uint8_t>(m_value >> (8 * (5 - index)));
+		}
+
+		/**
+		 * @brief Parses the text form of an address.
+		 *
+		 * @param text Address in format "XX:XX:XX:XX:XX:XX", in either case.
+		 * @return Address, or std::nullopt if the text is not an address.
+		 */
+		static constexpr std::optional<BluetoothAddress> parse(std::string_view text) noexcept
+		{
+			if (text.size() != TEXT_LENGTH)
+			{
+				return std::nullopt;
+			}
+
+			uint64_t value = 0;
+			for (size_t i = 0; i < TEXT_LENGTH; i += 3)
+			{
+				int high = hexValue(text[i]);
+				int low = hexValue(text[i + 1]);
+				if (high < 0 || low < 0 || (i + 2 < TEXT_LENGTH && text[i + 2] != ':'))
+				{
+					return std::nullopt;
+				}
+				value = (value << 8) | static_cast<uint64_t>(high << 4 | low);
+			}
+			return BluetoothAddress(value);
+		}
+
+		/**
+		 * @brief Parses the text form of an address.
+		 *
+		 * @param text Address in format "XX:XX:XX:XX:XX:XX", in either case.
+		 * @return Address.
+		 *
+		 * @throws std::invalid_argument if the text is not an address.
+		 */
+		static constexpr BluetoothAddress fromString(std::string_view text)
+		{
+			std::optional<BluetoothAddress> address = parse(text);
+			if (!address)
+			{
+				throw std::invalid_argument("Invalid Bluetooth address format");
+			}
+			return *address;
+		}
+
+		/**
+		 * @brief Formats the address into a fixed buffer.
+		 *
+		 * @return Text form "xx:xx:xx:xx:xx:xx" followed by a NUL terminator.
+		 */
+		constexpr std::array<char, TEXT_LENGTH + 1> toChars() const noexcept
+		{
+			constexpr char digits[] = "0123456789abcdef";
+			std::array<char, TEXT_LENGTH + 1> text{};
+			for (size_t i = 0; i < 6; ++i)
+			{
+				uint8_t byte = octet(i);
+				text[i * 3] = digits[byte >> 4];
+				text[i * 3 + 1] = digits[byte & 0x0f];
+				if (i < 5)
+				{
+					text[i * 3 + 2] = ':';
+				}
+			}
+			return text;
+		}
+
+		/**
+		 * @brief Returns the text form "xx:xx:xx:xx:xx:xx".
+		 */
+		std::string toString() const
+		{
+			std::array<char, TEXT_LENGTH + 1> text = toChars();
+			return std::string(text.data(), TEXT_LENGTH);
+		}
+
+		/**
+		 * @brief Compares addresses by their integer value.
+		 */
+		constexpr auto operator<=>(const BluetoothAddress&) const = default;
+
+	private:
+		/**
+		 * @brief Bits of an address.
+		 */
+		static constexpr uint64_t VALUE_MASK = 0xffffffffffffull;
+
+		/**
+		 * @brief Returns the value of a hexadecimal digit, or -1.
+		 */
+		static constexpr int hexValue(char c) noexcept
+		{
+			if (c >= '0' && c <= '9')
+			{
+				return c - '0';
+			}
+			if (c >= 'a' && c <= 'f')
+			{
+				return c - 'a' + 10;
+			}
+			if (c >= 'A' && c <= 'F')
+			{
+				return c - 'A' + 10;
+			}
+			return -1;
+		}
+
+		/**
+		 * @brief Address in the low 48 bits.
+		 */
+		uint64_t m_value;
+	};
+
+	static_assert(std::is_trivially_copyable_v<BluetoothAddress>);
+	static_assert(BluetoothAddress::parse("24:00:28:00:1E:5b")->value() == 0x240028001e5bull);
+	static_assert(BluetoothAddress(0x240028001e5bull).toChars()[16] == 'b');
+	static_assert(!BluetoothAddress::parse("24:00:28:00:1e-5b"));
+
+	/**
+	 * @brief Writes the text form of an address to a stream.
+	 */
+	inline std::ostream& operator<<(std::ostream& out, BluetoothAddress address)
+	{
+		std::array<char, BluetoothAddress::TEXT_LENGTH + 1> text = address.toChars();
+		return out.write(text.data(), BluetoothAddress::TEXT_LENGTH);
+	}
+}
+
+/**
+ * @brief Hashes a BluetoothAddress by its integer value.
+ */
+template<>
+struct std::hash<yhkcatprint::BluetoothAddress>
+{
+	size_t operator()(yhkcatprint::BluetoothAddress address) const noexcept
+	{
+		return std::hash<uint64_t>()(address.value());
+	}
+};
+
+#ifdef __cpp_lib_format
+/**
+ * @brief Formats a BluetoothAddress as "xx:xx:xx:xx:xx:xx", accepting string format specifications.
+ */
+template<>
+struct std::formatter<yhkcatprint::BluetoothAddress, char> : std::formatter<std::string_view, char>
+{
+	template<typename FormatContext>
+	auto format(yhkcatprint::BluetoothAddress address, FormatContext& context) const
+	{
+		std::array<char, yhkcatprint::BluetoothAddress::TEXT_LENGTH + 1> text = address.toChars();
+		return std::formatter<std::string_view, char>::format(std::string_view(text.data(), yhkcatprint::BluetoothAddress::TEXT_LENGTH), context);
+	}
+};
+#endif
@@ -0,0 +1,78 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Bluez.h
+
+Abstract:
+	Thin wrappers over the kernel HCI interface and the BlueZ device store.
+
+--*/
+
+#pragma once
+#include "BluetoothAddress.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @file Bluez.h
+ * @brief Thin wrappers over the kernel HCI interface and the BlueZ device store.
+ *
+ * This header declares the Linux helpers under AdapterLinux and
+ * BluetoothManagerLinux. The HCI queries need the BlueZ headers and a
+ * kernel with Bluetooth support; reading the device store needs neither,
+ * so it can be run against a directory laid out like /var/lib/bluetooth.
+ */
+
+namespace yhkcatprint::bluez
+{
+	/**
+	 * @brief Address and name of a local adapter or a remote device.
+	 */
+	typedef struct _BLUEZ_ENTRY
+	{
+		/**
+		 * @brief Bluetooth address.
+		 */
+		BluetoothAddress address;
+		/**
+		 * @brief Human-readable name, empty if BlueZ does not know one.
+		 */
+		std::string name;
+	} BLUEZ_ENTRY;
+
+	/**
+	 * @brief Lists the identifiers of HCI devices known to the kernel.
+	 *
+	 * @return HCI device identifiers, e.g. 0 for hci0.
+	 *
+	 * @throws std::runtime_error if the HCI interface cannot be queried.
+	 */
+	std::vector<int> listHciDevices();
+
+	/**
+	 * @brief Reads the address and name of an HCI device.
+	 *
+	 * @param deviceId HCI device identifier.
+	 * @return Address and name of the adapter.
+	 *
+	 * @throws std::runtime_error if the device cannot be queried.
+	 */
+	BLUEZ_ENTRY readHciDeviceInfo(int deviceId);
+
+	/**
+	 * @brief Reads the devices paired with an adapter from the BlueZ device store.
+	 *
+	 * A device counts as paired when its store entry holds a link key.
+	 *
+	 * @param adapter Address of the adapter.
+	 * @param storePath Root of the BlueZ device store.
+	 * @return Addresses and names of the paired devices; empty if the adapter has no store entry.
+	 *
+	 * @throws std::runtime_error if the store cannot be read.
+	 */
+	std::vector<BLUEZ_ENTRY> readPairedDevices(BluetoothAddress adapter,
+		const std::filesystem::path& storePath = "/var/lib/bluetooth");
+}
@@ -0,0 +1,102 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BluezHci.cpp
+
+Abstract:
+	Implementation of the HCI queries declared in Bluez.h.
+
+--*/
+
+#include "Bluez.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/hci.h>
+
+namespace
+{
+	/**
+	 * Owns a raw HCI control socket.
+	 */
+	struct HciControlSocket
+	{
+		int fd;
+
+		HciControlSocket()
+			: fd(::socket(AF_BLUETOOTH, SOCK_RAW | SOCK_CLOEXEC, BTPROTO_HCI))
+		{
+			if (fd < 0)
+			{
+				throw std::runtime_error(std::string("Failed to open HCI control socket: ") + std::strerror(errno));
+			}
+		}
+
+		~HciControlSocket()
+		{
+			::close(fd);
+		}
+
+		// Disable copy semantics
+		HciControlSocket(const HciControlSocket&) = delete;
+		HciControlSocket& operator=(const HciControlSocket&) = delete;
+	};
+
+	/**
+	 * Converts a little-endian BlueZ address.
+	 */
+	yhkcatprint::BluetoothAddress toBluetoothAddress(const bdaddr_t& addr)
+	{
+		uint64_t value = 0;
+		for (int i = 5; i >= 0; --i)
+		{
+			value = (value << 8) | addr.b[i];
+		}
+		return yhkcatprint::BluetoothAddress(value);
+	}
+}
+
+std::vector<int> yhkcatprint::bluez::listHciDevices()
+{
+	HciControlSocket control;
+
+	std::vector<uint8_t> storage(sizeof(hci_dev_list_req) + HCI_MAX_DEV * sizeof(hci_dev_req));
+	auto* list = reinterpret_cast<hci_dev_list_req*>(storage.data());
+	list->dev_num = HCI_MAX_DEV;
+
+	if (::ioctl(control.fd, HCIGETDEVLIST, list) < 0)
+	{
+		throw std::runtime_error(std::string("Failed to list HCI devices: ") + std::strerror(errno));
+	}
+
+	std::vector<int> deviceIds;
+	for (int i = 0; i < list->dev_num; ++i)
+	{
+		deviceIds.push_back(list->dev_req[i].dev_id);
+	}
+	return deviceIds;
+}
+
+yhkcatprint::bluez::BLUEZ_ENTRY yhkcatprint::bluez::readHciDeviceInfo(int deviceId)
+{
+	HciControlSocket control;
+
+	hci_dev_info info = {};
+	info.dev_id = static_cast<uint16_t>(deviceId);
+	if (::ioctl(control.fd, HCIGETDEVINFO, &info) < 0)
+	{
+		throw std::runtime_error(std::string("Failed to get HCI device info: ") + std::strerror(errno));
+	}
+
+	BLUEZ_ENTRY result;
+	result.address = toBluetoothAddress(info.bdaddr);
+	result.name = std::string(info.name, std::find(std::begin(info.name), std::end(info.name), '\0'));
+	return result;
+}
@@ -0,0 +1,84 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BluezStore.cpp
+
+Abstract:
+	Implementation of the BlueZ device store reader declared in Bluez.h.
+
+--*/
+
+#include "Bluez.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+	std::string toUpper(std::string text)
+	{
+		std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+		return text;
+	}
+}
+
+std::vector<yhkcatprint::bluez::BLUEZ_ENTRY> yhkcatprint::bluez::readPairedDevices(BluetoothAddress adapter, const std::filesystem::path& storePath)
+{
+	std::vector<BLUEZ_ENTRY> devices;
+
+	// BlueZ names store directories after upper-case addresses.
+	std::filesystem::path adapterPath = storePath / toUpper(adapter.toString());
+	std::error_code ec;
+	if (!std::filesystem::is_directory(adapterPath, ec))
+	{
+		return devices;
+	}
+
+	std::filesystem::directory_iterator entries(adapterPath, ec);
+	if (ec)
+	{
+		throw std::runtime_error("Failed to read BlueZ device store: " + ec.message());
+	}
+
+	for (const auto& entry : entries)
+	{
+		std::optional<BluetoothAddress> address = BluetoothAddress::parse(entry.path().filename().string());
+		if (!entry.is_directory() || !address)
+		{
+			continue;
+		}
+
+		std::ifstream infoFile(entry.path() / "info");
+		if (!infoFile)
+		{
+			continue;
+		}
+
+		std::string name;
+		std::string section;
+		bool paired = false;
+		for (std::string line; std::getline(infoFile, line);)
+		{
+			if (line.starts_with('['))
+			{
+				section = line;
+				paired = paired || section == "[LinkKey]";
+			}
+			else if (section == "[General]" && line.starts_with("Name="))
+			{
+				name = line.substr(5);
+			}
+		}
+
+		if (paired)
+		{
+			devices.push_back({ *address, name });
+		}
+	}
+
+	return devices;
+}
@@ -0,0 +1,208 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BoundedQueue.h
+
+Abstract:
+	Bounded blocking multi-producer, multi-consumer queue.
+
+--*/
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * @file BoundedQueue.h
+ * @brief Bounded blocking multi-producer, multi-consumer queue.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Bounded blocking multi-producer, multi-consumer queue.
+	 *
+	 * Producers either block while the queue is full or fail immediately.
+	 * Consumers block while the queue is empty. Closing the queue wakes all
+	 * waiters; items already queued can still be popped afterwards.
+	 *
+	 * @tparam T Type of queued items, must be movable.
+	 *
+	 * @note All methods are thread-safe.
+	 */
+	template<typename T>
+	class BoundedQueue
+	{
+	public:
+		/**
+		 * @brief Constructs an empty queue.
+		 *
+		 * @param capacity Maximum number of items held at once.
+		 */
+		explicit BoundedQueue(size_t capacity)
+			: m_capacity(capacity > 0 ? capacity : 1), m_closed(false)
+		{
+		}
+
+		// Disable copy semantics
+		BoundedQueue(const BoundedQueue&) = delete;
+		BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+		/**
+		 * @brief Appends an item if there is room, without blocking.
+		 *
+		 * @param item Item to append; left untouched on failure.
+		 * @return true if the item was queued, false if the queue is full or closed.
+		 */
+		bool tryPush(T& item)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_closed || m_items.size() >= m_capacity)
+				{
+					return false;
+				}
+				m_items.push_back(std::move(item));
+			}
+			m_notEmpty.notify_one();
+			return true;
+		}
+
+		/**
+		 * @brief Appends an item, blocking while the queue is full.
+		 *
+		 * @param item Item to append; left untouched on failure.
+		 * @return true if the item was queued, false if the queue was closed.
+		 */
+		bool push(T& item)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+				if (m_closed)
+				{
+					return false;
+				}
+				m_items.push_back(std::move(item));
+			}
+			m_notEmpty.notify_one();
+			return true;
+		}
+
+		/**
+		 * @brief Removes the oldest item, blocking while the queue is empty.
+		 *
+		 * @return The oldest item, or std::nullopt once the queue is closed and drained.
+		 */
+		std::optional<T> pop()
+		{
+			std::optional<T> item;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+				if (m_items.empty())
+				{
+					return std::nullopt;
+				}
+				item.emplace(std::move(m_items.front()));
+				m_items.pop_front();
+			}
+			m_notFull.notify_one();
+			return item;
+		}
+
+		/**
+		 * @brief Removes the oldest item, waiting at most the given time for one to arrive.
+		 *
+		 * @param timeout Maximum duration to wait while the queue is empty.
+		 * @return The oldest item, or std::nullopt on timeout or once the queue is closed and drained.
+		 */
+		std::optional<T> pop(std::chrono::nanoseconds timeout)
+		{
+			std::optional<T> item;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_notEmpty.wait_for(lock, timeout, [this] { return m_closed || !m_items.empty(); });
+				if (m_items.empty())
+				{
+					return std::nullopt;
+				}
+				item.emplace(std::move(m_items.front()));
+				m_items.pop_front();
+			}
+			m_notFull.notify_one();
+			return item;
+		}
+
+		/**
+		 * @brief Checks whether close() has been called.
+		 */
+		bool isClosed() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_closed;
+		}
+
+		/**
+		 * @brief Stops accepting new items and wakes all waiters.
+		 */
+		void close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_closed = true;
+			}
+			m_notEmpty.notify_all();
+			m_notFull.notify_all();
+		}
+
+		/**
+		 * @brief Returns the number of queued items.
+		 */
+		size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_items.size();
+		}
+
+		/**
+		 * @brief Returns the maximum number of items held at once.
+		 */
+		size_t capacity() const noexcept
+		{
+			return m_capacity;
+		}
+
+	private:
+		/**
+		 * @brief Maximum number of queued items.
+		 */
+		const size_t m_capacity;
+		/**
+		 * @brief Whether close() has been called.
+		 */
+		bool m_closed;
+		/**
+		 * @brief Queued items, oldest first.
+		 */
+		std::deque<T> m_items;
+		/**
+		 * @brief Guards all state.
+		 */
+		mutable std::mutex m_mutex;
+		/**
+		 * @brief Signalled when an item is queued or the queue is closed.
+		 */
+		std::condition_variable m_notEmpty;
+		/**
+		 * @brief Signalled when an item is removed or the queue is closed.
+		 */
+		std::condition_variable m_notFull;
+	};
+}
@@ -0,0 +1,265 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BufferPool.cpp
+
+Abstract:
+	Implementation of BufferPool and PooledBuffer methods.
+
+--*/
+
+#include "BufferPool.h"
+#include <bit>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+struct yhkcatprint::BufferPool::ThreadCache
+{
+	/**
+	 * @brief Cached buffers by size class; the first counts[c] entries of buffers[c] are valid.
+	 */
+	std::array<std::array<uint8_t*, THREAD_CACHE_DEPTH>, CLASS_COUNT> buffers{};
+	std::array<size_t, CLASS_COUNT> counts{};
+
+	/**
+	 * @brief Whether the calling thread's cache has been destroyed, so that buffers released later skip it.
+	 */
+	static thread_local bool destroyed;
+
+	~ThreadCache()
+	{
+		destroyed = true;
+		flush();
+	}
+
+	/**
+	 * @brief Moves all cached buffers to the shared free lists.
+	 */
+	void flush() noexcept
+	{
+		BufferPool& pool = BufferPool::instance();
+		for (size_t sizeClass = 0; sizeClass < CLASS_COUNT; sizeClass++)
+		{
+			while (counts[sizeClass] > 0)
+			{
+				pool.releaseShared(buffers[sizeClass][--counts[sizeClass]], static_cast<uint8_t>(sizeClass));
+			}
+		}
+	}
+};
+
+thread_local bool yhkcatprint::BufferPool::ThreadCache::destroyed = false;
+
+yhkcatprint::PooledBuffer::PooledBuffer() noexcept
+	: m_data(nullptr), m_size(0), m_capacity(0), m_sizeClass(BufferPool::UNPOOLED)
+{
+}
+
+yhkcatprint::PooledBuffer::PooledBuffer(uint8_t* data, size_t size, size_t capacity, uint8_t sizeClass) noexcept
+	: m_data(data), m_size(size), m_capacity(capacity), m_sizeClass(sizeClass)
+{
+}
+
+yhkcatprint::PooledBuffer::~PooledBuffer()
+{
+	reset();
+}
+
+yhkcatprint::PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+	: m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)), m_capacity(std::exchange(other.m_capacity, 0)), m_sizeClass(other.m_sizeClass)
+{
+}
+
+yhkcatprint::PooledBuffer& yhkcatprint::PooledBuffer::operator=(PooledBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		reset();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_capacity = std::exchange(other.m_capacity, 0);
+		m_sizeClass = other.m_sizeClass;
+	}
+	return *this;
+}
+
+void yhkcatprint::PooledBuffer::resize(size_t size)
+{
+	if (size > m_capacity)
+	{
+		throw std::length_error("Size exceeds the capacity of the pooled buffer");
+	}
+	m_size = size;
+}
+
+void yhkcatprint::PooledBuffer::reset() noexcept
+{
+	if (m_data != nullptr)
+	{
+		BufferPool::instance().release(m_data, m_sizeClass);
+		m_data = nullptr;
+		m_size = 0;
+		m_capacity = 0;
+	}
+}
+
+yhkcatprint::BufferPool& yhkcatprint::BufferPool::instance()
+{
+	// Never destroyed, so that buffers outliving static destructors can still be released.
+	static BufferPool* pool = new BufferPool();
+	return *pool;
+}
+
+yhkcatprint::BufferPool::BufferPool()
+	: m_idleBytes(0), m_acquired(0), m_allocated(0), m_threadHits(0), m_sharedHits(0), m_freed(0)
+{
+}
+
+yhkcatprint::PooledBuffer yhkcatprint::BufferPool::acquire(size_t size)
+{
+	m_acquired.fetch_add(1, std::memory_order_relaxed);
+
+	uint8_t sizeClass = BufferPool::sizeClass(size);
+	if (sizeClass == UNPOOLED)
+	{
+		m_allocated.fetch_add(1, std::memory_order_relaxed);
+		return PooledBuffer(new uint8_t[size], size, size, UNPOOLED);
+	}
+
+	size_t capacity = MIN_BUFFER_SIZE << sizeClass;
+	if (capacity <= THREAD_CACHE_MAX_SIZE)
+	{
+		ThreadCache* cache = threadCache();
+		if (cache != nullptr && cache->counts[sizeClass] > 0)
+		{
+			m_threadHits.fetch_add(1, std::memory_order_relaxed);
+			return PooledBuffer(cache->buffers[sizeClass][--cache->counts[sizeClass]], size, capacity, sizeClass);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::vector<uint8_t*>& list = m_free[sizeClass];
+		if (!list.empty())
+		{
+			uint8_t* data = list.back();
+			list.pop_back();
+			m_idleBytes -= capacity;
+			m_sharedHits.fetch_add(1, std::memory_order_relaxed);
+			return PooledBuffer(data, size, capacity, sizeClass);
+		}
+	}
+
+	m_allocated.fetch_add(1, std::memory_order_relaxed);
+	return PooledBuffer(new uint8_t[capacity], size, capacity, sizeClass);
+}
+
+void yhkcatprint::BufferPool::trim()
+{
+	if (ThreadCache* cache = threadCache())
+	{
+		cache->flush();
+	}
+
+	std::array<std::vector<uint8_t*>, CLASS_COUNT> released;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		released.swap(m_free);
+		m_idleBytes = 0;
+	}
+
+	for (std::vector<uint8_t*>& list : released)
+	{
+		for (uint8_t* data : list)
+		{
+			delete[] data;
+		}
+		m_freed.fetch_add(list.size(), std::memory_order_relaxed);
+	}
+}
+
+yhkcatprint::BUFFER_POOL_STATS yhkcatprint::BufferPool::stats() const
+{
+	BUFFER_POOL_STATS stats;
+	stats.acquired = m_acquired.load(std::memory_order_relaxed);
+	stats.allocated = m_allocated.load(std::memory_order_relaxed);
+	stats.threadHits = m_threadHits.load(std::memory_order_relaxed);
+	stats.sharedHits = m_sharedHits.load(std::memory_order_relaxed);
+	stats.freed = m_freed.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	stats.idleBytes = m_idleBytes;
+	return stats;
+}
+
+uint8_t yhkcatprint::BufferPool::sizeClass(size_t size) noexcept
+{
+	if (size <= MIN_BUFFER_SIZE)
+	{
+		return 0;
+	}
+	if (size > MAX_BUFFER_SIZE)
+	{
+		return UNPOOLED;
+	}
+	return static_cast<uint8_t>(std::bit_width(size - 1) - std::countr_zero(MIN_BUFFER_SIZE));
+}
+
+void yhkcatprint::BufferPool::release(uint8_t* data, uint8_t sizeClass) noexcept
+{
+	if (sizeClass == UNPOOLED)
+	{
+		delete[] data;
+		m_freed.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	if ((MIN_BUFFER_SIZE << sizeClass) <= THREAD_CACHE_MAX_SIZE)
+	{
+		ThreadCache* cache = threadCache();
+		if (cache != nullptr && cache->counts[sizeClass] < THREAD_CACHE_DEPTH)
+		{
+			cache->buffers[sizeClass][cache->counts[sizeClass]++] = data;
+			return;
+		}
+	}
+
+	releaseShared(data, sizeClass);
+}
+
+void yhkcatprint::BufferPool::releaseShared(uint8_t* data, uint8_t sizeClass) noexcept
+{
+	size_t capacity = MIN_BUFFER_SIZE << sizeClass;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_idleBytes + capacity <= MAX_IDLE_BYTES)
+		{
+			try
+			{
+				m_free[sizeClass].push_back(data);
+				m_idleBytes += capacity;
+				return;
+			}
+			catch (const std::bad_alloc&)
+			{
+				// Without room to list it, the buffer goes back to the heap.
+			}
+		}
+	}
+
+	delete[] data;
+	m_freed.fetch_add(1, std::memory_order_relaxed);
+}
+
+yhkcatprint::BufferPool::ThreadCache* yhkcatprint::BufferPool::threadCache() noexcept
+{
+	if (ThreadCache::destroyed)
+	{
+		return nullptr;
+	}
+	thread_local ThreadCache cache;
+	return &cache;
+}
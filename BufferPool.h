@@ -0,0 +1,327 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BufferPool.h
+
+Abstract:
+	Size-class pool of byte buffers with per-thread caches.
+
+--*/
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+/**
+ * @file BufferPool.h
+ * @brief Size-class pool of byte buffers with per-thread caches.
+ *
+ * This header defines BufferPool, which recycles the byte buffers of the
+ * print path, such as queued jobs, raster bands and encoder frames, and
+ * PooledBuffer, which hands a buffer back to the pool when destroyed. Once
+ * the pool has warmed up, a steady stream of jobs no longer reaches the
+ * heap, which keeps the native heap of long-running hosts from fragmenting.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Buffer pool statistics, counted since the process started.
+	 */
+	typedef struct _BUFFER_POOL_STATS
+	{
+		/**
+		 * @brief Buffers handed out.
+		 */
+		uint64_t acquired = 0;
+		/**
+		 * @brief Buffers that had to be allocated from the heap, including those too large to pool.
+		 */
+		uint64_t allocated = 0;
+		/**
+		 * @brief Buffers taken from the calling thread's cache.
+		 */
+		uint64_t threadHits = 0;
+		/**
+		 * @brief Buffers taken from the shared free lists.
+		 */
+		uint64_t sharedHits = 0;
+		/**
+		 * @brief Buffers given back to the heap because the free lists were full or trimmed.
+		 */
+		uint64_t freed = 0;
+		/**
+		 * @brief Bytes held in the shared free lists.
+		 */
+		size_t idleBytes = 0;
+	} BUFFER_POOL_STATS;
+
+	/**
+	 * @brief Byte buffer on loan from the BufferPool.
+	 *
+	 * The buffer is returned to the pool when the PooledBuffer is destroyed
+	 * or reset. Its capacity is the size class it was taken from, so it may
+	 * be resized up to that without reallocating. The contents of a new
+	 * buffer are unspecified.
+	 *
+	 * @note A PooledBuffer may be moved to and released on any thread.
+	 */
+	class PooledBuffer
+	{
+	public:
+		/**
+		 * @brief Constructs an empty PooledBuffer holding no buffer.
+		 */
+		PooledBuffer() noexcept;
+
+		/**
+		 * @brief Destructor. Returns the buffer to the pool.
+		 */
+		~PooledBuffer();
+
+		PooledBuffer(PooledBuffer&& other) noexcept;
+		PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+
+		// Disable copy semantics
+		PooledBuffer(const PooledBuffer&) = delete;
+		PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+		/**
+		 * @brief Returns the first byte of the buffer, or nullptr if empty.
+		 */
+		uint8_t* data() noexcept
+		{
+			return m_data;
+		}
+
+		/**
+		 * @brief Returns the first byte of the buffer, or nullptr if empty.
+		 */
+		const uint8_t* data() const noexcept
+		{
+			return m_data;
+		}
+
+		/**
+		 * @brief Returns the number of bytes in use.
+		 */
+		size_t size() const noexcept
+		{
+			return m_size;
+		}
+
+		/**
+		 * @brief Returns the number of bytes the buffer can hold.
+		 */
+		size_t capacity() const noexcept
+		{
+			return m_capacity;
+		}
+
+		/**
+		 * @brief Checks whether no bytes are in use.
+		 */
+		bool empty() const noexcept
+		{
+			return m_size == 0;
+		}
+
+		/**
+		 * @brief Returns the bytes in use.
+		 */
+		std::span<uint8_t> span() noexcept
+		{
+			return { m_data, m_size };
+		}
+
+		/**
+		 * @brief Returns the bytes in use.
+		 */
+		std::span<const uint8_t> span() const noexcept
+		{
+			return { m_data, m_size };
+		}
+
+		/**
+		 * @brief Changes the number of bytes in use without reallocating.
+		 *
+		 * @throws std::length_error if the size exceeds the capacity.
+		 */
+		void resize(size_t size);
+
+		/**
+		 * @brief Returns the buffer to the pool, leaving the PooledBuffer empty.
+		 */
+		void reset() noexcept;
+
+	private:
+		friend class BufferPool;
+
+		PooledBuffer(uint8_t* data, size_t size, size_t capacity, uint8_t sizeClass) noexcept;
+
+		/**
+		 * @brief Buffer, or nullptr.
+		 */
+		uint8_t* m_data;
+		/**
+		 * @brief Bytes in use.
+		 */
+		size_t m_size;
+		/**
+		 * @brief Size of the buffer.
+		 */
+		size_t m_capacity;
+		/**
+		 * @brief Size class the buffer belongs to, or BufferPool::UNPOOLED.
+		 */
+		uint8_t m_sizeClass;
+	};
+
+	/**
+	 * @brief Size-class pool of byte buffers with per-thread caches.
+	 *
+	 * Requests are rounded up to a power of two between MIN_BUFFER_SIZE and
+	 * MAX_BUFFER_SIZE and served from a free list of that size; larger
+	 * requests go straight to the heap. Every thread keeps a few small
+	 * buffers of each size for itself, so the buffers a thread frees and
+	 * takes again, like the frames of consecutive jobs, do not touch a lock.
+	 * Other buffers go back to free lists shared by all threads.
+	 *
+	 * Memory held by the pool is bounded: each thread caches at most
+	 * THREAD_CACHE_DEPTH buffers of each size up to THREAD_CACHE_MAX_SIZE,
+	 * and the shared lists hold at most MAX_IDLE_BYTES, beyond which freed
+	 * buffers go back to the heap.
+	 *
+	 * There is one pool per process. It is never destroyed, so buffers may be
+	 * released from static and thread-local destructors.
+	 *
+	 * @note All public methods are thread-safe.
+	 */
+	class BufferPool
+	{
+	public:
+		/**
+		 * @brief Smallest size class.
+		 */
+		static constexpr size_t MIN_BUFFER_SIZE = 256;
+
+		/**
+		 * @brief Largest size class; larger buffers are not pooled.
+		 */
+		static constexpr size_t MAX_BUFFER_SIZE = 16u << 20;
+
+		/**
+		 * @brief Buffers of each size class a thread keeps for itself.
+		 */
+		static constexpr size_t THREAD_CACHE_DEPTH = 4;
+
+		/**
+		 * @brief Largest size class kept in thread caches.
+		 */
+		static constexpr size_t THREAD_CACHE_MAX_SIZE = 64u << 10;
+
+		/**
+		 * @brief Most bytes the shared free lists hold.
+		 */
+		static constexpr size_t MAX_IDLE_BYTES = 32u << 20;
+
+		/**
+		 * @brief Returns the pool of the process.
+		 */
+		static BufferPool& instance();
+
+		// Disable copy semantics
+		BufferPool(const BufferPool&) = delete;
+		BufferPool& operator=(const BufferPool&) = delete;
+
+		/**
+		 * @brief Takes a buffer of at least the given size.
+		 *
+		 * @param size Bytes in use of the returned buffer.
+		 * @return Buffer with the given size; its contents are unspecified.
+		 *
+		 * @throws std::bad_alloc if the heap is exhausted.
+		 */
+		PooledBuffer acquire(size_t size);
+
+		/**
+		 * @brief Gives the buffers in the shared free lists and the calling thread's cache back to the heap.
+		 */
+		void trim();
+
+		/**
+		 * @brief Returns the pool statistics.
+		 */
+		BUFFER_POOL_STATS stats() const;
+
+	private:
+		friend class PooledBuffer;
+
+		/**
+		 * @brief Buffers a thread keeps for itself.
+		 */
+		struct ThreadCache;
+
+		/**
+		 * @brief Returns the calling thread's cache, or nullptr once the thread is exiting.
+		 */
+		static ThreadCache* threadCache() noexcept;
+
+		/**
+		 * @brief Number of size classes.
+		 */
+		static constexpr size_t CLASS_COUNT = 17;
+
+		/**
+		 * @brief Size class of buffers that are not pooled.
+		 */
+		static constexpr uint8_t UNPOOLED = 0xff;
+
+		static_assert(MIN_BUFFER_SIZE << (CLASS_COUNT - 1) == MAX_BUFFER_SIZE, "Size classes must span the pooled sizes");
+
+		BufferPool();
+
+		/**
+		 * @brief Returns the size class of buffers of the given size, or UNPOOLED.
+		 */
+		static uint8_t sizeClass(size_t size) noexcept;
+
+		/**
+		 * @brief Returns a buffer to its thread cache or free list, or to the heap.
+		 */
+		void release(uint8_t* data, uint8_t sizeClass) noexcept;
+
+		/**
+		 * @brief Returns a buffer to its shared free list, or to the heap if the lists are full.
+		 */
+		void releaseShared(uint8_t* data, uint8_t sizeClass) noexcept;
+
+		/**
+		 * @brief Shared free lists by size class.
+		 */
+		std::array<std::vector<uint8_t*>, CLASS_COUNT> m_free;
+		/**
+		 * @brief Bytes held in m_free.
+		 */
+		size_t m_idleBytes;
+		/**
+		 * @brief Guards m_free and m_idleBytes.
+		 */
+		mutable std::mutex m_mutex;
+		/**
+		 * @brief Counters reported by stats().
+		 */
+		std::atomic<uint64_t> m_acquired;
+		std::atomic<uint64_t> m_allocated;
+		std::atomic<uint64_t> m_threadHits;
+		std::atomic<uint64_t> m_sharedHits;
+		std::atomic<uint64_t> m_freed;
+	};
+}
@@ -0,0 +1,323 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BufferedReader.h
+
+Abstract:
+	Receive ring buffer layered on an RFCOMM socket.
+
+--*/
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @file BufferedReader.h
+ * @brief Receive ring buffer layered on an RFCOMM socket.
+ *
+ * This header defines BufferedReader, which reads whatever the socket has
+ * received into a ring buffer and hands out replies of an exact size, no
+ * matter how the link split or merged them. Like BufferedWriter, it is a
+ * template over the socket type and does not include the socket interface,
+ * so the same code serves the header and the module API.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Receive ring buffer layered on an RFCOMM socket.
+	 *
+	 * RFCOMM delivers a reply in as many pieces as the link cut it into, and
+	 * may deliver the start of the next reply together with the end of this
+	 * one. The reader receives in bulk, as much as the socket holds and the
+	 * buffer has room for, and readExact() waits until a whole reply has
+	 * arrived, keeping any bytes after it for the next call.
+	 *
+	 * Replies are returned as views into the buffer, so parsers decode them
+	 * where they were received. A reply that wraps around the end of the
+	 * buffer is moved to its start first, which only happens when replies do
+	 * not divide the capacity.
+	 *
+	 * The ring buffer is allocated by the reader, or supplied by the caller,
+	 * such as from an Arena.
+	 *
+	 * With sockets whose available() returns the number of bytes received,
+	 * such as the module API's, the reader receives exactly that many. With
+	 * sockets whose available() only tells whether a receive would not block,
+	 * it receives until it says no.
+	 *
+	 * @tparam TSocket Socket type providing receive() with and without a timeout and available(), typically IRfcommSocket.
+	 *
+	 * @note Not thread-safe, and the socket must not be read around the reader while it holds data.
+	 */
+	template<typename TSocket>
+	class BufferedReader
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Default capacity, about four RFCOMM frames.
+		 */
+		static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+		/**
+		 * @brief Constructs an empty BufferedReader.
+		 *
+		 * @param socket Connected socket; must outlive the reader.
+		 * @param capacity Size of the ring buffer, and so of the largest reply.
+		 */
+		explicit BufferedReader(TSocket& socket, size_t capacity = DEFAULT_CAPACITY)
+			: m_socket(socket), m_capacity(capacity > 0 ? capacity : 1), m_owned(std::make_unique_for_overwrite<uint8_t[]>(m_capacity)), m_buffer(m_owned.get()), m_head(0), m_size(0), m_closed(false)
+		{
+		}
+
+		/**
+		 * @brief Constructs an empty BufferedReader receiving into the caller's storage.
+		 *
+		 * @param socket Connected socket; must outlive the reader.
+		 * @param storage Ring buffer, whose size is the capacity; must outlive the reader.
+		 *
+		 * @throws std::invalid_argument if the storage is empty.
+		 */
+		BufferedReader(TSocket& socket, std::span<uint8_t> storage)
+			: m_socket(socket), m_capacity(storage.size()), m_buffer(storage.data()), m_head(0), m_size(0), m_closed(false)
+		{
+			if (storage.empty())
+			{
+				throw std::invalid_argument("Reader storage must not be empty");
+			}
+		}
+
+		// Disable copy semantics
+		BufferedReader(const BufferedReader&) = delete;
+		BufferedReader& operator=(const BufferedReader&) = delete;
+
+		/**
+		 * @brief Returns the number of bytes received and not yet consumed.
+		 */
+		size_t buffered() const noexcept
+		{
+			return m_size;
+		}
+
+		/**
+		 * @brief Returns the size of the ring buffer.
+		 */
+		size_t capacity() const noexcept
+		{
+			return m_capacity;
+		}
+
+		/**
+		 * @brief Checks whether the peer has closed the connection; buffered bytes can still be read.
+		 */
+		bool isClosed() const noexcept
+		{
+			return m_closed;
+		}
+
+		/**
+		 * @brief Receives whatever the socket holds, as far as the buffer has room, without blocking.
+		 *
+		 * @return Number of bytes received.
+		 *
+		 * @throws std::runtime_error on failure to receive.
+		 */
+		size_t fill()
+		{
+			size_t total = 0;
+			while (!m_closed && m_size < m_capacity)
+			{
+				auto ready = m_socket.available();
+				if (!ready)
+				{
+					break;
+				}
+
+				size_t size = freeSpan().size();
+				if constexpr (!std::is_same_v<decltype(ready), bool>)
+				{
+					size = std::min(size, static_cast<size_t>(ready));
+				}
+				size_t received = commit(m_socket.receive(freeSpan().data(), size));
+				if (received == 0)
+				{
+					break;
+				}
+				total += received;
+			}
+			return total;
+		}
+
+		/**
+		 * @brief Waits until the socket has received something, then receives whatever it holds.
+		 *
+		 * @param deadline Latest time to wait until.
+		 * @return Number of bytes received, 0 if the peer has closed the connection or the buffer is full.
+		 *
+		 * @throws std::runtime_error on failure to receive or if nothing arrived before the deadline.
+		 */
+		size_t fill(Clock::time_point deadline)
+		{
+			if (m_closed || m_size == m_capacity)
+			{
+				return 0;
+			}
+
+			Clock::time_point now = Clock::now();
+			if (now >= deadline)
+			{
+				throw std::runtime_error("Timed out receiving data");
+			}
+
+			std::span<uint8_t> free = freeSpan();
+			size_t received = commit(m_socket.receive(free.data(), free.size(), deadline - now));
+			return received > 0 ? received + fill() : 0;
+		}
+
+		/**
+		 * @brief Returns the buffered bytes up to the end of the ring buffer, without consuming them.
+		 *
+		 * The view holds all buffered bytes unless they wrap around the end
+		 * of the buffer; consume() it to get to the rest.
+		 */
+		std::span<const uint8_t> peek() const noexcept
+		{
+			return { m_buffer + m_head, std::min(m_size, m_capacity - m_head) };
+		}
+
+		/**
+		 * @brief Returns the first bytes buffered as one view, without consuming them.
+		 *
+		 * @param size Number of bytes to view.
+		 * @return View valid until the next call that receives, consumes or views.
+		 *
+		 * @throws std::invalid_argument if fewer bytes are buffered.
+		 */
+		std::span<const uint8_t> peek(size_t size)
+		{
+			if (size > m_size)
+			{
+				throw std::invalid_argument("Not enough data buffered");
+			}
+			if (m_head + size > m_capacity)
+			{
+				// Moves the bytes wrapped to the front behind the rest.
+				std::rotate(m_buffer, m_buffer + m_head, m_buffer + m_capacity);
+				m_head = 0;
+			}
+			return { m_buffer + m_head, size };
+		}
+
+		/**
+		 * @brief Drops the first bytes buffered.
+		 *
+		 * @param size Number of bytes to drop.
+		 *
+		 * @throws std::invalid_argument if fewer bytes are buffered.
+		 */
+		void consume(size_t size)
+		{
+			if (size > m_size)
+			{
+				throw std::invalid_argument("Not enough data buffered");
+			}
+			m_size -= size;
+			// An empty buffer starts over, so that the next reply does not wrap.
+			m_head = m_size > 0 ? (m_head + size) % m_capacity : 0;
+		}
+
+		/**
+		 * @brief Waits until a reply of the given size has arrived and consumes it.
+		 *
+		 * Bytes received after the reply stay buffered.
+		 *
+		 * @param size Size of the reply.
+		 * @param deadline Latest time to wait until.
+		 * @return View of the reply, valid until the next call that receives, consumes or views.
+		 *
+		 * @throws std::invalid_argument if the reply is larger than the buffer.
+		 * @throws std::runtime_error on failure to receive, if the reply is not complete by the deadline,
+		 *         or if the peer closes the connection before it is.
+		 */
+		std::span<const uint8_t> readExact(size_t size, Clock::time_point deadline)
+		{
+			if (size > m_capacity)
+			{
+				throw std::invalid_argument("Reply larger than the receive buffer");
+			}
+
+			fill();
+			while (m_size < size)
+			{
+				if (m_closed)
+				{
+					throw std::runtime_error("Connection closed before the reply was complete");
+				}
+				fill(deadline);
+			}
+
+			std::span<const uint8_t> reply = peek(size);
+			consume(size);
+			return reply;
+		}
+
+	private:
+		/**
+		 * @brief Returns the free space after the buffered bytes up to the end of the ring buffer or the first buffered byte.
+		 */
+		std::span<uint8_t> freeSpan() noexcept
+		{
+			size_t tail = (m_head + m_size) % m_capacity;
+			return { m_buffer + tail, std::min(m_capacity - m_size, m_capacity - tail) };
+		}
+
+		/**
+		 * @brief Accounts for bytes received into freeSpan(); zero bytes mean the peer closed the connection.
+		 */
+		size_t commit(size_t received) noexcept
+		{
+			m_size += received;
+			m_closed = m_closed || received == 0;
+			return received;
+		}
+
+		/**
+		 * @brief Socket data is received from.
+		 */
+		TSocket& m_socket;
+		/**
+		 * @brief Size of m_buffer.
+		 */
+		const size_t m_capacity;
+		/**
+		 * @brief Ring buffer allocated by the reader, or nullptr if the caller supplied it.
+		 */
+		std::unique_ptr<uint8_t[]> m_owned;
+		/**
+		 * @brief Ring buffer of m_capacity bytes.
+		 */
+		uint8_t* m_buffer;
+		/**
+		 * @brief Offset of the first buffered byte.
+		 */
+		size_t m_head;
+		/**
+		 * @brief Number of buffered bytes.
+		 */
+		size_t m_size;
+		/**
+		 * @brief Whether a receive returned no data, meaning the peer closed the connection.
+		 */
+		bool m_closed;
+	};
+}
@@ -0,0 +1,281 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BufferedWriter.h
+
+Abstract:
+	Write-coalescing output buffer layered on an RFCOMM socket.
+
+--*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+/**
+ * @file BufferedWriter.h
+ * @brief Write-coalescing output buffer layered on an RFCOMM socket.
+ *
+ * This header defines BufferedWriter, which gathers small writes into
+ * frame-sized sends and retries partial sends until every byte is delivered.
+ * It is a template over the socket type and does not include the socket
+ * interface, so the same code serves the header and the module API.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Write-coalescing output buffer layered on an RFCOMM socket.
+	 *
+	 * Small writes, such as printer commands, are copied into a buffer and go
+	 * out together once a full frame has accumulated or flush() is called.
+	 * Large writes bypass the buffer: whole frames are sent straight from the
+	 * caller's memory together with the buffered bytes, and only the tail is
+	 * buffered, so it can share a frame with whatever is written next.
+	 *
+	 * The buffer is allocated by the writer, or supplied by the caller, such
+	 * as from an Arena, so that a writer set up for every job takes no heap
+	 * memory.
+	 *
+	 * The writer counts the bytes the socket has accepted, including those of
+	 * a send that later failed, so the caller can tell whether anything of a
+	 * job reached the printer.
+	 *
+	 * The destructor does not flush; unflushed data is discarded.
+	 *
+	 * @tparam TSocket Socket type providing the single-buffer and vectored send(), typically IRfcommSocket.
+	 *
+	 * @note Not thread-safe.
+	 */
+	template<typename TSocket>
+	class BufferedWriter
+	{
+	public:
+		/**
+		 * @brief Default frame size, about one RFCOMM frame.
+		 */
+		static constexpr size_t DEFAULT_FRAME_SIZE = 990;
+
+		/**
+		 * @brief Constructs an empty BufferedWriter.
+		 *
+		 * @param socket Connected socket; must outlive the writer.
+		 * @param frameSize Number of bytes gathered before a send.
+		 */
+		explicit BufferedWriter(TSocket& socket, size_t frameSize = DEFAULT_FRAME_SIZE)
+			: m_socket(socket), m_frameSize(frameSize > 0 ? frameSize : 1), m_owned(std::make_unique_for_overwrite<uint8_t[]>(m_frameSize)), m_buffer(m_owned.get()), m_size(0), m_sent(0)
+		{
+		}
+
+		/**
+		 * @brief Constructs an empty BufferedWriter gathering data in the caller's storage.
+		 *
+		 * @param socket Connected socket; must outlive the writer.
+		 * @param storage Buffer to gather data in, whose size is the frame size; must outlive the writer.
+		 *
+		 * @throws std::invalid_argument if the storage is empty.
+		 */
+		BufferedWriter(TSocket& socket, std::span<uint8_t> storage)
+			: m_socket(socket), m_frameSize(storage.size()), m_buffer(storage.data()), m_size(0), m_sent(0)
+		{
+			if (storage.empty())
+			{
+				throw std::invalid_argument("Writer storage must not be empty");
+			}
+		}
+
+		// Disable copy semantics
+		BufferedWriter(const BufferedWriter&) = delete;
+		BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+		/**
+		 * @brief Appends data, sending every frame that fills up.
+		 *
+		 * @param data Pointer to the data to write.
+		 * @param size Number of bytes to write.
+		 *
+		 * @throws std::runtime_error on failure to send.
+		 */
+		void write(const uint8_t* data, size_t size)
+		{
+			size_t total = m_size + size;
+			if (total < m_frameSize)
+			{
+				std::copy_n(data, size, m_buffer + m_size);
+				m_size = total;
+				return;
+			}
+
+			// The buffered bytes and all whole frames of the new data go out in
+			// one vectored send; only the tail is copied into the buffer.
+			size_t direct = total - total % m_frameSize - m_size;
+			const std::span<const uint8_t> parts[] = { { m_buffer, m_size }, { data, direct } };
+			try
+			{
+				sendAll(m_socket, parts, m_sent);
+			}
+			catch (...)
+			{
+				m_size = 0;
+				throw;
+			}
+			m_size = size - direct;
+			std::copy_n(data + direct, m_size, m_buffer);
+		}
+
+		/**
+		 * @brief Appends a fixed-size command or other array.
+		 *
+		 * @throws std::runtime_error on failure to send.
+		 */
+		template<size_t N>
+		void write(const std::array<uint8_t, N>& data)
+		{
+			write(data.data(), N);
+		}
+
+		/**
+		 * @brief Sends all buffered data.
+		 *
+		 * @throws std::runtime_error on failure to send; the buffer is cleared either way.
+		 */
+		void flush()
+		{
+			if (m_size == 0)
+			{
+				return;
+			}
+
+			// A failed send must not leave half-sent data behind to be repeated.
+			size_t size = m_size;
+			m_size = 0;
+			sendAll(m_socket, m_buffer, size, m_sent);
+		}
+
+		/**
+		 * @brief Returns the number of bytes waiting for flush().
+		 */
+		size_t buffered() const noexcept
+		{
+			return m_size;
+		}
+
+		/**
+		 * @brief Returns the number of bytes the socket has accepted so far.
+		 */
+		size_t sent() const noexcept
+		{
+			return m_sent;
+		}
+
+		/**
+		 * @brief Sends a buffer, repeating partial sends until every byte is delivered.
+		 *
+		 * @param socket Connected socket.
+		 * @param data Pointer to the data to send.
+		 * @param size Number of bytes to send.
+		 * @param sent Increased by every byte the socket accepts, also when a later send fails.
+		 *
+		 * @throws std::runtime_error on failure to send or if the socket stops accepting data.
+		 */
+		static void sendAll(TSocket& socket, const uint8_t* data, size_t size, size_t& sent)
+		{
+			while (size > 0)
+			{
+				size_t count = socket.send(data, size);
+				if (count == 0)
+				{
+					throw std::runtime_error("Connection stopped accepting data");
+				}
+				sent += count;
+				data += count;
+				size -= count;
+			}
+		}
+
+		/**
+		 * @brief Sends several buffers in order, repeating partial sends until every byte is delivered.
+		 *
+		 * Uses the socket's vectored send, so the buffers are never copied together.
+		 *
+		 * @param socket Connected socket.
+		 * @param buffers Buffers to send, in order.
+		 * @param sent Increased by every byte the socket accepts, also when a later send fails.
+		 *
+		 * @throws std::runtime_error on failure to send or if the socket stops accepting data.
+		 */
+		static void sendAll(TSocket& socket, std::span<const std::span<const uint8_t>> buffers, size_t& sent)
+		{
+			size_t index = 0;
+			size_t offset = 0;
+
+			while (true)
+			{
+				while (index < buffers.size() && offset == buffers[index].size())
+				{
+					index++;
+					offset = 0;
+				}
+				if (index == buffers.size())
+				{
+					return;
+				}
+
+				// After a partial send inside a buffer, finish that buffer on its own, then resume vectored.
+				size_t count = offset == 0
+					? socket.send(buffers.subspan(index))
+					: socket.send(buffers[index].data() + offset, buffers[index].size() - offset);
+				if (count == 0)
+				{
+					throw std::runtime_error("Connection stopped accepting data");
+				}
+				sent += count;
+
+				while (count > 0)
+				{
+					size_t remaining = buffers[index].size() - offset;
+					if (count < remaining)
+					{
+						offset += count;
+						break;
+					}
+					count -= remaining;
+					index++;
+					offset = 0;
+				}
+			}
+		}
+
+	private:
+		/**
+		 * @brief Socket data is sent through.
+		 */
+		TSocket& m_socket;
+		/**
+		 * @brief Number of bytes gathered before a send.
+		 */
+		const size_t m_frameSize;
+		/**
+		 * @brief Buffer allocated by the writer, or nullptr if the caller supplied it.
+		 */
+		std::unique_ptr<uint8_t[]> m_owned;
+		/**
+		 * @brief Buffer of m_frameSize bytes.
+		 */
+		uint8_t* m_buffer;
+		/**
+		 * @brief Bytes waiting to be sent.
+		 */
+		size_t m_size;
+		/**
+		 * @brief Bytes the socket has accepted.
+		 */
+		size_t m_sent;
+	};
+}
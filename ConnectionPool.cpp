@@ -0,0 +1,383 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ConnectionPool.cpp
+
+Abstract:
+	Implementation of ConnectionPool methods.
+
+--*/
+
+#include "ConnectionPool.h"
+#include "EscPos.h"
+#include <stdexcept>
+
+namespace
+{
+	constexpr auto getStatusCmd = yhkcatprint::escpos::getStatus();
+}
+
+yhkcatprint::ConnectionPool::Lease::Lease()
+	: m_pool(nullptr), m_reused(false)
+{
+}
+
+yhkcatprint::ConnectionPool::Lease::Lease(ConnectionPool* pool, std::string key, std::shared_ptr<IRfcommSocket> socket, bool reused)
+	: m_pool(pool), m_key(std::move(key)), m_socket(std::move(socket)), m_reused(reused)
+{
+}
+
+yhkcatprint::ConnectionPool::Lease::~Lease()
+{
+	giveBack(true);
+}
+
+yhkcatprint::ConnectionPool::Lease::Lease(Lease&& other) noexcept
+	: m_pool(other.m_pool), m_key(std::move(other.m_key)), m_socket(std::move(other.m_socket)), m_reused(other.m_reused)
+{
+	other.m_pool = nullptr;
+}
+
+yhkcatprint::ConnectionPool::Lease& yhkcatprint::ConnectionPool::Lease::operator=(Lease&& other) noexcept
+{
+	if (this != &other)
+	{
+		giveBack(true);
+		m_pool = other.m_pool;
+		m_key = std::move(other.m_key);
+		m_socket = std::move(other.m_socket);
+		m_reused = other.m_reused;
+		other.m_pool = nullptr;
+	}
+	return *this;
+}
+
+const std::shared_ptr<yhkcatprint::IRfcommSocket>& yhkcatprint::ConnectionPool::Lease::socket() const
+{
+	return m_socket;
+}
+
+bool yhkcatprint::ConnectionPool::Lease::isReused() const
+{
+	return m_reused;
+}
+
+void yhkcatprint::ConnectionPool::Lease::release()
+{
+	giveBack(true);
+}
+
+void yhkcatprint::ConnectionPool::Lease::discard()
+{
+	giveBack(false);
+}
+
+void yhkcatprint::ConnectionPool::Lease::giveBack(bool reusable) noexcept
+{
+	if (m_pool == nullptr)
+	{
+		return;
+	}
+
+	m_pool->giveBack(m_key, std::move(m_socket), reusable);
+	m_pool = nullptr;
+	m_socket.reset();
+}
+
+yhkcatprint::ConnectionPool::ConnectionPool(const POOL_OPTIONS& options)
+	: m_options(options), m_links(0), m_stats()
+{
+	if (options.maxLinks == 0)
+	{
+		throw std::invalid_argument("A connection pool needs at least one link");
+	}
+}
+
+yhkcatprint::ConnectionPool::~ConnectionPool()
+{
+	clear();
+}
+
+yhkcatprint::ConnectionPool::Lease yhkcatprint::ConnectionPool::acquire(IDevice& device, uint8_t channel, ConnectOptions options, std::chrono::milliseconds wait)
+{
+	const std::string key = makeKey(device.getInfo().address, channel);
+	const Clock::time_point deadline = Clock::now() + wait;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		Clock::time_point now = Clock::now();
+		std::vector<std::shared_ptr<IRfcommSocket>> closing;
+		collectExpired(now, closing);
+
+		auto idle = m_idle.find(key);
+		if (idle != m_idle.end() && !idle->second.empty())
+		{
+			IdleLink link = std::move(idle->second.back());
+			idle->second.pop_back();
+			lock.unlock();
+			closeAll(closing);
+
+			if (now - link.since < m_options.checkAfter || checkHealth(*link.socket))
+			{
+				lock.lock();
+				m_stats.reused++;
+				return Lease(this, key, std::move(link.socket), true);
+			}
+
+			// The printer went away while the link was idle; its slot goes to a new connection.
+			std::vector<std::shared_ptr<IRfcommSocket>> dead{ std::move(link.socket) };
+			closeAll(dead);
+			lock.lock();
+			m_stats.checkFailures++;
+			m_links--;
+			continue;
+		}
+
+		if (m_links >= m_options.maxLinks)
+		{
+			std::shared_ptr<IRfcommSocket> oldest = takeOldestIdle();
+			if (oldest != nullptr)
+			{
+				closing.push_back(std::move(oldest));
+				m_stats.evicted++;
+				m_links--;
+			}
+		}
+
+		if (m_links < m_options.maxLinks)
+		{
+			// The slot is taken before connecting, which can take seconds and runs unlocked.
+			m_links++;
+			lock.unlock();
+			closeAll(closing);
+
+			std::shared_ptr<IRfcommSocket> socket;
+			try
+			{
+				socket = device.createRfcommSocket(channel, options);
+			}
+			catch (...)
+			{
+				lock.lock();
+				m_links--;
+				m_released.notify_one();
+				throw;
+			}
+
+			lock.lock();
+			m_stats.connected++;
+			return Lease(this, key, std::move(socket), false);
+		}
+
+		if (!closing.empty())
+		{
+			lock.unlock();
+			closeAll(closing);
+			lock.lock();
+			continue;
+		}
+
+		if (Clock::now() >= deadline)
+		{
+			throw std::runtime_error("All " + std::to_string(m_options.maxLinks) + " pooled links are in use");
+		}
+		m_released.wait_until(lock, deadline);
+	}
+}
+
+size_t yhkcatprint::ConnectionPool::evictIdle()
+{
+	std::vector<std::shared_ptr<IRfcommSocket>> closing;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		collectExpired(Clock::now(), closing);
+	}
+	closeAll(closing);
+	return closing.size();
+}
+
+void yhkcatprint::ConnectionPool::clear()
+{
+	std::vector<std::shared_ptr<IRfcommSocket>> closing;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& entry : m_idle)
+		{
+			for (auto& link : entry.second)
+			{
+				closing.push_back(std::move(link.socket));
+			}
+		}
+		m_links -= closing.size();
+		m_idle.clear();
+		m_released.notify_all();
+	}
+	closeAll(closing);
+}
+
+void yhkcatprint::ConnectionPool::setMaxLinks(size_t maxLinks)
+{
+	if (maxLinks == 0)
+	{
+		throw std::invalid_argument("A connection pool needs at least one link");
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_options.maxLinks = maxLinks;
+	m_released.notify_all();
+}
+
+yhkcatprint::POOL_STATS yhkcatprint::ConnectionPool::stats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	POOL_STATS stats = m_stats;
+	for (const auto& entry : m_idle)
+	{
+		stats.idle += entry.second.size();
+	}
+	stats.active = m_links - stats.idle;
+	return stats;
+}
+
+std::string yhkcatprint::ConnectionPool::makeKey(const std::string& address, uint8_t channel)
+{
+	return address + "#" + std::to_string(channel);
+}
+
+bool yhkcatprint::ConnectionPool::checkHealth(IRfcommSocket& socket)
+{
+	try
+	{
+		// Bytes the printer sent while the link was idle would be mistaken for the reply.
+		uint8_t reply[escpos::STATUS_SIZE];
+		while (socket.available())
+		{
+			if (socket.receive(reply, sizeof(reply)) == 0)
+			{
+				return false;
+			}
+		}
+
+		if (socket.send(getStatusCmd.data(), getStatusCmd.size(), m_options.checkTimeout) != getStatusCmd.size())
+		{
+			return false;
+		}
+
+		const Clock::time_point deadline = Clock::now() + m_options.checkTimeout;
+		size_t received = 0;
+		while (received < sizeof(reply))
+		{
+			Clock::time_point now = Clock::now();
+			if (now >= deadline)
+			{
+				return false;
+			}
+			size_t count = socket.receive(reply + received, sizeof(reply) - received, deadline - now);
+			if (count == 0)
+			{
+				return false;
+			}
+			received += count;
+		}
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+}
+
+void yhkcatprint::ConnectionPool::collectExpired(Clock::time_point now, std::vector<std::shared_ptr<IRfcommSocket>>& closing)
+{
+	for (auto entry = m_idle.begin(); entry != m_idle.end();)
+	{
+		auto& links = entry->second;
+		for (auto link = links.begin(); link != links.end();)
+		{
+			if (now - link->since >= m_options.idleTimeout)
+			{
+				closing.push_back(std::move(link->socket));
+				link = links.erase(link);
+				m_stats.evicted++;
+				m_links--;
+			}
+			else
+			{
+				++link;
+			}
+		}
+
+		entry = links.empty() ? m_idle.erase(entry) : std::next(entry);
+	}
+}
+
+std::shared_ptr<yhkcatprint::IRfcommSocket> yhkcatprint::ConnectionPool::takeOldestIdle()
+{
+	auto oldestEntry = m_idle.end();
+	for (auto entry = m_idle.begin(); entry != m_idle.end(); ++entry)
+	{
+		// Each list is in return order, so its front is its least recently used link.
+		if (!entry->second.empty() && (oldestEntry == m_idle.end() || entry->second.front().since < oldestEntry->second.front().since))
+		{
+			oldestEntry = entry;
+		}
+	}
+
+	if (oldestEntry == m_idle.end())
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<IRfcommSocket> socket = std::move(oldestEntry->second.front().socket);
+	oldestEntry->second.erase(oldestEntry->second.begin());
+	if (oldestEntry->second.empty())
+	{
+		m_idle.erase(oldestEntry);
+	}
+	return socket;
+}
+
+void yhkcatprint::ConnectionPool::giveBack(const std::string& key, std::shared_ptr<IRfcommSocket> socket, bool reusable) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (reusable)
+		{
+			m_idle[key].push_back({ socket, Clock::now() });
+			m_released.notify_one();
+			return;
+		}
+		m_links--;
+		m_released.notify_one();
+	}
+
+	try
+	{
+		socket->close();
+	}
+	catch (const std::exception&)
+	{
+	}
+}
+
+void yhkcatprint::ConnectionPool::closeAll(std::vector<std::shared_ptr<IRfcommSocket>>& sockets) noexcept
+{
+	for (auto& socket : sockets)
+	{
+		if (socket == nullptr)
+		{
+			continue;
+		}
+		try
+		{
+			socket->close();
+		}
+		catch (const std::exception&)
+		{
+		}
+	}
+}
@@ -0,0 +1,347 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ConnectionPool.h
+
+Abstract:
+	Pool of connected RFCOMM links keyed by device address and channel.
+
+--*/
+
+#pragma once
+#include "IDevice.h"
+#include "IRfcommSocket.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file ConnectionPool.h
+ * @brief Pool of connected RFCOMM links keyed by device address and channel.
+ *
+ * This header defines ConnectionPool, which keeps RFCOMM links open after
+ * use so that the next job for the same printer skips the connect, which
+ * takes seconds over Bluetooth.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Connection pool limits and health check settings.
+	 */
+	typedef struct _POOL_OPTIONS
+	{
+		/**
+		 * @brief Most links open at once, in use or idle.
+		 *
+		 * The pool does not know which adapter a link goes through, so this
+		 * caps links per adapter only when each adapter has a pool of its own,
+		 * as the JNI layer keeps one per transport.
+		 */
+		size_t maxLinks = 4;
+		/**
+		 * @brief Idle time after which a link is closed.
+		 */
+		std::chrono::milliseconds idleTimeout{ 300000 };
+		/**
+		 * @brief Idle time after which a link is health-checked before it is handed out again.
+		 */
+		std::chrono::milliseconds checkAfter{ 2000 };
+		/**
+		 * @brief Maximum time to wait for the status reply of a health check.
+		 */
+		std::chrono::milliseconds checkTimeout{ 1000 };
+	} POOL_OPTIONS;
+
+	/**
+	 * @brief Connection pool counters.
+	 */
+	typedef struct _POOL_STATS
+	{
+		/**
+		 * @brief Leases served with an idle link.
+		 */
+		uint64_t reused = 0;
+		/**
+		 * @brief Leases that needed a new connection.
+		 */
+		uint64_t connected = 0;
+		/**
+		 * @brief Idle links that failed their health check.
+		 */
+		uint64_t checkFailures = 0;
+		/**
+		 * @brief Idle links closed for being idle too long or to make room for another printer.
+		 */
+		uint64_t evicted = 0;
+		/**
+		 * @brief Links currently leased.
+		 */
+		size_t active = 0;
+		/**
+		 * @brief Links currently idle in the pool.
+		 */
+		size_t idle = 0;
+	} POOL_STATS;
+
+	/**
+	 * @brief Pool of connected RFCOMM links keyed by device address and channel.
+	 *
+	 * acquire() hands out a Lease on an idle link to the same address and
+	 * channel if there is one, and connects a new link otherwise. A link
+	 * that has been idle for longer than POOL_OPTIONS::checkAfter is first
+	 * probed with the status query (1e 47 03); links that do not answer are
+	 * closed and replaced. When maxLinks are open, the least recently used
+	 * idle link to another printer is closed to make room, and if every link
+	 * is in use, acquire() waits for one to be released.
+	 *
+	 * Idle links are swept lazily on acquire() and by evictIdle(); the pool
+	 * runs no thread of its own.
+	 *
+	 * @note All public methods are thread-safe. Connects and health checks
+	 *       run without holding the pool lock.
+	 */
+	class ConnectionPool
+	{
+	public:
+		/**
+		 * @brief Exclusive use of a pooled link.
+		 *
+		 * A lease returns its link to the pool when released or destroyed.
+		 * A lease whose link failed must be discarded instead, so the link
+		 * is closed rather than handed to the next user.
+		 *
+		 * @note The pool must outlive its leases.
+		 */
+		class Lease
+		{
+		public:
+			/**
+			 * @brief Constructs an empty lease.
+			 */
+			Lease();
+
+			/**
+			 * @brief Destructor. Returns the link to the pool.
+			 */
+			~Lease();
+
+			/**
+			 * @brief Move constructor.
+			 */
+			Lease(Lease&& other) noexcept;
+
+			/**
+			 * @brief Move assignment; returns the link held so far to the pool.
+			 */
+			Lease& operator=(Lease&& other) noexcept;
+
+			// Disable copy semantics
+			Lease(const Lease&) = delete;
+			Lease& operator=(const Lease&) = delete;
+
+			/**
+			 * @brief Returns the leased socket, or nullptr for an empty lease.
+			 */
+			const std::shared_ptr<IRfcommSocket>& socket() const;
+
+			/**
+			 * @brief Checks whether the link was taken from the pool rather than newly connected.
+			 */
+			bool isReused() const;
+
+			/**
+			 * @brief Returns the link to the pool for the next user.
+			 *
+			 * @post The lease is empty.
+			 */
+			void release();
+
+			/**
+			 * @brief Closes the link instead of returning it to the pool.
+			 *
+			 * @post The lease is empty.
+			 */
+			void discard();
+
+		private:
+			friend class ConnectionPool;
+
+			/**
+			 * @brief Constructs a lease on a link.
+			 */
+			Lease(ConnectionPool* pool, std::string key, std::shared_ptr<IRfcommSocket> socket, bool reused);
+
+			/**
+			 * @brief Hands the link back to the pool.
+			 */
+			void giveBack(bool reusable) noexcept;
+
+			/**
+			 * @brief Pool the link belongs to, nullptr for an empty lease.
+			 */
+			ConnectionPool* m_pool;
+			/**
+			 * @brief Pool key of the link.
+			 */
+			std::string m_key;
+			/**
+			 * @brief Leased socket.
+			 */
+			std::shared_ptr<IRfcommSocket> m_socket;
+			/**
+			 * @brief Whether the link was taken from the pool.
+			 */
+			bool m_reused;
+		};
+
+		/**
+		 * @brief Constructs an empty ConnectionPool.
+		 *
+		 * @param options Limits and health check settings.
+		 *
+		 * @throws std::invalid_argument if maxLinks is 0.
+		 */
+		explicit ConnectionPool(const POOL_OPTIONS& options = POOL_OPTIONS());
+
+		/**
+		 * @brief Destructor. Closes all idle links.
+		 *
+		 * @pre No leases are outstanding.
+		 */
+		~ConnectionPool();
+
+		// Disable copy semantics
+		ConnectionPool(const ConnectionPool&) = delete;
+		ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+		/**
+		 * @brief Leases a connected link to a device.
+		 *
+		 * @param device Device to connect to if no idle link is available.
+		 * @param channel RFCOMM channel number.
+		 * @param options Connection options for a new link.
+		 * @param wait Maximum time to wait for a free slot when all links are in use.
+		 * @return Lease on a connected link.
+		 *
+		 * @throws std::runtime_error if connecting fails or no slot frees up in time.
+		 */
+		Lease acquire(IDevice& device, uint8_t channel, ConnectOptions options, std::chrono::milliseconds wait);
+
+		/**
+		 * @brief Closes idle links that have been idle longer than the idle timeout.
+		 *
+		 * @return Number of links closed.
+		 */
+		size_t evictIdle();
+
+		/**
+		 * @brief Closes all idle links.
+		 */
+		void clear();
+
+		/**
+		 * @brief Changes the most links open at once.
+		 *
+		 * Raising the cap wakes acquirers waiting for a slot. Lowering it
+		 * closes no link in use; idle links over the cap are closed as
+		 * further acquires need their slots.
+		 *
+		 * @param maxLinks New link cap.
+		 *
+		 * @throws std::invalid_argument if maxLinks is 0.
+		 */
+		void setMaxLinks(size_t maxLinks);
+
+		/**
+		 * @brief Returns the pool counters.
+		 */
+		POOL_STATS stats();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Idle link.
+		 */
+		struct IdleLink
+		{
+			/**
+			 * @brief Connected socket.
+			 */
+			std::shared_ptr<IRfcommSocket> socket;
+			/**
+			 * @brief When the link was returned to the pool.
+			 */
+			Clock::time_point since;
+		};
+
+		/**
+		 * @brief Returns the pool key of an address and channel.
+		 */
+		static std::string makeKey(const std::string& address, uint8_t channel);
+
+		/**
+		 * @brief Sends the status query and waits for the full reply.
+		 *
+		 * @return true if the printer answered in time.
+		 */
+		bool checkHealth(IRfcommSocket& socket);
+
+		/**
+		 * @brief Takes idle links past the idle timeout out of the pool.
+		 *
+		 * @param closing Receives the sockets to close once the lock is released.
+		 */
+		void collectExpired(Clock::time_point now, std::vector<std::shared_ptr<IRfcommSocket>>& closing);
+
+		/**
+		 * @brief Takes the least recently used idle link out of the pool.
+		 *
+		 * @return Its socket, or nullptr if no link is idle.
+		 */
+		std::shared_ptr<IRfcommSocket> takeOldestIdle();
+
+		/**
+		 * @brief Returns a leased link to the pool or closes it.
+		 */
+		void giveBack(const std::string& key, std::shared_ptr<IRfcommSocket> socket, bool reusable) noexcept;
+
+		/**
+		 * @brief Closes sockets, ignoring errors.
+		 */
+		static void closeAll(std::vector<std::shared_ptr<IRfcommSocket>>& sockets) noexcept;
+
+		/**
+		 * @brief Limits and health check settings.
+		 */
+		POOL_OPTIONS m_options;
+		/**
+		 * @brief Idle links by key, most recently used last.
+		 */
+		std::unordered_map<std::string, std::vector<IdleLink>> m_idle;
+		/**
+		 * @brief Links open or being connected, in use or idle.
+		 */
+		size_t m_links;
+		/**
+		 * @brief Pool counters; active and idle are computed on request.
+		 */
+		POOL_STATS m_stats;
+		/**
+		 * @brief Guards the pool state.
+		 */
+		std::mutex m_mutex;
+		/**
+		 * @brief Signalled when a link is returned or closed.
+		 */
+		std::condition_variable m_released;
+	};
+}
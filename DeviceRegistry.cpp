@@ -0,0 +1,204 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	DeviceRegistry.cpp
+
+Abstract:
+	Implementation of DeviceRegistry methods.
+
+--*/
+
+#include "DeviceRegistry.h"
+#include <iostream>
+#include <stdexcept>
+
+yhkcatprint::DeviceRegistry::DeviceRegistry(std::shared_ptr<IAdapter> adapter)
+	: m_adapter(std::move(adapter)), m_populated(false), m_interval(0), m_stopping(false)
+{
+	if (m_adapter == nullptr)
+	{
+		throw std::invalid_argument("Device registry needs an adapter");
+	}
+
+	try
+	{
+		refresh();
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Failed to enumerate paired devices: " << ex.what() << std::endl;
+	}
+}
+
+yhkcatprint::DeviceRegistry::~DeviceRegistry()
+{
+	stopWatching();
+}
+
+std::shared_ptr<yhkcatprint::IDevice> yhkcatprint::DeviceRegistry::find(BluetoothAddress address) const
+{
+	std::shared_lock<std::shared_mutex> lock(m_devicesMutex);
+
+	auto entry = m_devices.find(address);
+	return entry != m_devices.end() ? entry->second.device : nullptr;
+}
+
+std::shared_ptr<yhkcatprint::IDevice> yhkcatprint::DeviceRegistry::find(const std::string& address) const
+{
+	std::optional<BluetoothAddress> key = BluetoothAddress::parse(address);
+	return key ? find(*key) : nullptr;
+}
+
+std::vector<yhkcatprint::DEVICE_INFO> yhkcatprint::DeviceRegistry::devices() const
+{
+	std::shared_lock<std::shared_mutex> lock(m_devicesMutex);
+
+	std::vector<DEVICE_INFO> result;
+	result.reserve(m_devices.size());
+	for (const auto& entry : m_devices)
+	{
+		result.push_back(entry.second.info);
+	}
+	return result;
+}
+
+bool yhkcatprint::DeviceRegistry::refresh()
+{
+	std::lock_guard<std::mutex> refreshLock(m_refreshMutex);
+
+	// Enumeration goes through the system and can be slow; lookups keep using the old cache meanwhile.
+	std::vector<std::shared_ptr<IDevice>> paired = m_adapter->getPairedDevices();
+
+	std::unordered_map<BluetoothAddress, Entry> devices;
+	devices.reserve(paired.size());
+	for (auto& device : paired)
+	{
+		DEVICE_INFO info = device->getInfo();
+		if (info.bluetoothAddress.isNull())
+		{
+			continue;
+		}
+		BluetoothAddress address = info.bluetoothAddress;
+		devices[address] = { std::move(device), std::move(info) };
+	}
+
+	std::vector<DEVICE_INFO> added;
+	std::vector<DEVICE_INFO> removed;
+	bool populated;
+	{
+		std::unique_lock<std::shared_mutex> lock(m_devicesMutex);
+
+		for (auto& entry : devices)
+		{
+			auto known = m_devices.find(entry.first);
+			if (known == m_devices.end())
+			{
+				added.push_back(entry.second.info);
+			}
+			else
+			{
+				// Sessions may hold the old object; handing out the same one keeps lookups stable.
+				entry.second.device = known->second.device;
+			}
+		}
+		for (const auto& entry : m_devices)
+		{
+			if (devices.find(entry.first) == devices.end())
+			{
+				removed.push_back(entry.second.info);
+			}
+		}
+
+		m_devices.swap(devices);
+		populated = m_populated;
+		m_populated = true;
+	}
+
+	if (!populated)
+	{
+		return false;
+	}
+
+	std::shared_ptr<IEventListener> listener;
+	{
+		std::lock_guard<std::mutex> lock(m_watchMutex);
+		listener = m_listener;
+	}
+	if (listener != nullptr)
+	{
+		for (const DEVICE_INFO& info : removed)
+		{
+			listener->onDeviceDisconnected(info);
+		}
+		for (const DEVICE_INFO& info : added)
+		{
+			listener->onDeviceConnected(info);
+		}
+	}
+
+	return !added.empty() || !removed.empty();
+}
+
+void yhkcatprint::DeviceRegistry::startWatching(std::shared_ptr<IEventListener> listener, std::chrono::milliseconds interval)
+{
+	std::lock_guard<std::mutex> lock(m_watchMutex);
+
+	m_listener = std::move(listener);
+	m_interval = interval;
+	if (!m_watcher.joinable())
+	{
+		m_stopping = false;
+		m_watcher = std::thread(&DeviceRegistry::watch, this);
+	}
+	m_stopRequested.notify_all();
+}
+
+void yhkcatprint::DeviceRegistry::stopWatching()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_watchMutex);
+		m_stopping = true;
+		m_listener.reset();
+		m_stopRequested.notify_all();
+	}
+
+	if (m_watcher.joinable())
+	{
+		m_watcher.join();
+	}
+}
+
+void yhkcatprint::DeviceRegistry::watch()
+{
+	std::unique_lock<std::mutex> lock(m_watchMutex);
+	while (!m_stopping)
+	{
+		std::chrono::milliseconds interval = m_interval;
+		if (m_stopRequested.wait_for(lock, interval, [this, interval] { return m_stopping || m_interval != interval; }))
+		{
+			// Stopping, or a new interval that the next wait should use.
+			continue;
+		}
+
+		lock.unlock();
+		try
+		{
+			refresh();
+		}
+		catch (const std::exception& ex)
+		{
+			std::shared_ptr<IEventListener> listener;
+			{
+				std::lock_guard<std::mutex> listenerLock(m_watchMutex);
+				listener = m_listener;
+			}
+			if (listener != nullptr)
+			{
+				listener->onError({ -1, ex.what() });
+			}
+		}
+		lock.lock();
+	}
+}
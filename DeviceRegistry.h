@@ -0,0 +1,192 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	DeviceRegistry.h
+
+Abstract:
+	Cache of paired Bluetooth devices keyed by address.
+
+--*/
+
+#pragma once
+#include "BluetoothAddress.h"
+#include "IAdapter.h"
+#include "IDevice.h"
+#include "IEventListener.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file DeviceRegistry.h
+ * @brief Cache of paired Bluetooth devices keyed by address.
+ *
+ * This header defines DeviceRegistry, which keeps the paired-device list of
+ * an adapter in memory so that looking up a printer by address does not
+ * enumerate the paired devices through the system every time.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Cache of paired Bluetooth devices keyed by address.
+	 *
+	 * Devices are keyed by their BluetoothAddress, so find() is a hash lookup
+	 * under a shared lock and makes no system call. refresh() enumerates the
+	 * paired devices again and applies only the difference: devices that
+	 * are still paired keep their IDevice object, new ones are added and
+	 * unpaired ones removed.
+	 *
+	 * While watching, a background thread refreshes the cache periodically
+	 * and notifies the listener: onDeviceConnected when a device is paired,
+	 * onDeviceDisconnected when it is unpaired. The first enumeration only
+	 * fills the cache and raises no events; devices() returns its result.
+	 *
+	 * @note All public methods are thread-safe. Listener callbacks are
+	 *       invoked on the thread that ran the refresh.
+	 */
+	class DeviceRegistry
+	{
+	public:
+		/**
+		 * @brief Constructs a DeviceRegistry and enumerates the paired devices.
+		 *
+		 * An enumeration failure is logged and leaves the cache empty; the
+		 * next refresh tries again.
+		 *
+		 * @param adapter Adapter whose paired devices are cached.
+		 *
+		 * @throws std::invalid_argument if the adapter is nullptr.
+		 */
+		explicit DeviceRegistry(std::shared_ptr<IAdapter> adapter);
+
+		/**
+		 * @brief Destructor. Stops watching.
+		 */
+		~DeviceRegistry();
+
+		// Disable copy semantics
+		DeviceRegistry(const DeviceRegistry&) = delete;
+		DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+		/**
+		 * @brief Finds a cached device by address.
+		 *
+		 * @param address Bluetooth address.
+		 * @return Device, or nullptr if no paired device has this address.
+		 */
+		std::shared_ptr<IDevice> find(BluetoothAddress address) const;
+
+		/**
+		 * @brief Finds a cached device by address.
+		 *
+		 * @param address Bluetooth address in format "XX:XX:XX:XX:XX:XX", in either case.
+		 * @return Device, or nullptr if the address is malformed or no paired device has it.
+		 */
+		std::shared_ptr<IDevice> find(const std::string& address) const;
+
+		/**
+		 * @brief Returns the cached devices in no particular order.
+		 */
+		std::vector<DEVICE_INFO> devices() const;
+
+		/**
+		 * @brief Enumerates the paired devices and updates the cache.
+		 *
+		 * @return true if devices were paired or unpaired since the last refresh.
+		 *
+		 * @throws std::runtime_error if the paired devices cannot be enumerated; the cache is kept.
+		 */
+		bool refresh();
+
+		/**
+		 * @brief Starts refreshing the cache in the background.
+		 *
+		 * Calling it again replaces the listener and interval.
+		 *
+		 * @param listener Listener notified of paired and unpaired devices, may be nullptr.
+		 * @param interval Time between refreshes.
+		 */
+		void startWatching(std::shared_ptr<IEventListener> listener, std::chrono::milliseconds interval);
+
+		/**
+		 * @brief Stops the background refresh and joins its thread.
+		 */
+		void stopWatching();
+
+	private:
+		/**
+		 * @brief Cached device.
+		 */
+		struct Entry
+		{
+			/**
+			 * @brief Device object handed out by find().
+			 */
+			std::shared_ptr<IDevice> device;
+			/**
+			 * @brief Device information as last enumerated.
+			 */
+			DEVICE_INFO info;
+		};
+
+		/**
+		 * @brief Refreshes the cache until stopWatching() is called.
+		 */
+		void watch();
+
+		/**
+		 * @brief Adapter whose paired devices are cached.
+		 */
+		std::shared_ptr<IAdapter> m_adapter;
+		/**
+		 * @brief Cached devices by address.
+		 */
+		std::unordered_map<BluetoothAddress, Entry> m_devices;
+		/**
+		 * @brief Whether the cache holds the result of an enumeration.
+		 */
+		bool m_populated;
+		/**
+		 * @brief Guards m_devices and m_populated; find() takes it shared.
+		 */
+		mutable std::shared_mutex m_devicesMutex;
+		/**
+		 * @brief Serializes refreshes, which run without holding m_devicesMutex.
+		 */
+		std::mutex m_refreshMutex;
+		/**
+		 * @brief Listener notified of paired and unpaired devices.
+		 */
+		std::shared_ptr<IEventListener> m_listener;
+		/**
+		 * @brief Time between background refreshes.
+		 */
+		std::chrono::milliseconds m_interval;
+		/**
+		 * @brief Whether the background thread should stop.
+		 */
+		bool m_stopping;
+		/**
+		 * @brief Guards m_listener, m_interval and m_stopping.
+		 */
+		std::mutex m_watchMutex;
+		/**
+		 * @brief Signalled when the background thread should stop.
+		 */
+		std::condition_variable m_stopRequested;
+		/**
+		 * @brief Background refresh thread.
+		 */
+		std::thread m_watcher;
+	};
+}
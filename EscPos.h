@@ -0,0 +1,282 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	EscPos.h
+
+Abstract:
+	Compile-time builders for the printer's ESC/POS commands.
+
+--*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @file EscPos.h
+ * @brief Compile-time builders for the printer's ESC/POS commands.
+ *
+ * This header defines the commands the printer understands as constexpr
+ * functions that return fixed-size byte arrays. Commands with constant
+ * arguments are built by the compiler, and concat() folds a sequence of
+ * them into one array, so a handshake or a job prologue is a single
+ * static buffer with no construction at run time.
+ *
+ * It also defines the layout of the status reply, which the printer sends
+ * in answer to getStatus() and, unprompted, whenever its condition changes.
+ * Only the reply's size is known for certain; the offsets and bits below
+ * are inferred and have not been checked against real printers, see
+ * STATUS_LAYOUT_VERIFIED.
+ */
+
+namespace yhkcatprint::escpos
+{
+	/**
+	 * @brief Encoded command of N bytes.
+	 */
+	template<size_t N>
+	using Command = std::array<uint8_t, N>;
+
+	/**
+	 * @brief Line feed (LF); the printer ends a job after the raster with line feeds.
+	 */
+	inline constexpr Command<1> LINE_FEED = { 0x0a };
+
+	/**
+	 * @brief Prefix of the ESC J command that feeds paper by dot rows.
+	 */
+	inline constexpr Command<2> FEED_DOTS = { 0x1b, 0x4a };
+
+	/**
+	 * @brief Prefix of the GS v 0 command that prints a raster image.
+	 */
+	inline constexpr Command<3> RASTER_IMAGE = { 0x1d, 0x76, 0x30 };
+
+	/**
+	 * @brief Size of the GS v 0 header that precedes the raster rows.
+	 */
+	inline constexpr size_t RASTER_HEADER_SIZE = 8;
+
+	/**
+	 * @brief Most bytes per row or rows in one GS v 0 image.
+	 */
+	inline constexpr size_t MAX_RASTER_DIMENSION = 0xffff;
+
+	/**
+	 * @brief Size of the status reply.
+	 */
+	inline constexpr size_t STATUS_SIZE = 38;
+
+	/**
+	 * @brief Whether the status fields below have been verified against real printers.
+	 *
+	 * Decoded status carries this as PRINTER_STATUS::valid. Until it is set,
+	 * nothing may route, pause or report a printer's state as fact on the
+	 * strength of these fields.
+	 */
+	inline constexpr bool STATUS_LAYOUT_VERIFIED = false;
+
+	/**
+	 * @brief Offset of the condition byte in the status reply; zero means ready to print. Unverified.
+	 */
+	inline constexpr size_t STATUS_CONDITION = 0;
+
+	/**
+	 * @brief Condition bit: the paper roll is empty; the head stops until it is replaced.
+	 */
+	inline constexpr uint8_t CONDITION_PAPER_OUT = 0x01;
+
+	/**
+	 * @brief Condition bit: the print head is too hot; the head stops until it has cooled down.
+	 */
+	inline constexpr uint8_t CONDITION_OVERHEATED = 0x02;
+
+	/**
+	 * @brief Condition bit: the receive buffer has passed its high-water mark.
+	 *
+	 * The printer reports the bit set when its buffer fills past the mark
+	 * and cleared once it has drained below the low-water mark, so that the
+	 * host stops sending before the buffer overflows.
+	 */
+	inline constexpr uint8_t CONDITION_BUFFER_FULL = 0x04;
+
+	/**
+	 * @brief Condition bits that stop the print head.
+	 */
+	inline constexpr uint8_t CONDITION_HEAD_STOPPED = CONDITION_PAPER_OUT | CONDITION_OVERHEATED;
+
+	/**
+	 * @brief Condition bit: the paper roll is running low; printing goes on.
+	 */
+	inline constexpr uint8_t CONDITION_PAPER_LOW = 0x08;
+
+	/**
+	 * @brief Offset of the print head temperature in the status reply, in degrees Celsius as a signed byte. Unverified.
+	 */
+	inline constexpr size_t STATUS_TEMPERATURE = 1;
+
+	/**
+	 * @brief Offset of the battery byte in the status reply.
+	 *
+	 * The low seven bits are assumed to hold the charge in percent and the
+	 * high bit to be set while the printer is charging. Unverified.
+	 */
+	inline constexpr size_t STATUS_BATTERY = 2;
+
+	/**
+	 * @brief Battery bit assumed to be set while the printer is charging. Unverified.
+	 */
+	inline constexpr uint8_t BATTERY_CHARGING = 0x80;
+
+	/**
+	 * @brief Offset of the firmware major version in the status reply. Unverified.
+	 */
+	inline constexpr size_t STATUS_FIRMWARE_MAJOR = 3;
+
+	/**
+	 * @brief Offset of the firmware minor version in the status reply. Unverified.
+	 */
+	inline constexpr size_t STATUS_FIRMWARE_MINOR = 4;
+
+	/**
+	 * @brief Size of the serial number reply: the serial number in ASCII, padded with NUL bytes.
+	 */
+	inline constexpr size_t SERIAL_SIZE = 21;
+
+	/**
+	 * @brief Concatenates commands into one array.
+	 *
+	 * @param commands Commands in sending order.
+	 * @return Bytes of all commands.
+	 */
+	template<size_t... N>
+	constexpr Command<(N + ...)> concat(const Command<N>&... commands) noexcept
+	{
+		Command<(N + ...)> result{};
+		size_t position = 0;
+		auto append = [&](const auto& command)
+			{
+				for (uint8_t byte : command)
+				{
+					result[position++] = byte;
+				}
+			};
+		(append(commands), ...);
+		return result;
+	}
+
+	/**
+	 * @brief ESC @: resets the printer to its default settings.
+	 */
+	constexpr Command<2> initialize() noexcept
+	{
+		return { 0x1b, 0x40 };
+	}
+
+	/**
+	 * @brief Requests the status reply.
+	 */
+	constexpr Command<3> getStatus() noexcept
+	{
+		return { 0x1e, 0x47, 0x03 };
+	}
+
+	/**
+	 * @brief Requests the serial number reply.
+	 */
+	constexpr Command<3> getSerial() noexcept
+	{
+		return { 0x1d, 0x67, 0x39 };
+	}
+
+	/**
+	 * @brief Starts a job; the printer takes the following bytes as raw raster rows.
+	 */
+	constexpr Command<4> startPrint() noexcept
+	{
+		return { 0x1d, 0x49, 0xf0, 0x19 };
+	}
+
+	/**
+	 * @brief Feeds paper by N lines.
+	 */
+	template<size_t N>
+	constexpr Command<N> feedLines() noexcept
+	{
+		static_assert(N > 0, "Feed at least one line");
+		Command<N> result{};
+		result.fill(LINE_FEED[0]);
+		return result;
+	}
+
+	/**
+	 * @brief ESC J n: feeds paper by dot rows.
+	 *
+	 * @param dots Dot rows to feed.
+	 */
+	constexpr Command<3> feedDots(uint8_t dots) noexcept
+	{
+		return concat(FEED_DOTS, Command<1>{ dots });
+	}
+
+	/**
+	 * @brief GS ( K: selects the print density.
+	 *
+	 * @param level Density relative to the printer's default, from -6 (lightest) to 6 (darkest).
+	 *
+	 * @throws std::invalid_argument if the level is out of range.
+	 */
+	constexpr Command<7> setDensity(int level)
+	{
+		if (level < -6 || level > 6)
+		{
+			throw std::invalid_argument("Print density must be between -6 and 6");
+		}
+		return { 0x1d, 0x28, 0x4b, 0x02, 0x00, 0x31, static_cast<uint8_t>(level) };
+	}
+
+	/**
+	 * @brief GS v 0 header of a raster image in normal size.
+	 *
+	 * The header is followed by widthBytes * height bytes of rows, most
+	 * significant bit leftmost.
+	 *
+	 * @param widthBytes Bytes per row.
+	 * @param height Rows.
+	 *
+	 * @throws std::invalid_argument if either dimension exceeds MAX_RASTER_DIMENSION.
+	 */
+	constexpr Command<RASTER_HEADER_SIZE> rasterHeader(size_t widthBytes, size_t height)
+	{
+		if (widthBytes > MAX_RASTER_DIMENSION || height > MAX_RASTER_DIMENSION)
+		{
+			throw std::invalid_argument("Raster image is too large");
+		}
+		return concat(RASTER_IMAGE, Command<5>{
+			0x00,
+			static_cast<uint8_t>(widthBytes), static_cast<uint8_t>(widthBytes >> 8),
+			static_cast<uint8_t>(height), static_cast<uint8_t>(height >> 8) });
+	}
+
+	/**
+	 * @brief Opens a link: resets the printer and requests the status reply in one frame.
+	 */
+	inline constexpr auto HANDSHAKE = concat(initialize(), getStatus());
+
+	/**
+	 * @brief Ends a raw raster job, feeding the printed rows past the tear bar.
+	 *
+	 * Fixed rather than computed from the blank rows: the printer reads the
+	 * bytes after startPrint() as raster until it sees this trailer, so a
+	 * longer run of line feeds is not known to be taken as a feed.
+	 */
+	inline constexpr auto END_PRINT = feedLines<4>();
+
+	static_assert(HANDSHAKE == Command<5>{ 0x1b, 0x40, 0x1e, 0x47, 0x03 });
+	static_assert(rasterHeader(48, 0x1234) == Command<8>{ 0x1d, 0x76, 0x30, 0x00, 0x30, 0x00, 0x34, 0x12 });
+	static_assert(setDensity(-1)[6] == 0xff);
+}
@@ -0,0 +1,441 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	FlowControl.cpp
+
+Abstract:
+	Implementation of FlowControl methods.
+
+--*/
+
+#include "FlowControl.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	namespace escpos = yhkcatprint::escpos;
+
+	// Vectored sends cut short by the printer's buffer keep at most this many buffers.
+	const size_t maxParts = 8;
+	// Growth of a learned print speed each time sending waits on it during slow start.
+	const double slowStartGain = 1.189207115002721;
+	// Growth of a learned print speed per second of paced sending, once past slow start.
+	const double probeGain = 0.125;
+	// Keeps a speed that a silent printer never corrects from growing without bound.
+	const double maxDrainRate = 1e9;
+
+	std::string describeCondition(uint8_t condition)
+	{
+		if (condition & escpos::CONDITION_PAPER_OUT)
+		{
+			return "out of paper";
+		}
+		if (condition & escpos::CONDITION_OVERHEATED)
+		{
+			return "overheated";
+		}
+		return "buffer full";
+	}
+}
+
+yhkcatprint::FlowControl::FlowControl(FLOW_CONTROL_CONFIG config)
+	: m_config(config), m_socket(nullptr), m_readsSocket(false), m_closed(false), m_frame{}, m_frameSize(0), m_condition(0), m_buffered(0.0), m_cycleBytes(0.0), m_slowStart(config.drainRate <= 0.0)
+{
+	if (m_config.printerBuffer == 0)
+	{
+		throw std::invalid_argument("Printer buffer size must be greater than zero");
+	}
+	if (!(m_config.lowWater >= 0.0 && m_config.lowWater < m_config.highWater && m_config.highWater < 1.0))
+	{
+		throw std::invalid_argument("Water marks must satisfy 0 <= low < high < 1");
+	}
+	if (!(m_config.initialDrainRate >= 0.0))
+	{
+		throw std::invalid_argument("Initial print speed must not be negative");
+	}
+
+	m_stats.drainRate = m_config.drainRate > 0.0 ? m_config.drainRate : m_config.initialDrainRate;
+}
+
+void yhkcatprint::FlowControl::attach(IRfcommSocket& socket, bool readsSocket, const uint8_t* status)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_socket = &socket;
+	m_readsSocket = readsSocket;
+	m_closed = false;
+	m_frameSize = 0;
+	m_condition = 0;
+	m_buffered = 0.0;
+	m_drainedAt = Clock::now();
+	m_fullSince = Clock::time_point();
+	m_cycleStart = Clock::time_point();
+	m_cycleBytes = 0.0;
+	m_probedAt = m_drainedAt;
+	applyCondition(status != nullptr ? status[escpos::STATUS_CONDITION] : 0, m_drainedAt);
+}
+
+void yhkcatprint::FlowControl::detach() noexcept
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_socket = nullptr;
+	m_frameSize = 0;
+}
+
+void yhkcatprint::FlowControl::setReadsSocket(bool readsSocket)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_readsSocket = readsSocket;
+	// A frame started by one reader is not finished by the other.
+	m_frameSize = 0;
+}
+
+void yhkcatprint::FlowControl::setStatusCallback(StatusCallback callback)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statusCallback = std::move(callback);
+}
+
+size_t yhkcatprint::FlowControl::send(const uint8_t* data, size_t size)
+{
+	if (!m_config.enabled)
+	{
+		return m_socket->send(data, size);
+	}
+
+	size_t sent = m_socket->send(data, admit(size));
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	drain(Clock::now());
+	m_buffered += static_cast<double>(sent);
+	m_cycleBytes += static_cast<double>(sent);
+	return sent;
+}
+
+size_t yhkcatprint::FlowControl::send(std::span<const std::span<const uint8_t>> buffers)
+{
+	if (!m_config.enabled)
+	{
+		return m_socket->send(buffers);
+	}
+
+	size_t total = 0;
+	for (const auto& buffer : buffers)
+	{
+		total += buffer.size();
+	}
+
+	size_t allowed = admit(total);
+	size_t sent;
+	if (allowed == total)
+	{
+		sent = m_socket->send(buffers);
+	}
+	else
+	{
+		// Only the leading buffers that fit go out, the last of them possibly cut short.
+		std::span<const uint8_t> parts[maxParts];
+		size_t count = 0;
+		for (const auto& buffer : buffers)
+		{
+			if (allowed == 0 || count == maxParts)
+			{
+				break;
+			}
+			size_t part = std::min(buffer.size(), allowed);
+			parts[count++] = buffer.first(part);
+			allowed -= part;
+		}
+		sent = m_socket->send(std::span<const std::span<const uint8_t>>(parts, count));
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	drain(Clock::now());
+	m_buffered += static_cast<double>(sent);
+	m_cycleBytes += static_cast<double>(sent);
+	return sent;
+}
+
+void yhkcatprint::FlowControl::onReceived(const uint8_t* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	parse(data, size, Clock::now());
+}
+
+void yhkcatprint::FlowControl::onClosed()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closed = true;
+	}
+	m_statusChanged.notify_all();
+}
+
+yhkcatprint::FLOW_STATS yhkcatprint::FlowControl::stats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+size_t yhkcatprint::FlowControl::admit(size_t size)
+{
+	poll();
+
+	const double buffer = static_cast<double>(m_config.printerBuffer);
+	// Paced sends keep the buffer halfway between the marks: far enough from
+	// the high one that estimation errors do not trip it, with enough queued
+	// that the head does not run dry.
+	const double target = buffer * (m_config.lowWater + m_config.highWater) / 2.0;
+	const double step = buffer * (m_config.highWater - m_config.lowWater) / 4.0;
+	// Without a print speed, each piece fits above the high-water mark, so one send cannot overflow the buffer.
+	const size_t headroom = std::max<size_t>(1, static_cast<size_t>(buffer * (1.0 - m_config.highWater)));
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	const Clock::time_point start = Clock::now();
+	const Clock::time_point deadline = start + m_config.resumeTimeout;
+	bool waited = false;
+	size_t allowed = 0;
+
+	while (true)
+	{
+		if (m_closed)
+		{
+			throw std::runtime_error("Connection closed while waiting for the printer");
+		}
+
+		Clock::time_point now = Clock::now();
+		drain(now);
+
+		if (m_config.pauseOnStatus && (m_condition & (escpos::CONDITION_HEAD_STOPPED | escpos::CONDITION_BUFFER_FULL)))
+		{
+			if (now >= deadline)
+			{
+				throw std::runtime_error("Printer did not recover in time: " + describeCondition(m_condition));
+			}
+			waited = true;
+			waitForStatus(lock, deadline);
+			continue;
+		}
+
+		if (m_stats.drainRate <= 0.0)
+		{
+			// Only a status the printer is trusted to report can teach a speed; until one is known, pieces
+			// small enough to check it in between are worth their cost only if a report can come.
+			allowed = m_config.pauseOnStatus ? std::min(size, headroom) : size;
+			break;
+		}
+
+		double space = target - m_buffered;
+		double wanted = std::min(static_cast<double>(size), step);
+		if (space >= wanted)
+		{
+			allowed = std::min(size, static_cast<size_t>(space));
+			break;
+		}
+
+		if (now >= deadline)
+		{
+			throw std::runtime_error("Printer did not recover in time: buffer not drained");
+		}
+		if (!waited)
+		{
+			m_stats.throttles++;
+			// A learned speed is probed upwards; the printer reporting its buffer full brings it back down.
+			if (m_config.drainRate <= 0.0)
+			{
+				// Slow start doubles the speed for every span between the marks sent, that is every four waits.
+				double growth = m_slowStart ? slowStartGain : 1.0 + probeGain * std::min(std::chrono::duration<double>(now - m_probedAt).count(), 1.0);
+				m_stats.drainRate = std::min(m_stats.drainRate * growth, maxDrainRate);
+				m_probedAt = now;
+			}
+		}
+		waited = true;
+
+		// Sleeps until the estimate has room, unless a status frame comes first.
+		auto until = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((wanted - space) / m_stats.drainRate));
+		waitForStatus(lock, std::min(until, deadline));
+	}
+
+	if (waited)
+	{
+		m_stats.waited += Clock::now() - start;
+	}
+	return allowed;
+}
+
+void yhkcatprint::FlowControl::waitForStatus(std::unique_lock<std::mutex>& lock, Clock::time_point until)
+{
+	if (!m_readsSocket || m_socket == nullptr)
+	{
+		m_statusChanged.wait_until(lock, until);
+		return;
+	}
+
+	// The socket is read without the lock, so onReceived() and stats() are not held up.
+	IRfcommSocket& socket = *m_socket;
+	lock.unlock();
+
+	uint8_t received[escpos::STATUS_SIZE];
+	size_t count = 0;
+	bool closed = false;
+	Clock::time_point now = Clock::now();
+	if (until > now)
+	{
+		try
+		{
+			count = socket.receive(received, sizeof(received), until - now);
+			closed = count == 0;
+		}
+		catch (const std::exception&)
+		{
+			// A timed receive also throws when nothing arrives; only an early failure is a broken link.
+			if (Clock::now() < until)
+			{
+				throw;
+			}
+		}
+	}
+
+	lock.lock();
+	if (closed)
+	{
+		m_closed = true;
+	}
+	parse(received, count, Clock::now());
+}
+
+void yhkcatprint::FlowControl::poll()
+{
+	IRfcommSocket* socket;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_readsSocket || m_socket == nullptr)
+		{
+			return;
+		}
+		socket = m_socket;
+	}
+
+	uint8_t received[escpos::STATUS_SIZE];
+	while (socket->available())
+	{
+		size_t count = socket->receive(received, sizeof(received));
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (count == 0)
+		{
+			m_closed = true;
+			return;
+		}
+		parse(received, count, Clock::now());
+	}
+}
+
+void yhkcatprint::FlowControl::parse(const uint8_t* data, size_t size, Clock::time_point now)
+{
+	bool changed = false;
+	while (size > 0)
+	{
+		size_t part = std::min(size, escpos::STATUS_SIZE - m_frameSize);
+		std::copy(data, data + part, m_frame + m_frameSize);
+		m_frameSize += part;
+		data += part;
+		size -= part;
+
+		if (m_frameSize == escpos::STATUS_SIZE)
+		{
+			applyCondition(m_frame[escpos::STATUS_CONDITION], now);
+			if (m_statusCallback)
+			{
+				m_statusCallback(std::span<const uint8_t>(m_frame, escpos::STATUS_SIZE));
+			}
+			m_frameSize = 0;
+			changed = true;
+		}
+	}
+
+	if (changed)
+	{
+		m_statusChanged.notify_all();
+	}
+}
+
+void yhkcatprint::FlowControl::applyCondition(uint8_t condition, Clock::time_point now)
+{
+	// Settled first, so that time the head spent stopped is not counted as draining.
+	drain(now);
+
+	const double buffer = static_cast<double>(m_config.printerBuffer);
+	const uint8_t previous = m_condition;
+	const bool wasFull = (previous & escpos::CONDITION_BUFFER_FULL) != 0;
+	const bool isFull = (condition & escpos::CONDITION_BUFFER_FULL) != 0;
+
+	m_condition = condition;
+	m_stats.condition = condition;
+
+	if ((condition & escpos::CONDITION_HEAD_STOPPED) && !(previous & escpos::CONDITION_HEAD_STOPPED))
+	{
+		m_stats.pauses++;
+	}
+	if (isFull && !wasFull)
+	{
+		m_stats.bufferFull++;
+	}
+
+	// The condition byte comes from an unverified status layout; unless told to trust
+	// it, it is counted but neither fills the estimate nor teaches the print speed.
+	if (!m_config.pauseOnStatus)
+	{
+		return;
+	}
+
+	if ((condition & escpos::CONDITION_HEAD_STOPPED) && !(previous & escpos::CONDITION_HEAD_STOPPED))
+	{
+		// The speed is only measured over spans the head ran throughout.
+		m_fullSince = Clock::time_point();
+		m_cycleStart = Clock::time_point();
+	}
+
+	if (isFull && !wasFull)
+	{
+		m_fullSince = now;
+		m_slowStart = false;
+		m_buffered = std::max(m_buffered, buffer * m_config.highWater);
+	}
+	else if (!isFull && wasFull)
+	{
+		if (m_config.drainRate <= 0.0 && m_cycleStart != Clock::time_point() && now > m_cycleStart)
+		{
+			// The buffer is at the low-water mark again, so all sent since it last was has been printed.
+			double seconds = std::chrono::duration<double>(now - m_cycleStart).count();
+			m_stats.drainRate = (m_stats.drainRate + m_cycleBytes / seconds) / 2.0;
+		}
+		else if (m_config.drainRate <= 0.0 && m_fullSince != Clock::time_point() && now > m_fullSince)
+		{
+			// The printer reports the marks only roughly, so this first speed is a cautious one and replaces the one slow start overshot.
+			double seconds = std::chrono::duration<double>(now - m_fullSince).count();
+			m_stats.drainRate = buffer * (m_config.highWater - m_config.lowWater) / seconds;
+		}
+		m_buffered = std::min(m_buffered, buffer * m_config.lowWater);
+		m_fullSince = Clock::time_point();
+		m_cycleStart = now;
+		m_cycleBytes = 0.0;
+		m_probedAt = now;
+	}
+}
+
+void yhkcatprint::FlowControl::drain(Clock::time_point now)
+{
+	// Unless status is trusted, a reported stop does not hold the estimate, which would hold the sends.
+	const bool stopped = m_config.pauseOnStatus && (m_condition & escpos::CONDITION_HEAD_STOPPED);
+	if (!stopped && m_stats.drainRate > 0.0)
+	{
+		double seconds = std::chrono::duration<double>(now - m_drainedAt).count();
+		m_buffered = std::max(0.0, m_buffered - m_stats.drainRate * seconds);
+	}
+	m_drainedAt = now;
+}
@@ -0,0 +1,358 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	FlowControl.h
+
+Abstract:
+	Status-driven pacing of the data sent to a printer.
+
+--*/
+
+#pragma once
+#include "EscPos.h"
+#include "IRfcommSocket.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+
+/**
+ * @file FlowControl.h
+ * @brief Status-driven pacing of the data sent to a printer.
+ *
+ * This header defines FlowControl, which stands between a BufferedWriter
+ * and the socket and holds data back while the printer cannot take it:
+ * once its print speed is known, whenever sending more would overfill its
+ * buffer, and, if status is trusted, while its status reports the buffer
+ * full or the printer out of paper or overheated.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Flow control configuration.
+	 */
+	typedef struct _FLOW_CONTROL_CONFIG
+	{
+		/**
+		 * @brief Whether sends are paced at all; when false they go straight to the socket.
+		 */
+		bool enabled = true;
+		/**
+		 * @brief Whether status frames drive pacing: sending stops while they report the buffer full or the head stopped, and they teach the print speed.
+		 *
+		 * Off by default: the layout of the status reply is not verified
+		 * against real printers, and a misread condition byte would hold
+		 * every job until resumeTimeout or skew the learned speed. Without
+		 * it, status frames are only counted, and sends are paced only at a
+		 * configured drainRate or initialDrainRate.
+		 */
+		bool pauseOnStatus = false;
+		/**
+		 * @brief Receive buffer of the printer in bytes.
+		 */
+		size_t printerBuffer = 4096;
+		/**
+		 * @brief Fill level, as a fraction of the buffer, at which the printer reports its buffer full.
+		 */
+		double highWater = 0.75;
+		/**
+		 * @brief Fill level, as a fraction of the buffer, at which the printer reports it can take data again.
+		 */
+		double lowWater = 0.25;
+		/**
+		 * @brief Bytes per second the printer prints, 0 to learn it from its buffer-full reports if pauseOnStatus is set.
+		 */
+		double drainRate = 0.0;
+		/**
+		 * @brief Print speed, in bytes per second, to start learning from, 0 to send unpaced until the printer first reports its buffer full.
+		 *
+		 * Set it for printers known to report their buffer, so that their first report does not come too late.
+		 */
+		double initialDrainRate = 0.0;
+		/**
+		 * @brief Longest wait for a printer that is out of paper, overheated or full.
+		 */
+		std::chrono::milliseconds resumeTimeout{ 120000 };
+	} FLOW_CONTROL_CONFIG;
+
+	/**
+	 * @brief Flow control statistics, counted since the FlowControl was constructed.
+	 */
+	typedef struct _FLOW_STATS
+	{
+		/**
+		 * @brief Times sending waited for the printer to drain its buffer.
+		 */
+		uint64_t throttles = 0;
+		/**
+		 * @brief Times the printer reported its buffer full.
+		 */
+		uint64_t bufferFull = 0;
+		/**
+		 * @brief Times the printer stopped for lack of paper or heat.
+		 */
+		uint64_t pauses = 0;
+		/**
+		 * @brief Total time sending was held back.
+		 */
+		std::chrono::nanoseconds waited{ 0 };
+		/**
+		 * @brief Bytes per second the printer is assumed to print, as configured or learned so far; 0 while unknown.
+		 */
+		double drainRate = 0.0;
+		/**
+		 * @brief Condition bits of the last status seen.
+		 */
+		uint8_t condition = 0;
+	} FLOW_STATS;
+
+	/**
+	 * @brief Status-driven pacing of the data sent to a printer.
+	 *
+	 * The printer reports its condition in status frames it sends unprompted
+	 * (see escpos::STATUS_CONDITION). FlowControl reads them either itself,
+	 * from the socket between sends, or from onReceived() when another thread
+	 * owns the reads, such as a SocketReactor.
+	 *
+	 * With pauseOnStatus set, sending stops while the printer reports its
+	 * buffer full or its head stopped, and continues from the same byte once
+	 * it recovers, so a job survives a paper change intact. Otherwise the
+	 * condition is only counted in the statistics: it neither holds data
+	 * back nor feeds the estimates below. Once a print speed is known,
+	 * FlowControl tracks how full the printer's buffer should be at that
+	 * speed and keeps it about halfway between the marks, so that the
+	 * printer neither overflows nor runs dry; without one, and without
+	 * trusted status, data goes out unpaced.
+	 *
+	 * With pauseOnStatus set and no speed configured, the speed is learned. Until the printer first
+	 * reports its buffer full, data goes out in pieces no larger than the
+	 * space above the high-water mark, with the status checked in between,
+	 * which costs nothing with printers that never report; given an initial
+	 * speed, it instead starts there and grows whenever sending waits on it,
+	 * the way TCP finds its window. The time the buffer then takes to drain
+	 * to the low-water mark gives a first, cautious speed. Each time
+	 * the printer reports its buffer drained again, the buffer is back at the
+	 * same mark, so everything sent since the previous such report has been
+	 * printed, which gives the speed without depending on how exactly the
+	 * printer tells the marks. In between, the speed slowly grows while the
+	 * printer does not complain, since one set too low would otherwise never
+	 * be corrected.
+	 *
+	 * Provides the send() overloads BufferedWriter needs, so it can stand in
+	 * for the socket.
+	 *
+	 * @note send() must be called from one thread at a time; onReceived() and
+	 *       onClosed() may be called from any thread.
+	 */
+	class FlowControl
+	{
+	public:
+		/**
+		 * @brief Callback taking a complete status frame.
+		 */
+		using StatusCallback = std::function<void(std::span<const uint8_t> frame)>;
+
+		/**
+		 * @brief Constructs a FlowControl not attached to any link.
+		 *
+		 * @param config Flow control configuration.
+		 *
+		 * @throws std::invalid_argument if the buffer is empty, the water marks are not 0 <= low < high < 1, or the initial print speed is negative.
+		 */
+		explicit FlowControl(FLOW_CONTROL_CONFIG config = {});
+
+		// Disable copy semantics
+		FlowControl(const FlowControl&) = delete;
+		FlowControl& operator=(const FlowControl&) = delete;
+
+		/**
+		 * @brief Starts pacing the sends on a new link.
+		 *
+		 * The printer's buffer is assumed empty and its condition is taken
+		 * from the status reply of the handshake. A learned print speed is
+		 * kept, since the link leads to the same printer.
+		 *
+		 * @param socket Connected socket; must stay valid until detach().
+		 * @param readsSocket true to read status frames from the socket, false if they come through onReceived().
+		 * @param status Status reply of the handshake, or nullptr if none was received.
+		 */
+		void attach(IRfcommSocket& socket, bool readsSocket, const uint8_t* status);
+
+		/**
+		 * @brief Stops using the socket passed to attach().
+		 */
+		void detach() noexcept;
+
+		/**
+		 * @brief Switches between reading status frames from the socket and receiving them through onReceived().
+		 */
+		void setReadsSocket(bool readsSocket);
+
+		/**
+		 * @brief Sets a callback for every status frame received after the handshake.
+		 *
+		 * The callback runs on the thread that received the frame, with the
+		 * flow control locked, so it must be quick and must not call back
+		 * into the FlowControl.
+		 *
+		 * @param callback Callback, or an empty function for none.
+		 */
+		void setStatusCallback(StatusCallback callback);
+
+		/**
+		 * @brief Sends data as far as the printer can take it, waiting first if it can take nothing.
+		 *
+		 * @param data Pointer to the data to send.
+		 * @param size Number of bytes to send.
+		 * @return Number of bytes sent.
+		 *
+		 * @pre attach() has been called.
+		 *
+		 * @throws std::runtime_error on failure to send, if the link closes, or if the printer does not recover within resumeTimeout.
+		 */
+		size_t send(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Sends several buffers as far as the printer can take them, waiting first if it can take nothing.
+		 *
+		 * @param buffers Buffers to send, in order.
+		 * @return Number of bytes sent, counted across all buffers.
+		 *
+		 * @pre attach() has been called.
+		 *
+		 * @throws std::runtime_error on failure to send, if the link closes, or if the printer does not recover within resumeTimeout.
+		 */
+		size_t send(std::span<const std::span<const uint8_t>> buffers);
+
+		/**
+		 * @brief Takes bytes the printer sent, which are parsed as status frames.
+		 *
+		 * @param data Pointer to the received data.
+		 * @param size Number of bytes received.
+		 */
+		void onReceived(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Takes note that the link has closed, failing any send waiting for the printer.
+		 */
+		void onClosed();
+
+		/**
+		 * @brief Returns the flow control statistics.
+		 */
+		FLOW_STATS stats() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Waits until the printer can take data and returns how many of size bytes it can take.
+		 */
+		size_t admit(size_t size);
+
+		/**
+		 * @brief Waits for a status frame or the link closing until the given time; m_mutex is held through lock.
+		 *
+		 * @throws std::runtime_error if reading the socket fails.
+		 */
+		void waitForStatus(std::unique_lock<std::mutex>& lock, Clock::time_point until);
+
+		/**
+		 * @brief Reads whatever the printer sent without blocking, if reading the socket.
+		 */
+		void poll();
+
+		/**
+		 * @brief Parses received bytes into status frames; m_mutex must be held.
+		 */
+		void parse(const uint8_t* data, size_t size, Clock::time_point now);
+
+		/**
+		 * @brief Applies the condition of a status frame; m_mutex must be held.
+		 */
+		void applyCondition(uint8_t condition, Clock::time_point now);
+
+		/**
+		 * @brief Brings the estimated fill of the printer's buffer up to date; m_mutex must be held.
+		 */
+		void drain(Clock::time_point now);
+
+		/**
+		 * @brief Configuration.
+		 */
+		const FLOW_CONTROL_CONFIG m_config;
+		/**
+		 * @brief Attached socket, or nullptr.
+		 */
+		IRfcommSocket* m_socket;
+		/**
+		 * @brief Whether status frames are read from the socket rather than passed to onReceived().
+		 */
+		bool m_readsSocket;
+		/**
+		 * @brief Whether the attached link has closed.
+		 */
+		bool m_closed;
+		/**
+		 * @brief Status frame being assembled from received bytes.
+		 */
+		uint8_t m_frame[escpos::STATUS_SIZE];
+		/**
+		 * @brief Bytes of m_frame received so far.
+		 */
+		size_t m_frameSize;
+		/**
+		 * @brief Condition bits of the last status frame.
+		 */
+		uint8_t m_condition;
+		/**
+		 * @brief Estimated bytes in the printer's buffer.
+		 */
+		double m_buffered;
+		/**
+		 * @brief When m_buffered was last brought up to date.
+		 */
+		Clock::time_point m_drainedAt;
+		/**
+		 * @brief When the printer reported its buffer full, if it has not reported it drained since.
+		 */
+		Clock::time_point m_fullSince;
+		/**
+		 * @brief When the printer last reported its buffer drained, if its head has run since.
+		 */
+		Clock::time_point m_cycleStart;
+		/**
+		 * @brief Bytes sent since m_cycleStart.
+		 */
+		double m_cycleBytes;
+		/**
+		 * @brief When the learned print speed was last probed upwards.
+		 */
+		Clock::time_point m_probedAt;
+		/**
+		 * @brief Whether the learned print speed still doubles, that is the printer has not yet reported its buffer full.
+		 */
+		bool m_slowStart;
+		/**
+		 * @brief Statistics, including the drain rate in use.
+		 */
+		FLOW_STATS m_stats;
+		/**
+		 * @brief Callback for complete status frames, possibly empty.
+		 */
+		StatusCallback m_statusCallback;
+		/**
+		 * @brief Guards all state above.
+		 */
+		mutable std::mutex m_mutex;
+		/**
+		 * @brief Signalled when a status frame arrives or the link closes.
+		 */
+		std::condition_variable m_statusChanged;
+	};
+}
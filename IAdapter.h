@@ -13,6 +13,7 @@ Abstract:
 #pragma once
 
 #include "IDevice.h"
+#include <memory>
 #include <vector>
 
 namespace yhkcatprint
@@ -30,6 +31,10 @@ namespace yhkcatprint
 		 * @brief Human-readable name of the adapter.
 		 */
 		std::string name;
+		/**
+		 * @brief Bluetooth address of the adapter.
+		 */
+		BluetoothAddress bluetoothAddress;
 	} ADAPTER_INFO;
 
 	/**
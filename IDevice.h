@@ -11,7 +11,9 @@ Abstract:
 --*/
 
 #pragma once
+#include <memory>
 #include <string>
+#include "BluetoothAddress.h"
 #include "IRfcommSocket.h"
 
 /**
@@ -30,13 +32,18 @@ namespace yhkcatprint
 	typedef struct _DEVICE_INFO
 	{
 		/**
-		 * @brief Bluetooth address of the device in format "XX:XX:XX:XX:XX:XX".
+		 * @brief Bluetooth address of the device in format "XX:XX:XX:XX:XX:XX",
+		 *        or the endpoint of a network or loopback device.
 		 */
 		std::string address;
 		/**
 		 * @brief Human-readable name of the device.
 		 */
 		std::string name;
+		/**
+		 * @brief Bluetooth address of the device, null for network and loopback devices.
+		 */
+		BluetoothAddress bluetoothAddress;
 	} DEVICE_INFO;
 
 	/**
@@ -42,6 +42,25 @@ namespace yhkcatprint
 		std::string message;
 	} ERROR_INFO;
 
+	/**
+	 * @brief Structure identifying a queued print job.
+	 */
+	typedef struct _JOB_INFO
+	{
+		/**
+		 * @brief Job handle returned when the job was submitted.
+		 */
+		uint64_t id;
+		/**
+		 * @brief Size of the job's raster data in bytes.
+		 */
+		size_t size;
+		/**
+		 * @brief Bytes the raster was encoded to for sending, 0 if it was not sent;
+		 *        size / sentBytes is the job's compression ratio.
+		 */
+		size_t sentBytes;
+	} JOB_INFO;
 
 	/**
 	 * @brief Abstract interface for receiving asynchronous events.
@@ -97,5 +116,20 @@ namespace yhkcatprint
 		 * @param ERROR_INFO Information about the error.
 		 */
 		virtual void onError(ERROR_INFO) = 0;
+
+		/**
+		 * @brief Called when a queued print job has been fully sent.
+		 * 
+		 * @param JOB_INFO Information about the completed job.
+		 */
+		virtual void onJobCompleted(const JOB_INFO&) = 0;
+
+		/**
+		 * @brief Called when a queued print job could not be sent.
+		 * 
+		 * @param JOB_INFO Information about the failed job.
+		 * @param ERROR_INFO Information about the error.
+		 */
+		virtual void onJobFailed(const JOB_INFO&, ERROR_INFO) = 0;
 	};
 }
\ No newline at end of file
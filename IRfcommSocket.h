@@ -12,6 +12,9 @@ Abstract:
 
 #pragma once
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
 
 /**
  * @file IRfcommSocket.h
@@ -36,6 +39,11 @@ namespace yhkcatprint
 	class IRfcommSocket
 	{
 	public:
+		/**
+		 * @brief Value of nativeHandle() for sockets that are not backed by an operating system socket.
+		 */
+		static constexpr intptr_t NO_NATIVE_HANDLE = -1;
+
 		/**
 		 * @brief Virtual destructor.
 		 */
@@ -79,6 +87,39 @@ namespace yhkcatprint
 		 */
 		virtual size_t send(const uint8_t* data, size_t size) = 0;
 
+		/**
+		 * @brief Sends data over the RFCOMM connection within a deadline.
+		 * 
+		 * Sends as much of the buffer as the connection accepts before the
+		 * timeout elapses.
+		 * 
+		 * @param data Pointer to the data buffer to send.
+		 * @param size Number of bytes to send from the buffer.
+		 * @param timeout Maximum duration to wait for the connection to accept data.
+		 * @return Number of bytes actually sent.
+		 * 
+		 * @pre The socket is connected.
+		 * 
+		 * @throws std::runtime_error on failure to send data or if no data could be sent before the timeout.
+		 */
+		virtual size_t send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout) = 0;
+
+		/**
+		 * @brief Sends several buffers over the RFCOMM connection in one operation.
+		 * 
+		 * The buffers are sent in order as one contiguous stream, without
+		 * copying them into a single allocation first. Like the single-buffer
+		 * overload, this may send fewer bytes than requested.
+		 * 
+		 * @param buffers Buffers to send, in order.
+		 * @return Number of bytes actually sent, counted across all buffers.
+		 * 
+		 * @pre The socket is connected.
+		 * 
+		 * @throws std::runtime_error on failure to send data.
+		 */
+		virtual size_t send(std::span<const std::span<const uint8_t>> buffers) = 0;
+
 		/**
 		 * @brief Receives data from the RFCOMM connection.
 		 * 
@@ -92,6 +133,20 @@ namespace yhkcatprint
 		 */
 		virtual size_t receive(uint8_t* buffer, size_t size) = 0;
 
+		/**
+		 * @brief Receives data from the RFCOMM connection within a deadline.
+		 * 
+		 * @param buffer Pointer to the buffer to store received data.
+		 * @param size Maximum number of bytes to receive.
+		 * @param timeout Maximum duration to wait for data to arrive.
+		 * @return Number of bytes actually received.
+		 * 
+		 * @pre The socket is connected.
+		 * 
+		 * @throws std::runtime_error on failure to receive data or if no data arrived before the timeout.
+		 */
+		virtual size_t receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) = 0;
+
 		/**
 		 * @brief Checks if data is available to read from the RFCOMM connection.
 		 * 
@@ -101,6 +156,29 @@ namespace yhkcatprint
 		 */
 		virtual bool available() = 0;
 
+		/**
+		 * @brief Returns the operating system socket, so that many connections can be waited on at once.
+		 * 
+		 * @return SOCKET on Windows or file descriptor elsewhere, or NO_NATIVE_HANDLE
+		 *         if the socket is not connected or not backed by one.
+		 */
+		virtual intptr_t nativeHandle() const = 0;
+
+		/**
+		 * @brief Sets a callback invoked whenever the socket becomes readable.
+		 * 
+		 * This is how sockets without a native handle are waited on. The
+		 * callback runs on the thread that delivered the data or closed the
+		 * connection, so it must be short and must not block.
+		 * 
+		 * @param callback Callback, or an empty function to remove it.
+		 * @return false if the socket does not support readiness callbacks and
+		 *         is waited on through nativeHandle() instead.
+		 * 
+		 * @throws std::runtime_error if the socket supports callbacks but is not connected.
+		 */
+		virtual bool setReadableCallback(std::function<void()> callback) = 0;
+
 		/**
 		 * @brief Closes the RFCOMM connection.
 		 * 
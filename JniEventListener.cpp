@@ -0,0 +1,224 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	JniEventListener.cpp
+
+Abstract:
+	Implementation of JniEventListener methods.
+
+--*/
+
+#include "JniEventListener.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+	/**
+	 * @brief Detaches a natively created thread from the JVM when it exits.
+	 */
+	struct ThreadDetacher
+	{
+		JavaVM* vm = nullptr;
+
+		~ThreadDetacher()
+		{
+			if (vm != nullptr)
+			{
+				vm->DetachCurrentThread();
+			}
+		}
+	};
+
+	thread_local ThreadDetacher threadDetacher;
+
+	void clearPendingException(JNIEnv* env)
+	{
+		if (env->ExceptionCheck())
+		{
+			env->ExceptionDescribe();
+			env->ExceptionClear();
+		}
+	}
+}
+
+yhkcatprint::JniEventListener::JniEventListener(JNIEnv* env, jobject listener)
+	: m_vm(nullptr), m_listener(nullptr), m_onJobCompleted(nullptr), m_onJobFailed(nullptr), m_onDeviceConnected(nullptr), m_onDeviceDisconnected(nullptr), m_onDataReceived(nullptr), m_onConnectionClosed(nullptr)
+{
+	if (env->GetJavaVM(&m_vm) != JNI_OK)
+	{
+		throw std::runtime_error("Failed to get Java VM");
+	}
+
+	// Each interface is optional; a failed lookup raises NoSuchMethodError, which is cleared.
+	jclass listenerClass = env->GetObjectClass(listener);
+	m_onJobCompleted = env->GetMethodID(listenerClass, "onJobCompleted", "(J)V");
+	env->ExceptionClear();
+	m_onJobFailed = env->GetMethodID(listenerClass, "onJobFailed", "(JILjava/lang/String;)V");
+	env->ExceptionClear();
+	m_onDeviceConnected = env->GetMethodID(listenerClass, "onDeviceConnected", "(Ljava/lang/String;Ljava/lang/String;)V");
+	env->ExceptionClear();
+	m_onDeviceDisconnected = env->GetMethodID(listenerClass, "onDeviceDisconnected", "(Ljava/lang/String;Ljava/lang/String;)V");
+	env->ExceptionClear();
+	m_onDataReceived = env->GetMethodID(listenerClass, "onDataReceived", "([B)V");
+	env->ExceptionClear();
+	m_onConnectionClosed = env->GetMethodID(listenerClass, "onConnectionClosed", "()V");
+	env->ExceptionClear();
+	env->DeleteLocalRef(listenerClass);
+
+	if (m_onJobCompleted == nullptr || m_onJobFailed == nullptr)
+	{
+		m_onJobCompleted = nullptr;
+		m_onJobFailed = nullptr;
+	}
+	if (m_onDeviceConnected == nullptr || m_onDeviceDisconnected == nullptr)
+	{
+		m_onDeviceConnected = nullptr;
+		m_onDeviceDisconnected = nullptr;
+	}
+	if (m_onDataReceived == nullptr || m_onConnectionClosed == nullptr)
+	{
+		m_onDataReceived = nullptr;
+		m_onConnectionClosed = nullptr;
+	}
+	if (m_onJobCompleted == nullptr && m_onDeviceConnected == nullptr && m_onDataReceived == nullptr)
+	{
+		throw std::runtime_error("Listener implements none of PrintListener, DeviceListener and SocketListener");
+	}
+
+	m_listener = env->NewGlobalRef(listener);
+}
+
+yhkcatprint::JniEventListener::~JniEventListener()
+{
+	JNIEnv* env = currentEnv(m_vm);
+	if (env != nullptr && m_listener != nullptr)
+	{
+		env->DeleteGlobalRef(m_listener);
+	}
+}
+
+void yhkcatprint::JniEventListener::onDeviceConnected(const DEVICE_INFO& info)
+{
+	if (m_onDeviceConnected == nullptr)
+	{
+		std::cout << "Device connected: " << info.name << " [" << info.address << "]" << std::endl;
+		return;
+	}
+
+	callDeviceMethod(m_onDeviceConnected, info);
+}
+
+void yhkcatprint::JniEventListener::onDeviceDisconnected(const DEVICE_INFO& info)
+{
+	if (m_onDeviceDisconnected == nullptr)
+	{
+		std::cout << "Device disconnected: " << info.name << " [" << info.address << "]" << std::endl;
+		return;
+	}
+
+	callDeviceMethod(m_onDeviceDisconnected, info);
+}
+
+void yhkcatprint::JniEventListener::onSocketDateReceived(const IRfcommSocket&, const uint8_t* data, size_t size)
+{
+	JNIEnv* env = currentEnv(m_vm);
+	if (env == nullptr || m_onDataReceived == nullptr)
+	{
+		return;
+	}
+
+	jbyteArray bytes = env->NewByteArray(static_cast<jsize>(size));
+	if (bytes == nullptr)
+	{
+		clearPendingException(env);
+		return;
+	}
+	env->SetByteArrayRegion(bytes, 0, static_cast<jsize>(size), reinterpret_cast<const jbyte*>(data));
+	env->CallVoidMethod(m_listener, m_onDataReceived, bytes);
+	clearPendingException(env);
+	env->DeleteLocalRef(bytes);
+}
+
+void yhkcatprint::JniEventListener::onSocketClosed(const IRfcommSocket&)
+{
+	JNIEnv* env = currentEnv(m_vm);
+	if (env == nullptr || m_onConnectionClosed == nullptr)
+	{
+		return;
+	}
+
+	env->CallVoidMethod(m_listener, m_onConnectionClosed);
+	clearPendingException(env);
+}
+
+void yhkcatprint::JniEventListener::onError(ERROR_INFO error)
+{
+	std::cerr << "Error " << error.code << ": " << error.message << std::endl;
+}
+
+void yhkcatprint::JniEventListener::onJobCompleted(const JOB_INFO& job)
+{
+	JNIEnv* env = currentEnv(m_vm);
+	if (env == nullptr || m_onJobCompleted == nullptr)
+	{
+		return;
+	}
+
+	env->CallVoidMethod(m_listener, m_onJobCompleted, static_cast<jlong>(job.id));
+	clearPendingException(env);
+}
+
+void yhkcatprint::JniEventListener::onJobFailed(const JOB_INFO& job, ERROR_INFO error)
+{
+	JNIEnv* env = currentEnv(m_vm);
+	if (env == nullptr || m_onJobFailed == nullptr)
+	{
+		return;
+	}
+
+	jstring message = env->NewStringUTF(error.message.c_str());
+	env->CallVoidMethod(m_listener, m_onJobFailed, static_cast<jlong>(job.id), static_cast<jint>(error.code), message);
+	clearPendingException(env);
+	env->DeleteLocalRef(message);
+}
+
+void yhkcatprint::JniEventListener::callDeviceMethod(jmethodID method, const DEVICE_INFO& info)
+{
+	JNIEnv* env = currentEnv(m_vm);
+	if (env == nullptr)
+	{
+		return;
+	}
+
+	jstring address = env->NewStringUTF(info.address.c_str());
+	jstring name = env->NewStringUTF(info.name.c_str());
+	env->CallVoidMethod(m_listener, method, address, name);
+	clearPendingException(env);
+	env->DeleteLocalRef(name);
+	env->DeleteLocalRef(address);
+}
+
+JNIEnv* yhkcatprint::JniEventListener::currentEnv(JavaVM* vm)
+{
+	JNIEnv* env = nullptr;
+	jint result = vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+
+	if (result == JNI_EDETACHED)
+	{
+		if (vm->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), nullptr) != JNI_OK)
+		{
+			std::cerr << "Failed to attach thread to Java VM." << std::endl;
+			return nullptr;
+		}
+		threadDetacher.vm = vm;
+	}
+	else if (result != JNI_OK)
+	{
+		return nullptr;
+	}
+
+	return env;
+}
@@ -0,0 +1,124 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	JniEventListener.h
+
+Abstract:
+	IEventListener forwarding events to a Java listener object.
+
+--*/
+
+#pragma once
+#include <jni.h>
+#include "IEventListener.h"
+
+/**
+ * @file JniEventListener.h
+ * @brief IEventListener forwarding events to a Java listener object.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief IEventListener forwarding events to a Java listener object.
+	 *
+	 * The Java object must implement at least one of
+	 * pl.umamusume.yhkcatprint.utils.PrintListener,
+	 * pl.umamusume.yhkcatprint.utils.DeviceListener and
+	 * pl.umamusume.yhkcatprint.utils.SocketListener:
+	 * @code
+	 * void onJobCompleted(long jobId);
+	 * void onJobFailed(long jobId, int code, String message);
+	 * void onDeviceConnected(String address, String name);
+	 * void onDeviceDisconnected(String address, String name);
+	 * void onDataReceived(byte[] data);
+	 * void onConnectionClosed();
+	 * @endcode
+	 *
+	 * Native threads calling into the listener are attached to the JVM on
+	 * first use and detached when they exit. Events without a Java
+	 * counterpart are only logged.
+	 */
+	class JniEventListener : public IEventListener
+	{
+	public:
+		/**
+		 * @brief Constructs a JniEventListener.
+		 *
+		 * @param env JNI environment of the calling thread.
+		 * @param listener Java listener object; a global reference is kept.
+		 *
+		 * @throws std::runtime_error if the listener implements none of PrintListener, DeviceListener and SocketListener.
+		 */
+		JniEventListener(JNIEnv* env, jobject listener);
+
+		/**
+		 * @brief Destructor. Releases the global reference to the listener.
+		 */
+		virtual ~JniEventListener();
+
+		// Disable copy semantics
+		JniEventListener(const JniEventListener&) = delete;
+		JniEventListener& operator=(const JniEventListener&) = delete;
+
+		void onDeviceConnected(const DEVICE_INFO&) override;
+		void onDeviceDisconnected(const DEVICE_INFO&) override;
+		void onSocketDateReceived(const IRfcommSocket&, const uint8_t* data, size_t size) override;
+		void onSocketClosed(const IRfcommSocket&) override;
+		void onError(ERROR_INFO) override;
+		void onJobCompleted(const JOB_INFO&) override;
+		void onJobFailed(const JOB_INFO&, ERROR_INFO) override;
+
+		/**
+		 * @brief Returns the JNI environment of the calling thread.
+		 *
+		 * Attaches the thread to the JVM if needed. Threads attached here are
+		 * detached automatically when they exit.
+		 *
+		 * @param vm Java virtual machine.
+		 * @return JNI environment, or nullptr if the thread could not be attached.
+		 */
+		static JNIEnv* currentEnv(JavaVM* vm);
+
+	private:
+		/**
+		 * @brief Calls a DeviceListener method with the device address and name.
+		 */
+		void callDeviceMethod(jmethodID method, const DEVICE_INFO& info);
+
+		/**
+		 * @brief Java virtual machine the listener belongs to.
+		 */
+		JavaVM* m_vm;
+		/**
+		 * @brief Global reference to the Java listener.
+		 */
+		jobject m_listener;
+		/**
+		 * @brief PrintListener.onJobCompleted(long).
+		 */
+		jmethodID m_onJobCompleted;
+		/**
+		 * @brief PrintListener.onJobFailed(long, int, String).
+		 */
+		jmethodID m_onJobFailed;
+		/**
+		 * @brief DeviceListener.onDeviceConnected(String, String), or nullptr.
+		 */
+		jmethodID m_onDeviceConnected;
+		/**
+		 * @brief DeviceListener.onDeviceDisconnected(String, String), or nullptr.
+		 */
+		jmethodID m_onDeviceDisconnected;
+		/**
+		 * @brief SocketListener.onDataReceived(byte[]), or nullptr.
+		 */
+		jmethodID m_onDataReceived;
+		/**
+		 * @brief SocketListener.onConnectionClosed(), or nullptr.
+		 */
+		jmethodID m_onConnectionClosed;
+	};
+}
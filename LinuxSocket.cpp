@@ -0,0 +1,396 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LinuxSocket.cpp
+
+Abstract:
+	Implementation of LinuxSocket methods.
+
+--*/
+
+#include "LinuxSocket.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+
+yhkcatprint::LinuxSocket::LinuxSocket(int domain, int type, int protocol)
+	: m_domain(domain), m_type(type), m_protocol(protocol), m_socket(-1), m_epoll(-1), m_connected(false)
+{
+	open();
+}
+
+yhkcatprint::LinuxSocket::LinuxSocket(int fd)
+	: m_domain(-1), m_type(0), m_protocol(0), m_socket(fd), m_epoll(-1), m_connected(false)
+{
+	if (fd < 0)
+	{
+		throw std::invalid_argument("Invalid socket descriptor");
+	}
+
+	try
+	{
+		registerSocket();
+	}
+	catch (...)
+	{
+		// Ownership was taken, so the descriptor is closed even though construction failed.
+		closeSocket();
+		throw;
+	}
+	m_connected = true;
+}
+
+yhkcatprint::LinuxSocket::~LinuxSocket()
+{
+	closeSocket();
+	if (m_epoll >= 0)
+	{
+		::close(m_epoll);
+	}
+}
+
+void yhkcatprint::LinuxSocket::connect(const sockaddr* address, socklen_t length)
+{
+	if (m_connected)
+	{
+		throw std::runtime_error("Socket already connected");
+	}
+	if (m_socket < 0)
+	{
+		open();
+	}
+
+	int result;
+	do
+	{
+		result = ::connect(m_socket, address, length);
+	} while (result < 0 && errno == EINTR);
+
+	if (result < 0)
+	{
+		auto failure = error("Failed to connect to the device");
+		reopen();
+		throw failure;
+	}
+	m_connected = true;
+}
+
+void yhkcatprint::LinuxSocket::connect(const sockaddr* address, socklen_t length, std::chrono::nanoseconds timeout)
+{
+	if (m_connected)
+	{
+		throw std::runtime_error("Socket already connected");
+	}
+	if (m_socket < 0)
+	{
+		open();
+	}
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	setNonBlocking(true);
+	if (::connect(m_socket, address, length) < 0)
+	{
+		if (errno != EINPROGRESS && errno != EINTR)
+		{
+			auto failure = error("Failed to connect to the device");
+			reopen();
+			throw failure;
+		}
+
+		if (!waitReady(EPOLLOUT, deadline))
+		{
+			// A connect that timed out leaves the socket unusable; start over with a fresh one.
+			reopen();
+			throw std::runtime_error("Timed out connecting to the device");
+		}
+
+		int result = 0;
+		socklen_t resultLength = sizeof(result);
+		if (::getsockopt(m_socket, SOL_SOCKET, SO_ERROR, &result, &resultLength) < 0)
+		{
+			result = errno;
+		}
+		if (result != 0)
+		{
+			reopen();
+			throw std::runtime_error(std::string("Failed to connect to the device: ") + std::strerror(result));
+		}
+	}
+	setNonBlocking(false);
+	m_connected = true;
+}
+
+size_t yhkcatprint::LinuxSocket::send(const uint8_t* data, size_t size)
+{
+	requireConnected();
+
+	ssize_t bytesSent;
+	do
+	{
+		bytesSent = ::send(m_socket, data, size, MSG_NOSIGNAL);
+	} while (bytesSent < 0 && errno == EINTR);
+
+	if (bytesSent < 0)
+	{
+		throw error("Failed to send data");
+	}
+	return static_cast<size_t>(bytesSent);
+}
+
+size_t yhkcatprint::LinuxSocket::send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+{
+	requireConnected();
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	size_t total = 0;
+	while (total < size)
+	{
+		ssize_t bytesSent = ::send(m_socket, data + total, size - total, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (bytesSent < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				throw error("Failed to send data");
+			}
+			if (!waitReady(EPOLLOUT, deadline))
+			{
+				break;
+			}
+			continue;
+		}
+		total += static_cast<size_t>(bytesSent);
+	}
+
+	if (total == 0 && size > 0)
+	{
+		throw std::runtime_error("Timed out sending data");
+	}
+	return total;
+}
+
+size_t yhkcatprint::LinuxSocket::send(std::span<const std::span<const uint8_t>> buffers)
+{
+	requireConnected();
+
+	iovec vectors[MAX_SEND_BUFFERS];
+	size_t count = 0;
+	for (const auto& buffer : buffers)
+	{
+		if (count == MAX_SEND_BUFFERS)
+		{
+			break;
+		}
+		if (!buffer.empty())
+		{
+			vectors[count].iov_base = const_cast<uint8_t*>(buffer.data());
+			vectors[count].iov_len = buffer.size();
+			count++;
+		}
+	}
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	msghdr message = {};
+	message.msg_iov = vectors;
+	message.msg_iovlen = count;
+
+	ssize_t bytesSent;
+	do
+	{
+		bytesSent = ::sendmsg(m_socket, &message, MSG_NOSIGNAL);
+	} while (bytesSent < 0 && errno == EINTR);
+
+	if (bytesSent < 0)
+	{
+		throw error("Failed to send data");
+	}
+	return static_cast<size_t>(bytesSent);
+}
+
+size_t yhkcatprint::LinuxSocket::receive(uint8_t* buffer, size_t size)
+{
+	requireConnected();
+
+	ssize_t bytesReceived;
+	do
+	{
+		bytesReceived = ::recv(m_socket, buffer, size, 0);
+	} while (bytesReceived < 0 && errno == EINTR);
+
+	if (bytesReceived < 0)
+	{
+		throw error("Failed to receive data");
+	}
+	if (bytesReceived == 0 && size > 0)
+	{
+		// Connection has been closed by the peer
+		m_connected = false;
+	}
+	return static_cast<size_t>(bytesReceived);
+}
+
+size_t yhkcatprint::LinuxSocket::receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+{
+	requireConnected();
+
+	if (!waitReady(EPOLLIN, std::chrono::steady_clock::now() + timeout))
+	{
+		throw std::runtime_error("Timed out receiving data");
+	}
+	return receive(buffer, size);
+}
+
+size_t yhkcatprint::LinuxSocket::available()
+{
+	requireConnected();
+
+	int bytesAvailable = 0;
+	if (::ioctl(m_socket, FIONREAD, &bytesAvailable) < 0)
+	{
+		throw error("Failed to check available data");
+	}
+	return static_cast<size_t>(bytesAvailable);
+}
+
+bool yhkcatprint::LinuxSocket::isConnected() const noexcept
+{
+	return m_connected;
+}
+
+int yhkcatprint::LinuxSocket::nativeHandle() const noexcept
+{
+	return m_socket;
+}
+
+void yhkcatprint::LinuxSocket::close() noexcept
+{
+	closeSocket();
+}
+
+void yhkcatprint::LinuxSocket::open()
+{
+	m_socket = ::socket(m_domain, m_type | SOCK_CLOEXEC, m_protocol);
+	if (m_socket < 0)
+	{
+		throw error("Failed to create socket");
+	}
+
+	try
+	{
+		registerSocket();
+	}
+	catch (...)
+	{
+		closeSocket();
+		throw;
+	}
+}
+
+void yhkcatprint::LinuxSocket::registerSocket()
+{
+	if (m_epoll < 0)
+	{
+		m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		if (m_epoll < 0)
+		{
+			throw error("Failed to create epoll instance");
+		}
+	}
+
+	epoll_event event = {};
+	event.data.fd = m_socket;
+	if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_socket, &event) < 0)
+	{
+		throw error("Failed to register socket with epoll");
+	}
+}
+
+void yhkcatprint::LinuxSocket::closeSocket() noexcept
+{
+	if (m_socket >= 0)
+	{
+		if (m_epoll >= 0)
+		{
+			::epoll_ctl(m_epoll, EPOLL_CTL_DEL, m_socket, nullptr);
+		}
+		::close(m_socket);
+		m_socket = -1;
+	}
+	m_connected = false;
+}
+
+void yhkcatprint::LinuxSocket::reopen()
+{
+	closeSocket();
+	open();
+}
+
+void yhkcatprint::LinuxSocket::setNonBlocking(bool enabled)
+{
+	int flags = ::fcntl(m_socket, F_GETFL);
+	if (flags < 0)
+	{
+		throw error("Failed to read socket flags");
+	}
+	flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+	if (::fcntl(m_socket, F_SETFL, flags) < 0)
+	{
+		throw error("Failed to change socket blocking mode");
+	}
+}
+
+bool yhkcatprint::LinuxSocket::waitReady(uint32_t events, std::chrono::steady_clock::time_point deadline)
+{
+	epoll_event event = {};
+	event.events = events | EPOLLERR | EPOLLHUP;
+	event.data.fd = m_socket;
+	if (::epoll_ctl(m_epoll, EPOLL_CTL_MOD, m_socket, &event) < 0)
+	{
+		throw error("Failed to update epoll registration");
+	}
+
+	while (true)
+	{
+		auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		int timeout = static_cast<int>(std::clamp<long long>(remaining.count(), 0, std::numeric_limits<int>::max()));
+
+		epoll_event ready = {};
+		int result = ::epoll_wait(m_epoll, &ready, 1, timeout);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw error("Failed to wait for socket");
+		}
+		return result > 0;
+	}
+}
+
+void yhkcatprint::LinuxSocket::requireConnected() const
+{
+	if (!m_connected)
+	{
+		throw std::runtime_error("Socket not connected");
+	}
+}
+
+std::runtime_error yhkcatprint::LinuxSocket::error(const std::string& message)
+{
+	return std::runtime_error(message + ": " + std::strerror(errno));
+}
@@ -0,0 +1,240 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LinuxSocket.h
+
+Abstract:
+	Stream socket with deadlines on Linux, waiting for readiness with epoll.
+
+--*/
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+
+/**
+ * @file LinuxSocket.h
+ * @brief Stream socket with deadlines on Linux, waiting for readiness with epoll.
+ *
+ * This header defines LinuxSocket, the transport under the Linux RFCOMM
+ * backend. It does not depend on the address family, so the same code that
+ * drives AF_BLUETOOTH sockets runs against AF_UNIX socketpairs and loopback
+ * TCP in tests on machines without a radio.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Stream socket with deadlines on Linux.
+	 *
+	 * Untimed operations block. Timed ones run the socket non-blocking and
+	 * wait for readiness on a private epoll instance until the deadline. A
+	 * connect that fails or times out replaces the socket, so the object can
+	 * connect again.
+	 *
+	 * @note Not thread-safe; a socket must not be used from several threads at once.
+	 */
+	class LinuxSocket
+	{
+	public:
+		/**
+		 * @brief Creates an unconnected socket.
+		 *
+		 * @param domain Address family, e.g. AF_BLUETOOTH.
+		 * @param type Socket type, e.g. SOCK_STREAM; SOCK_CLOEXEC is always added.
+		 * @param protocol Protocol, e.g. BTPROTO_RFCOMM.
+		 *
+		 * @throws std::runtime_error on failure to create the socket.
+		 */
+		LinuxSocket(int domain, int type, int protocol);
+
+		/**
+		 * @brief Adopts an already connected stream socket.
+		 *
+		 * The object takes ownership of the descriptor. Once closed it cannot
+		 * connect again, since the address family is not known.
+		 *
+		 * @param fd Connected stream socket descriptor.
+		 *
+		 * @throws std::invalid_argument if fd is negative.
+		 * @throws std::runtime_error on failure to set up readiness polling.
+		 */
+		explicit LinuxSocket(int fd);
+
+		/**
+		 * @brief Destructor. Closes the socket if open.
+		 */
+		~LinuxSocket();
+
+		// Disable copy semantics
+		LinuxSocket(const LinuxSocket&) = delete;
+		LinuxSocket& operator=(const LinuxSocket&) = delete;
+
+		/**
+		 * @brief Connects to an address, blocking until connected or failed.
+		 *
+		 * @throws std::runtime_error on failure to connect or if already connected.
+		 */
+		void connect(const sockaddr* address, socklen_t length);
+
+		/**
+		 * @brief Connects to an address within a deadline.
+		 *
+		 * @throws std::runtime_error on failure to connect, timeout or if already connected.
+		 */
+		void connect(const sockaddr* address, socklen_t length, std::chrono::nanoseconds timeout);
+
+		/**
+		 * @brief Sends data, blocking until at least some of it is accepted.
+		 *
+		 * @return Number of bytes sent, possibly fewer than requested.
+		 *
+		 * @throws std::runtime_error on send failure or if not connected.
+		 */
+		size_t send(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Sends as much data as the socket accepts before the deadline.
+		 *
+		 * @return Number of bytes sent, fewer than requested if the deadline passed.
+		 *
+		 * @throws std::runtime_error on send failure, if nothing could be sent
+		 *         before the deadline or if not connected.
+		 */
+		size_t send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout);
+
+		/**
+		 * @brief Sends several buffers in one operation, without copying them together.
+		 *
+		 * Buffers beyond the first MAX_SEND_BUFFERS non-empty ones are left for the next call.
+		 *
+		 * @return Number of bytes sent, counted across all buffers.
+		 *
+		 * @throws std::runtime_error on send failure or if not connected.
+		 */
+		size_t send(std::span<const std::span<const uint8_t>> buffers);
+
+		/**
+		 * @brief Receives data, blocking until some arrives or the peer closes.
+		 *
+		 * @return Number of bytes received; 0 once the peer has closed the connection.
+		 *
+		 * @throws std::runtime_error on receive failure or if not connected.
+		 */
+		size_t receive(uint8_t* buffer, size_t size);
+
+		/**
+		 * @brief Receives data that arrives before the deadline.
+		 *
+		 * @return Number of bytes received; 0 once the peer has closed the connection.
+		 *
+		 * @throws std::runtime_error on receive failure, timeout or if not connected.
+		 */
+		size_t receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout);
+
+		/**
+		 * @brief Returns the number of bytes that can be read without blocking.
+		 *
+		 * @throws std::runtime_error on failure or if not connected.
+		 */
+		size_t available();
+
+		/**
+		 * @brief Checks whether the socket is connected and the peer has not closed it.
+		 */
+		bool isConnected() const noexcept;
+
+		/**
+		 * @brief Returns the socket descriptor, or -1 if closed.
+		 */
+		int nativeHandle() const noexcept;
+
+		/**
+		 * @brief Closes the socket.
+		 *
+		 * @post The socket is no longer connected. A socket created with an
+		 *       address family can connect again.
+		 */
+		void close() noexcept;
+
+		/**
+		 * @brief Most buffers sent by one gathering send.
+		 */
+		static constexpr size_t MAX_SEND_BUFFERS = 16;
+
+	private:
+		/**
+		 * @brief Creates a fresh socket of the family given on construction.
+		 */
+		void open();
+
+		/**
+		 * @brief Registers the socket with the epoll instance, creating it first if needed.
+		 */
+		void registerSocket();
+
+		/**
+		 * @brief Closes the socket, leaving the epoll instance for the next one.
+		 */
+		void closeSocket() noexcept;
+
+		/**
+		 * @brief Closes the socket after a failed connect and opens a fresh one.
+		 */
+		void reopen();
+
+		/**
+		 * @brief Switches the socket between blocking and non-blocking mode.
+		 */
+		void setNonBlocking(bool enabled);
+
+		/**
+		 * @brief Waits until the socket is ready for the given epoll events or the deadline passes.
+		 *
+		 * @return true if ready, false on timeout.
+		 */
+		bool waitReady(uint32_t events, std::chrono::steady_clock::time_point deadline);
+
+		/**
+		 * @brief Throws std::runtime_error unless the socket is connected.
+		 */
+		void requireConnected() const;
+
+		/**
+		 * @brief Returns an error with the message and the description of errno.
+		 */
+		static std::runtime_error error(const std::string& message);
+
+		/**
+		 * @brief Address family, or -1 for an adopted descriptor.
+		 */
+		int m_domain;
+		/**
+		 * @brief Socket type.
+		 */
+		int m_type;
+		/**
+		 * @brief Socket protocol.
+		 */
+		int m_protocol;
+		/**
+		 * @brief Socket descriptor, or -1 if closed.
+		 */
+		int m_socket;
+		/**
+		 * @brief Epoll instance the socket is registered with, or -1 until first needed.
+		 */
+		int m_epoll;
+		/**
+		 * @brief Whether the socket is connected and the peer has not closed it.
+		 */
+		bool m_connected;
+	};
+}
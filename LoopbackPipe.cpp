@@ -0,0 +1,258 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LoopbackPipe.cpp
+
+Abstract:
+	Implementation of LoopbackPipe and LoopbackListener methods.
+
+--*/
+
+#include "LoopbackPipe.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+
+struct yhkcatprint::LoopbackListener::State
+{
+	std::string name;
+	size_t capacity;
+	bool closed = false;
+	std::deque<LOOPBACK_ENDPOINT> pending;
+	std::mutex mutex;
+	std::condition_variable incoming;
+};
+
+std::mutex yhkcatprint::LoopbackListener::s_registryMutex;
+std::unordered_map<std::string, std::weak_ptr<yhkcatprint::LoopbackListener::State>> yhkcatprint::LoopbackListener::s_registry;
+
+namespace
+{
+	template <typename Predicate>
+	bool waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point deadline, Predicate ready)
+	{
+		if (deadline == yhkcatprint::LoopbackPipe::NO_DEADLINE)
+		{
+			cv.wait(lock, ready);
+			return true;
+		}
+		return cv.wait_until(lock, deadline, ready);
+	}
+
+	std::string stripScheme(const std::string& name)
+	{
+		const std::string scheme = yhkcatprint::LoopbackListener::SCHEME;
+		return name.compare(0, scheme.size(), scheme) == 0 ? name.substr(scheme.size()) : name;
+	}
+}
+
+yhkcatprint::LoopbackPipe::LoopbackPipe(size_t capacity)
+	: m_buffer(capacity), m_head(0), m_count(0), m_closed(false)
+{
+	if (capacity == 0)
+	{
+		throw std::invalid_argument("Pipe capacity must be greater than zero");
+	}
+}
+
+size_t yhkcatprint::LoopbackPipe::write(const uint8_t* data, size_t size, std::chrono::steady_clock::time_point deadline)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	size_t written = 0;
+
+	while (written < size)
+	{
+		bool ready = waitUntil(m_writable, lock, deadline, [this] { return m_closed || m_count < m_buffer.size(); });
+		if (m_closed) {
+			throw std::runtime_error("Connection closed by peer");
+		}
+		if (!ready) {
+			break;
+		}
+
+		size_t tail = (m_head + m_count) % m_buffer.size();
+		size_t chunk = std::min({ size - written, m_buffer.size() - m_count, m_buffer.size() - tail });
+		std::memcpy(m_buffer.data() + tail, data + written, chunk);
+		m_count += chunk;
+		written += chunk;
+		m_readable.notify_all();
+
+		// The reader may be a reactor waiting for the callback, which must run before waiting for space again.
+		if (m_onReadable)
+		{
+			std::function<void()> onReadable = m_onReadable;
+			lock.unlock();
+			onReadable();
+			lock.lock();
+		}
+	}
+
+	if (written == 0 && size > 0) {
+		throw std::runtime_error("Timed out sending data");
+	}
+
+	return written;
+}
+
+size_t yhkcatprint::LoopbackPipe::read(uint8_t* buffer, size_t size, std::chrono::steady_clock::time_point deadline)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (!waitUntil(m_readable, lock, deadline, [this] { return m_closed || m_count > 0; })) {
+		throw std::runtime_error("Timed out receiving data");
+	}
+
+	size_t total = 0;
+	while (total < size && m_count > 0)
+	{
+		size_t chunk = std::min({ size - total, m_count, m_buffer.size() - m_head });
+		std::memcpy(buffer + total, m_buffer.data() + m_head, chunk);
+		m_head = (m_head + chunk) % m_buffer.size();
+		m_count -= chunk;
+		total += chunk;
+	}
+
+	m_writable.notify_all();
+	return total;
+}
+
+size_t yhkcatprint::LoopbackPipe::available() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_count;
+}
+
+void yhkcatprint::LoopbackPipe::close()
+{
+	std::function<void()> onReadable;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closed = true;
+		onReadable = m_onReadable;
+	}
+	m_readable.notify_all();
+	m_writable.notify_all();
+	if (onReadable)
+	{
+		onReadable();
+	}
+}
+
+bool yhkcatprint::LoopbackPipe::isClosed() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_closed;
+}
+
+void yhkcatprint::LoopbackPipe::setReadableCallback(std::function<void()> callback)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_onReadable = std::move(callback);
+}
+
+yhkcatprint::LoopbackListener::LoopbackListener(const std::string& name, size_t capacity)
+	: m_state(std::make_shared<State>())
+{
+	m_state->name = stripScheme(name);
+	m_state->capacity = capacity;
+
+	std::lock_guard<std::mutex> lock(s_registryMutex);
+	auto& slot = s_registry[m_state->name];
+	if (!slot.expired())
+	{
+		throw std::runtime_error("Loopback endpoint already in use: " + m_state->name);
+	}
+	slot = m_state;
+}
+
+yhkcatprint::LoopbackListener::~LoopbackListener()
+{
+	close();
+}
+
+yhkcatprint::LOOPBACK_ENDPOINT yhkcatprint::LoopbackListener::accept(std::chrono::nanoseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(m_state->mutex);
+
+	auto ready = [this] { return m_state->closed || !m_state->pending.empty(); };
+	if (timeout == std::chrono::nanoseconds::max())
+	{
+		m_state->incoming.wait(lock, ready);
+	}
+	else if (!m_state->incoming.wait_for(lock, timeout, ready))
+	{
+		throw std::runtime_error("Timed out waiting for a loopback connection");
+	}
+
+	if (m_state->closed)
+	{
+		throw std::runtime_error("Loopback listener closed");
+	}
+
+	LOOPBACK_ENDPOINT endpoint = std::move(m_state->pending.front());
+	m_state->pending.pop_front();
+	return endpoint;
+}
+
+void yhkcatprint::LoopbackListener::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_registryMutex);
+		auto it = s_registry.find(m_state->name);
+		if (it != s_registry.end() && it->second.lock() == m_state)
+		{
+			s_registry.erase(it);
+		}
+	}
+
+	std::deque<LOOPBACK_ENDPOINT> orphaned;
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		m_state->closed = true;
+		orphaned.swap(m_state->pending);
+	}
+	m_state->incoming.notify_all();
+
+	// Connections nobody accepted must not leave their clients blocked.
+	for (auto& endpoint : orphaned)
+	{
+		endpoint.rx->close();
+		endpoint.tx->close();
+	}
+}
+
+yhkcatprint::LOOPBACK_ENDPOINT yhkcatprint::LoopbackListener::connect(const std::string& name)
+{
+	std::shared_ptr<State> state;
+	{
+		std::lock_guard<std::mutex> lock(s_registryMutex);
+		auto it = s_registry.find(stripScheme(name));
+		if (it != s_registry.end())
+		{
+			state = it->second.lock();
+		}
+	}
+
+	if (state == nullptr)
+	{
+		throw std::runtime_error("No loopback listener at " + name);
+	}
+
+	auto upstream = std::make_shared<LoopbackPipe>(state->capacity);
+	auto downstream = std::make_shared<LoopbackPipe>(state->capacity);
+
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (state->closed)
+		{
+			throw std::runtime_error("No loopback listener at " + name);
+		}
+		state->pending.push_back({ upstream, downstream });
+	}
+	state->incoming.notify_one();
+
+	return { downstream, upstream };
+}
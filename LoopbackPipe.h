@@ -0,0 +1,253 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LoopbackPipe.h
+
+Abstract:
+	In-process byte pipes and named endpoints for loopback sockets.
+
+--*/
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file LoopbackPipe.h
+ * @brief In-process byte pipes and named endpoints for loopback sockets.
+ *
+ * This header provides the transport shared by the loopback IRfcommSocket
+ * implementations. It does not depend on the socket interfaces, so the same
+ * endpoints are reachable from both the header and the module API.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Bounded, blocking, single-direction byte pipe.
+	 *
+	 * Writers block while the pipe is full, which models the flow control of
+	 * a real link. Either side may close the pipe; readers then drain the
+	 * remaining bytes and see end of stream.
+	 *
+	 * @note All methods are thread-safe.
+	 */
+	class LoopbackPipe
+	{
+	public:
+		/**
+		 * @brief Deadline meaning "wait indefinitely".
+		 */
+		static constexpr std::chrono::steady_clock::time_point NO_DEADLINE = std::chrono::steady_clock::time_point::max();
+
+		/**
+		 * @brief Constructs an empty pipe.
+		 *
+		 * @param capacity Number of bytes the pipe buffers before writers block.
+		 */
+		explicit LoopbackPipe(size_t capacity);
+
+		// Disable copy semantics
+		LoopbackPipe(const LoopbackPipe&) = delete;
+		LoopbackPipe& operator=(const LoopbackPipe&) = delete;
+
+		/**
+		 * @brief Writes data into the pipe.
+		 *
+		 * Without a deadline, blocks until every byte is buffered. With a
+		 * deadline, returns the number of bytes buffered when it passes.
+		 *
+		 * @param data Pointer to the data to write.
+		 * @param size Number of bytes to write.
+		 * @param deadline Point in time after which waiting stops.
+		 * @return Number of bytes written.
+		 *
+		 * @throws std::runtime_error if the pipe is closed or nothing was written before the deadline.
+		 */
+		size_t write(const uint8_t* data, size_t size, std::chrono::steady_clock::time_point deadline = NO_DEADLINE);
+
+		/**
+		 * @brief Reads data from the pipe.
+		 *
+		 * Blocks until at least one byte is available or the pipe is closed.
+		 *
+		 * @param buffer Pointer to the buffer to store the data.
+		 * @param size Maximum number of bytes to read.
+		 * @param deadline Point in time after which waiting stops.
+		 * @return Number of bytes read, 0 once the pipe is closed and drained.
+		 *
+		 * @throws std::runtime_error if no data arrived before the deadline.
+		 */
+		size_t read(uint8_t* buffer, size_t size, std::chrono::steady_clock::time_point deadline = NO_DEADLINE);
+
+		/**
+		 * @brief Returns the number of bytes that can be read without blocking.
+		 */
+		size_t available() const;
+
+		/**
+		 * @brief Closes the pipe and wakes all waiters.
+		 */
+		void close();
+
+		/**
+		 * @brief Checks whether the pipe has been closed.
+		 */
+		bool isClosed() const;
+
+		/**
+		 * @brief Sets a callback invoked after bytes are written or the pipe is closed.
+		 *
+		 * The callback runs on the writing or closing thread without the
+		 * pipe's lock held, so it may read the pipe's state.
+		 *
+		 * @param callback Callback, or an empty function to remove it.
+		 */
+		void setReadableCallback(std::function<void()> callback);
+
+	private:
+		/**
+		 * @brief Ring buffer storage.
+		 */
+		std::vector<uint8_t> m_buffer;
+		/**
+		 * @brief Index of the oldest buffered byte.
+		 */
+		size_t m_head;
+		/**
+		 * @brief Number of buffered bytes.
+		 */
+		size_t m_count;
+		/**
+		 * @brief Whether close() has been called.
+		 */
+		bool m_closed;
+		/**
+		 * @brief Invoked after bytes are written or the pipe is closed.
+		 */
+		std::function<void()> m_onReadable;
+		/**
+		 * @brief Guards all state.
+		 */
+		mutable std::mutex m_mutex;
+		/**
+		 * @brief Signalled when bytes are written or the pipe is closed.
+		 */
+		std::condition_variable m_readable;
+		/**
+		 * @brief Signalled when bytes are read or the pipe is closed.
+		 */
+		std::condition_variable m_writable;
+	};
+
+	/**
+	 * @brief One side of a loopback connection.
+	 */
+	typedef struct _LOOPBACK_ENDPOINT
+	{
+		/**
+		 * @brief Pipe carrying data towards this side.
+		 */
+		std::shared_ptr<LoopbackPipe> rx;
+		/**
+		 * @brief Pipe carrying data away from this side.
+		 */
+		std::shared_ptr<LoopbackPipe> tx;
+	} LOOPBACK_ENDPOINT;
+
+	/**
+	 * @brief Named, in-process listener accepting loopback connections.
+	 *
+	 * A listener registers its name for the lifetime of the object. Clients
+	 * connect to it through connect(), typically via a loopback socket
+	 * addressed as "loop://name".
+	 *
+	 * @note All methods are thread-safe.
+	 */
+	class LoopbackListener
+	{
+	public:
+		/**
+		 * @brief Address scheme of loopback endpoints.
+		 */
+		static constexpr const char* SCHEME = "loop://";
+
+		/**
+		 * @brief Default pipe capacity, roughly one RFCOMM receive window.
+		 */
+		static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+		/**
+		 * @brief Constructs a LoopbackListener and registers its name.
+		 *
+		 * @param name Endpoint name, without the scheme.
+		 * @param capacity Capacity of each pipe of accepted connections.
+		 *
+		 * @throws std::runtime_error if the name is already taken.
+		 */
+		explicit LoopbackListener(const std::string& name, size_t capacity = DEFAULT_CAPACITY);
+
+		/**
+		 * @brief Destructor. Unregisters the name.
+		 */
+		~LoopbackListener();
+
+		// Disable copy semantics
+		LoopbackListener(const LoopbackListener&) = delete;
+		LoopbackListener& operator=(const LoopbackListener&) = delete;
+
+		/**
+		 * @brief Waits for the next incoming connection.
+		 *
+		 * @param timeout Maximum duration to wait.
+		 * @return Server side of the accepted connection.
+		 *
+		 * @throws std::runtime_error if the listener is closed or the timeout is reached.
+		 */
+		LOOPBACK_ENDPOINT accept(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+		/**
+		 * @brief Unregisters the name and wakes pending accept() calls.
+		 */
+		void close();
+
+		/**
+		 * @brief Connects to a registered listener.
+		 *
+		 * @param name Endpoint name, with or without the scheme.
+		 * @return Client side of the new connection.
+		 *
+		 * @throws std::runtime_error if no listener is registered under the name.
+		 */
+		static LOOPBACK_ENDPOINT connect(const std::string& name);
+
+	private:
+		/**
+		 * @brief State shared with the registry.
+		 */
+		struct State;
+
+		/**
+		 * @brief Pointer to the shared state.
+		 */
+		std::shared_ptr<State> m_state;
+
+		/**
+		 * @brief Guards the registry of listener names.
+		 */
+		static std::mutex s_registryMutex;
+		/**
+		 * @brief Registered listeners by name.
+		 */
+		static std::unordered_map<std::string, std::weak_ptr<State>> s_registry;
+	};
+}
@@ -0,0 +1,113 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LoopbackSocket.cpp
+
+Abstract:
+	Implementation of LoopbackSocket methods.
+
+--*/
+
+#include "LoopbackSocket.h"
+#include <stdexcept>
+
+yhkcatprint::LoopbackSocket::LoopbackSocket(const std::string& address, uint8_t channel)
+	: m_address(address)
+{
+}
+
+yhkcatprint::LoopbackSocket::LoopbackSocket(LOOPBACK_ENDPOINT endpoint)
+	: m_endpoint(std::move(endpoint))
+{
+}
+
+yhkcatprint::LoopbackSocket::~LoopbackSocket()
+{
+	close();
+}
+
+void yhkcatprint::LoopbackSocket::connect()
+{
+	if (m_endpoint.rx != nullptr) {
+		throw std::runtime_error("Socket already connected");
+	}
+	m_endpoint = LoopbackListener::connect(m_address);
+}
+
+void yhkcatprint::LoopbackSocket::connect(std::chrono::nanoseconds timeout)
+{
+	// Connecting to an in-process listener never blocks.
+	connect();
+}
+
+size_t yhkcatprint::LoopbackSocket::send(const uint8_t* data, size_t size)
+{
+	ensureConnected();
+	return m_endpoint.tx->write(data, size);
+}
+
+size_t yhkcatprint::LoopbackSocket::send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+{
+	ensureConnected();
+	return m_endpoint.tx->write(data, size, std::chrono::steady_clock::now() + timeout);
+}
+
+size_t yhkcatprint::LoopbackSocket::send(std::span<const std::span<const uint8_t>> buffers)
+{
+	ensureConnected();
+	size_t total = 0;
+	for (const auto& buffer : buffers) {
+		total += m_endpoint.tx->write(buffer.data(), buffer.size());
+	}
+	return total;
+}
+
+size_t yhkcatprint::LoopbackSocket::receive(uint8_t* buffer, size_t size)
+{
+	ensureConnected();
+	return m_endpoint.rx->read(buffer, size);
+}
+
+size_t yhkcatprint::LoopbackSocket::receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+{
+	ensureConnected();
+	return m_endpoint.rx->read(buffer, size, std::chrono::steady_clock::now() + timeout);
+}
+
+bool yhkcatprint::LoopbackSocket::available()
+{
+	if (m_endpoint.rx == nullptr) {
+		return false;
+	}
+	// A closed pipe is reported as readable so that receive() observes end of stream.
+	return m_endpoint.rx->available() > 0 || m_endpoint.rx->isClosed();
+}
+
+intptr_t yhkcatprint::LoopbackSocket::nativeHandle() const
+{
+	return NO_NATIVE_HANDLE;
+}
+
+bool yhkcatprint::LoopbackSocket::setReadableCallback(std::function<void()> callback)
+{
+	ensureConnected();
+	m_endpoint.rx->setReadableCallback(std::move(callback));
+	return true;
+}
+
+void yhkcatprint::LoopbackSocket::close()
+{
+	if (m_endpoint.rx != nullptr) {
+		m_endpoint.rx->close();
+		m_endpoint.tx->close();
+	}
+}
+
+void yhkcatprint::LoopbackSocket::ensureConnected() const
+{
+	if (m_endpoint.rx == nullptr) {
+		throw std::runtime_error("Socket not connected");
+	}
+}
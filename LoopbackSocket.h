@@ -0,0 +1,90 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LoopbackSocket.h
+
+Abstract:
+	Implementation of IRfcommSocket over in-process loopback pipes.
+
+--*/
+
+#pragma once
+#include "IRfcommSocket.h"
+#include "LoopbackPipe.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @file LoopbackSocket.h
+ * @brief Implementation of IRfcommSocket over in-process loopback pipes.
+ *
+ * This header defines a socket that connects to a LoopbackListener in the
+ * same process, addressed as "loop://name". It lets the print pipeline run
+ * against the printer emulator without a Bluetooth radio.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Implementation of IRfcommSocket over in-process loopback pipes.
+	 *
+	 * The RFCOMM channel number is ignored. Send and receive are safe to call
+	 * concurrently from different threads.
+	 */
+	class LoopbackSocket : public IRfcommSocket
+	{
+	public:
+		/**
+		 * @brief Constructs an unconnected client LoopbackSocket.
+		 *
+		 * @param address Endpoint address in format "loop://name".
+		 * @param channel RFCOMM channel number, ignored.
+		 */
+		LoopbackSocket(const std::string& address, uint8_t channel);
+
+		/**
+		 * @brief Constructs a connected LoopbackSocket from an accepted endpoint.
+		 *
+		 * @param endpoint Endpoint returned by LoopbackListener::accept().
+		 */
+		explicit LoopbackSocket(LOOPBACK_ENDPOINT endpoint);
+
+		/**
+		 * @brief Destructor. Closes the socket if open.
+		 */
+		virtual ~LoopbackSocket();
+
+		// Disable copy semantics
+		LoopbackSocket(const LoopbackSocket&) = delete;
+		LoopbackSocket& operator=(const LoopbackSocket&) = delete;
+
+		void connect() override;
+		void connect(std::chrono::nanoseconds timeout) override;
+		size_t send(const uint8_t* data, size_t size) override;
+		size_t send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+		size_t send(std::span<const std::span<const uint8_t>> buffers) override;
+		size_t receive(uint8_t* buffer, size_t size) override;
+		size_t receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
+		bool available() override;
+		intptr_t nativeHandle() const override;
+		bool setReadableCallback(std::function<void()> callback) override;
+		void close() override;
+
+	private:
+		/**
+		 * @brief Endpoint address.
+		 */
+		std::string m_address;
+		/**
+		 * @brief Pipes of the connection, empty until connected.
+		 */
+		LOOPBACK_ENDPOINT m_endpoint;
+
+		/**
+		 * @brief Throws unless the socket is connected.
+		 */
+		void ensureConnected() const;
+	};
+}
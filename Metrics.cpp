@@ -0,0 +1,313 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Metrics.cpp
+
+Abstract:
+	Implementation of Histogram, DeviceMetrics and MetricsRegistry methods.
+
+--*/
+
+#include "Metrics.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+	/**
+	 * @brief Quantiles exported for every summary.
+	 */
+	constexpr double exportedQuantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+	constexpr const char* phaseNames[] = { "lookup", "connect", "handshake", "transfer", "job" };
+	constexpr const char* enumerationNames[] = { "radios", "devices" };
+
+	static_assert(std::size(phaseNames) == yhkcatprint::METRIC_PHASE_COUNT, "Every phase needs a name");
+	static_assert(std::size(enumerationNames) == yhkcatprint::METRIC_ENUMERATION_COUNT, "Every enumeration needs a name");
+
+	/**
+	 * @brief Name, help text and index of a counter exported per device.
+	 */
+	struct CounterFamily
+	{
+		const char* name;
+		const char* help;
+		yhkcatprint::MetricCounter counter;
+	};
+
+	constexpr CounterFamily counterFamilies[] = {
+		{ "yhkcatprint_jobs_total", "Print jobs sent.", yhkcatprint::METRIC_COUNTER_JOBS },
+		{ "yhkcatprint_job_failures_total", "Print jobs that failed.", yhkcatprint::METRIC_COUNTER_FAILURES },
+		{ "yhkcatprint_sent_bytes_total", "Raster bytes sent after encoding.", yhkcatprint::METRIC_COUNTER_BYTES_SENT },
+		{ "yhkcatprint_retries_total", "Print jobs sent again after the link was lost before printing started.", yhkcatprint::METRIC_COUNTER_RETRIES },
+		{ "yhkcatprint_reconnects_total", "Links set up again after the first one of a session.", yhkcatprint::METRIC_COUNTER_RECONNECTS }
+	};
+
+	static_assert(std::size(counterFamilies) == yhkcatprint::METRIC_COUNTER_COUNT, "Every counter needs a family");
+
+	/**
+	 * @brief Writes a label value, escaped as the text format requires.
+	 */
+	void writeLabelValue(std::ostream& out, const std::string& value)
+	{
+		for (char c : value)
+		{
+			switch (c)
+			{
+			case '\\':
+				out << "\\\\";
+				break;
+			case '"':
+				out << "\\\"";
+				break;
+			case '\n':
+				out << "\\n";
+				break;
+			default:
+				out << c;
+				break;
+			}
+		}
+	}
+
+	/**
+	 * @brief Writes the samples of a duration summary; labels are written before each sample's own.
+	 */
+	void writeSummary(std::ostream& out, const char* name, const std::string& labels, const yhkcatprint::HISTOGRAM_SNAPSHOT& histogram)
+	{
+		for (double quantile : exportedQuantiles)
+		{
+			out << name << "{" << labels << ",quantile=\"" << quantile << "\"} "
+				<< static_cast<double>(histogram.valueAt(quantile)) / 1e9 << "\n";
+		}
+		out << name << "_sum{" << labels << "} " << static_cast<double>(histogram.sum) / 1e9 << "\n";
+		out << name << "_count{" << labels << "} " << histogram.count << "\n";
+	}
+
+	/**
+	 * @brief Returns the device label of a device's samples.
+	 */
+	std::string deviceLabel(const yhkcatprint::DEVICE_METRICS_SNAPSHOT& device)
+	{
+		std::ostringstream label;
+		label << "device=\"";
+		writeLabelValue(label, device.address);
+		label << "\"";
+		return label.str();
+	}
+}
+
+uint64_t yhkcatprint::HISTOGRAM_SNAPSHOT::valueAt(double quantile) const noexcept
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	// The rank of the value sought, counting from 1.
+	double clamped = std::clamp(quantile, 0.0, 1.0);
+	uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+
+	uint64_t seen = 0;
+	for (size_t bucket = 0; bucket < buckets.size(); bucket++)
+	{
+		seen += buckets[bucket];
+		if (seen >= rank)
+		{
+			return std::min(Histogram::bucketTop(bucket), max);
+		}
+	}
+	return max;
+}
+
+yhkcatprint::Histogram::Histogram()
+	: m_sum(0), m_max(0)
+{
+	for (std::atomic<uint64_t>& bucket : m_buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+void yhkcatprint::Histogram::record(uint64_t value) noexcept
+{
+	m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t max = m_max.load(std::memory_order_relaxed);
+	while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+void yhkcatprint::Histogram::record(std::chrono::nanoseconds duration) noexcept
+{
+	record(static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0)));
+}
+
+yhkcatprint::HISTOGRAM_SNAPSHOT yhkcatprint::Histogram::snapshot() const
+{
+	HISTOGRAM_SNAPSHOT snapshot;
+	snapshot.buckets.resize(BUCKET_COUNT);
+	for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+	{
+		snapshot.buckets[bucket] = m_buckets[bucket].load(std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[bucket];
+	}
+	snapshot.sum = m_sum.load(std::memory_order_relaxed);
+	snapshot.max = m_max.load(std::memory_order_relaxed);
+
+	if (snapshot.count == 0)
+	{
+		snapshot.buckets.clear();
+	}
+	return snapshot;
+}
+
+size_t yhkcatprint::Histogram::bucketOf(uint64_t value) noexcept
+{
+	// Values below 2 * SUB_BUCKETS are counted exactly; above, the bits below
+	// the top SUB_BUCKET_BITS + 1 are dropped and the number dropped picks the row.
+	unsigned width = static_cast<unsigned>(std::bit_width(value));
+	if (width <= SUB_BUCKET_BITS + 1)
+	{
+		return static_cast<size_t>(value);
+	}
+	unsigned shift = width - SUB_BUCKET_BITS - 1;
+	return shift * SUB_BUCKETS + static_cast<size_t>(value >> shift);
+}
+
+uint64_t yhkcatprint::Histogram::bucketTop(size_t bucket) noexcept
+{
+	if (bucket < 2 * SUB_BUCKETS)
+	{
+		return bucket;
+	}
+	unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS - 1);
+	uint64_t mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+	return (mantissa << shift) + ((uint64_t{ 1 } << shift) - 1);
+}
+
+yhkcatprint::DeviceMetrics::DeviceMetrics(std::string address)
+	: m_address(std::move(address)), m_queueDepth(0)
+{
+	for (std::atomic<uint64_t>& counter : m_counters)
+	{
+		counter.store(0, std::memory_order_relaxed);
+	}
+}
+
+yhkcatprint::DEVICE_METRICS_SNAPSHOT yhkcatprint::DeviceMetrics::snapshot() const
+{
+	DEVICE_METRICS_SNAPSHOT snapshot;
+	snapshot.address = m_address;
+	for (size_t phase = 0; phase < METRIC_PHASE_COUNT; phase++)
+	{
+		snapshot.phases[phase] = m_phases[phase].snapshot();
+	}
+	for (size_t counter = 0; counter < METRIC_COUNTER_COUNT; counter++)
+	{
+		snapshot.counters[counter] = m_counters[counter].load(std::memory_order_relaxed);
+	}
+	snapshot.queueDepth = m_queueDepth.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+yhkcatprint::MetricsRegistry& yhkcatprint::MetricsRegistry::instance()
+{
+	// Never destroyed, so that sessions outliving static destructors can still record.
+	static MetricsRegistry* registry = new MetricsRegistry();
+	return *registry;
+}
+
+std::shared_ptr<yhkcatprint::DeviceMetrics> yhkcatprint::MetricsRegistry::device(const std::string& address)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::shared_ptr<DeviceMetrics>& metrics = m_devices[address];
+	if (metrics == nullptr)
+	{
+		metrics = std::make_shared<DeviceMetrics>(address);
+		m_order.push_back(metrics);
+	}
+	return metrics;
+}
+
+yhkcatprint::METRICS_SNAPSHOT yhkcatprint::MetricsRegistry::snapshot() const
+{
+	std::vector<std::shared_ptr<DeviceMetrics>> devices;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		devices = m_order;
+	}
+
+	METRICS_SNAPSHOT snapshot;
+	for (size_t enumeration = 0; enumeration < METRIC_ENUMERATION_COUNT; enumeration++)
+	{
+		snapshot.enumerations[enumeration] = m_enumerations[enumeration].snapshot();
+	}
+	snapshot.devices.reserve(devices.size());
+	for (const auto& device : devices)
+	{
+		snapshot.devices.push_back(device->snapshot());
+	}
+	return snapshot;
+}
+
+std::string yhkcatprint::MetricsRegistry::toPrometheus() const
+{
+	METRICS_SNAPSHOT metrics = snapshot();
+
+	std::vector<std::string> labels;
+	labels.reserve(metrics.devices.size());
+	for (const DEVICE_METRICS_SNAPSHOT& device : metrics.devices)
+	{
+		labels.push_back(deviceLabel(device));
+	}
+
+	std::ostringstream out;
+	out.precision(9);
+
+	out << "# HELP yhkcatprint_enumeration_duration_seconds Time taken to enumerate Bluetooth radios and paired devices.\n"
+		<< "# TYPE yhkcatprint_enumeration_duration_seconds summary\n";
+	for (size_t enumeration = 0; enumeration < METRIC_ENUMERATION_COUNT; enumeration++)
+	{
+		writeSummary(out, "yhkcatprint_enumeration_duration_seconds", std::string("enumeration=\"") + enumerationNames[enumeration] + "\"",
+			metrics.enumerations[enumeration]);
+	}
+
+	out << "# HELP yhkcatprint_phase_duration_seconds Time taken by each phase of printing to a device.\n"
+		<< "# TYPE yhkcatprint_phase_duration_seconds summary\n";
+	for (size_t device = 0; device < metrics.devices.size(); device++)
+	{
+		for (size_t phase = 0; phase < METRIC_PHASE_COUNT; phase++)
+		{
+			writeSummary(out, "yhkcatprint_phase_duration_seconds", labels[device] + ",phase=\"" + phaseNames[phase] + "\"",
+				metrics.devices[device].phases[phase]);
+		}
+	}
+
+	for (const CounterFamily& family : counterFamilies)
+	{
+		out << "# HELP " << family.name << " " << family.help << "\n"
+			<< "# TYPE " << family.name << " counter\n";
+		for (size_t device = 0; device < metrics.devices.size(); device++)
+		{
+			out << family.name << "{" << labels[device] << "} " << metrics.devices[device].counters[family.counter] << "\n";
+		}
+	}
+
+	out << "# HELP yhkcatprint_queue_depth Print jobs queued and not yet finished.\n"
+		<< "# TYPE yhkcatprint_queue_depth gauge\n";
+	for (size_t device = 0; device < metrics.devices.size(); device++)
+	{
+		out << "yhkcatprint_queue_depth{" << labels[device] << "} " << metrics.devices[device].queueDepth << "\n";
+	}
+
+	return out.str();
+}
@@ -0,0 +1,424 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Metrics.h
+
+Abstract:
+	Per-device latency histograms and counters of the print path.
+
+--*/
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Metrics.h
+ * @brief Per-device latency histograms and counters of the print path.
+ *
+ * This header defines MetricsRegistry, which records how long each phase of
+ * printing takes, from enumerating radios and devices through connecting and
+ * the handshake to sending the raster, together with job, byte, retry and
+ * reconnect counts and the queue depth of every device. Recording is a few
+ * relaxed atomic increments, so it stays on in production; the registry can
+ * be read as a snapshot or dumped in the Prometheus text format.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Phases of a print timed per device.
+	 */
+	enum MetricPhase
+	{
+		/**
+		 * @brief Finding the device among paired devices.
+		 */
+		METRIC_PHASE_LOOKUP = 0,
+		/**
+		 * @brief Connecting, or leasing a link from the connection pool.
+		 */
+		METRIC_PHASE_CONNECT = 1,
+		/**
+		 * @brief Init, status and serial number handshake.
+		 */
+		METRIC_PHASE_HANDSHAKE = 2,
+		/**
+		 * @brief Sending the raster of a job, including waits for the printer.
+		 */
+		METRIC_PHASE_TRANSFER = 3,
+		/**
+		 * @brief Whole print call, from lookup to the last byte sent.
+		 */
+		METRIC_PHASE_JOB = 4,
+		/**
+		 * @brief Number of phases.
+		 */
+		METRIC_PHASE_COUNT = 5
+	};
+
+	/**
+	 * @brief Events counted per device.
+	 */
+	enum MetricCounter
+	{
+		/**
+		 * @brief Jobs sent.
+		 */
+		METRIC_COUNTER_JOBS = 0,
+		/**
+		 * @brief Jobs that failed.
+		 */
+		METRIC_COUNTER_FAILURES = 1,
+		/**
+		 * @brief Raster bytes sent, after encoding.
+		 */
+		METRIC_COUNTER_BYTES_SENT = 2,
+		/**
+		 * @brief Jobs sent again on a new link after the old one was lost before printing started.
+		 */
+		METRIC_COUNTER_RETRIES = 3,
+		/**
+		 * @brief Links set up again after the first one of a session.
+		 */
+		METRIC_COUNTER_RECONNECTS = 4,
+		/**
+		 * @brief Number of counters.
+		 */
+		METRIC_COUNTER_COUNT = 5
+	};
+
+	/**
+	 * @brief Enumerations timed for the whole process.
+	 */
+	enum MetricEnumeration
+	{
+		/**
+		 * @brief Enumerating Bluetooth radios.
+		 */
+		METRIC_ENUMERATION_RADIOS = 0,
+		/**
+		 * @brief Enumerating paired devices.
+		 */
+		METRIC_ENUMERATION_DEVICES = 1,
+		/**
+		 * @brief Number of enumerations.
+		 */
+		METRIC_ENUMERATION_COUNT = 2
+	};
+
+	/**
+	 * @brief Contents of a Histogram at one point in time.
+	 */
+	typedef struct _HISTOGRAM_SNAPSHOT
+	{
+		/**
+		 * @brief Number of values recorded.
+		 */
+		uint64_t count = 0;
+		/**
+		 * @brief Sum of the values recorded.
+		 */
+		uint64_t sum = 0;
+		/**
+		 * @brief Largest value recorded.
+		 */
+		uint64_t max = 0;
+		/**
+		 * @brief Number of values in each bucket, empty if none were recorded.
+		 */
+		std::vector<uint64_t> buckets;
+
+		/**
+		 * @brief Returns the value below or at which the given fraction of the values lies.
+		 *
+		 * The value is the top of the bucket holding it, at most max, so it
+		 * overstates the true one by less than the bucket resolution.
+		 *
+		 * @param quantile Fraction between 0 and 1.
+		 * @return Value, or 0 if none were recorded.
+		 */
+		uint64_t valueAt(double quantile) const noexcept;
+	} HISTOGRAM_SNAPSHOT;
+
+	/**
+	 * @brief Lock-free histogram of non-negative integers with constant relative precision.
+	 *
+	 * Values are counted in buckets laid out as in HdrHistogram: each power
+	 * of two is split into SUB_BUCKETS equal buckets, so a value is known to
+	 * within 1/SUB_BUCKETS of itself, about 6%, from nanoseconds to hours,
+	 * in a fixed table of counters. Recording is a few relaxed atomic
+	 * operations and never blocks.
+	 *
+	 * @note All methods are thread-safe. A snapshot taken while values are
+	 *       recorded may miss the latest of them.
+	 */
+	class Histogram
+	{
+	public:
+		/**
+		 * @brief Bits of a value kept below its leading one.
+		 */
+		static constexpr unsigned SUB_BUCKET_BITS = 4;
+
+		/**
+		 * @brief Buckets each power of two is split into.
+		 */
+		static constexpr size_t SUB_BUCKETS = size_t{ 1 } << SUB_BUCKET_BITS;
+
+		/**
+		 * @brief Number of buckets, enough for any 64-bit value.
+		 */
+		static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+		/**
+		 * @brief Constructs an empty Histogram.
+		 */
+		Histogram();
+
+		// Disable copy semantics
+		Histogram(const Histogram&) = delete;
+		Histogram& operator=(const Histogram&) = delete;
+
+		/**
+		 * @brief Records a value.
+		 */
+		void record(uint64_t value) noexcept;
+
+		/**
+		 * @brief Records a duration in nanoseconds; negative durations count as zero.
+		 */
+		void record(std::chrono::nanoseconds duration) noexcept;
+
+		/**
+		 * @brief Returns the values recorded so far.
+		 */
+		HISTOGRAM_SNAPSHOT snapshot() const;
+
+		/**
+		 * @brief Returns the bucket a value is counted in.
+		 */
+		static size_t bucketOf(uint64_t value) noexcept;
+
+		/**
+		 * @brief Returns the largest value counted in a bucket.
+		 */
+		static uint64_t bucketTop(size_t bucket) noexcept;
+
+	private:
+		/**
+		 * @brief Values counted per bucket.
+		 */
+		std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+		/**
+		 * @brief Sum of the values recorded.
+		 */
+		std::atomic<uint64_t> m_sum;
+		/**
+		 * @brief Largest value recorded.
+		 */
+		std::atomic<uint64_t> m_max;
+	};
+
+	/**
+	 * @brief Metrics of one device at one point in time.
+	 */
+	typedef struct _DEVICE_METRICS_SNAPSHOT
+	{
+		/**
+		 * @brief Address the device was printed to.
+		 */
+		std::string address;
+		/**
+		 * @brief Durations in nanoseconds, indexed by MetricPhase.
+		 */
+		std::array<HISTOGRAM_SNAPSHOT, METRIC_PHASE_COUNT> phases;
+		/**
+		 * @brief Counts, indexed by MetricCounter.
+		 */
+		std::array<uint64_t, METRIC_COUNTER_COUNT> counters = {};
+		/**
+		 * @brief Jobs queued and not yet finished.
+		 */
+		int64_t queueDepth = 0;
+	} DEVICE_METRICS_SNAPSHOT;
+
+	/**
+	 * @brief Metrics of the whole process at one point in time.
+	 */
+	typedef struct _METRICS_SNAPSHOT
+	{
+		/**
+		 * @brief Enumeration durations in nanoseconds, indexed by MetricEnumeration.
+		 */
+		std::array<HISTOGRAM_SNAPSHOT, METRIC_ENUMERATION_COUNT> enumerations;
+		/**
+		 * @brief Metrics of every device printed to, in the order they were first used.
+		 */
+		std::vector<DEVICE_METRICS_SNAPSHOT> devices;
+	} METRICS_SNAPSHOT;
+
+	/**
+	 * @brief Metrics of one device.
+	 *
+	 * Obtained from MetricsRegistry::device() and shared by all sessions and
+	 * queues printing to the device.
+	 *
+	 * @note All methods are thread-safe and lock-free.
+	 */
+	class DeviceMetrics
+	{
+	public:
+		/**
+		 * @brief Constructs empty metrics for a device.
+		 *
+		 * @param address Address of the device.
+		 */
+		explicit DeviceMetrics(std::string address);
+
+		// Disable copy semantics
+		DeviceMetrics(const DeviceMetrics&) = delete;
+		DeviceMetrics& operator=(const DeviceMetrics&) = delete;
+
+		/**
+		 * @brief Returns the address of the device.
+		 */
+		const std::string& address() const noexcept
+		{
+			return m_address;
+		}
+
+		/**
+		 * @brief Records how long a phase took.
+		 */
+		void record(MetricPhase phase, std::chrono::nanoseconds duration) noexcept
+		{
+			m_phases[phase].record(duration);
+		}
+
+		/**
+		 * @brief Adds to a counter.
+		 */
+		void add(MetricCounter counter, uint64_t value = 1) noexcept
+		{
+			m_counters[counter].fetch_add(value, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Adds to the queue depth; negative to take away.
+		 */
+		void addQueueDepth(int64_t jobs) noexcept
+		{
+			m_queueDepth.fetch_add(jobs, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Returns the metrics recorded so far.
+		 */
+		DEVICE_METRICS_SNAPSHOT snapshot() const;
+
+	private:
+		/**
+		 * @brief Address of the device.
+		 */
+		const std::string m_address;
+		/**
+		 * @brief Durations per phase.
+		 */
+		std::array<Histogram, METRIC_PHASE_COUNT> m_phases;
+		/**
+		 * @brief Counts per counter.
+		 */
+		std::array<std::atomic<uint64_t>, METRIC_COUNTER_COUNT> m_counters;
+		/**
+		 * @brief Jobs queued and not yet finished.
+		 */
+		std::atomic<int64_t> m_queueDepth;
+	};
+
+	/**
+	 * @brief Process-wide registry of print path metrics.
+	 *
+	 * Sessions look up the metrics of their device once, when constructed,
+	 * and record into them without locking from then on. Only that lookup
+	 * and reading the registry take a lock.
+	 *
+	 * There is one registry per process, so metrics of all sessions, queues
+	 * and schedulers end up in one place. It is never destroyed, so metrics
+	 * may be recorded from static and thread-local destructors.
+	 *
+	 * @note All methods are thread-safe.
+	 */
+	class MetricsRegistry
+	{
+	public:
+		/**
+		 * @brief Returns the registry of the process.
+		 */
+		static MetricsRegistry& instance();
+
+		// Disable copy semantics
+		MetricsRegistry(const MetricsRegistry&) = delete;
+		MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+		/**
+		 * @brief Returns the metrics of a device, creating them on first use.
+		 *
+		 * @param address Address of the device, as given to the session.
+		 * @return Metrics shared by everything printing to the device.
+		 */
+		std::shared_ptr<DeviceMetrics> device(const std::string& address);
+
+		/**
+		 * @brief Records how long an enumeration took.
+		 */
+		void record(MetricEnumeration enumeration, std::chrono::nanoseconds duration) noexcept
+		{
+			m_enumerations[enumeration].record(duration);
+		}
+
+		/**
+		 * @brief Returns the metrics recorded so far.
+		 */
+		METRICS_SNAPSHOT snapshot() const;
+
+		/**
+		 * @brief Returns the metrics recorded so far in the Prometheus text exposition format.
+		 *
+		 * Durations are exported as summaries in seconds with the 0.5, 0.9,
+		 * 0.99 and 0.999 quantiles, counts as counters and the queue depth
+		 * as a gauge, all labelled with the device address.
+		 */
+		std::string toPrometheus() const;
+
+	private:
+		MetricsRegistry() = default;
+
+		/**
+		 * @brief Enumeration durations.
+		 */
+		std::array<Histogram, METRIC_ENUMERATION_COUNT> m_enumerations;
+		/**
+		 * @brief Metrics by device address.
+		 */
+		std::unordered_map<std::string, std::shared_ptr<DeviceMetrics>> m_devices;
+		/**
+		 * @brief Metrics in the order the devices were first used.
+		 */
+		std::vector<std::shared_ptr<DeviceMetrics>> m_order;
+		/**
+		 * @brief Guards m_devices and m_order.
+		 */
+		mutable std::mutex m_mutex;
+	};
+}
@@ -0,0 +1,219 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintQueue.cpp
+
+Abstract:
+	Implementation of PrintQueue methods.
+
+--*/
+
+#include "PrintQueue.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+	/**
+	 * Calls a job's release callback when the job is done with, even if reporting its outcome threw.
+	 */
+	class ReleaseGuard
+	{
+	public:
+		explicit ReleaseGuard(std::function<void()>& release)
+			: m_release(release)
+		{
+		}
+
+		~ReleaseGuard()
+		{
+			if (!m_release)
+			{
+				return;
+			}
+			try
+			{
+				m_release();
+			}
+			catch (const std::exception& ex)
+			{
+				std::cerr << "Failed to release print job data: " << ex.what() << std::endl;
+			}
+			catch (...)
+			{
+				std::cerr << "Failed to release print job data." << std::endl;
+			}
+		}
+
+		// Disable copy semantics
+		ReleaseGuard(const ReleaseGuard&) = delete;
+		ReleaseGuard& operator=(const ReleaseGuard&) = delete;
+
+	private:
+		std::function<void()>& m_release;
+	};
+}
+
+yhkcatprint::PrintQueue::PrintQueue(std::shared_ptr<PrinterSession> session, size_t capacity, std::shared_ptr<IEventListener> listener,
+	std::shared_ptr<std::atomic<uint64_t>> jobIds)
+	: m_session(std::move(session)), m_metrics(m_session != nullptr ? m_session->metrics() : nullptr), m_listener(std::move(listener)), m_jobs(capacity), m_nextId(std::move(jobIds)),
+	m_unfinished(0), m_unfinishedBytes(0), m_stats()
+{
+	if (m_session == nullptr)
+	{
+		throw std::invalid_argument("Print queue needs a session");
+	}
+
+	if (m_nextId == nullptr)
+	{
+		m_nextId = std::make_shared<std::atomic<uint64_t>>(1);
+	}
+
+	m_worker = std::thread(&PrintQueue::run, this);
+}
+
+yhkcatprint::PrintQueue::~PrintQueue()
+{
+	close();
+}
+
+uint64_t yhkcatprint::PrintQueue::submit(std::vector<uint8_t> data)
+{
+	Job job;
+	job.buffer = std::move(data);
+	job.data = job.buffer.data();
+	job.size = job.buffer.size();
+	return enqueue(job);
+}
+
+uint64_t yhkcatprint::PrintQueue::submit(PooledBuffer data)
+{
+	Job job;
+	job.pooled = std::move(data);
+	job.data = job.pooled.data();
+	job.size = job.pooled.size();
+	return enqueue(job);
+}
+
+uint64_t yhkcatprint::PrintQueue::submit(const uint8_t* data, size_t size, std::function<void()> release)
+{
+	Job job;
+	job.data = data;
+	job.size = size;
+	job.release = std::move(release);
+	return enqueue(job);
+}
+
+size_t yhkcatprint::PrintQueue::pending() const
+{
+	return m_jobs.size();
+}
+
+yhkcatprint::QUEUE_STATS yhkcatprint::PrintQueue::stats() const
+{
+	QUEUE_STATS stats;
+	{
+		std::lock_guard<std::mutex> lock(m_statsMutex);
+		stats = m_stats;
+	}
+	stats.pending = m_unfinished.load(std::memory_order_relaxed);
+	stats.pendingBytes = m_unfinishedBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void yhkcatprint::PrintQueue::close()
+{
+	m_jobs.close();
+	if (m_worker.joinable())
+	{
+		m_worker.join();
+	}
+}
+
+uint64_t yhkcatprint::PrintQueue::enqueue(Job& job)
+{
+	job.id = m_nextId->fetch_add(1, std::memory_order_relaxed);
+	uint64_t id = job.id;
+	size_t size = job.size;
+
+	// Counted before the push, so the I/O thread never finishes a job that is not counted yet.
+	m_unfinished.fetch_add(1, std::memory_order_relaxed);
+	m_unfinishedBytes.fetch_add(size, std::memory_order_relaxed);
+	m_metrics->addQueueDepth(1);
+	if (!m_jobs.tryPush(job))
+	{
+		m_unfinished.fetch_sub(1, std::memory_order_relaxed);
+		m_unfinishedBytes.fetch_sub(size, std::memory_order_relaxed);
+		m_metrics->addQueueDepth(-1);
+		throw std::runtime_error("Print queue is full or closed");
+	}
+
+	return id;
+}
+
+void yhkcatprint::PrintQueue::run()
+{
+	while (auto job = m_jobs.pop())
+	{
+		ReleaseGuard release(job->release);
+		JOB_INFO info = { job->id, job->size, 0 };
+		auto started = std::chrono::steady_clock::now();
+		bool sent = false;
+		std::string error;
+
+		try
+		{
+			info.sentBytes = m_session->print(job->data, job->size).encodedBytes;
+			sent = true;
+		}
+		catch (const std::exception& ex)
+		{
+			error = ex.what();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_statsMutex);
+			m_stats.busy += std::chrono::steady_clock::now() - started;
+			if (sent)
+			{
+				m_stats.completed++;
+				m_stats.bytes += job->size;
+				m_stats.consecutiveFailures = 0;
+			}
+			else
+			{
+				m_stats.failed++;
+				m_stats.consecutiveFailures++;
+			}
+		}
+		m_unfinished.fetch_sub(1, std::memory_order_relaxed);
+		m_unfinishedBytes.fetch_sub(job->size, std::memory_order_relaxed);
+		m_metrics->addQueueDepth(-1);
+
+		if (m_listener)
+		{
+			// A throwing listener must neither stop the I/O thread nor skip the release.
+			try
+			{
+				if (sent)
+				{
+					m_listener->onJobCompleted(info);
+				}
+				else
+				{
+					m_listener->onJobFailed(info, { -1, error });
+				}
+			}
+			catch (const std::exception& ex)
+			{
+				std::cerr << "Print job listener failed: " << ex.what() << std::endl;
+			}
+			catch (...)
+			{
+				std::cerr << "Print job listener failed." << std::endl;
+			}
+		}
+	}
+}
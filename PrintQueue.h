@@ -0,0 +1,245 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintQueue.h
+
+Abstract:
+	Asynchronous print job queue drained by a dedicated I/O thread.
+
+--*/
+
+#pragma once
+#include "BoundedQueue.h"
+#include "BufferPool.h"
+#include "IEventListener.h"
+#include "PrinterSession.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file PrintQueue.h
+ * @brief Asynchronous print job queue drained by a dedicated I/O thread.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Print queue counters.
+	 */
+	typedef struct _QUEUE_STATS
+	{
+		/**
+		 * @brief Jobs waiting to be sent, including the one being sent.
+		 */
+		size_t pending = 0;
+		/**
+		 * @brief Raster bytes of the pending jobs.
+		 */
+		size_t pendingBytes = 0;
+		/**
+		 * @brief Jobs sent successfully.
+		 */
+		uint64_t completed = 0;
+		/**
+		 * @brief Jobs that could not be sent.
+		 */
+		uint64_t failed = 0;
+		/**
+		 * @brief Failed jobs since the last successful one.
+		 */
+		uint64_t consecutiveFailures = 0;
+		/**
+		 * @brief Raster bytes of the jobs sent successfully.
+		 */
+		uint64_t bytes = 0;
+		/**
+		 * @brief Time the I/O thread spent sending jobs.
+		 */
+		std::chrono::nanoseconds busy{ 0 };
+	} QUEUE_STATS;
+
+	/**
+	 * @brief Asynchronous print job queue for a single printer.
+	 *
+	 * Jobs are submitted from any thread and return a job handle immediately.
+	 * One I/O thread per queue sends them through the printer session in
+	 * submission order and reports the outcome to the event listener.
+	 *
+	 * @note Listener callbacks are invoked on the I/O thread.
+	 * @note All public methods are thread-safe.
+	 */
+	class PrintQueue
+	{
+	public:
+		/**
+		 * @brief Constructs a PrintQueue and starts its I/O thread.
+		 *
+		 * @param session Opened session to print through, kept alive by the queue until it is destroyed.
+		 * @param capacity Maximum number of jobs waiting to be sent.
+		 * @param listener Listener notified of job completion, may be nullptr.
+		 * @param jobIds Counter job handles are drawn from, shared by queues whose handles
+		 *               must not collide, or nullptr for a counter of the queue's own.
+		 *
+		 * @throws std::invalid_argument if session is nullptr.
+		 */
+		PrintQueue(std::shared_ptr<PrinterSession> session, size_t capacity, std::shared_ptr<IEventListener> listener,
+			std::shared_ptr<std::atomic<uint64_t>> jobIds = nullptr);
+
+		/**
+		 * @brief Destructor. Sends the remaining jobs and stops the I/O thread.
+		 *
+		 * Blocks like close() until the backlog has been printed.
+		 */
+		~PrintQueue();
+
+		// Disable copy semantics
+		PrintQueue(const PrintQueue&) = delete;
+		PrintQueue& operator=(const PrintQueue&) = delete;
+
+		/**
+		 * @brief Queues a job that owns its raster data.
+		 *
+		 * @param data Raster data, moved into the queue.
+		 * @return Handle identifying the job in listener callbacks.
+		 *
+		 * @throws std::runtime_error if the queue is full or closed.
+		 */
+		uint64_t submit(std::vector<uint8_t> data);
+
+		/**
+		 * @brief Queues a job whose raster data is on loan from the BufferPool.
+		 *
+		 * The buffer goes back to the pool once the job is sent, so that jobs
+		 * of similar size reuse the same memory.
+		 *
+		 * @param data Raster data, moved into the queue.
+		 * @return Handle identifying the job in listener callbacks.
+		 *
+		 * @throws std::runtime_error if the queue is full or closed.
+		 */
+		uint64_t submit(PooledBuffer data);
+
+		/**
+		 * @brief Queues a job that borrows its raster data.
+		 *
+		 * @param data Pointer to the raster data; must stay valid until release is called.
+		 * @param size Number of bytes of raster data.
+		 * @param release Called on the I/O thread once the data is no longer needed.
+		 * @return Handle identifying the job in listener callbacks.
+		 *
+		 * @throws std::runtime_error if the queue is full or closed; release is not called.
+		 */
+		uint64_t submit(const uint8_t* data, size_t size, std::function<void()> release);
+
+		/**
+		 * @brief Returns the number of jobs waiting to be sent.
+		 */
+		size_t pending() const;
+
+		/**
+		 * @brief Returns the queue counters.
+		 */
+		QUEUE_STATS stats() const;
+
+		/**
+		 * @brief Stops accepting jobs, sends the remaining ones and joins the I/O thread.
+		 *
+		 * Every job still pending is printed before the thread is joined, so
+		 * this blocks for as long as the backlog takes to print, including
+		 * the reconnect attempts of jobs to an unreachable printer.
+		 */
+		void close();
+
+	private:
+		/**
+		 * @brief Queued print job.
+		 */
+		struct Job
+		{
+			/**
+			 * @brief Job handle.
+			 */
+			uint64_t id;
+			/**
+			 * @brief Owned raster data, empty for borrowed and pooled jobs.
+			 */
+			std::vector<uint8_t> buffer;
+			/**
+			 * @brief Pooled raster data, empty for borrowed and owned jobs.
+			 */
+			PooledBuffer pooled;
+			/**
+			 * @brief Pointer to the raster data.
+			 */
+			const uint8_t* data;
+			/**
+			 * @brief Number of bytes of raster data.
+			 */
+			size_t size;
+			/**
+			 * @brief Releases borrowed raster data, empty for owned jobs.
+			 */
+			std::function<void()> release;
+		};
+
+		/**
+		 * @brief Queues a prepared job and assigns its handle.
+		 */
+		uint64_t enqueue(Job& job);
+
+		/**
+		 * @brief I/O thread body.
+		 */
+		void run();
+
+		/**
+		 * @brief Session jobs are printed through, shared with whoever opened it.
+		 */
+		std::shared_ptr<PrinterSession> m_session;
+		/**
+		 * @brief Metrics of the session's device, whose queue depth this queue keeps.
+		 */
+		std::shared_ptr<DeviceMetrics> m_metrics;
+		/**
+		 * @brief Listener notified of job outcomes.
+		 */
+		std::shared_ptr<IEventListener> m_listener;
+		/**
+		 * @brief Jobs waiting to be sent.
+		 */
+		BoundedQueue<Job> m_jobs;
+		/**
+		 * @brief Next job handle to assign.
+		 */
+		std::shared_ptr<std::atomic<uint64_t>> m_nextId;
+		/**
+		 * @brief Jobs submitted and not yet finished.
+		 */
+		std::atomic<size_t> m_unfinished;
+		/**
+		 * @brief Raster bytes of the jobs submitted and not yet finished.
+		 */
+		std::atomic<size_t> m_unfinishedBytes;
+		/**
+		 * @brief Guards m_stats.
+		 */
+		mutable std::mutex m_statsMutex;
+		/**
+		 * @brief Counters of finished jobs.
+		 */
+		QUEUE_STATS m_stats;
+		/**
+		 * @brief I/O thread.
+		 */
+		std::thread m_worker;
+	};
+}
@@ -0,0 +1,259 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintScheduler.cpp
+
+Abstract:
+	Implementation of PrintScheduler methods.
+
+--*/
+
+#include "PrintScheduler.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+	yhkcatprint::POOL_OPTIONS schedulerPoolOptions()
+	{
+		// Grown to a link per printer as printers are added.
+		yhkcatprint::POOL_OPTIONS options;
+		options.maxLinks = 1;
+		return options;
+	}
+}
+
+yhkcatprint::PrintScheduler::PrintScheduler(std::shared_ptr<IEventListener> listener, std::shared_ptr<DeviceRegistry> registry)
+	: m_pool(std::make_shared<ConnectionPool>(schedulerPoolOptions())), m_slots(0), m_listener(std::move(listener)), m_registry(std::move(registry)),
+	m_jobIds(std::make_shared<std::atomic<uint64_t>>(1))
+{
+}
+
+yhkcatprint::PrintScheduler::~PrintScheduler()
+{
+	close();
+}
+
+void yhkcatprint::PrintScheduler::addPrinter(const PRINTER_CONFIG& config)
+{
+	if (config.name.empty())
+	{
+		throw std::invalid_argument("Printer name is empty");
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto& printer : m_printers)
+		{
+			if (printer->config.name == config.name)
+			{
+				throw std::invalid_argument("Printer already registered: " + config.name);
+			}
+		}
+
+		// Every session holds its link while registered, so each printer needs a slot of its own.
+		m_slots++;
+		m_pool->setMaxLinks(m_slots);
+	}
+
+	auto printer = std::make_shared<Printer>();
+	printer->config = config;
+	printer->session = std::make_shared<PrinterSession>(config.address, config.channel, m_pool, m_registry);
+
+	// Connecting can take seconds and must not hold up jobs for the other printers.
+	try
+	{
+		printer->session->open();
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Printer " << config.name << " is not reachable yet: " << ex.what() << std::endl;
+	}
+
+	printer->queue = std::make_unique<PrintQueue>(printer->session, config.capacity, m_listener, m_jobIds);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		bool duplicate = false;
+		for (const auto& other : m_printers)
+		{
+			duplicate = duplicate || other->config.name == config.name;
+		}
+		if (!duplicate)
+		{
+			m_printers.push_back(printer);
+			return;
+		}
+	}
+
+	printer->queue->close();
+	printer->session->close();
+	releaseSlot();
+	throw std::invalid_argument("Printer already registered: " + config.name);
+}
+
+bool yhkcatprint::PrintScheduler::removePrinter(const std::string& name)
+{
+	std::shared_ptr<Printer> removed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto it = m_printers.begin(); it != m_printers.end(); ++it)
+		{
+			if ((*it)->config.name == name)
+			{
+				removed = *it;
+				m_printers.erase(it);
+				break;
+			}
+		}
+	}
+
+	if (removed == nullptr)
+	{
+		return false;
+	}
+
+	removed->queue->close();
+	removed->session->close();
+	releaseSlot();
+	return true;
+}
+
+uint64_t yhkcatprint::PrintScheduler::submit(const std::string& printer, std::vector<uint8_t> data)
+{
+	return target(printer)->queue->submit(std::move(data));
+}
+
+uint64_t yhkcatprint::PrintScheduler::submit(const std::string& printer, PooledBuffer data)
+{
+	return target(printer)->queue->submit(std::move(data));
+}
+
+uint64_t yhkcatprint::PrintScheduler::submitToGroup(const std::string& group, std::vector<uint8_t> data)
+{
+	return targetInGroup(group)->queue->submit(std::move(data));
+}
+
+uint64_t yhkcatprint::PrintScheduler::submitToGroup(const std::string& group, PooledBuffer data)
+{
+	return targetInGroup(group)->queue->submit(std::move(data));
+}
+
+std::vector<yhkcatprint::PRINTER_STATS> yhkcatprint::PrintScheduler::stats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<PRINTER_STATS> result;
+	result.reserve(m_printers.size());
+	for (const auto& printer : m_printers)
+	{
+		PRINTER_STATS stats;
+		stats.name = printer->config.name;
+		stats.address = printer->config.address;
+		stats.group = printer->config.group;
+		stats.queue = printer->queue->stats();
+		stats.state = printer->session->printerState();
+
+		double seconds = std::chrono::duration<double>(stats.queue.busy).count();
+		stats.bytesPerSecond = seconds > 0.0 ? static_cast<double>(stats.queue.bytes) / seconds : 0.0;
+		result.push_back(stats);
+	}
+	return result;
+}
+
+void yhkcatprint::PrintScheduler::close()
+{
+	std::vector<std::shared_ptr<Printer>> printers;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		printers.swap(m_printers);
+	}
+
+	for (const auto& printer : printers)
+	{
+		printer->queue->close();
+	}
+	for (const auto& printer : printers)
+	{
+		printer->session->close();
+	}
+}
+
+void yhkcatprint::PrintScheduler::releaseSlot()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_slots--;
+	if (m_slots > 0)
+	{
+		m_pool->setMaxLinks(m_slots);
+	}
+}
+
+std::shared_ptr<yhkcatprint::PrintScheduler::Printer> yhkcatprint::PrintScheduler::find(const std::string& printer)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto& candidate : m_printers)
+	{
+		if (candidate->config.name == printer)
+		{
+			return candidate;
+		}
+	}
+	for (const auto& candidate : m_printers)
+	{
+		if (candidate->config.address == printer)
+		{
+			return candidate;
+		}
+	}
+	return nullptr;
+}
+
+std::shared_ptr<yhkcatprint::PrintScheduler::Printer> yhkcatprint::PrintScheduler::target(const std::string& printer)
+{
+	std::shared_ptr<Printer> found = find(printer);
+	if (found == nullptr)
+	{
+		throw std::invalid_argument("Unknown printer: " + printer);
+	}
+	return found;
+}
+
+std::shared_ptr<yhkcatprint::PrintScheduler::Printer> yhkcatprint::PrintScheduler::targetInGroup(const std::string& group)
+{
+	std::shared_ptr<Printer> chosen;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		bool chosenFailing = true;
+		size_t chosenLoad = 0;
+		for (const auto& printer : m_printers)
+		{
+			if (printer->config.group != group)
+			{
+				continue;
+			}
+
+			// Only failed jobs count; the printer's status reply is not decoded reliably enough to route on.
+			QUEUE_STATS stats = printer->queue->stats();
+			bool failing = stats.consecutiveFailures > 0;
+			if (chosen == nullptr || (chosenFailing && !failing) || (failing == chosenFailing && stats.pendingBytes < chosenLoad))
+			{
+				chosen = printer;
+				chosenFailing = failing;
+				chosenLoad = stats.pendingBytes;
+			}
+		}
+	}
+
+	if (chosen == nullptr)
+	{
+		throw std::invalid_argument("No printers in group: " + group);
+	}
+
+	return chosen;
+}
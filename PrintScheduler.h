@@ -0,0 +1,290 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintScheduler.h
+
+Abstract:
+	Routing of print jobs across a fleet of printers.
+
+--*/
+
+#pragma once
+#include "ConnectionPool.h"
+#include "DeviceRegistry.h"
+#include "IEventListener.h"
+#include "BufferPool.h"
+#include "PrintQueue.h"
+#include "PrinterSession.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file PrintScheduler.h
+ * @brief Routing of print jobs across a fleet of printers.
+ *
+ * This header defines PrintScheduler, which keeps a PrintQueue per printer
+ * and routes jobs to a printer by name or address, or to the least loaded
+ * printer of a group.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Printer registered with a PrintScheduler.
+	 */
+	typedef struct _PRINTER_CONFIG
+	{
+		/**
+		 * @brief Logical name jobs can be routed by, unique within the scheduler.
+		 */
+		std::string name;
+		/**
+		 * @brief Bluetooth address in format "XX:XX:XX:XX:XX:XX", or an endpoint.
+		 */
+		std::string address;
+		/**
+		 * @brief RFCOMM channel number.
+		 */
+		uint8_t channel = 2;
+		/**
+		 * @brief Group for least-loaded routing, empty for none.
+		 */
+		std::string group;
+		/**
+		 * @brief Maximum number of jobs waiting for this printer.
+		 */
+		size_t capacity = 64;
+	} PRINTER_CONFIG;
+
+	/**
+	 * @brief Queue depth and throughput of one printer.
+	 */
+	typedef struct _PRINTER_STATS
+	{
+		/**
+		 * @brief Logical name of the printer.
+		 */
+		std::string name;
+		/**
+		 * @brief Address of the printer.
+		 */
+		std::string address;
+		/**
+		 * @brief Group of the printer.
+		 */
+		std::string group;
+		/**
+		 * @brief Queue counters.
+		 */
+		QUEUE_STATS queue;
+		/**
+		 * @brief Raster bytes sent per second of sending time, 0 before the first job.
+		 */
+		double bytesPerSecond = 0.0;
+		/**
+		 * @brief Last known state of the printer, as of its latest status report.
+		 */
+		PRINTER_STATE state;
+	} PRINTER_STATS;
+
+	/**
+	 * @brief Routes print jobs across a fleet of printers.
+	 *
+	 * Every printer has its own PrinterSession and PrintQueue, so printers
+	 * drain in parallel and a slow or jammed printer only holds up its own
+	 * jobs. Sessions keep their links for as long as they are registered,
+	 * leased from a ConnectionPool of the scheduler's own whose link cap
+	 * grows and shrinks with the number of printers, so neither a large
+	 * fleet nor sessions opened outside the scheduler wait for a slot.
+	 *
+	 * Group routing picks the printer with the fewest raster bytes still to
+	 * send. Printers whose last job failed are only picked when every
+	 * printer in the group is failing, so a printer that is out of paper
+	 * stops receiving group jobs until it prints again. Status reports do
+	 * not steer routing, since their layout is not verified.
+	 *
+	 * Job handles are unique across all printers of the scheduler.
+	 *
+	 * @note All public methods are thread-safe. Listener callbacks are
+	 *       invoked on the I/O threads of the printers.
+	 */
+	class PrintScheduler
+	{
+	public:
+		/**
+		 * @brief Constructs a PrintScheduler without printers.
+		 *
+		 * @param listener Listener notified of job outcomes, may be nullptr.
+		 * @param registry Paired devices the printers are looked up in, may be nullptr.
+		 */
+		explicit PrintScheduler(std::shared_ptr<IEventListener> listener, std::shared_ptr<DeviceRegistry> registry = nullptr);
+
+		/**
+		 * @brief Destructor. Sends the remaining jobs of every printer.
+		 */
+		~PrintScheduler();
+
+		// Disable copy semantics
+		PrintScheduler(const PrintScheduler&) = delete;
+		PrintScheduler& operator=(const PrintScheduler&) = delete;
+
+		/**
+		 * @brief Registers a printer and starts its I/O thread.
+		 *
+		 * The printer is connected right away if it can be reached; otherwise
+		 * its first job retries the connection.
+		 *
+		 * @param config Printer to add.
+		 *
+		 * @throws std::invalid_argument if the name is empty or already registered.
+		 */
+		void addPrinter(const PRINTER_CONFIG& config);
+
+		/**
+		 * @brief Unregisters a printer after sending its remaining jobs.
+		 *
+		 * @param name Logical name of the printer.
+		 * @return false if no printer has this name.
+		 */
+		bool removePrinter(const std::string& name);
+
+		/**
+		 * @brief Queues a job for one printer.
+		 *
+		 * @param printer Logical name or address of the printer.
+		 * @param data Raster data, moved into the queue.
+		 * @return Job handle.
+		 *
+		 * @throws std::invalid_argument if no printer has this name or address.
+		 * @throws std::runtime_error if the printer's queue is full.
+		 */
+		uint64_t submit(const std::string& printer, std::vector<uint8_t> data);
+
+		/**
+		 * @brief Queues a job for one printer, with raster data on loan from the BufferPool.
+		 *
+		 * @param printer Logical name or address of the printer.
+		 * @param data Raster data, moved into the queue.
+		 * @return Job handle.
+		 *
+		 * @throws std::invalid_argument if no printer has this name or address.
+		 * @throws std::runtime_error if the printer's queue is full.
+		 */
+		uint64_t submit(const std::string& printer, PooledBuffer data);
+
+		/**
+		 * @brief Queues a job for the least loaded printer of a group.
+		 *
+		 * @param group Printer group.
+		 * @param data Raster data, moved into the queue.
+		 * @return Job handle.
+		 *
+		 * @throws std::invalid_argument if the group has no printers.
+		 * @throws std::runtime_error if the chosen printer's queue is full.
+		 */
+		uint64_t submitToGroup(const std::string& group, std::vector<uint8_t> data);
+
+		/**
+		 * @brief Queues a job for the least loaded printer of a group, with raster data on loan from the BufferPool.
+		 *
+		 * @param group Printer group.
+		 * @param data Raster data, moved into the queue.
+		 * @return Job handle.
+		 *
+		 * @throws std::invalid_argument if the group has no printers.
+		 * @throws std::runtime_error if the chosen printer's queue is full.
+		 */
+		uint64_t submitToGroup(const std::string& group, PooledBuffer data);
+
+		/**
+		 * @brief Returns queue depth and throughput of every printer, in registration order.
+		 */
+		std::vector<PRINTER_STATS> stats();
+
+		/**
+		 * @brief Sends the remaining jobs and stops all I/O threads.
+		 */
+		void close();
+
+	private:
+		/**
+		 * @brief Registered printer.
+		 */
+		struct Printer
+		{
+			/**
+			 * @brief Printer configuration.
+			 */
+			PRINTER_CONFIG config;
+			/**
+			 * @brief Session jobs are printed through, shared with the queue.
+			 */
+			std::shared_ptr<PrinterSession> session;
+			/**
+			 * @brief Job queue and I/O thread; destroyed before the session.
+			 */
+			std::unique_ptr<PrintQueue> queue;
+		};
+
+		/**
+		 * @brief Gives up the pool slot of a printer that was removed or not added.
+		 */
+		void releaseSlot();
+
+		/**
+		 * @brief Finds a printer by name or address.
+		 *
+		 * @return Printer, or nullptr if none matches.
+		 */
+		std::shared_ptr<Printer> find(const std::string& printer);
+
+		/**
+		 * @brief Finds the printer to queue a job for by name or address.
+		 *
+		 * @throws std::invalid_argument if no printer has this name or address.
+		 */
+		std::shared_ptr<Printer> target(const std::string& printer);
+
+		/**
+		 * @brief Chooses the printer of a group to queue a job for: a healthy one before a failing one, then the least loaded.
+		 *
+		 * @throws std::invalid_argument if the group has no printers.
+		 */
+		std::shared_ptr<Printer> targetInGroup(const std::string& group);
+
+		/**
+		 * @brief Pool the printers' links are leased from, with a link per printer.
+		 */
+		std::shared_ptr<ConnectionPool> m_pool;
+		/**
+		 * @brief Printers registered or being added, which the pool's link cap covers.
+		 */
+		size_t m_slots;
+		/**
+		 * @brief Listener notified of job outcomes.
+		 */
+		std::shared_ptr<IEventListener> m_listener;
+		/**
+		 * @brief Paired devices the printers are looked up in.
+		 */
+		std::shared_ptr<DeviceRegistry> m_registry;
+		/**
+		 * @brief Counter job handles are drawn from, shared by all queues.
+		 */
+		std::shared_ptr<std::atomic<uint64_t>> m_jobIds;
+		/**
+		 * @brief Registered printers in registration order.
+		 */
+		std::vector<std::shared_ptr<Printer>> m_printers;
+		/**
+		 * @brief Guards m_printers and m_slots.
+		 */
+		std::mutex m_mutex;
+	};
+}
@@ -0,0 +1,667 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrinterSession.cpp
+
+Abstract:
+	Implementation of PrinterSession methods.
+
+--*/
+
+#include "PrinterSession.h"
+#include "BufferedReader.h"
+#include "BufferedWriter.h"
+#include "EscPos.h"
+#include "ProtoDevice.h"
+#ifdef _WIN32
+#include "ProtoAdapter.h"
+#endif
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+	namespace escpos = yhkcatprint::escpos;
+
+	constexpr auto getSerialCmd = escpos::getSerial();
+	constexpr auto startPrintCmd = escpos::startPrint();
+	constexpr auto endPrintCmd = escpos::END_PRINT;
+	// Room for both handshake replies and a status report arriving with them.
+	const size_t handshakeBufferSize = 128;
+
+	const char* describePaper(yhkcatprint::PaperState paper)
+	{
+		switch (paper)
+		{
+		case yhkcatprint::PAPER_STATE_LOW:
+			return "low";
+		case yhkcatprint::PAPER_STATE_OUT:
+			return "out";
+		default:
+			return "ok";
+		}
+	}
+
+	/**
+	 * Times a print call and counts it as a job, or as a failure unless it succeeded.
+	 */
+	class JobRecorder
+	{
+	public:
+		explicit JobRecorder(yhkcatprint::DeviceMetrics& metrics)
+			: m_metrics(metrics), m_started(std::chrono::steady_clock::now()), m_succeeded(false)
+		{
+		}
+
+		~JobRecorder()
+		{
+			if (!m_succeeded)
+			{
+				m_metrics.add(yhkcatprint::METRIC_COUNTER_FAILURES);
+			}
+		}
+
+		void succeeded(const yhkcatprint::ENCODE_STATS& stats) noexcept
+		{
+			m_metrics.record(yhkcatprint::METRIC_PHASE_JOB, std::chrono::steady_clock::now() - m_started);
+			m_metrics.add(yhkcatprint::METRIC_COUNTER_JOBS);
+			m_metrics.add(yhkcatprint::METRIC_COUNTER_BYTES_SENT, stats.encodedBytes);
+			m_succeeded = true;
+		}
+
+	private:
+		yhkcatprint::DeviceMetrics& m_metrics;
+		std::chrono::steady_clock::time_point m_started;
+		bool m_succeeded;
+	};
+
+	/**
+	 * Passes the data the reactor receives to the flow control, then to the monitor.
+	 */
+	class FlowListener : public yhkcatprint::IEventListener
+	{
+	public:
+		FlowListener(std::shared_ptr<yhkcatprint::FlowControl> flow, std::shared_ptr<yhkcatprint::IEventListener> monitor)
+			: m_flow(std::move(flow)), m_monitor(std::move(monitor))
+		{
+		}
+
+		void onDeviceConnected(const yhkcatprint::DEVICE_INFO& info) override
+		{
+			m_monitor->onDeviceConnected(info);
+		}
+
+		void onDeviceDisconnected(const yhkcatprint::DEVICE_INFO& info) override
+		{
+			m_monitor->onDeviceDisconnected(info);
+		}
+
+		void onSocketDateReceived(const yhkcatprint::IRfcommSocket& socket, const uint8_t* data, size_t size) override
+		{
+			m_flow->onReceived(data, size);
+			m_monitor->onSocketDateReceived(socket, data, size);
+		}
+
+		void onSocketClosed(const yhkcatprint::IRfcommSocket& socket) override
+		{
+			m_flow->onClosed();
+			m_monitor->onSocketClosed(socket);
+		}
+
+		void onError(yhkcatprint::ERROR_INFO error) override
+		{
+			m_monitor->onError(error);
+		}
+
+		void onJobCompleted(const yhkcatprint::JOB_INFO& job) override
+		{
+			m_monitor->onJobCompleted(job);
+		}
+
+		void onJobFailed(const yhkcatprint::JOB_INFO& job, yhkcatprint::ERROR_INFO error) override
+		{
+			m_monitor->onJobFailed(job, error);
+		}
+
+	private:
+		std::shared_ptr<yhkcatprint::FlowControl> m_flow;
+		std::shared_ptr<yhkcatprint::IEventListener> m_monitor;
+	};
+}
+
+yhkcatprint::PrinterSession::PrinterSession(const std::string& address, uint8_t channel, std::shared_ptr<ConnectionPool> pool,
+	std::shared_ptr<DeviceRegistry> registry)
+	: m_address(address), m_bluetoothAddress(BluetoothAddress::parse(address).value_or(BluetoothAddress())), m_channel(channel), m_opened(false), m_pool(std::move(pool)), m_registry(std::move(registry)), m_watched(false), m_flow(std::make_shared<FlowControl>()), m_handshakeDone(false), m_status{}, m_encoding(RASTER_ENCODING_RAW), m_trimTrailing(true), m_lastJob(), m_state(),
+	m_metrics(MetricsRegistry::instance().device(m_bluetoothAddress.isNull() ? m_address : m_bluetoothAddress.toString())), m_hadLink(false), m_arena()
+{
+	m_flow->setStatusCallback([this](std::span<const uint8_t> frame) { recordStatus(frame); });
+}
+
+yhkcatprint::PrinterSession::~PrinterSession()
+{
+	close();
+	m_flow->setStatusCallback(nullptr);
+}
+
+void yhkcatprint::PrinterSession::open()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_arena.reset();
+
+	// Set first, so that a printer that is off now is retried by the next print.
+	m_opened = true;
+
+	if (m_device == nullptr)
+	{
+		m_device = findDevice();
+	}
+
+	ensureConnected();
+}
+
+yhkcatprint::ENCODE_STATS yhkcatprint::PrinterSession::print(const uint8_t* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_arena.reset();
+	JobRecorder job(*m_metrics);
+
+	if (!m_opened)
+	{
+		throw std::runtime_error("Session not opened");
+	}
+
+	if (m_device == nullptr)
+	{
+		m_device = findDevice();
+	}
+
+	ensureConnected();
+
+	size_t sent = 0;
+	ENCODE_STATS stats;
+	auto started = std::chrono::steady_clock::now();
+	try
+	{
+		stats = sendJob(data, size, sent);
+	}
+	catch (const std::exception& ex)
+	{
+		disconnect();
+
+		// Once the socket took raster bytes past the start command, retrying would print part of the job twice.
+		size_t prologue = m_encoding == RASTER_ENCODING_RAW ? startPrintCmd.size() : 0;
+		if (sent > prologue)
+		{
+			throw;
+		}
+
+		std::cerr << "Link lost before print started, reconnecting: " << ex.what() << std::endl;
+		m_metrics->add(METRIC_COUNTER_RETRIES);
+		ensureConnected();
+		started = std::chrono::steady_clock::now();
+		sent = 0;
+		stats = sendJob(data, size, sent);
+	}
+	m_metrics->record(METRIC_PHASE_TRANSFER, std::chrono::steady_clock::now() - started);
+
+	recordJob(stats);
+	job.succeeded(stats);
+	return stats;
+}
+
+yhkcatprint::ENCODE_STATS yhkcatprint::PrinterSession::print(RasterStream& stream)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_arena.reset();
+	JobRecorder job(*m_metrics);
+
+	if (!m_opened)
+	{
+		throw std::runtime_error("Session not opened");
+	}
+
+	if (m_device == nullptr)
+	{
+		m_device = findDevice();
+	}
+
+	// Connecting overlaps with rendering the first band.
+	ensureConnected();
+
+	// A failure to render the first band leaves the link idle and usable.
+	std::span<const uint8_t> band = stream.next();
+
+	ENCODE_STATS stats;
+	auto started = std::chrono::steady_clock::now();
+	try
+	{
+		stats = sendStream(stream, band);
+	}
+	catch (...)
+	{
+		// The printer is somewhere in the middle of a job; only a new link resets it.
+		disconnect();
+		throw;
+	}
+	m_metrics->record(METRIC_PHASE_TRANSFER, std::chrono::steady_clock::now() - started);
+
+	recordJob(stats);
+	job.succeeded(stats);
+	return stats;
+}
+
+void yhkcatprint::PrinterSession::setEncoding(RasterEncoding encoding)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_encoding = encoding;
+}
+
+void yhkcatprint::PrinterSession::setTrimming(bool trimTrailing)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_trimTrailing = trimTrailing;
+}
+
+yhkcatprint::ENCODE_STATS yhkcatprint::PrinterSession::lastJobStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_lastJob;
+}
+
+void yhkcatprint::PrinterSession::setFlowControl(FLOW_CONTROL_CONFIG config)
+{
+	auto flow = std::make_shared<FlowControl>(config);
+	flow->setStatusCallback([this](std::span<const uint8_t> frame) { recordStatus(frame); });
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// The reactor's listener holds the old flow control, so the link is watched again with the new one.
+	bool watched = m_watched;
+	stopWatching();
+	m_flow->detach();
+	m_flow->setStatusCallback(nullptr);
+	m_flow = std::move(flow);
+	if (m_handshakeDone && m_socket != nullptr)
+	{
+		m_flow->attach(*m_socket, true, m_status);
+		if (watched && isLinkAlive())
+		{
+			startWatching();
+		}
+	}
+}
+
+yhkcatprint::FLOW_STATS yhkcatprint::PrinterSession::flowStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_flow->stats();
+}
+
+yhkcatprint::PRINTER_STATE yhkcatprint::PrinterSession::printerState()
+{
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	return m_state;
+}
+
+void yhkcatprint::PrinterSession::monitor(std::shared_ptr<SocketReactor> reactor, std::shared_ptr<IEventListener> listener)
+{
+	if (reactor != nullptr && listener == nullptr)
+	{
+		throw std::invalid_argument("Monitoring requires a listener");
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	stopWatching();
+	m_reactor = std::move(reactor);
+	m_monitor = m_reactor != nullptr ? std::move(listener) : nullptr;
+	if (m_handshakeDone && isLinkAlive())
+	{
+		startWatching();
+	}
+}
+
+void yhkcatprint::PrinterSession::close()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// A healthy link goes back to the pool; anything else is closed.
+	if (m_lease.socket() != nullptr && m_handshakeDone && isLinkAlive())
+	{
+		// The next holder of the link reads it itself.
+		stopWatching();
+		m_lease.release();
+		m_socket.reset();
+		m_handshakeDone = false;
+	}
+
+	disconnect();
+	m_device.reset();
+	m_opened = false;
+}
+
+bool yhkcatprint::PrinterSession::isConnected()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_handshakeDone && isLinkAlive();
+}
+
+std::shared_ptr<yhkcatprint::IDevice> yhkcatprint::PrinterSession::findDevice()
+{
+	auto started = std::chrono::steady_clock::now();
+	std::shared_ptr<IDevice> device;
+
+	// Network and loopback endpoints are not Bluetooth devices and need no discovery.
+	if (m_address.find("://") != std::string::npos)
+	{
+		device = std::make_shared<ProtoDevice>(m_address, m_address);
+	}
+	else if (m_registry != nullptr)
+	{
+		device = m_registry->find(m_bluetoothAddress);
+		if (device == nullptr && !m_bluetoothAddress.isNull())
+		{
+			// The printer may have been paired since the last refresh.
+			m_registry->refresh();
+			device = m_registry->find(m_bluetoothAddress);
+		}
+	}
+	else
+	{
+#ifdef _WIN32
+		ProtoAdapter adapter;
+
+		for (const auto& paired : adapter.getPairedDevices())
+		{
+			if (!m_bluetoothAddress.isNull() && paired->getInfo().bluetoothAddress == m_bluetoothAddress)
+			{
+				device = paired;
+				break;
+			}
+		}
+#else
+		throw std::runtime_error("Paired devices are only enumerated on Windows; look the printer up in a DeviceRegistry");
+#endif
+	}
+
+	if (device == nullptr)
+	{
+		throw std::runtime_error("Target device not found among paired devices: " + m_address);
+	}
+
+	m_metrics->record(METRIC_PHASE_LOOKUP, std::chrono::steady_clock::now() - started);
+	return device;
+}
+
+bool yhkcatprint::PrinterSession::isLinkAlive()
+{
+	if (m_socket == nullptr)
+	{
+		return false;
+	}
+
+	if (m_watched)
+	{
+		return m_reactor->isWatching(*m_socket);
+	}
+
+	try
+	{
+		uint8_t received[64];
+		while (m_socket->available())
+		{
+			size_t count = m_socket->receive(received, sizeof(received));
+			if (count == 0)
+			{
+				return false;
+			}
+			// Status reports the flow control has not read yet are not lost.
+			m_flow->onReceived(received, count);
+		}
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void yhkcatprint::PrinterSession::ensureConnected()
+{
+	if (m_handshakeDone && isLinkAlive())
+	{
+		return;
+	}
+
+	disconnect();
+
+	if (m_hadLink)
+	{
+		m_metrics->add(METRIC_COUNTER_RECONNECTS);
+	}
+
+	auto started = std::chrono::steady_clock::now();
+	DEVICE_INFO info = m_device->getInfo();
+	if (m_pool != nullptr)
+	{
+		m_lease = m_pool->acquire(*m_device, m_channel, TIMEOUT_DEFAULT, POOL_WAIT);
+		m_socket = m_lease.socket();
+		std::cout << (m_lease.isReused() ? "Reusing link to device: " : "Connected to device: ")
+			<< info.name << " [" << info.address << "]" << std::endl;
+	}
+	else
+	{
+		std::cout << "Connecting to device: " << info.name << " [" << info.address << "]" << std::endl;
+		m_socket = m_device->createRfcommSocket(m_channel, TIMEOUT_DEFAULT);
+	}
+	m_metrics->record(METRIC_PHASE_CONNECT, std::chrono::steady_clock::now() - started);
+
+	try
+	{
+		started = std::chrono::steady_clock::now();
+		handshake();
+		m_metrics->record(METRIC_PHASE_HANDSHAKE, std::chrono::steady_clock::now() - started);
+		m_hadLink = true;
+		startWatching();
+	}
+	catch (...)
+	{
+		disconnect();
+		throw;
+	}
+}
+
+void yhkcatprint::PrinterSession::handshake()
+{
+	// Init and the status query share one frame.
+	BufferedWriter writer(*m_socket, m_arena.allocate(BufferedWriter<IRfcommSocket>::DEFAULT_FRAME_SIZE));
+	BufferedReader reader(*m_socket, m_arena.allocate(handshakeBufferSize));
+	writer.write(escpos::HANDSHAKE);
+	writer.flush();
+	std::span<const uint8_t> status = reader.readExact(STATUS_SIZE, std::chrono::steady_clock::now() + RESPONSE_TIMEOUT);
+	std::copy(status.begin(), status.end(), m_status);
+	recordStatus(status);
+
+	writer.write(getSerialCmd);
+	writer.flush();
+	recordIdentity(reader.readExact(SERIAL_SIZE, std::chrono::steady_clock::now() + RESPONSE_TIMEOUT));
+
+	// Whatever came in behind the replies, such as a status report, is the flow control's to read.
+	m_flow->attach(*m_socket, true, m_status);
+	while (reader.buffered() > 0)
+	{
+		std::span<const uint8_t> rest = reader.peek();
+		m_flow->onReceived(rest.data(), rest.size());
+		reader.consume(rest.size());
+	}
+
+	PRINTER_STATE state = printerState();
+	if (state.hasIdentity)
+	{
+		std::cout << "Serial number: " << state.identity.serialNumber() << std::endl;
+	}
+	if (state.hasStatus && !state.status.valid)
+	{
+		std::cout << "Printer status (layout unverified): condition 0x" << std::hex << std::setw(2) << std::setfill('0')
+			<< static_cast<int>(state.status.condition) << std::dec << std::setfill(' ') << std::endl;
+	}
+	else if (state.hasStatus)
+	{
+		std::cout << "Printer status: paper " << describePaper(state.status.paper)
+			<< (state.status.overheated ? ", overheated" : "")
+			<< ", head " << static_cast<int>(state.status.temperature) << " C"
+			<< ", battery " << static_cast<int>(state.status.battery) << "%" << (state.status.charging ? " (charging)" : "")
+			<< ", firmware " << static_cast<int>(state.status.firmwareMajor) << "." << static_cast<int>(state.status.firmwareMinor) << std::endl;
+	}
+
+	m_handshakeDone = true;
+}
+
+void yhkcatprint::PrinterSession::recordStatus(std::span<const uint8_t> reply)
+{
+	std::optional<PRINTER_STATUS> status = decodeStatus(reply);
+	if (!status)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	m_state.status = *status;
+	m_state.hasStatus = true;
+	m_state.updated = std::chrono::steady_clock::now();
+}
+
+void yhkcatprint::PrinterSession::recordIdentity(std::span<const uint8_t> reply)
+{
+	std::optional<PRINTER_IDENTITY> identity = decodeIdentity(reply);
+	if (!identity)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_stateMutex);
+	m_state.identity = *identity;
+	m_state.hasIdentity = true;
+	m_state.updated = std::chrono::steady_clock::now();
+}
+
+void yhkcatprint::PrinterSession::startWatching()
+{
+	if (m_reactor == nullptr || m_watched)
+	{
+		return;
+	}
+
+	m_reactor->watch(m_socket, std::make_shared<FlowListener>(m_flow, m_monitor));
+	m_flow->setReadsSocket(false);
+	m_watched = true;
+}
+
+void yhkcatprint::PrinterSession::stopWatching() noexcept
+{
+	if (!m_watched)
+	{
+		return;
+	}
+
+	// The socket is no longer watched if the reactor has seen it close.
+	if (m_socket != nullptr)
+	{
+		m_reactor->unwatch(*m_socket);
+	}
+	m_flow->setReadsSocket(true);
+	m_watched = false;
+}
+
+yhkcatprint::ENCODE_STATS yhkcatprint::PrinterSession::sendJob(const uint8_t* data, size_t size, size_t& sent)
+{
+	if (m_encoding == RASTER_ENCODING_RAW)
+	{
+		// The whole raster is at hand, so the blank tail is cut off up front with one backward scan.
+		ENCODE_STATS stats;
+		stats.rasterBytes = size;
+		if (m_trimTrailing && size % ROW_BYTES == 0)
+		{
+			stats.trimmedRows = countTrailingBlankRows(data, size / ROW_BYTES, ROW_BYTES);
+		}
+		stats.encodedBytes = size - stats.trimmedRows * ROW_BYTES;
+
+		// Start command, raster and end feed go out in one vectored send, without copying the raster.
+		const std::span<const uint8_t> parts[] = { startPrintCmd, { data, stats.encodedBytes }, endPrintCmd };
+		BufferedWriter<FlowControl>::sendAll(*m_flow, parts, sent);
+		return stats;
+	}
+
+	BufferedWriter writer(*m_flow, m_arena.allocate(BufferedWriter<FlowControl>::DEFAULT_FRAME_SIZE));
+	RasterEncoder encoder(ROW_BYTES, m_encoding, m_trimTrailing);
+	try
+	{
+		encoder.encode(data, size, writer);
+		encoder.finish(writer);
+		writer.flush();
+	}
+	catch (...)
+	{
+		sent = writer.sent();
+		throw;
+	}
+	sent = writer.sent();
+	return encoder.stats();
+}
+
+yhkcatprint::ENCODE_STATS yhkcatprint::PrinterSession::sendStream(RasterStream& stream, std::span<const uint8_t> band)
+{
+	// Band tails share frames with the start of the next band.
+	BufferedWriter writer(*m_flow, m_arena.allocate(BufferedWriter<FlowControl>::DEFAULT_FRAME_SIZE));
+	RasterEncoder encoder(stream.rowBytes(), m_encoding, m_trimTrailing);
+	if (m_encoding == RASTER_ENCODING_RAW)
+	{
+		writer.write(startPrintCmd);
+	}
+	while (!band.empty())
+	{
+		encoder.encode(band.data(), band.size(), writer);
+		band = stream.next();
+	}
+	encoder.finish(writer);
+	if (m_encoding == RASTER_ENCODING_RAW)
+	{
+		writer.write(endPrintCmd);
+	}
+	writer.flush();
+	return encoder.stats();
+}
+
+void yhkcatprint::PrinterSession::recordJob(const ENCODE_STATS& stats)
+{
+	m_lastJob = stats;
+
+	if (stats.encodedBytes > 0)
+	{
+		std::cout << "Sent " << stats.rasterBytes << " raster bytes as " << stats.encodedBytes << " bytes ("
+			<< std::fixed << std::setprecision(2) << static_cast<double>(stats.rasterBytes) / stats.encodedBytes
+			<< std::defaultfloat << "x), " << stats.trimmedRows << " blank rows trimmed." << std::endl;
+	}
+}
+
+void yhkcatprint::PrinterSession::disconnect() noexcept
+{
+	stopWatching();
+	m_flow->detach();
+
+	if (m_lease.socket() != nullptr)
+	{
+		m_lease.discard();
+		m_socket.reset();
+	}
+	else if (m_socket != nullptr)
+	{
+		m_socket->close();
+		m_socket.reset();
+	}
+	m_handshakeDone = false;
+}
@@ -0,0 +1,440 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrinterSession.h
+
+Abstract:
+	Persistent connection to a single YHK printer.
+
+--*/
+
+#pragma once
+#include "Arena.h"
+#include "ConnectionPool.h"
+#include "DeviceRegistry.h"
+#include "FlowControl.h"
+#include "IDevice.h"
+#include "IEventListener.h"
+#include "IRfcommSocket.h"
+#include "Metrics.h"
+#include "PrinterStatus.h"
+#include "RasterEncoder.h"
+#include "RasterStream.h"
+#include "SocketReactor.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @file PrinterSession.h
+ * @brief Persistent connection to a single YHK printer.
+ *
+ * This header defines PrinterSession, which keeps an RFCOMM link and the
+ * printer handshake alive across print jobs.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Persistent connection to a single YHK printer.
+	 *
+	 * The device is looked up among paired devices once, when the session is
+	 * opened. The RFCOMM socket and the init/status/serial handshake are kept
+	 * for all subsequent print jobs. If the link drops, the session reconnects
+	 * lazily on the next print.
+	 *
+	 * With a connection pool, the link is leased from the pool and handed
+	 * back when the session is closed, so the next session to the same
+	 * printer skips the connect.
+	 *
+	 * With a socket reactor, status replies and other bytes the printer
+	 * sends unprompted are delivered to a listener as they arrive, instead
+	 * of being drained and dropped before the next job.
+	 *
+	 * Print jobs go out through a FlowControl, which paces them to the
+	 * printer's buffer once given its print speed and, if configured to
+	 * trust the status reports, learns the speed from them and holds jobs
+	 * while the printer is out of paper or overheated. By default neither
+	 * is known, and jobs go out unpaced. It reads the printer's status reports
+	 * itself, or gets them from the reactor while the link is monitored.
+	 *
+	 * The status and serial number replies of the handshake, and every
+	 * status report after it, are decoded into the printer's last known
+	 * state, which printerState() returns without asking the printer.
+	 *
+	 * Device lookup, connecting, the handshake and every job are timed, and
+	 * jobs, bytes, retries and reconnects counted, in the device's metrics
+	 * in the MetricsRegistry.
+	 *
+	 * @note All public methods are thread-safe; print jobs are serialized.
+	 */
+	class PrinterSession
+	{
+	public:
+		/**
+		 * @brief Size of the status reply to the status query, in bytes.
+		 */
+		static constexpr size_t STATUS_SIZE = escpos::STATUS_SIZE;
+
+		/**
+		 * @brief Size of the serial number reply to the serial query, in bytes.
+		 */
+		static constexpr size_t SERIAL_SIZE = escpos::SERIAL_SIZE;
+
+		/**
+		 * @brief Maximum time to wait for a handshake reply from the printer.
+		 */
+		static constexpr std::chrono::milliseconds RESPONSE_TIMEOUT{ 2000 };
+
+		/**
+		 * @brief Raster bytes per printed row, 384 dots on YHK printers.
+		 */
+		static constexpr size_t ROW_BYTES = 48;
+
+		/**
+		 * @brief Maximum time to wait for a pooled link when all are in use.
+		 */
+		static constexpr std::chrono::milliseconds POOL_WAIT{ 30000 };
+
+		/**
+		 * @brief Constructs a closed PrinterSession.
+		 *
+		 * @param address Bluetooth address of the printer in format "XX:XX:XX:XX:XX:XX",
+		 *                or an endpoint in format "tcp://host:port" or "loop://name".
+		 * @param channel RFCOMM channel number of the printer, ignored for endpoints.
+		 * @param pool Pool to lease the link from, or nullptr to connect and close it directly.
+		 * @param registry Paired devices to look the printer up in, or nullptr to enumerate them on open; enumeration is only available on Windows.
+		 */
+		PrinterSession(const std::string& address, uint8_t channel, std::shared_ptr<ConnectionPool> pool = nullptr,
+			std::shared_ptr<DeviceRegistry> registry = nullptr);
+
+		/**
+		 * @brief Destructor. Closes the session if open.
+		 */
+		~PrinterSession();
+
+		// Disable copy semantics
+		PrinterSession(const PrinterSession&) = delete;
+		PrinterSession& operator=(const PrinterSession&) = delete;
+
+		/**
+		 * @brief Looks up the printer, connects and performs the handshake.
+		 *
+		 * The session counts as opened even if this fails; the next print
+		 * then retries the lookup and the connection.
+		 *
+		 * @throws std::runtime_error if the printer is not paired or cannot be reached.
+		 */
+		void open();
+
+		/**
+		 * @brief Prints a raster buffer.
+		 *
+		 * Reconnects first if the link has dropped since the previous job.
+		 *
+		 * @param data Pointer to the raster data.
+		 * @param size Number of bytes of raster data.
+		 * @return Size of the raster and of its encoding on the wire.
+		 *
+		 * @pre The session has been opened.
+		 *
+		 * @throws std::runtime_error on failure to reconnect or send the job.
+		 */
+		ENCODE_STATS print(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Prints an image while it is being rasterized.
+		 *
+		 * Each band is sent as soon as the stream has rendered it, so the
+		 * printer starts feeding before the rest of the image exists. Unlike
+		 * print(const uint8_t*, size_t), a job is not retried after a link
+		 * failure, because the bands already sent cannot be produced again.
+		 *
+		 * @param stream Stream to print; it is consumed to the end.
+		 * @return Size of the raster and of its encoding on the wire.
+		 *
+		 * @pre The session has been opened.
+		 *
+		 * @throws std::runtime_error on failure to reconnect or send the job.
+		 * @throws std::exception rethrown from the stream if rendering failed.
+		 */
+		ENCODE_STATS print(RasterStream& stream);
+
+		/**
+		 * @brief Selects the wire format of subsequent jobs.
+		 *
+		 * Raw encoding, the default, works with every YHK printer. Image
+		 * encoding replaces blank rows with paper feeds, which makes text
+		 * receipts several times smaller, but needs firmware that accepts
+		 * GS v 0 raster images.
+		 *
+		 * @param encoding Wire format.
+		 */
+		void setEncoding(RasterEncoding encoding);
+
+		/**
+		 * @brief Selects whether blank rows at the end of subsequent jobs are printed.
+		 *
+		 * Trimming saves the paper and transfer time of a blank bottom
+		 * margin, such as the unused part of a fixed-height canvas. It is on
+		 * by default; a whole raw buffer is then cut off at its last inked
+		 * row with one backward scan before it is sent. The end-of-job feed
+		 * is sent either way: computed from the blank rows in image encoding,
+		 * and the fixed END_PRINT in raw encoding, where the printer would
+		 * take anything but the trailer for raster rows.
+		 *
+		 * @param trimTrailing true to drop trailing blank rows, false to print them.
+		 */
+		void setTrimming(bool trimTrailing);
+
+		/**
+		 * @brief Returns the statistics of the last job sent, all zero before the first one.
+		 */
+		ENCODE_STATS lastJobStats();
+
+		/**
+		 * @brief Replaces the flow control of subsequent jobs.
+		 *
+		 * The statistics and learned print speed of the previous flow control are discarded.
+		 *
+		 * @param config Flow control configuration; set enabled to false to send jobs unpaced.
+		 *
+		 * @throws std::invalid_argument if the configuration is invalid.
+		 */
+		void setFlowControl(FLOW_CONTROL_CONFIG config);
+
+		/**
+		 * @brief Returns the flow control statistics, counted since the session was constructed or setFlowControl() was called.
+		 */
+		FLOW_STATS flowStats();
+
+		/**
+		 * @brief Returns the last known state of the printer, without asking the printer.
+		 *
+		 * The state is kept across reconnects and does not wait for a job
+		 * in progress, so schedulers and health checks can poll it freely.
+		 */
+		PRINTER_STATE printerState();
+
+		/**
+		 * @brief Returns the metrics of the printer, shared with other sessions to the same address.
+		 */
+		std::shared_ptr<DeviceMetrics> metrics() const noexcept
+		{
+			return m_metrics;
+		}
+
+		/**
+		 * @brief Delivers the data the printer sends outside the handshake to a listener.
+		 *
+		 * The link is watched from the end of each handshake until it is
+		 * closed or dropped, including links connected again after a drop.
+		 * The listener runs on the reactor thread and must not call back into
+		 * the session, whose methods may be waiting for the reactor.
+		 *
+		 * @param reactor Reactor to watch the link on, or nullptr to stop monitoring.
+		 * @param listener Listener for the printer's data and the link closure; ignored without a reactor.
+		 *
+		 * @throws std::invalid_argument if a reactor is given without a listener.
+		 * @throws std::runtime_error if the current link cannot be watched.
+		 */
+		void monitor(std::shared_ptr<SocketReactor> reactor, std::shared_ptr<IEventListener> listener);
+
+		/**
+		 * @brief Closes the RFCOMM link, or returns it to the pool, and forgets the handshake state.
+		 *
+		 * @post The session must be opened again before printing.
+		 */
+		void close();
+
+		/**
+		 * @brief Checks whether the session currently holds a live link.
+		 *
+		 * @return true if the socket is connected and handshake completed.
+		 */
+		bool isConnected();
+
+	private:
+		/**
+		 * @brief Finds the printer among paired devices.
+		 *
+		 * Endpoint addresses bypass Bluetooth discovery. With a registry, the
+		 * paired devices are only enumerated again if the printer is not cached.
+		 *
+		 * @throws std::runtime_error if the device is not paired.
+		 */
+		std::shared_ptr<IDevice> findDevice();
+
+		/**
+		 * @brief Checks whether the socket is still connected.
+		 *
+		 * Drains any unsolicited bytes sent by the printer. A zero-length read
+		 * or a receive error means the remote end has closed the link. While
+		 * the link is watched, the reactor does the reading and drops the
+		 * link once it has closed.
+		 */
+		bool isLinkAlive();
+
+		/**
+		 * @brief Connects and performs the handshake if not already done.
+		 */
+		void ensureConnected();
+
+		/**
+		 * @brief Sends the init command, reads status and serial number and attaches the flow control to the link.
+		 *
+		 * @throws std::runtime_error if either reply is not complete within RESPONSE_TIMEOUT.
+		 */
+		void handshake();
+
+		/**
+		 * @brief Decodes a status reply into the last known state; a reply that does not decode is ignored.
+		 */
+		void recordStatus(std::span<const uint8_t> reply);
+
+		/**
+		 * @brief Decodes a serial number reply into the last known state; a reply that does not decode is ignored.
+		 */
+		void recordIdentity(std::span<const uint8_t> reply);
+
+		/**
+		 * @brief Hands the reads of the current link to the reactor, if monitoring.
+		 *
+		 * The reactor passes the printer's data to the flow control before the monitor.
+		 */
+		void startWatching();
+
+		/**
+		 * @brief Takes the reads of the current link back from the reactor.
+		 */
+		void stopWatching() noexcept;
+
+		/**
+		 * @brief Sends one print job over the current link.
+		 *
+		 * @param sent Set to the number of bytes the socket accepted, also when sending fails.
+		 * @return Size of the raster and of its encoding.
+		 */
+		ENCODE_STATS sendJob(const uint8_t* data, size_t size, size_t& sent);
+
+		/**
+		 * @brief Sends one streamed print job over the current link.
+		 *
+		 * @param stream Stream the remaining bands are taken from.
+		 * @param band First band, already taken from the stream.
+		 * @return Size of the raster and of its encoding.
+		 */
+		ENCODE_STATS sendStream(RasterStream& stream, std::span<const uint8_t> band);
+
+		/**
+		 * @brief Records and logs the statistics of a job that has been sent.
+		 */
+		void recordJob(const ENCODE_STATS& stats);
+
+		/**
+		 * @brief Closes the socket, discarding a pooled link, and resets the handshake state.
+		 */
+		void disconnect() noexcept;
+
+		/**
+		 * @brief Bluetooth address of the printer.
+		 */
+		std::string m_address;
+		/**
+		 * @brief Parsed Bluetooth address of the printer, null for endpoints.
+		 */
+		BluetoothAddress m_bluetoothAddress;
+		/**
+		 * @brief RFCOMM channel number of the printer.
+		 */
+		uint8_t m_channel;
+		/**
+		 * @brief Whether open() has been called since construction or the last close().
+		 */
+		bool m_opened;
+		/**
+		 * @brief Printer device, resolved on open or on the first print after a failed lookup.
+		 */
+		std::shared_ptr<IDevice> m_device;
+		/**
+		 * @brief Pool links are leased from, or nullptr.
+		 */
+		std::shared_ptr<ConnectionPool> m_pool;
+		/**
+		 * @brief Cache of paired devices, or nullptr.
+		 */
+		std::shared_ptr<DeviceRegistry> m_registry;
+		/**
+		 * @brief Lease on the pooled link, empty without a pool or when the link is down.
+		 */
+		ConnectionPool::Lease m_lease;
+		/**
+		 * @brief Connected socket, or nullptr when the link is down.
+		 */
+		std::shared_ptr<IRfcommSocket> m_socket;
+		/**
+		 * @brief Reactor the link is watched on, or nullptr when not monitoring.
+		 */
+		std::shared_ptr<SocketReactor> m_reactor;
+		/**
+		 * @brief Listener for the data the printer sends, or nullptr when not monitoring.
+		 */
+		std::shared_ptr<IEventListener> m_monitor;
+		/**
+		 * @brief Whether the current link is watched on m_reactor.
+		 */
+		bool m_watched;
+		/**
+		 * @brief Flow control print jobs are sent through, attached to the current link.
+		 */
+		std::shared_ptr<FlowControl> m_flow;
+		/**
+		 * @brief Whether the handshake has completed on the current link.
+		 */
+		bool m_handshakeDone;
+		/**
+		 * @brief Status reply captured during the last handshake.
+		 */
+		uint8_t m_status[STATUS_SIZE];
+		/**
+		 * @brief Wire format of print jobs.
+		 */
+		RasterEncoding m_encoding;
+		/**
+		 * @brief Whether blank rows at the end of print jobs are dropped.
+		 */
+		bool m_trimTrailing;
+		/**
+		 * @brief Statistics of the last job sent.
+		 */
+		ENCODE_STATS m_lastJob;
+		/**
+		 * @brief Last known state of the printer.
+		 */
+		PRINTER_STATE m_state;
+		/**
+		 * @brief Metrics of the printer in the MetricsRegistry.
+		 */
+		const std::shared_ptr<DeviceMetrics> m_metrics;
+		/**
+		 * @brief Whether a link has been set up before, so that the next one counts as a reconnect.
+		 */
+		bool m_hadLink;
+		/**
+		 * @brief Scratch memory of the current print, such as writer and reader buffers; reset by every open and print.
+		 */
+		Arena m_arena;
+		/**
+		 * @brief Serializes access to the link.
+		 */
+		std::mutex m_mutex;
+		/**
+		 * @brief Guards m_state, which is updated from status reports while m_mutex is held by a job.
+		 */
+		std::mutex m_stateMutex;
+	};
+}
@@ -0,0 +1,239 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrinterStatus.h
+
+Abstract:
+	Decoding of the printer's status and serial number replies.
+
+--*/
+
+#pragma once
+#include "EscPos.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+/**
+ * @file PrinterStatus.h
+ * @brief Decoding of the printer's status and serial number replies.
+ *
+ * This header defines PRINTER_STATUS and PRINTER_IDENTITY, the fields of
+ * the status and serial number replies, and the functions that decode
+ * them. Decoding reads the reply where it was received and fills plain
+ * structs, so it neither allocates nor blocks and can run on the thread
+ * that receives the reply.
+ *
+ * The status fields follow a layout that has not been verified against
+ * real printers. Decoded status keeps the reply as received and is marked
+ * valid only once escpos::STATUS_LAYOUT_VERIFIED is set; until then its
+ * fields are for display and diagnosis, not for decisions.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Paper supply as reported by the printer.
+	 */
+	enum PaperState
+	{
+		/**
+		 * @brief Paper is loaded.
+		 */
+		PAPER_STATE_OK = 0,
+		/**
+		 * @brief The paper roll is running low.
+		 */
+		PAPER_STATE_LOW = 1,
+		/**
+		 * @brief The paper roll is empty; the printer does not print.
+		 */
+		PAPER_STATE_OUT = 2
+	};
+
+	/**
+	 * @brief Decoded status reply.
+	 */
+	typedef struct _PRINTER_STATUS
+	{
+		/**
+		 * @brief Reply as received.
+		 */
+		std::array<uint8_t, escpos::STATUS_SIZE> raw = {};
+		/**
+		 * @brief Whether the fields below were decoded with a verified layout; false while escpos::STATUS_LAYOUT_VERIFIED is.
+		 */
+		bool valid = false;
+		/**
+		 * @brief Raw condition bits, see escpos::CONDITION_PAPER_OUT and following.
+		 */
+		uint8_t condition = 0;
+		/**
+		 * @brief Paper supply.
+		 */
+		PaperState paper = PAPER_STATE_OK;
+		/**
+		 * @brief Whether the print head is too hot to print.
+		 */
+		bool overheated = false;
+		/**
+		 * @brief Whether the receive buffer is past its high-water mark.
+		 */
+		bool bufferFull = false;
+		/**
+		 * @brief Print head temperature in degrees Celsius.
+		 */
+		int8_t temperature = 0;
+		/**
+		 * @brief Battery charge in percent.
+		 */
+		uint8_t battery = 0;
+		/**
+		 * @brief Whether the printer is charging.
+		 */
+		bool charging = false;
+		/**
+		 * @brief Firmware major version.
+		 */
+		uint8_t firmwareMajor = 0;
+		/**
+		 * @brief Firmware minor version.
+		 */
+		uint8_t firmwareMinor = 0;
+
+		/**
+		 * @brief Checks whether the print head is known to be stopped, that is the printer is out of paper or overheated.
+		 *
+		 * @return false unless the status is valid.
+		 */
+		constexpr bool isHeadStopped() const noexcept
+		{
+			return valid && (condition & escpos::CONDITION_HEAD_STOPPED) != 0;
+		}
+	} PRINTER_STATUS;
+
+	/**
+	 * @brief Decoded serial number reply.
+	 */
+	typedef struct _PRINTER_IDENTITY
+	{
+		/**
+		 * @brief Serial number in ASCII, NUL-terminated.
+		 */
+		char serial[escpos::SERIAL_SIZE + 1] = {};
+		/**
+		 * @brief Length of the serial number.
+		 */
+		size_t serialLength = 0;
+
+		/**
+		 * @brief Returns the serial number.
+		 */
+		constexpr std::string_view serialNumber() const noexcept
+		{
+			return std::string_view(serial, serialLength);
+		}
+	} PRINTER_IDENTITY;
+
+	/**
+	 * @brief Last known state of a printer.
+	 */
+	typedef struct _PRINTER_STATE
+	{
+		/**
+		 * @brief Last status reply, valid if hasStatus.
+		 */
+		PRINTER_STATUS status;
+		/**
+		 * @brief Identity from the last handshake, valid if hasIdentity.
+		 */
+		PRINTER_IDENTITY identity;
+		/**
+		 * @brief Whether a status reply has been decoded.
+		 */
+		bool hasStatus = false;
+		/**
+		 * @brief Whether a serial number reply has been decoded.
+		 */
+		bool hasIdentity = false;
+		/**
+		 * @brief When the status or identity was last decoded.
+		 */
+		std::chrono::steady_clock::time_point updated;
+	} PRINTER_STATE;
+
+	/**
+	 * @brief Decodes a status reply.
+	 *
+	 * @param reply Received reply.
+	 * @return Decoded status, valid only if escpos::STATUS_LAYOUT_VERIFIED is set,
+	 *         or std::nullopt if the reply is not escpos::STATUS_SIZE bytes long.
+	 */
+	constexpr std::optional<PRINTER_STATUS> decodeStatus(std::span<const uint8_t> reply) noexcept
+	{
+		if (reply.size() != escpos::STATUS_SIZE)
+		{
+			return std::nullopt;
+		}
+
+		PRINTER_STATUS status;
+		std::copy(reply.begin(), reply.end(), status.raw.begin());
+		status.valid = escpos::STATUS_LAYOUT_VERIFIED;
+		status.condition = reply[escpos::STATUS_CONDITION];
+		status.paper = (status.condition & escpos::CONDITION_PAPER_OUT) != 0 ? PAPER_STATE_OUT
+			: (status.condition & escpos::CONDITION_PAPER_LOW) != 0 ? PAPER_STATE_LOW
+			: PAPER_STATE_OK;
+		status.overheated = (status.condition & escpos::CONDITION_OVERHEATED) != 0;
+		status.bufferFull = (status.condition & escpos::CONDITION_BUFFER_FULL) != 0;
+		status.temperature = static_cast<int8_t>(reply[escpos::STATUS_TEMPERATURE]);
+		status.battery = reply[escpos::STATUS_BATTERY] & static_cast<uint8_t>(~escpos::BATTERY_CHARGING);
+		status.charging = (reply[escpos::STATUS_BATTERY] & escpos::BATTERY_CHARGING) != 0;
+		status.firmwareMajor = reply[escpos::STATUS_FIRMWARE_MAJOR];
+		status.firmwareMinor = reply[escpos::STATUS_FIRMWARE_MINOR];
+		return status;
+	}
+
+	/**
+	 * @brief Decodes a serial number reply.
+	 *
+	 * The serial number runs up to the first NUL byte or the end of the reply.
+	 *
+	 * @param reply Received reply.
+	 * @return Decoded identity, or std::nullopt if the reply is not escpos::SERIAL_SIZE bytes long,
+	 *         the serial number is empty or it holds anything but printable ASCII.
+	 */
+	constexpr std::optional<PRINTER_IDENTITY> decodeIdentity(std::span<const uint8_t> reply) noexcept
+	{
+		if (reply.size() != escpos::SERIAL_SIZE)
+		{
+			return std::nullopt;
+		}
+
+		PRINTER_IDENTITY identity;
+		for (uint8_t byte : reply)
+		{
+			if (byte == 0)
+			{
+				break;
+			}
+			if (byte < 0x20 || byte > 0x7e)
+			{
+				return std::nullopt;
+			}
+			identity.serial[identity.serialLength++] = static_cast<char>(byte);
+		}
+
+		if (identity.serialLength == 0)
+		{
+			return std::nullopt;
+		}
+		return identity;
+	}
+}
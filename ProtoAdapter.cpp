@@ -12,10 +12,10 @@ Abstract:
 
 #include "ProtoAdapter.h"
 #include "ProtoDevice.h"
+#include "Metrics.h"
+#include <chrono>
 #include <stdexcept>
-#include <sstream>
 #include <iostream>
-#include <iomanip>
 
 yhkcatprint::ADAPTER_INFO yhkcatprint::ProtoAdapter::getInfo()
 {
@@ -40,7 +40,8 @@ yhkcatprint::ADAPTER_INFO yhkcatprint::ProtoAdapter::getInfo()
 	BluetoothFindRadioClose(hFind);
 	CloseHandle(hRadio);
 	ADAPTER_INFO info;
-	info.address = formatBthAddr(radioInfo.address.ullLong);
+	info.bluetoothAddress = BluetoothAddress(radioInfo.address.ullLong);
+	info.address = info.bluetoothAddress.toString();
 	info.name = wideStringToString(radioInfo.szName);
 
 	return info;
@@ -48,6 +49,7 @@ yhkcatprint::ADAPTER_INFO yhkcatprint::ProtoAdapter::getInfo()
 
 std::vector<std::shared_ptr<yhkcatprint::IDevice>> yhkcatprint::ProtoAdapter::getPairedDevices()
 {
+	auto started = std::chrono::steady_clock::now();
 	std::vector<std::shared_ptr<IDevice>> devices;
 
 	BLUETOOTH_DEVICE_SEARCH_PARAMS searchParams = { sizeof(BLUETOOTH_DEVICE_SEARCH_PARAMS) };
@@ -63,18 +65,24 @@ std::vector<std::shared_ptr<yhkcatprint::IDevice>> yhkcatprint::ProtoAdapter::ge
 
 	if (hFind == nullptr)
 	{
+		// No paired devices is a valid answer, not a failure.
+		if (GetLastError() == ERROR_NO_MORE_ITEMS)
+		{
+			MetricsRegistry::instance().record(METRIC_ENUMERATION_DEVICES, std::chrono::steady_clock::now() - started);
+			return devices;
+		}
 		throw std::runtime_error("Failed to find Bluetooth devices.");
 	}
 
 	do
 	{
-		std::string address = formatBthAddr(deviceInfo.Address.ullLong);
 		std::string name = wideStringToString(deviceInfo.szName);
-		devices.push_back(std::make_shared<ProtoDevice>(address, name));
+		devices.push_back(std::make_shared<ProtoDevice>(BluetoothAddress(deviceInfo.Address.ullLong), name));
 	} while (BluetoothFindNextDevice(hFind, &deviceInfo));
 
 	BluetoothFindDeviceClose(hFind);
 
+	MetricsRegistry::instance().record(METRIC_ENUMERATION_DEVICES, std::chrono::steady_clock::now() - started);
 	return devices;
 }
 
@@ -82,17 +90,4 @@ std::string yhkcatprint::ProtoAdapter::wideStringToString(const std::wstring& ws
 {
 	std::string str(wstr.begin(), wstr.end());
 	return str;
-}
-
-std::string yhkcatprint::ProtoAdapter::formatBthAddr(const BTH_ADDR& addr)
-{
-	std::ostringstream oss;
-	oss << std::hex << std::setfill('0')
-		<< std::setw(2) << ((addr >> 40) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 32) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 24) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 16) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 8) & 0xFF) << ":"
-		<< std::setw(2) << (addr & 0xFF);
-	return oss.str();
 }
\ No newline at end of file
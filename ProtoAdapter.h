@@ -63,13 +63,6 @@ namespace yhkcatprint {
 		 * @return The converted standard string.
 		 */
 		static std::string wideStringToString(const std::wstring& wstr);
-
-		/**
-		 * @brief Formats a BTH_ADDR into a human-readable MAC address string.
-		 * @param addr The BTH_ADDR to format.
-		 * @return The formatted MAC address string in the format "XX:XX:XX:XX:XX:XX".
-		 */
-		static std::string formatBthAddr(const BTH_ADDR& addr);
 	};
 }
 
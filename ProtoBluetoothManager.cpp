@@ -12,7 +12,9 @@ Abstract:
 
 #include "ProtoBluetoothManager.h"
 #include "ProtoAdapter.h"
+#include "Metrics.h"
 #include <bluetoothapis.h>
+#include <chrono>
 #include <stdexcept>
 #include <ranges>
 #include <vector>
@@ -21,6 +23,7 @@ Abstract:
 
 yhkcatprint::ProtoBluetoothManager::ProtoBluetoothManager()
 {
+	auto started = std::chrono::steady_clock::now();
 	BLUETOOTH_FIND_RADIO_PARAMS params = { sizeof(BLUETOOTH_FIND_RADIO_PARAMS) };
 	HANDLE hRadio = nullptr;
 	HBLUETOOTH_RADIO_FIND hFind = BluetoothFindFirstRadio(&params, &hRadio);
@@ -28,6 +31,7 @@ yhkcatprint::ProtoBluetoothManager::ProtoBluetoothManager()
 	if (hFind == nullptr)
 	{
 		std::cout << "No Bluetooth adapters found on this device." << std::endl;
+		MetricsRegistry::instance().record(METRIC_ENUMERATION_RADIOS, std::chrono::steady_clock::now() - started);
 		return;
 	}
 
@@ -40,7 +44,8 @@ yhkcatprint::ProtoBluetoothManager::ProtoBluetoothManager()
 		if (result == ERROR_SUCCESS)
 		{
 			yhkcatprint::ADAPTER_INFO info;
-			info.address = formatBthAddr(radioInfo.address.ullLong);
+			info.bluetoothAddress = BluetoothAddress(radioInfo.address.ullLong);
+			info.address = info.bluetoothAddress.toString();
 			info.name = wideStringToString(radioInfo.szName);
 			adapters.push_back(std::make_shared<ProtoAdapter>());
 		}
@@ -53,6 +58,8 @@ yhkcatprint::ProtoBluetoothManager::ProtoBluetoothManager()
 
 	} while (BluetoothFindNextRadio(hFind, &hRadio));
 	BluetoothFindRadioClose(hFind);
+
+	MetricsRegistry::instance().record(METRIC_ENUMERATION_RADIOS, std::chrono::steady_clock::now() - started);
 }
 
 std::vector<yhkcatprint::ADAPTER_INFO> yhkcatprint::ProtoBluetoothManager::listAdapters()
@@ -80,9 +87,16 @@ std::shared_ptr<yhkcatprint::IAdapter> yhkcatprint::ProtoBluetoothManager::getAd
 std::shared_ptr<yhkcatprint::IAdapter> yhkcatprint::ProtoBluetoothManager::getAdapter(
 	const std::string& adapterAddress)
 {
+	// Parsed once, so the comparison ignores case and does not depend on how adapters format addresses.
+	std::optional<BluetoothAddress> target = BluetoothAddress::parse(adapterAddress);
+	if (!target)
+	{
+		return nullptr;
+	}
+
 	auto result = std::ranges::find_if(adapters, [&](const std::shared_ptr<IAdapter>& adapter)
 		{
-			return adapter && adapter->getInfo().address == adapterAddress;
+			return adapter && adapter->getInfo().bluetoothAddress == *target;
 		});
 
 	return result != std::ranges::end(adapters) ? *result : nullptr;
@@ -97,17 +111,5 @@ void yhkcatprint::ProtoBluetoothManager::shutdown()
 std::string yhkcatprint::ProtoBluetoothManager::wideStringToString(const std::wstring& wstr)
 {
 	std::string str(wstr.begin(), wstr.end());
+	return str;
 }
-
-std::string yhkcatprint::ProtoBluetoothManager::formatBthAddr(const BTH_ADDR& addr)
-{
-	std::ostringstream oss;
-	oss << std::hex << std::setfill('0')
-		<< std::setw(2) << ((addr >> 40) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 32) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 24) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 16) & 0xFF) << ":"
-		<< std::setw(2) << ((addr >> 8) & 0xFF) << ":"
-		<< std::setw(2) << (addr & 0xFF);
-	return oss.str();
-}
\ No newline at end of file
@@ -64,13 +64,5 @@ namespace yhkcatprint
 		 * @return The converted standard string.
 		 */
 		static std::string wideStringToString(const std::wstring& wstr);
-
-		/**
-		 * @brief Formats a BTH_ADDR into a human-readable string.
-		 * 
-		 * @param addr The BTH_ADDR to format.
-		 * @return Formatted Bluetooth address string in "XX:XX:XX:XX:XX:XX" format.
-		 */
-		static std::string formatBthAddr(const BTH_ADDR& addr);
 	};
 }
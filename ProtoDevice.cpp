@@ -11,29 +11,63 @@ Abstract:
 --*/
 
 #include "ProtoDevice.h"
+#include "LoopbackSocket.h"
+#ifdef _WIN32
 #include "ProtoRfcommSocket.h"
+#include "ProtoTcpSocket.h"
+#endif
 #include <chrono>
 #include <stdexcept>
 
 yhkcatprint::ProtoDevice::ProtoDevice(const std::string& address, const std::string& name)
-	: deviceAddress(address), deviceName(name)
+	: deviceAddress(address), bluetoothAddress(BluetoothAddress::parse(address).value_or(BluetoothAddress())), deviceName(name)
+{
+}
+
+yhkcatprint::ProtoDevice::ProtoDevice(BluetoothAddress address, const std::string& name)
+	: deviceAddress(address.toString()), bluetoothAddress(address), deviceName(name)
 {
 }
 
 yhkcatprint::DEVICE_INFO yhkcatprint::ProtoDevice::getInfo()
 {
-	return { deviceAddress, deviceName };
+	return { deviceAddress, deviceName, bluetoothAddress };
 }
 
 std::shared_ptr<yhkcatprint::IRfcommSocket> yhkcatprint::ProtoDevice::createRfcommSocket(
 	uint8_t channel, yhkcatprint::ConnectOptions options)
 {
-	if (channel < 1 || channel > 30)
+	std::shared_ptr<IRfcommSocket> socket;
+
+	// Scheme-qualified addresses select a non-Bluetooth transport; the channel is ignored.
+	// Outside Windows only the in-process loopback is available here; Linux links go through the module API.
+	if (deviceAddress.rfind(LoopbackListener::SCHEME, 0) == 0)
 	{
-		throw std::invalid_argument("Invalid RFCOMM channel number");
+		socket = std::make_shared<LoopbackSocket>(deviceAddress, channel);
 	}
-
-	auto socket = std::make_shared<ProtoRfcommSocket>(deviceAddress, channel);
+#ifdef _WIN32
+	else if (deviceAddress.rfind(ProtoTcpSocket::SCHEME, 0) == 0)
+	{
+		socket = std::make_shared<ProtoTcpSocket>(deviceAddress, channel);
+	}
+	else
+	{
+		if (channel < 1 || channel > 30)
+		{
+			throw std::invalid_argument("Invalid RFCOMM channel number");
+		}
+		if (bluetoothAddress.isNull())
+		{
+			throw std::invalid_argument("Invalid Bluetooth address format");
+		}
+		socket = std::make_shared<ProtoRfcommSocket>(bluetoothAddress, channel);
+	}
+#else
+	else
+	{
+		throw std::runtime_error("Only loopback endpoints are supported on this platform: " + deviceAddress);
+	}
+#endif
 
 	switch (options)
 	{
@@ -43,6 +77,7 @@ std::shared_ptr<yhkcatprint::IRfcommSocket> yhkcatprint::ProtoDevice::createRfco
 
 	case TIMEOUT_LONG:
 		socket->connect(std::chrono::seconds(30));
+		break;
 
 	case TIMEOUT_NONE:
 		[[fallthrough]];
@@ -44,6 +44,13 @@ namespace yhkcatprint
 		 */
 		ProtoDevice(const std::string& address, const std::string& name);
 
+		/**
+		 * @brief Constructs a ProtoDevice for a Bluetooth device.
+		 * @param address Bluetooth address of the device.
+		 * @param name Human-readable device name
+		 */
+		ProtoDevice(BluetoothAddress address, const std::string& name);
+
 		/**
 		 * @brief Virtual destructor.
 		 */
@@ -58,6 +65,10 @@ namespace yhkcatprint
 		 * @brief Device bluetooth MAC address
 		 */
 		std::string deviceAddress;
+		/**
+		 * @brief Device Bluetooth address, null for network and loopback endpoints
+		 */
+		BluetoothAddress bluetoothAddress;
 		/**
 		 * @brief Human-readable device name
 		 */
@@ -11,19 +11,29 @@ Abstract:
 --*/
 
 #include "ProtoRfcommSocket.h"
+#include <algorithm>
+#include <climits>
 #include <stdexcept>
 #include <vector>
-#include <sstream>
-#include <iomanip>
 #include <iostream>
 
+namespace
+{
+	const DWORD maxSendBuffers = 16;
+}
+
 yhkcatprint::ProtoRfcommSocket::ProtoRfcommSocket(const std::string& address, uint8_t channel)
+	: ProtoRfcommSocket(BluetoothAddress::fromString(address), channel)
+{
+}
+
+yhkcatprint::ProtoRfcommSocket::ProtoRfcommSocket(BluetoothAddress address, uint8_t channel)
 	: m_socket(INVALID_SOCKET), m_connected(false)
 {
 	ensureWinsockInit();
 	std::memset(&m_addr, 0, sizeof(m_addr));
 	m_addr.addressFamily = AF_BTH;
-	m_addr.btAddr = strToBthAddr(address);
+	m_addr.btAddr = static_cast<BTH_ADDR>(address.value());
 	m_addr.serviceClassId = RFCOMM_PROTOCOL_UUID;
 	m_addr.port = static_cast<ULONG>(channel);
 
@@ -51,8 +61,33 @@ void yhkcatprint::ProtoRfcommSocket::connect()
 
 void yhkcatprint::ProtoRfcommSocket::connect(std::chrono::nanoseconds timeout)
 {
-	// For simplicity, ignoring timeout implementation in this example
-	connect();
+	if (m_connected) {
+		throw std::runtime_error("Socket already connected");
+	}
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	setNonBlocking(true);
+	if (::connect(m_socket, reinterpret_cast<SOCKADDR*>(&m_addr), sizeof(m_addr)) == SOCKET_ERROR) {
+		if (WSAGetLastError() != WSAEWOULDBLOCK) {
+			recreateSocket();
+			throw std::runtime_error("Failed to connect to the device");
+		}
+
+		bool ready = false;
+		try {
+			ready = waitReady(true, deadline);
+		}
+		catch (const std::exception&) {
+			recreateSocket();
+			throw std::runtime_error("Failed to connect to the device");
+		}
+		if (!ready) {
+			recreateSocket();
+			throw std::runtime_error("Timed out connecting to the device");
+		}
+	}
+	setNonBlocking(false);
+	m_connected = true;
 }
 
 size_t yhkcatprint::ProtoRfcommSocket::send(const uint8_t* data, size_t size)
@@ -67,6 +102,80 @@ size_t yhkcatprint::ProtoRfcommSocket::send(const uint8_t* data, size_t size)
 	return static_cast<size_t>(bytesSent);
 }
 
+size_t yhkcatprint::ProtoRfcommSocket::send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	// Non-blocking mode lets a partially accepted buffer return at the deadline
+	// instead of blocking until the whole buffer is queued.
+	size_t total = 0;
+	setNonBlocking(true);
+	try {
+		while (total < size) {
+			int chunk = static_cast<int>(std::min<size_t>(size - total, INT_MAX));
+			int bytesSent = ::send(m_socket, reinterpret_cast<const char*>(data + total), chunk, 0);
+			if (bytesSent == SOCKET_ERROR) {
+				if (WSAGetLastError() != WSAEWOULDBLOCK) {
+					throw std::runtime_error("Failed to send data");
+				}
+				if (!waitReady(true, deadline)) {
+					break;
+				}
+				continue;
+			}
+			total += static_cast<size_t>(bytesSent);
+		}
+	}
+	catch (...) {
+		setNonBlocking(false);
+		throw;
+	}
+	setNonBlocking(false);
+
+	if (total == 0 && size > 0) {
+		throw std::runtime_error("Timed out sending data");
+	}
+	return total;
+}
+
+size_t yhkcatprint::ProtoRfcommSocket::send(std::span<const std::span<const uint8_t>> buffers)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+
+	// Buffers beyond the first maxSendBuffers are left for the caller's next call.
+	WSABUF wsaBuffers[maxSendBuffers];
+	DWORD count = 0;
+	for (const auto& buffer : buffers) {
+		if (count == maxSendBuffers) {
+			break;
+		}
+		if (buffer.empty()) {
+			continue;
+		}
+		ULONG length = static_cast<ULONG>(std::min<size_t>(buffer.size(), ULONG_MAX));
+		wsaBuffers[count].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(buffer.data()));
+		wsaBuffers[count].len = length;
+		count++;
+		if (length < buffer.size()) {
+			break;
+		}
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	DWORD bytesSent = 0;
+	if (::WSASend(m_socket, wsaBuffers, count, &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to send data");
+	}
+	return static_cast<size_t>(bytesSent);
+}
+
 size_t yhkcatprint::ProtoRfcommSocket::receive(uint8_t* buffer, size_t size)
 {
 	if (!m_connected) {
@@ -83,6 +192,17 @@ size_t yhkcatprint::ProtoRfcommSocket::receive(uint8_t* buffer, size_t size)
 	return static_cast<size_t>(bytesReceived);
 }
 
+size_t yhkcatprint::ProtoRfcommSocket::receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+	if (!waitReady(false, std::chrono::steady_clock::now() + timeout)) {
+		throw std::runtime_error("Timed out receiving data");
+	}
+	return receive(buffer, size);
+}
+
 bool yhkcatprint::ProtoRfcommSocket::available()
 {
 	if (!m_connected) {
@@ -96,6 +216,17 @@ bool yhkcatprint::ProtoRfcommSocket::available()
 	return (result > 0);
 }
 
+intptr_t yhkcatprint::ProtoRfcommSocket::nativeHandle() const
+{
+	return m_connected ? static_cast<intptr_t>(m_socket) : NO_NATIVE_HANDLE;
+}
+
+bool yhkcatprint::ProtoRfcommSocket::setReadableCallback(std::function<void()> callback)
+{
+	// Readiness of a real socket is waited on through its handle.
+	return false;
+}
+
 void yhkcatprint::ProtoRfcommSocket::close()
 {
 	if (m_socket != INVALID_SOCKET) {
@@ -105,19 +236,55 @@ void yhkcatprint::ProtoRfcommSocket::close()
 	}
 }
 
-BTH_ADDR yhkcatprint::ProtoRfcommSocket::strToBthAddr(const std::string& address)
+void yhkcatprint::ProtoRfcommSocket::recreateSocket()
 {
-	BTH_ADDR btAddr = 0;
-	std::istringstream iss(address);
-	std::string byteStr;
-	for (int i = 0; i < 6; ++i) {
-		if (!std::getline(iss, byteStr, ':')) {
-			throw std::invalid_argument("Invalid Bluetooth address format");
-		}
-		uint8_t byte = static_cast<uint8_t>(std::stoul(byteStr, nullptr, 16));
-		btAddr |= (static_cast<BTH_ADDR>(byte) << (8 * (5 - i)));
+	close();
+	m_socket = ::socket(AF_BTH, SOCK_STREAM, BTHPROTO_RFCOMM);
+	if (m_socket == INVALID_SOCKET) {
+		throw std::runtime_error("Failed to create socket");
+	}
+}
+
+void yhkcatprint::ProtoRfcommSocket::setNonBlocking(bool enabled)
+{
+	u_long mode = enabled ? 1 : 0;
+	if (ioctlsocket(m_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to change socket blocking mode");
+	}
+}
+
+bool yhkcatprint::ProtoRfcommSocket::waitReady(bool write, std::chrono::steady_clock::time_point deadline)
+{
+	auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+	if (remaining.count() < 0) {
+		remaining = std::chrono::microseconds::zero();
+	}
+	timeval timeout = {
+		static_cast<long>(remaining.count() / 1000000),
+		static_cast<long>(remaining.count() % 1000000)
+	};
+
+	fd_set readyfds;
+	FD_ZERO(&readyfds);
+	FD_SET(m_socket, &readyfds);
+	// Windows reports a failed non-blocking connect through the exception set.
+	fd_set errorfds;
+	FD_ZERO(&errorfds);
+	FD_SET(m_socket, &errorfds);
+
+	int result = write
+		? ::select(0, nullptr, &readyfds, &errorfds, &timeout)
+		: ::select(0, &readyfds, nullptr, &errorfds, &timeout);
+	if (result == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to wait for socket");
+	}
+	if (result > 0 && FD_ISSET(m_socket, &errorfds)) {
+		int error = 0;
+		int length = sizeof(error);
+		::getsockopt(m_socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+		throw std::runtime_error("Socket error: " + std::to_string(error));
 	}
-	return btAddr;
+	return result > 0;
 }
 
 void yhkcatprint::ProtoRfcommSocket::ensureWinsockInit()
@@ -11,6 +11,7 @@ Abstract:
 --*/
 
 #pragma once
+#include "BluetoothAddress.h"
 #include "IRfcommSocket.h"
 #include <cstdint>
 #include <string>
@@ -52,6 +53,16 @@ namespace yhkcatprint
 		 */
 		ProtoRfcommSocket(const std::string& address, uint8_t channel);
 
+		/**
+		 * @brief Constructs a ProtoRfcommSocket.
+		 * 
+		 * @param address Bluetooth address of the remote device.
+		 * @param channel RFCOMM channel number to connect to.
+		 * 
+		 * @throws std::runtime_error on failure to create the socket.
+		 */
+		ProtoRfcommSocket(BluetoothAddress address, uint8_t channel);
+
 		/**
 		 * @brief Destructor. Closes the socket if open.
 		 */
@@ -64,8 +75,13 @@ namespace yhkcatprint
 		void connect() override;
 		void connect(std::chrono::nanoseconds timeout) override;
 		size_t send(const uint8_t* data, size_t size) override;
+		size_t send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+		size_t send(std::span<const std::span<const uint8_t>> buffers) override;
 		size_t receive(uint8_t* buffer, size_t size) override;
+		size_t receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
 		bool available() override;
+		intptr_t nativeHandle() const override;
+		bool setReadableCallback(std::function<void()> callback) override;
 		void close() override;
 
 	private:
@@ -74,14 +90,31 @@ namespace yhkcatprint
 		bool m_connected;
 
 		/**
-		 * @brief Converts a string Bluetooth address to BTH_ADDR.
+		 * @brief Replaces the socket with a freshly created one.
 		 * 
-		 * @param address Bluetooth address in format "XX:XX:XX:XX:XX:XX".
-		 * @return BTH_ADDR representation of the address.
+		 * Used after a failed or timed out connect, which leaves the socket unusable.
 		 * 
-		 * @throws std::invalid_argument if the address format is invalid.
+		 * @throws std::runtime_error on failure to create the socket.
+		 */
+		void recreateSocket();
+
+		/**
+		 * @brief Switches the socket between blocking and non-blocking mode.
+		 * 
+		 * @throws std::runtime_error on failure to change the mode.
+		 */
+		void setNonBlocking(bool enabled);
+
+		/**
+		 * @brief Waits until the socket is readable or writable.
+		 * 
+		 * @param write true to wait for writability, false for readability.
+		 * @param deadline Point in time after which waiting stops.
+		 * @return true if the socket is ready, false if the deadline passed.
+		 * 
+		 * @throws std::runtime_error on failure to wait or if the socket reports an error.
 		 */
-		static BTH_ADDR strToBthAddr(const std::string& address);
+		bool waitReady(bool write, std::chrono::steady_clock::time_point deadline);
 
 		/**
 		 * @brief Ensures that Winsock is initialized.
@@ -0,0 +1,73 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ProtoTcpListener.cpp
+
+Abstract:
+	Implementation of ProtoTcpListener methods.
+
+--*/
+
+#include "ProtoTcpListener.h"
+#include <stdexcept>
+
+yhkcatprint::ProtoTcpListener::ProtoTcpListener(uint16_t port, bool loopbackOnly)
+	: m_socket(INVALID_SOCKET), m_port(port)
+{
+	ProtoTcpSocket::ensureWinsockInit();
+
+	m_socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (m_socket == INVALID_SOCKET) {
+		throw std::runtime_error("Failed to create socket");
+	}
+
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+	if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+		close();
+		throw std::runtime_error("Failed to bind to port " + std::to_string(port));
+	}
+	if (::listen(m_socket, SOMAXCONN) == SOCKET_ERROR) {
+		close();
+		throw std::runtime_error("Failed to listen on port " + std::to_string(port));
+	}
+
+	int length = sizeof(addr);
+	if (::getsockname(m_socket, reinterpret_cast<sockaddr*>(&addr), &length) == 0) {
+		m_port = ntohs(addr.sin_port);
+	}
+}
+
+yhkcatprint::ProtoTcpListener::~ProtoTcpListener()
+{
+	close();
+}
+
+std::shared_ptr<yhkcatprint::ProtoTcpSocket> yhkcatprint::ProtoTcpListener::accept()
+{
+	SOCKET client = ::accept(m_socket, nullptr, nullptr);
+	if (client == INVALID_SOCKET) {
+		throw std::runtime_error("Failed to accept connection");
+	}
+
+	BOOL noDelay = TRUE;
+	::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+	return std::make_shared<ProtoTcpSocket>(client);
+}
+
+uint16_t yhkcatprint::ProtoTcpListener::port() const
+{
+	return m_port;
+}
+
+void yhkcatprint::ProtoTcpListener::close()
+{
+	if (m_socket != INVALID_SOCKET) {
+		::closesocket(m_socket);
+		m_socket = INVALID_SOCKET;
+	}
+}
@@ -0,0 +1,81 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ProtoTcpListener.h
+
+Abstract:
+	Prototype TCP listener accepting ProtoTcpSocket connections.
+
+--*/
+
+#pragma once
+#include "ProtoTcpSocket.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <winsock2.h>
+
+/**
+ * @file ProtoTcpListener.h
+ * @brief Prototype TCP listener accepting ProtoTcpSocket connections.
+ *
+ * This header defines the server side of the TCP transport, used by the
+ * printer emulator to accept connections from "tcp://host:port" sockets.
+ * For testing purposes only.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Prototype TCP listener accepting ProtoTcpSocket connections.
+	 *
+	 * For testing purposes only, not intended for production use.
+	 */
+	class ProtoTcpListener
+	{
+	public:
+		/**
+		 * @brief Constructs a ProtoTcpListener and starts listening.
+		 *
+		 * @param port TCP port to listen on, 0 to let the system pick one.
+		 * @param loopbackOnly true to accept connections from this machine only.
+		 *
+		 * @throws std::runtime_error on failure to create, bind or listen on the socket.
+		 */
+		explicit ProtoTcpListener(uint16_t port, bool loopbackOnly = true);
+
+		/**
+		 * @brief Destructor. Closes the listening socket.
+		 */
+		~ProtoTcpListener();
+
+		// Disable copy semantics
+		ProtoTcpListener(const ProtoTcpListener&) = delete;
+		ProtoTcpListener& operator=(const ProtoTcpListener&) = delete;
+
+		/**
+		 * @brief Waits for the next incoming connection.
+		 *
+		 * @return Connected socket.
+		 *
+		 * @throws std::runtime_error on failure to accept or if the listener was closed.
+		 */
+		std::shared_ptr<ProtoTcpSocket> accept();
+
+		/**
+		 * @brief Returns the port the listener is bound to.
+		 */
+		uint16_t port() const;
+
+		/**
+		 * @brief Closes the listening socket, failing pending accept() calls.
+		 */
+		void close();
+
+	private:
+		SOCKET m_socket;
+		uint16_t m_port;
+	};
+}
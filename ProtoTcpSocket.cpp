@@ -0,0 +1,335 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ProtoTcpSocket.cpp
+
+Abstract:
+	Implementation of ProtoTcpSocket methods.
+
+--*/
+
+#include "ProtoTcpSocket.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+namespace
+{
+	const DWORD maxSendBuffers = 16;
+}
+
+yhkcatprint::ProtoTcpSocket::ProtoTcpSocket(const std::string& address, uint8_t channel)
+	: m_socket(INVALID_SOCKET), m_port(std::to_string(DEFAULT_PORT)), m_connected(false)
+{
+	ensureWinsockInit();
+
+	const std::string scheme = SCHEME;
+	std::string endpoint = address.compare(0, scheme.size(), scheme) == 0 ? address.substr(scheme.size()) : address;
+
+	// Bracketed hosts carry IPv6 literals, whose colons are not port separators.
+	size_t hostEnd = 0;
+	if (!endpoint.empty() && endpoint.front() == '[') {
+		hostEnd = endpoint.find(']');
+		if (hostEnd == std::string::npos) {
+			throw std::invalid_argument("Invalid TCP address format");
+		}
+		m_host = endpoint.substr(1, hostEnd - 1);
+		hostEnd += 1;
+	}
+	else {
+		hostEnd = endpoint.rfind(':');
+		m_host = endpoint.substr(0, hostEnd);
+	}
+
+	if (hostEnd < endpoint.size()) {
+		if (endpoint[hostEnd] != ':' || hostEnd + 1 == endpoint.size()) {
+			throw std::invalid_argument("Invalid TCP address format");
+		}
+		m_port = endpoint.substr(hostEnd + 1);
+	}
+	if (m_host.empty()) {
+		throw std::invalid_argument("Invalid TCP address format");
+	}
+}
+
+yhkcatprint::ProtoTcpSocket::ProtoTcpSocket(SOCKET socket)
+	: m_socket(socket), m_connected(socket != INVALID_SOCKET)
+{
+}
+
+yhkcatprint::ProtoTcpSocket::~ProtoTcpSocket()
+{
+	close();
+}
+
+void yhkcatprint::ProtoTcpSocket::connect()
+{
+	connectUntil(std::nullopt);
+}
+
+void yhkcatprint::ProtoTcpSocket::connect(std::chrono::nanoseconds timeout)
+{
+	connectUntil(std::chrono::steady_clock::now() + timeout);
+}
+
+size_t yhkcatprint::ProtoTcpSocket::send(const uint8_t* data, size_t size)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+	int bytesSent = ::send(m_socket, reinterpret_cast<const char*>(data), static_cast<int>(size), 0);
+	if (bytesSent == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to send data");
+	}
+	return static_cast<size_t>(bytesSent);
+}
+
+size_t yhkcatprint::ProtoTcpSocket::send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	size_t total = 0;
+	setNonBlocking(true);
+	try {
+		while (total < size) {
+			int chunk = static_cast<int>(std::min<size_t>(size - total, INT_MAX));
+			int bytesSent = ::send(m_socket, reinterpret_cast<const char*>(data + total), chunk, 0);
+			if (bytesSent == SOCKET_ERROR) {
+				if (WSAGetLastError() != WSAEWOULDBLOCK) {
+					throw std::runtime_error("Failed to send data");
+				}
+				if (!waitReady(true, deadline)) {
+					break;
+				}
+				continue;
+			}
+			total += static_cast<size_t>(bytesSent);
+		}
+	}
+	catch (...) {
+		setNonBlocking(false);
+		throw;
+	}
+	setNonBlocking(false);
+
+	if (total == 0 && size > 0) {
+		throw std::runtime_error("Timed out sending data");
+	}
+	return total;
+}
+
+size_t yhkcatprint::ProtoTcpSocket::send(std::span<const std::span<const uint8_t>> buffers)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+
+	// Buffers beyond the first maxSendBuffers are left for the caller's next call.
+	WSABUF wsaBuffers[maxSendBuffers];
+	DWORD count = 0;
+	for (const auto& buffer : buffers) {
+		if (count == maxSendBuffers) {
+			break;
+		}
+		if (buffer.empty()) {
+			continue;
+		}
+		ULONG length = static_cast<ULONG>(std::min<size_t>(buffer.size(), ULONG_MAX));
+		wsaBuffers[count].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(buffer.data()));
+		wsaBuffers[count].len = length;
+		count++;
+		if (length < buffer.size()) {
+			break;
+		}
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	DWORD bytesSent = 0;
+	if (::WSASend(m_socket, wsaBuffers, count, &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to send data");
+	}
+	return static_cast<size_t>(bytesSent);
+}
+
+size_t yhkcatprint::ProtoTcpSocket::receive(uint8_t* buffer, size_t size)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+	int bytesReceived = ::recv(m_socket, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+	if (bytesReceived == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to receive data");
+	}
+	if (bytesReceived == 0) {
+		// Connection has been closed
+		m_connected = false;
+	}
+	return static_cast<size_t>(bytesReceived);
+}
+
+size_t yhkcatprint::ProtoTcpSocket::receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+{
+	if (!m_connected) {
+		throw std::runtime_error("Socket not connected");
+	}
+	if (!waitReady(false, std::chrono::steady_clock::now() + timeout)) {
+		throw std::runtime_error("Timed out receiving data");
+	}
+	return receive(buffer, size);
+}
+
+bool yhkcatprint::ProtoTcpSocket::available()
+{
+	if (!m_connected) {
+		return false;
+	}
+	fd_set readfds;
+	FD_ZERO(&readfds);
+	FD_SET(m_socket, &readfds);
+	timeval timeout = { 0, 0 }; // Non-blocking check
+	int result = ::select(0, &readfds, nullptr, nullptr, &timeout);
+	return (result > 0);
+}
+
+intptr_t yhkcatprint::ProtoTcpSocket::nativeHandle() const
+{
+	return m_connected ? static_cast<intptr_t>(m_socket) : NO_NATIVE_HANDLE;
+}
+
+bool yhkcatprint::ProtoTcpSocket::setReadableCallback(std::function<void()> callback)
+{
+	// Readiness of a real socket is waited on through its handle.
+	return false;
+}
+
+void yhkcatprint::ProtoTcpSocket::close()
+{
+	if (m_socket != INVALID_SOCKET) {
+		::closesocket(m_socket);
+		m_socket = INVALID_SOCKET;
+		m_connected = false;
+	}
+}
+
+void yhkcatprint::ProtoTcpSocket::connectUntil(std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+	if (m_connected) {
+		throw std::runtime_error("Socket already connected");
+	}
+
+	addrinfo hints = {};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	addrinfo* results = nullptr;
+	if (::getaddrinfo(m_host.c_str(), m_port.c_str(), &hints, &results) != 0 || results == nullptr) {
+		throw std::runtime_error("Failed to resolve host: " + m_host);
+	}
+
+	bool timedOut = false;
+	for (addrinfo* candidate = results; candidate != nullptr && !m_connected; candidate = candidate->ai_next) {
+		m_socket = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+		if (m_socket == INVALID_SOCKET) {
+			continue;
+		}
+
+		try {
+			if (!deadline) {
+				m_connected = ::connect(m_socket, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) != SOCKET_ERROR;
+			}
+			else {
+				setNonBlocking(true);
+				if (::connect(m_socket, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) != SOCKET_ERROR) {
+					m_connected = true;
+				}
+				else if (WSAGetLastError() == WSAEWOULDBLOCK) {
+					m_connected = waitReady(true, *deadline);
+					timedOut = !m_connected;
+				}
+				if (m_connected) {
+					setNonBlocking(false);
+				}
+			}
+		}
+		catch (const std::exception&) {
+			m_connected = false;
+		}
+
+		if (!m_connected) {
+			close();
+			if (timedOut) {
+				break;
+			}
+		}
+	}
+	::freeaddrinfo(results);
+
+	if (!m_connected) {
+		throw std::runtime_error(timedOut ? "Timed out connecting to the device" : "Failed to connect to the device");
+	}
+
+	BOOL noDelay = TRUE;
+	::setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+}
+
+void yhkcatprint::ProtoTcpSocket::setNonBlocking(bool enabled)
+{
+	u_long mode = enabled ? 1 : 0;
+	if (ioctlsocket(m_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to change socket blocking mode");
+	}
+}
+
+bool yhkcatprint::ProtoTcpSocket::waitReady(bool write, std::chrono::steady_clock::time_point deadline)
+{
+	auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+	if (remaining.count() < 0) {
+		remaining = std::chrono::microseconds::zero();
+	}
+	timeval timeout = {
+		static_cast<long>(remaining.count() / 1000000),
+		static_cast<long>(remaining.count() % 1000000)
+	};
+
+	fd_set readyfds;
+	FD_ZERO(&readyfds);
+	FD_SET(m_socket, &readyfds);
+	// Windows reports a failed non-blocking connect through the exception set.
+	fd_set errorfds;
+	FD_ZERO(&errorfds);
+	FD_SET(m_socket, &errorfds);
+
+	int result = write
+		? ::select(0, nullptr, &readyfds, &errorfds, &timeout)
+		: ::select(0, &readyfds, nullptr, &errorfds, &timeout);
+	if (result == SOCKET_ERROR) {
+		throw std::runtime_error("Failed to wait for socket");
+	}
+	if (result > 0 && FD_ISSET(m_socket, &errorfds)) {
+		int error = 0;
+		int length = sizeof(error);
+		::getsockopt(m_socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+		throw std::runtime_error("Socket error: " + std::to_string(error));
+	}
+	return result > 0;
+}
+
+void yhkcatprint::ProtoTcpSocket::ensureWinsockInit()
+{
+	static bool initialized = false;
+	if (!initialized) {
+		WSADATA wsaData;
+		int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
+		if (result != 0) {
+			throw std::runtime_error("Failed to initialize Winsock");
+		}
+		initialized = true;
+	}
+}
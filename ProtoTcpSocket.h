@@ -0,0 +1,133 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ProtoTcpSocket.h
+
+Abstract:
+	Prototype implementation of IRfcommSocket over TCP using Windows Sockets API.
+
+--*/
+
+#pragma once
+#include "IRfcommSocket.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+// Link with Ws2_32.lib
+#pragma comment(lib, "ws2_32.lib")
+
+/**
+ * @file ProtoTcpSocket.h
+ * @brief Prototype implementation of IRfcommSocket over TCP using Windows Sockets API.
+ *
+ * This header defines a socket that speaks the printer protocol over a TCP
+ * stream, addressed as "tcp://host:port". It is used for network printers
+ * and for the printer emulator running in a separate process.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Prototype implementation of IRfcommSocket over TCP.
+	 *
+	 * The RFCOMM channel number is ignored. Nagle's algorithm is disabled,
+	 * since the protocol relies on short request/response exchanges.
+	 */
+	class ProtoTcpSocket : public IRfcommSocket
+	{
+	public:
+		/**
+		 * @brief Address scheme of TCP endpoints.
+		 */
+		static constexpr const char* SCHEME = "tcp://";
+
+		/**
+		 * @brief Port used when the address does not specify one.
+		 */
+		static constexpr uint16_t DEFAULT_PORT = 9100;
+
+		/**
+		 * @brief Constructs an unconnected ProtoTcpSocket.
+		 *
+		 * @param address Endpoint address in format "tcp://host:port".
+		 * @param channel RFCOMM channel number, ignored.
+		 *
+		 * @throws std::invalid_argument if the address format is invalid.
+		 * @throws std::runtime_error on failure to initialize Winsock.
+		 */
+		ProtoTcpSocket(const std::string& address, uint8_t channel);
+
+		/**
+		 * @brief Constructs a connected ProtoTcpSocket from an accepted socket.
+		 *
+		 * @param socket Connected socket, ownership is taken.
+		 */
+		explicit ProtoTcpSocket(SOCKET socket);
+
+		/**
+		 * @brief Destructor. Closes the socket if open.
+		 */
+		virtual ~ProtoTcpSocket();
+
+		// Disable copy semantics
+		ProtoTcpSocket(const ProtoTcpSocket&) = delete;
+		ProtoTcpSocket& operator=(const ProtoTcpSocket&) = delete;
+
+		void connect() override;
+		void connect(std::chrono::nanoseconds timeout) override;
+		size_t send(const uint8_t* data, size_t size) override;
+		size_t send(const uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+		size_t send(std::span<const std::span<const uint8_t>> buffers) override;
+		size_t receive(uint8_t* buffer, size_t size) override;
+		size_t receive(uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
+		bool available() override;
+		intptr_t nativeHandle() const override;
+		bool setReadableCallback(std::function<void()> callback) override;
+		void close() override;
+
+		/**
+		 * @brief Ensures that Winsock is initialized.
+		 *
+		 * @throws std::runtime_error on failure to initialize Winsock.
+		 */
+		static void ensureWinsockInit();
+
+	private:
+		SOCKET m_socket;
+		std::string m_host;
+		std::string m_port;
+		bool m_connected;
+
+		/**
+		 * @brief Resolves the host and connects to the first reachable address.
+		 *
+		 * @param deadline Point in time after which connecting stops, or std::nullopt to block.
+		 *
+		 * @throws std::runtime_error on failure to connect or if the deadline passes.
+		 */
+		void connectUntil(std::optional<std::chrono::steady_clock::time_point> deadline);
+
+		/**
+		 * @brief Switches the socket between blocking and non-blocking mode.
+		 *
+		 * @throws std::runtime_error on failure to change the mode.
+		 */
+		void setNonBlocking(bool enabled);
+
+		/**
+		 * @brief Waits until the socket is readable or writable.
+		 *
+		 * @param write true to wait for writability, false for readability.
+		 * @param deadline Point in time after which waiting stops.
+		 * @return true if the socket is ready, false if the deadline passed.
+		 *
+		 * @throws std::runtime_error on failure to wait or if the socket reports an error.
+		 */
+		bool waitReady(bool write, std::chrono::steady_clock::time_point deadline);
+	};
+}
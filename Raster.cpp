@@ -0,0 +1,361 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Raster.cpp
+
+Abstract:
+	Implementation of Rasterizer methods.
+
+--*/
+
+#include "Raster.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	const uint8_t bayerMatrix[8][8] = {
+		{ 0, 32, 8, 40, 2, 34, 10, 42 },
+		{ 48, 16, 56, 24, 50, 18, 58, 26 },
+		{ 12, 44, 4, 36, 14, 46, 6, 38 },
+		{ 60, 28, 52, 20, 62, 30, 54, 22 },
+		{ 3, 35, 11, 43, 1, 33, 9, 41 },
+		{ 51, 19, 59, 27, 49, 17, 57, 25 },
+		{ 15, 47, 7, 39, 13, 45, 5, 37 },
+		{ 63, 31, 55, 23, 61, 29, 53, 21 }
+	};
+
+	// Error buffers have 2 spare entries on each side so kernels never need bounds checks.
+	const size_t errorMargin = 2;
+
+	const uint32_t noSourceRow = std::numeric_limits<uint32_t>::max();
+
+	size_t bytesPerPixel(yhkcatprint::PixelFormat format)
+	{
+		return format == yhkcatprint::PIXEL_FORMAT_RGBA ? 4 : 1;
+	}
+}
+
+yhkcatprint::Rasterizer::Rasterizer(const RASTER_OPTIONS& options, SimdLevel level)
+	: m_options(options), m_level(level), m_image(), m_rows(0), m_nextRow(0), m_paletteLuma{}, m_lineSource(noSourceRow)
+{
+	if (options.dotWidth == 0 || options.dotWidth % 8 != 0)
+	{
+		throw std::invalid_argument("Dot width must be a positive multiple of 8");
+	}
+
+	if (!isSimdLevelSupported(level))
+	{
+		throw std::invalid_argument(std::string("Instruction set not supported: ") + simdLevelName(level));
+	}
+
+	m_columnStart.resize(options.dotWidth);
+	m_columnCount.resize(options.dotWidth);
+	m_sums.resize(options.dotWidth);
+	m_line.resize(options.dotWidth);
+	for (auto& errors : m_errors)
+	{
+		errors.resize(options.dotWidth + 2 * errorMargin);
+	}
+
+	switch (options.dither)
+	{
+	case DITHER_THRESHOLD:
+		m_thresholds.assign(options.dotWidth, options.threshold);
+		break;
+	case DITHER_BAYER:
+		m_thresholds.resize(8 * static_cast<size_t>(options.dotWidth));
+		for (size_t row = 0; row < 8; ++row)
+		{
+			for (size_t x = 0; x < options.dotWidth; ++x)
+			{
+				// Thresholds 2, 6, ... 254 centred on 128, then shifted by the configured threshold.
+				int value = bayerMatrix[row][x % 8] * 4 + 2 + options.threshold - 128;
+				m_thresholds[row * options.dotWidth + x] = static_cast<uint8_t>(std::clamp(value, 0, 255));
+			}
+		}
+		break;
+	case DITHER_FLOYD_STEINBERG:
+	case DITHER_ATKINSON:
+		break;
+	default:
+		throw std::invalid_argument("Unknown dither method");
+	}
+}
+
+size_t yhkcatprint::Rasterizer::rowBytes() const
+{
+	return m_options.dotWidth / 8;
+}
+
+uint32_t yhkcatprint::Rasterizer::scaledHeight(const IMAGE_DESC& image, uint32_t dotWidth)
+{
+	if (image.width == 0 || image.height == 0)
+	{
+		return 0;
+	}
+
+	uint64_t height = (static_cast<uint64_t>(image.height) * dotWidth + image.width / 2) / image.width;
+	return static_cast<uint32_t>(std::clamp<uint64_t>(height, 1, std::numeric_limits<uint32_t>::max()));
+}
+
+void yhkcatprint::Rasterizer::begin(const IMAGE_DESC& image)
+{
+	if (image.pixels == nullptr || image.width == 0 || image.height == 0)
+	{
+		throw std::invalid_argument("Image is empty");
+	}
+
+	size_t minStride = static_cast<size_t>(image.width) * bytesPerPixel(image.format);
+	if (image.format != PIXEL_FORMAT_RGBA && image.format != PIXEL_FORMAT_GRAY && image.format != PIXEL_FORMAT_INDEXED)
+	{
+		throw std::invalid_argument("Unknown pixel format");
+	}
+	if (image.stride != 0 && image.stride < minStride)
+	{
+		throw std::invalid_argument("Image stride is shorter than a row");
+	}
+	if (image.format == PIXEL_FORMAT_INDEXED && image.palette == nullptr && image.paletteSize > 0)
+	{
+		throw std::invalid_argument("Palette is missing");
+	}
+
+	m_image = image;
+	if (m_image.stride == 0)
+	{
+		m_image.stride = minStride;
+	}
+
+	if (image.format == PIXEL_FORMAT_INDEXED)
+	{
+		std::fill(std::begin(m_paletteLuma), std::end(m_paletteLuma), static_cast<uint8_t>(255));
+		size_t entries = std::min<size_t>(image.paletteSize, 256);
+		rgbaToGray(image.palette, m_paletteLuma, entries, SIMD_SCALAR);
+	}
+	if (image.format != PIXEL_FORMAT_GRAY)
+	{
+		m_sourceRow.resize(image.width);
+	}
+
+	for (uint32_t x = 0; x < m_options.dotWidth; ++x)
+	{
+		uint32_t start = static_cast<uint32_t>(static_cast<uint64_t>(x) * image.width / m_options.dotWidth);
+		uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(x + 1) * image.width / m_options.dotWidth);
+		m_columnStart[x] = start;
+		m_columnCount[x] = std::max<uint32_t>(end - start, 1);
+	}
+
+	for (auto& errors : m_errors)
+	{
+		std::fill(errors.begin(), errors.end(), 0);
+	}
+
+	m_rows = scaledHeight(image, m_options.dotWidth);
+	m_nextRow = 0;
+	m_lineSource = noSourceRow;
+}
+
+uint32_t yhkcatprint::Rasterizer::rows() const
+{
+	return m_rows;
+}
+
+uint32_t yhkcatprint::Rasterizer::remaining() const
+{
+	return m_rows - m_nextRow;
+}
+
+size_t yhkcatprint::Rasterizer::render(uint8_t* out, size_t maxRows)
+{
+	size_t count = std::min<size_t>(maxRows, remaining());
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		scaleRow(m_nextRow);
+		ditherRow(m_nextRow, out + i * rowBytes());
+		m_nextRow++;
+	}
+
+	return count;
+}
+
+std::vector<uint8_t> yhkcatprint::Rasterizer::rasterize(const IMAGE_DESC& image)
+{
+	begin(image);
+
+	std::vector<uint8_t> raster(static_cast<size_t>(m_rows) * rowBytes());
+	render(raster.data(), m_rows);
+	return raster;
+}
+
+const uint8_t* yhkcatprint::Rasterizer::sourceLuma(uint32_t y)
+{
+	const uint8_t* row = m_image.pixels + static_cast<size_t>(y) * m_image.stride;
+
+	switch (m_image.format)
+	{
+	case PIXEL_FORMAT_GRAY:
+		return row;
+	case PIXEL_FORMAT_RGBA:
+		rgbaToGray(row, m_sourceRow.data(), m_image.width, m_level);
+		return m_sourceRow.data();
+	default:
+		for (uint32_t x = 0; x < m_image.width; ++x)
+		{
+			m_sourceRow[x] = m_paletteLuma[row[x]];
+		}
+		return m_sourceRow.data();
+	}
+}
+
+void yhkcatprint::Rasterizer::scaleRow(uint32_t y)
+{
+	uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(y) * m_image.height / m_rows);
+	uint32_t last = static_cast<uint32_t>(static_cast<uint64_t>(y + 1) * m_image.height / m_rows);
+	uint32_t rowCount = std::max<uint32_t>(last - first, 1);
+	uint32_t width = m_options.dotWidth;
+
+	if (rowCount == 1)
+	{
+		// When enlarging, consecutive output rows repeat the same source row.
+		if (first == m_lineSource)
+		{
+			return;
+		}
+
+		const uint8_t* luma = sourceLuma(first);
+		if (m_image.width == width)
+		{
+			std::memcpy(m_line.data(), luma, width);
+		}
+		else
+		{
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				uint32_t count = m_columnCount[x];
+				uint32_t sum = 0;
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					sum += luma[m_columnStart[x] + i];
+				}
+				m_line[x] = static_cast<uint8_t>((sum + count / 2) / count);
+			}
+		}
+		m_lineSource = first;
+		return;
+	}
+
+	std::fill(m_sums.begin(), m_sums.end(), 0);
+	for (uint32_t source = first; source < first + rowCount; ++source)
+	{
+		const uint8_t* luma = sourceLuma(source);
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			uint32_t sum = 0;
+			for (uint32_t i = 0; i < m_columnCount[x]; ++i)
+			{
+				sum += luma[m_columnStart[x] + i];
+			}
+			m_sums[x] += sum;
+		}
+	}
+
+	for (uint32_t x = 0; x < width; ++x)
+	{
+		uint32_t count = m_columnCount[x] * rowCount;
+		m_line[x] = static_cast<uint8_t>((m_sums[x] + count / 2) / count);
+	}
+	m_lineSource = noSourceRow;
+}
+
+void yhkcatprint::Rasterizer::ditherRow(uint32_t y, uint8_t* out)
+{
+	switch (m_options.dither)
+	{
+	case DITHER_THRESHOLD:
+		packThreshold(m_line.data(), m_thresholds.data(), out, m_options.dotWidth, m_level);
+		break;
+	case DITHER_BAYER:
+		packThreshold(m_line.data(), m_thresholds.data() + (y % 8) * static_cast<size_t>(m_options.dotWidth), out, m_options.dotWidth, m_level);
+		break;
+	case DITHER_FLOYD_STEINBERG:
+		std::memset(out, 0, rowBytes());
+		diffuseFloydSteinberg(y, out);
+		break;
+	case DITHER_ATKINSON:
+		std::memset(out, 0, rowBytes());
+		diffuseAtkinson(out);
+		break;
+	}
+
+	// Rows below become the current ones; the freed row is reused for the furthest one.
+	m_errors[0].swap(m_errors[1]);
+	m_errors[1].swap(m_errors[2]);
+	std::fill(m_errors[2].begin(), m_errors[2].end(), 0);
+}
+
+void yhkcatprint::Rasterizer::diffuseFloydSteinberg(uint32_t y, uint8_t* out)
+{
+	// Errors are kept in sixteenths. Odd rows run right to left to avoid directional artifacts.
+	int32_t* current = m_errors[0].data() + errorMargin;
+	int32_t* below = m_errors[1].data() + errorMargin;
+	const int width = static_cast<int>(m_options.dotWidth);
+	const int step = (y % 2 == 0) ? 1 : -1;
+	const int threshold = m_options.threshold;
+
+	for (int i = 0; i < width; ++i)
+	{
+		int x = step > 0 ? i : width - 1 - i;
+		int value = m_line[x] + ((current[x] + 8) >> 4);
+		int error = value;
+		if (value < threshold)
+		{
+			out[x >> 3] |= static_cast<uint8_t>(0x80 >> (x & 7));
+		}
+		else
+		{
+			error = value - 255;
+		}
+
+		current[x + step] += error * 7;
+		below[x - step] += error * 3;
+		below[x] += error * 5;
+		below[x + step] += error;
+	}
+}
+
+void yhkcatprint::Rasterizer::diffuseAtkinson(uint8_t* out)
+{
+	// Errors are kept in eighths; only 6/8 of the error is spread, which preserves contrast.
+	int32_t* current = m_errors[0].data() + errorMargin;
+	int32_t* below = m_errors[1].data() + errorMargin;
+	int32_t* twoBelow = m_errors[2].data() + errorMargin;
+	const int width = static_cast<int>(m_options.dotWidth);
+	const int threshold = m_options.threshold;
+
+	for (int x = 0; x < width; ++x)
+	{
+		int value = m_line[x] + ((current[x] + 4) >> 3);
+		int error = value;
+		if (value < threshold)
+		{
+			out[x >> 3] |= static_cast<uint8_t>(0x80 >> (x & 7));
+		}
+		else
+		{
+			error = value - 255;
+		}
+
+		current[x + 1] += error;
+		current[x + 2] += error;
+		below[x - 1] += error;
+		below[x] += error;
+		below[x + 1] += error;
+		twoBelow[x] += error;
+	}
+}
@@ -0,0 +1,291 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Raster.h
+
+Abstract:
+	Conversion of images to the printer's 1-bit raster format.
+
+--*/
+
+#pragma once
+#include "RasterKernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file Raster.h
+ * @brief Conversion of images to the printer's 1-bit raster format.
+ *
+ * This header defines Rasterizer, which turns RGBA, grayscale or indexed
+ * images into the rows sent after the print start command: the image is
+ * scaled to the printer's dot width, converted to luma, dithered and packed
+ * to 1 bit per dot, most significant bit first, with 1 meaning a black dot.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Pixel layout of a source image.
+	 */
+	enum PixelFormat
+	{
+		/**
+		 * @brief 4 bytes per pixel in R, G, B, A order.
+		 */
+		PIXEL_FORMAT_RGBA = 0,
+		/**
+		 * @brief 1 byte of luma per pixel, 0 black and 255 white.
+		 */
+		PIXEL_FORMAT_GRAY = 1,
+		/**
+		 * @brief 1 byte per pixel indexing an RGBA palette.
+		 */
+		PIXEL_FORMAT_INDEXED = 2
+	};
+
+	/**
+	 * @brief Method used to reduce luma to black and white dots.
+	 */
+	enum DitherMethod
+	{
+		/**
+		 * @brief Fixed threshold; best for text and line art.
+		 */
+		DITHER_THRESHOLD = 0,
+		/**
+		 * @brief Ordered dithering with an 8x8 Bayer matrix.
+		 */
+		DITHER_BAYER = 1,
+		/**
+		 * @brief Floyd-Steinberg error diffusion with serpentine scanning.
+		 */
+		DITHER_FLOYD_STEINBERG = 2,
+		/**
+		 * @brief Atkinson error diffusion; keeps more contrast than Floyd-Steinberg.
+		 */
+		DITHER_ATKINSON = 3
+	};
+
+	/**
+	 * @brief Source image description. The pixels are not copied.
+	 */
+	typedef struct _IMAGE_DESC
+	{
+		/**
+		 * @brief First byte of the top row.
+		 */
+		const uint8_t* pixels = nullptr;
+		/**
+		 * @brief Width in pixels.
+		 */
+		uint32_t width = 0;
+		/**
+		 * @brief Height in pixels.
+		 */
+		uint32_t height = 0;
+		/**
+		 * @brief Distance between rows in bytes, 0 for tightly packed rows.
+		 */
+		size_t stride = 0;
+		/**
+		 * @brief Pixel layout.
+		 */
+		PixelFormat format = PIXEL_FORMAT_RGBA;
+		/**
+		 * @brief RGBA palette entries for indexed images, 4 bytes each.
+		 */
+		const uint8_t* palette = nullptr;
+		/**
+		 * @brief Number of palette entries; indices past the end print as white.
+		 */
+		size_t paletteSize = 0;
+	} IMAGE_DESC;
+
+	/**
+	 * @brief Rasterization options.
+	 */
+	typedef struct _RASTER_OPTIONS
+	{
+		/**
+		 * @brief Printable width in dots, a multiple of 8.
+		 */
+		uint32_t dotWidth = 384;
+		/**
+		 * @brief Dithering method.
+		 */
+		DitherMethod dither = DITHER_FLOYD_STEINBERG;
+		/**
+		 * @brief Luma below which a pixel prints black; shifts the Bayer matrix and error diffusion alike.
+		 */
+		uint8_t threshold = 128;
+	} RASTER_OPTIONS;
+
+	/**
+	 * @brief Converts images to packed 1-bit printer rows.
+	 *
+	 * The image is scaled to the dot width keeping its aspect ratio, using
+	 * box filtering when shrinking and pixel replication when enlarging.
+	 * Rows can be produced all at once with rasterize(), or incrementally
+	 * with begin() and render(); error diffusion state carries over between
+	 * render() calls, so the output is the same either way.
+	 *
+	 * @note Not thread-safe; use one Rasterizer per thread.
+	 */
+	class Rasterizer
+	{
+	public:
+		/**
+		 * @brief Constructs a Rasterizer.
+		 *
+		 * @param options Rasterization options.
+		 * @param level Instruction set for the pixel kernels.
+		 *
+		 * @throws std::invalid_argument if the dot width is not a positive multiple of 8
+		 *         or the instruction set is not supported.
+		 */
+		explicit Rasterizer(const RASTER_OPTIONS& options, SimdLevel level = detectSimdLevel());
+
+		// Disable copy semantics
+		Rasterizer(const Rasterizer&) = delete;
+		Rasterizer& operator=(const Rasterizer&) = delete;
+
+		/**
+		 * @brief Returns the size of one output row in bytes.
+		 */
+		size_t rowBytes() const;
+
+		/**
+		 * @brief Returns the number of output rows an image scales to.
+		 *
+		 * @param image Source image.
+		 * @param dotWidth Printable width in dots.
+		 * @return Scaled height, at least 1 for a non-empty image.
+		 */
+		static uint32_t scaledHeight(const IMAGE_DESC& image, uint32_t dotWidth);
+
+		/**
+		 * @brief Starts rasterizing an image and resets the dithering state.
+		 *
+		 * @param image Source image; its pixels must stay valid until the last row is rendered.
+		 *
+		 * @throws std::invalid_argument if the image description is inconsistent.
+		 */
+		void begin(const IMAGE_DESC& image);
+
+		/**
+		 * @brief Returns the total number of output rows of the current image.
+		 */
+		uint32_t rows() const;
+
+		/**
+		 * @brief Returns the number of output rows not yet rendered.
+		 */
+		uint32_t remaining() const;
+
+		/**
+		 * @brief Renders the next rows of the current image.
+		 *
+		 * @param out Destination for at most maxRows rows of rowBytes() bytes each.
+		 * @param maxRows Maximum number of rows to render.
+		 * @return Number of rows rendered, 0 once the image is finished.
+		 */
+		size_t render(uint8_t* out, size_t maxRows);
+
+		/**
+		 * @brief Rasterizes a whole image.
+		 *
+		 * @param image Source image.
+		 * @return Packed rows, rowBytes() * scaledHeight() bytes.
+		 *
+		 * @throws std::invalid_argument if the image description is inconsistent.
+		 */
+		std::vector<uint8_t> rasterize(const IMAGE_DESC& image);
+
+	private:
+		/**
+		 * @brief Returns luma of a source row, converting it if necessary.
+		 */
+		const uint8_t* sourceLuma(uint32_t y);
+
+		/**
+		 * @brief Fills m_line with the scaled luma of an output row.
+		 */
+		void scaleRow(uint32_t y);
+
+		/**
+		 * @brief Dithers m_line into one packed output row.
+		 */
+		void ditherRow(uint32_t y, uint8_t* out);
+
+		/**
+		 * @brief Floyd-Steinberg error diffusion of one row.
+		 */
+		void diffuseFloydSteinberg(uint32_t y, uint8_t* out);
+
+		/**
+		 * @brief Atkinson error diffusion of one row.
+		 */
+		void diffuseAtkinson(uint8_t* out);
+
+		/**
+		 * @brief Rasterization options.
+		 */
+		RASTER_OPTIONS m_options;
+		/**
+		 * @brief Instruction set for the pixel kernels.
+		 */
+		SimdLevel m_level;
+		/**
+		 * @brief Image being rasterized.
+		 */
+		IMAGE_DESC m_image;
+		/**
+		 * @brief Output rows of the current image.
+		 */
+		uint32_t m_rows;
+		/**
+		 * @brief Next output row to render.
+		 */
+		uint32_t m_nextRow;
+		/**
+		 * @brief First source column averaged into each output column.
+		 */
+		std::vector<uint32_t> m_columnStart;
+		/**
+		 * @brief Number of source columns averaged into each output column.
+		 */
+		std::vector<uint32_t> m_columnCount;
+		/**
+		 * @brief Luma of each palette index, for indexed images.
+		 */
+		uint8_t m_paletteLuma[256];
+		/**
+		 * @brief Luma of the source row last converted.
+		 */
+		std::vector<uint8_t> m_sourceRow;
+		/**
+		 * @brief Column sums while averaging several source rows.
+		 */
+		std::vector<uint32_t> m_sums;
+		/**
+		 * @brief Scaled luma of the current output row.
+		 */
+		std::vector<uint8_t> m_line;
+		/**
+		 * @brief Source row m_line was scaled from, or UINT32_MAX if m_line is an average of several rows.
+		 */
+		uint32_t m_lineSource;
+		/**
+		 * @brief Per-dot thresholds for the threshold method, or 8 rows of Bayer thresholds.
+		 */
+		std::vector<uint8_t> m_thresholds;
+		/**
+		 * @brief Diffused error for the current row and the two below, with a margin of 2 on each side.
+		 */
+		std::vector<int32_t> m_errors[3];
+	};
+}
@@ -0,0 +1,50 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterEncoder.cpp
+
+Abstract:
+	Blank row detection used by RasterEncoder.
+
+--*/
+
+#include "RasterEncoder.h"
+
+namespace
+{
+	bool isBlankRow(const uint8_t* row, size_t rowBytes, yhkcatprint::SimdLevel level)
+	{
+		return yhkcatprint::findNonZero(row, rowBytes, level) == rowBytes;
+	}
+}
+
+size_t yhkcatprint::countBlankRows(const uint8_t* rows, size_t rowCount, size_t rowBytes)
+{
+	// One scan over the whole run; rows are contiguous, so the first dot ends it.
+	size_t size = rowCount * rowBytes;
+	return findNonZero(rows, size, detectSimdLevel()) / rowBytes;
+}
+
+size_t yhkcatprint::countInkRows(const uint8_t* rows, size_t rowCount, size_t rowBytes)
+{
+	const SimdLevel level = detectSimdLevel();
+	size_t count = 0;
+	while (count < rowCount && !isBlankRow(rows + count * rowBytes, rowBytes, level))
+	{
+		count++;
+	}
+	return count;
+}
+
+size_t yhkcatprint::countTrailingBlankRows(const uint8_t* rows, size_t rowCount, size_t rowBytes)
+{
+	size_t size = rowCount * rowBytes;
+	size_t last = findLastNonZero(rows, size, detectSimdLevel());
+	if (last == size)
+	{
+		return rowCount;
+	}
+	return rowCount - (last / rowBytes + 1);
+}
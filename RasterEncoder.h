@@ -0,0 +1,340 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterEncoder.h
+
+Abstract:
+	Encoding of raster rows into printer commands.
+
+--*/
+
+#pragma once
+#include "EscPos.h"
+#include "RasterKernels.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RasterEncoder.h
+ * @brief Encoding of raster rows into printer commands.
+ *
+ * This header defines RasterEncoder, which turns packed raster rows into the
+ * byte stream sent to the printer, replacing blank rows with paper feeds
+ * where the encoding allows it. Blank rows are found with the vectorized
+ * zero scans from RasterKernels.h.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Wire format of raster data.
+	 */
+	enum RasterEncoding
+	{
+		/**
+		 * @brief Rows sent as they are after the print start command.
+		 */
+		RASTER_ENCODING_RAW = 0,
+		/**
+		 * @brief Runs of printed rows sent as GS v 0 raster images and runs of
+		 *        blank rows as ESC J paper feeds, without a print start command.
+		 */
+		RASTER_ENCODING_IMAGE = 1
+	};
+
+	/**
+	 * @brief Size statistics of an encoded job.
+	 */
+	typedef struct _ENCODE_STATS
+	{
+		/**
+		 * @brief Raster bytes passed to the encoder.
+		 */
+		size_t rasterBytes = 0;
+		/**
+		 * @brief Bytes the raster was encoded to, excluding job framing commands.
+		 */
+		size_t encodedBytes = 0;
+		/**
+		 * @brief Blank rows replaced with paper feeds.
+		 */
+		size_t blankRows = 0;
+		/**
+		 * @brief Blank rows at the end of the raster that were not printed at all.
+		 */
+		size_t trimmedRows = 0;
+	} ENCODE_STATS;
+
+	/**
+	 * @brief Counts the blank rows at the start of a raster.
+	 *
+	 * @param rows First row.
+	 * @param rowCount Number of rows available.
+	 * @param rowBytes Bytes per row.
+	 * @return Number of leading rows with no dots set.
+	 */
+	size_t countBlankRows(const uint8_t* rows, size_t rowCount, size_t rowBytes);
+
+	/**
+	 * @brief Counts the rows with dots set at the start of a raster.
+	 *
+	 * @param rows First row.
+	 * @param rowCount Number of rows available.
+	 * @param rowBytes Bytes per row.
+	 * @return Number of leading rows with at least one dot set.
+	 */
+	size_t countInkRows(const uint8_t* rows, size_t rowCount, size_t rowBytes);
+
+	/**
+	 * @brief Counts the blank rows at the end of a raster.
+	 *
+	 * @param rows First row.
+	 * @param rowCount Number of rows available.
+	 * @param rowBytes Bytes per row.
+	 * @return Number of trailing rows with no dots set.
+	 */
+	size_t countTrailingBlankRows(const uint8_t* rows, size_t rowCount, size_t rowBytes);
+
+	/**
+	 * @brief Encodes raster rows into printer commands.
+	 *
+	 * In image encoding, runs of blank rows are held back and sent as a
+	 * single feed when the next printed row or the end of the job arrives,
+	 * so rows may be passed in bands. Printed rows are handed to the writer
+	 * straight from the caller's memory; only command headers are written
+	 * from the encoder.
+	 *
+	 * With trimming, blank rows at the end of the job are dropped instead of
+	 * fed; raw encoding then holds blank rows back as well and only sends
+	 * them once a printed row follows.
+	 *
+	 * finish() writes the end of the job. In image encoding that is a feed
+	 * computed from the held back blank rows and END_FEED_ROWS, followed by
+	 * a line feed that ends the job. Raw encoding has no feed command while
+	 * the printer takes rows, since it reads every byte up to the trailer as
+	 * raster: blank runs inside a raw job go out as zero rows, and the caller
+	 * sends the print start command before and the fixed escpos::END_PRINT
+	 * after the rows.
+	 */
+	class RasterEncoder
+	{
+	public:
+		/**
+		 * @brief Most rows sent in one raster image command.
+		 */
+		static constexpr size_t MAX_IMAGE_ROWS = 256;
+
+		/**
+		 * @brief Most dot rows fed by one ESC J command.
+		 */
+		static constexpr size_t MAX_FEED_ROWS = 255;
+
+		/**
+		 * @brief Dot rows fed after a job in image encoding, 12 mm at 8 dots per mm to clear the tear bar.
+		 */
+		static constexpr size_t END_FEED_ROWS = 96;
+
+		/**
+		 * @brief Constructs a RasterEncoder for one job.
+		 *
+		 * @param rowBytes Bytes per raster row.
+		 * @param encoding Wire format.
+		 * @param trimTrailing Whether blank rows at the end of the job are dropped.
+		 */
+		RasterEncoder(size_t rowBytes, RasterEncoding encoding, bool trimTrailing = false)
+			: m_rowBytes(rowBytes), m_encoding(encoding), m_trimTrailing(trimTrailing), m_pendingBlankRows(0), m_stats()
+		{
+		}
+
+		/**
+		 * @brief Encodes raster rows.
+		 *
+		 * @param data Raster rows; only the last call of a job may end with an incomplete row.
+		 * @param size Number of bytes.
+		 * @param writer Destination providing write(const uint8_t*, size_t), typically a BufferedWriter.
+		 */
+		template<typename TWriter>
+		void encode(const uint8_t* data, size_t size, TWriter& writer)
+		{
+			m_stats.rasterBytes += size;
+
+			if (m_encoding == RASTER_ENCODING_RAW && !m_trimTrailing)
+			{
+				writer.write(data, size);
+				m_stats.encodedBytes += size;
+				return;
+			}
+
+			size_t rowCount = size / m_rowBytes;
+			size_t row = 0;
+			while (row < rowCount)
+			{
+				const uint8_t* rows = data + row * m_rowBytes;
+				size_t blank = countBlankRows(rows, rowCount - row, m_rowBytes);
+				if (blank > 0)
+				{
+					m_pendingBlankRows += blank;
+					m_stats.blankRows += blank;
+					row += blank;
+					continue;
+				}
+
+				writeBlankRows(writer);
+				if (m_encoding == RASTER_ENCODING_RAW)
+				{
+					size_t ink = countInkRows(rows, rowCount - row, m_rowBytes);
+					writeRows(rows, ink * m_rowBytes, writer);
+					row += ink;
+					continue;
+				}
+				size_t ink = countInkRows(rows, std::min(rowCount - row, MAX_IMAGE_ROWS), m_rowBytes);
+				writeImage(rows, m_rowBytes, ink, writer);
+				row += ink;
+			}
+
+			// An incomplete trailing row is printed as a narrower image, as raw encoding would.
+			size_t tail = size - rowCount * m_rowBytes;
+			if (tail > 0)
+			{
+				writeBlankRows(writer);
+				if (m_encoding == RASTER_ENCODING_RAW)
+				{
+					writeRows(data + rowCount * m_rowBytes, tail, writer);
+				}
+				else
+				{
+					writeImage(data + rowCount * m_rowBytes, tail, 1, writer);
+				}
+			}
+		}
+
+		/**
+		 * @brief Completes the job's raster.
+		 *
+		 * Blank rows still held back are dropped when trimming, and written
+		 * otherwise. In image encoding they are merged into the end-of-job
+		 * feed, so a blank margin at the bottom costs a few bytes however
+		 * tall it is.
+		 *
+		 * @param writer Destination given to encode().
+		 */
+		template<typename TWriter>
+		void finish(TWriter& writer)
+		{
+			if (m_trimTrailing)
+			{
+				m_stats.trimmedRows += m_pendingBlankRows;
+				m_stats.blankRows -= m_pendingBlankRows;
+				m_pendingBlankRows = 0;
+			}
+
+			if (m_encoding == RASTER_ENCODING_RAW)
+			{
+				writeBlankRows(writer);
+				return;
+			}
+
+			// The held back rows are not counted as encoded raster; the end feed is job framing.
+			size_t encodedBytes = m_stats.encodedBytes;
+			m_pendingBlankRows += END_FEED_ROWS;
+			writeFeed(writer);
+			writer.write(escpos::LINE_FEED.data(), escpos::LINE_FEED.size());
+			m_stats.encodedBytes = encodedBytes;
+		}
+
+		/**
+		 * @brief Returns the statistics of the rows encoded so far.
+		 */
+		const ENCODE_STATS& stats() const
+		{
+			return m_stats;
+		}
+
+	private:
+		/**
+		 * @brief Writes the held back blank rows in the job's wire format.
+		 */
+		template<typename TWriter>
+		void writeBlankRows(TWriter& writer)
+		{
+			if (m_encoding != RASTER_ENCODING_RAW)
+			{
+				writeFeed(writer);
+				return;
+			}
+
+			static const uint8_t zeros[512] = {};
+			size_t remaining = m_pendingBlankRows * m_rowBytes;
+			while (remaining > 0)
+			{
+				size_t chunk = std::min(remaining, sizeof(zeros));
+				writeRows(zeros, chunk, writer);
+				remaining -= chunk;
+			}
+			m_stats.blankRows -= m_pendingBlankRows;
+			m_pendingBlankRows = 0;
+		}
+
+		/**
+		 * @brief Writes raw rows as they are.
+		 */
+		template<typename TWriter>
+		void writeRows(const uint8_t* rows, size_t size, TWriter& writer)
+		{
+			writer.write(rows, size);
+			m_stats.encodedBytes += size;
+		}
+
+		/**
+		 * @brief Writes the held back blank rows as paper feeds.
+		 */
+		template<typename TWriter>
+		void writeFeed(TWriter& writer)
+		{
+			while (m_pendingBlankRows > 0)
+			{
+				size_t rows = std::min(m_pendingBlankRows, MAX_FEED_ROWS);
+				const escpos::Command<3> command = escpos::feedDots(static_cast<uint8_t>(rows));
+				writer.write(command.data(), command.size());
+				m_stats.encodedBytes += command.size();
+				m_pendingBlankRows -= rows;
+			}
+		}
+
+		/**
+		 * @brief Writes rows as one GS v 0 raster image.
+		 */
+		template<typename TWriter>
+		void writeImage(const uint8_t* rows, size_t widthBytes, size_t height, TWriter& writer)
+		{
+			const escpos::Command<escpos::RASTER_HEADER_SIZE> header = escpos::rasterHeader(widthBytes, height);
+			writer.write(header.data(), header.size());
+			writer.write(rows, widthBytes * height);
+			m_stats.encodedBytes += header.size() + widthBytes * height;
+		}
+
+		/**
+		 * @brief Bytes per raster row.
+		 */
+		size_t m_rowBytes;
+		/**
+		 * @brief Wire format.
+		 */
+		RasterEncoding m_encoding;
+		/**
+		 * @brief Whether blank rows at the end of the job are dropped.
+		 */
+		bool m_trimTrailing;
+		/**
+		 * @brief Blank rows seen but not yet written as a feed.
+		 */
+		size_t m_pendingBlankRows;
+		/**
+		 * @brief Statistics of the rows encoded so far.
+		 */
+		ENCODE_STATS m_stats;
+	};
+}
@@ -0,0 +1,573 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterKernels.cpp
+
+Abstract:
+	Scalar and vectorized implementations of the pixel kernels.
+
+--*/
+
+#include "RasterKernels.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RASTER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define RASTER_NEON
+#include <arm_neon.h>
+#endif
+
+// MSVC compiles intrinsics for any instruction set; GCC and Clang need the target per function.
+#if defined(RASTER_X86) && !defined(_MSC_VER)
+#define RASTER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RASTER_TARGET_AVX2
+#endif
+
+namespace
+{
+	using yhkcatprint::SimdLevel;
+
+	// Rounded x / 255 for x in [0, 65535].
+	inline uint32_t divide255(uint32_t x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	// The vector variants below evaluate exactly this formula in 16-bit lanes.
+	inline uint8_t grayOverWhite(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+	{
+		uint32_t luma = (77 * r + 150 * g + 29 * b + 128) >> 8;
+		return static_cast<uint8_t>(255 - divide255(a * (255 - luma)));
+	}
+
+	void rgbaToGrayScalar(const uint8_t* rgba, uint8_t* gray, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint8_t* pixel = rgba + i * 4;
+			gray[i] = grayOverWhite(pixel[0], pixel[1], pixel[2], pixel[3]);
+		}
+	}
+
+	void packThresholdScalar(const uint8_t* gray, const uint8_t* thresholds, uint8_t* packed, size_t width)
+	{
+		for (size_t x = 0; x < width; x += 8)
+		{
+			uint8_t bits = 0;
+			size_t end = width - x < 8 ? width - x : 8;
+			for (size_t i = 0; i < end; ++i)
+			{
+				if (gray[x + i] < thresholds[x + i])
+				{
+					bits |= static_cast<uint8_t>(0x80 >> i);
+				}
+			}
+			packed[x / 8] = bits;
+		}
+	}
+
+	size_t findNonZeroScalar(const uint8_t* data, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8)
+		{
+			uint64_t word;
+			std::memcpy(&word, data + i, sizeof(word));
+			if (word != 0)
+			{
+				break;
+			}
+		}
+		for (; i < size; ++i)
+		{
+			if (data[i] != 0)
+			{
+				return i;
+			}
+		}
+		return size;
+	}
+
+	size_t findLastNonZeroScalar(const uint8_t* data, size_t size)
+	{
+		size_t end = size;
+		for (; end >= 8; end -= 8)
+		{
+			uint64_t word;
+			std::memcpy(&word, data + end - 8, sizeof(word));
+			if (word != 0)
+			{
+				break;
+			}
+		}
+		while (end > 0)
+		{
+			if (data[--end] != 0)
+			{
+				return end;
+			}
+		}
+		return size;
+	}
+
+#if defined(RASTER_X86)
+	// Bit-reversal table turning movemask order, first pixel in bit 0, into printer order.
+	struct ReverseTable
+	{
+		uint8_t values[256];
+
+		ReverseTable()
+		{
+			for (int i = 0; i < 256; ++i)
+			{
+				uint8_t reversed = 0;
+				for (int bit = 0; bit < 8; ++bit)
+				{
+					if (i & (1 << bit))
+					{
+						reversed |= static_cast<uint8_t>(0x80 >> bit);
+					}
+				}
+				values[i] = reversed;
+			}
+		}
+	};
+
+	const ReverseTable reverseTable;
+
+	// Luma of 8 pixels held in two vectors of 4, as 16-bit lanes.
+	inline __m128i grayOverWhiteSse2(__m128i first, __m128i second)
+	{
+		const __m128i byteMask = _mm_set1_epi32(0xff);
+		const __m128i r = _mm_packs_epi32(_mm_and_si128(first, byteMask), _mm_and_si128(second, byteMask));
+		const __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(first, 8), byteMask), _mm_and_si128(_mm_srli_epi32(second, 8), byteMask));
+		const __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(first, 16), byteMask), _mm_and_si128(_mm_srli_epi32(second, 16), byteMask));
+		const __m128i a = _mm_packs_epi32(_mm_srli_epi32(first, 24), _mm_srli_epi32(second, 24));
+
+		const __m128i white = _mm_set1_epi16(255);
+		const __m128i half = _mm_set1_epi16(128);
+		__m128i luma = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(77)), _mm_mullo_epi16(g, _mm_set1_epi16(150)));
+		luma = _mm_add_epi16(luma, _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(29)), half));
+		luma = _mm_srli_epi16(luma, 8);
+
+		__m128i cover = _mm_add_epi16(_mm_mullo_epi16(a, _mm_sub_epi16(white, luma)), half);
+		cover = _mm_srli_epi16(_mm_add_epi16(cover, _mm_srli_epi16(cover, 8)), 8);
+		return _mm_sub_epi16(white, cover);
+	}
+
+	void rgbaToGraySse2(const uint8_t* rgba, uint8_t* gray, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m128i* source = reinterpret_cast<const __m128i*>(rgba + i * 4);
+			__m128i low = grayOverWhiteSse2(_mm_loadu_si128(source), _mm_loadu_si128(source + 1));
+			__m128i high = grayOverWhiteSse2(_mm_loadu_si128(source + 2), _mm_loadu_si128(source + 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(gray + i), _mm_packus_epi16(low, high));
+		}
+		rgbaToGrayScalar(rgba + i * 4, gray + i, count - i);
+	}
+
+	void packThresholdSse2(const uint8_t* gray, const uint8_t* thresholds, uint8_t* packed, size_t width)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gray + x));
+			__m128i limits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds + x));
+			// threshold - gray saturates to zero unless the pixel is darker.
+			__m128i light = _mm_cmpeq_epi8(_mm_subs_epu8(limits, pixels), zero);
+			int mask = ~_mm_movemask_epi8(light);
+			packed[x / 8] = reverseTable.values[mask & 0xff];
+			packed[x / 8 + 1] = reverseTable.values[(mask >> 8) & 0xff];
+		}
+		packThresholdScalar(gray + x, thresholds + x, packed + x / 8, width - x);
+	}
+
+	RASTER_TARGET_AVX2 inline __m256i grayOverWhiteAvx2(__m256i first, __m256i second)
+	{
+		const __m256i byteMask = _mm256_set1_epi32(0xff);
+		const __m256i r = _mm256_packs_epi32(_mm256_and_si256(first, byteMask), _mm256_and_si256(second, byteMask));
+		const __m256i g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(first, 8), byteMask), _mm256_and_si256(_mm256_srli_epi32(second, 8), byteMask));
+		const __m256i b = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(first, 16), byteMask), _mm256_and_si256(_mm256_srli_epi32(second, 16), byteMask));
+		const __m256i a = _mm256_packs_epi32(_mm256_srli_epi32(first, 24), _mm256_srli_epi32(second, 24));
+
+		const __m256i white = _mm256_set1_epi16(255);
+		const __m256i half = _mm256_set1_epi16(128);
+		__m256i luma = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(77)), _mm256_mullo_epi16(g, _mm256_set1_epi16(150)));
+		luma = _mm256_add_epi16(luma, _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(29)), half));
+		luma = _mm256_srli_epi16(luma, 8);
+
+		__m256i cover = _mm256_add_epi16(_mm256_mullo_epi16(a, _mm256_sub_epi16(white, luma)), half);
+		cover = _mm256_srli_epi16(_mm256_add_epi16(cover, _mm256_srli_epi16(cover, 8)), 8);
+		return _mm256_sub_epi16(white, cover);
+	}
+
+	RASTER_TARGET_AVX2 void rgbaToGrayAvx2(const uint8_t* rgba, uint8_t* gray, size_t count)
+	{
+		// Packing works within 128-bit lanes, which leaves groups of 4 pixels out of order.
+		const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			const __m256i* source = reinterpret_cast<const __m256i*>(rgba + i * 4);
+			__m256i low = grayOverWhiteAvx2(_mm256_loadu_si256(source), _mm256_loadu_si256(source + 1));
+			__m256i high = grayOverWhiteAvx2(_mm256_loadu_si256(source + 2), _mm256_loadu_si256(source + 3));
+			__m256i packedGray = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(gray + i), packedGray);
+		}
+		rgbaToGraySse2(rgba + i * 4, gray + i, count - i);
+	}
+
+	RASTER_TARGET_AVX2 void packThresholdAvx2(const uint8_t* gray, const uint8_t* thresholds, uint8_t* packed, size_t width)
+	{
+		// Reversing each group of 8 pixels makes movemask produce printer bit order directly.
+		const __m256i reverse = _mm256_setr_epi8(
+			7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+		const __m256i zero = _mm256_setzero_si256();
+		size_t x = 0;
+		for (; x + 32 <= width; x += 32)
+		{
+			__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gray + x));
+			__m256i limits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(thresholds + x));
+			__m256i light = _mm256_cmpeq_epi8(_mm256_subs_epu8(limits, pixels), zero);
+			uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_shuffle_epi8(light, reverse)));
+			packed[x / 8] = static_cast<uint8_t>(mask);
+			packed[x / 8 + 1] = static_cast<uint8_t>(mask >> 8);
+			packed[x / 8 + 2] = static_cast<uint8_t>(mask >> 16);
+			packed[x / 8 + 3] = static_cast<uint8_t>(mask >> 24);
+		}
+		packThresholdSse2(gray + x, thresholds + x, packed + x / 8, width - x);
+	}
+
+	// Zero scans OR 4 vectors per step and only look for the byte within a step that has one.
+	size_t findNonZeroSse2(const uint8_t* data, size_t size)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 64 <= size; i += 64)
+		{
+			const __m128i* block = reinterpret_cast<const __m128i*>(data + i);
+			__m128i any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(block), _mm_loadu_si128(block + 1)),
+				_mm_or_si128(_mm_loadu_si128(block + 2), _mm_loadu_si128(block + 3)));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xffff)
+			{
+				break;
+			}
+		}
+		return i + findNonZeroScalar(data + i, size - i);
+	}
+
+	size_t findLastNonZeroSse2(const uint8_t* data, size_t size)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t end = size;
+		for (; end >= 64; end -= 64)
+		{
+			const __m128i* block = reinterpret_cast<const __m128i*>(data + end - 64);
+			__m128i any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(block), _mm_loadu_si128(block + 1)),
+				_mm_or_si128(_mm_loadu_si128(block + 2), _mm_loadu_si128(block + 3)));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xffff)
+			{
+				break;
+			}
+		}
+		size_t found = findLastNonZeroScalar(data, end);
+		return found == end ? size : found;
+	}
+
+	RASTER_TARGET_AVX2 size_t findNonZeroAvx2(const uint8_t* data, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 128 <= size; i += 128)
+		{
+			const __m256i* block = reinterpret_cast<const __m256i*>(data + i);
+			__m256i any = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256(block), _mm256_loadu_si256(block + 1)),
+				_mm256_or_si256(_mm256_loadu_si256(block + 2), _mm256_loadu_si256(block + 3)));
+			if (!_mm256_testz_si256(any, any))
+			{
+				break;
+			}
+		}
+		return i + findNonZeroSse2(data + i, size - i);
+	}
+
+	RASTER_TARGET_AVX2 size_t findLastNonZeroAvx2(const uint8_t* data, size_t size)
+	{
+		size_t end = size;
+		for (; end >= 128; end -= 128)
+		{
+			const __m256i* block = reinterpret_cast<const __m256i*>(data + end - 128);
+			__m256i any = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256(block), _mm256_loadu_si256(block + 1)),
+				_mm256_or_si256(_mm256_loadu_si256(block + 2), _mm256_loadu_si256(block + 3)));
+			if (!_mm256_testz_si256(any, any))
+			{
+				break;
+			}
+		}
+		size_t found = findLastNonZeroSse2(data, end);
+		return found == end ? size : found;
+	}
+
+	SimdLevel detectX86()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		// AVX2 also needs the OS to preserve YMM registers across context switches.
+		if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 5)) != 0)
+			{
+				return yhkcatprint::SIMD_AVX2;
+			}
+		}
+		return sse2 ? yhkcatprint::SIMD_SSE2 : yhkcatprint::SIMD_SCALAR;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return yhkcatprint::SIMD_AVX2;
+		}
+		return __builtin_cpu_supports("sse2") ? yhkcatprint::SIMD_SSE2 : yhkcatprint::SIMD_SCALAR;
+#endif
+	}
+#endif
+
+#if defined(RASTER_NEON)
+	void rgbaToGrayNeon(const uint8_t* rgba, uint8_t* gray, size_t count)
+	{
+		const uint16x8_t white = vdupq_n_u16(255);
+		const uint16x8_t half = vdupq_n_u16(128);
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			uint8x16x4_t pixels = vld4q_u8(rgba + i * 4);
+			uint8x8_t halves[2];
+			for (int part = 0; part < 2; ++part)
+			{
+				uint8x8_t r = part == 0 ? vget_low_u8(pixels.val[0]) : vget_high_u8(pixels.val[0]);
+				uint8x8_t g = part == 0 ? vget_low_u8(pixels.val[1]) : vget_high_u8(pixels.val[1]);
+				uint8x8_t b = part == 0 ? vget_low_u8(pixels.val[2]) : vget_high_u8(pixels.val[2]);
+				uint8x8_t a = part == 0 ? vget_low_u8(pixels.val[3]) : vget_high_u8(pixels.val[3]);
+
+				uint16x8_t luma = vmull_u8(r, vdup_n_u8(77));
+				luma = vmlal_u8(luma, g, vdup_n_u8(150));
+				luma = vmlal_u8(luma, b, vdup_n_u8(29));
+				luma = vshrq_n_u16(vaddq_u16(luma, half), 8);
+
+				uint16x8_t cover = vaddq_u16(vmulq_u16(vmovl_u8(a), vsubq_u16(white, luma)), half);
+				cover = vshrq_n_u16(vaddq_u16(cover, vshrq_n_u16(cover, 8)), 8);
+				halves[part] = vmovn_u16(vsubq_u16(white, cover));
+			}
+			vst1q_u8(gray + i, vcombine_u8(halves[0], halves[1]));
+		}
+		rgbaToGrayScalar(rgba + i * 4, gray + i, count - i);
+	}
+
+	void packThresholdNeon(const uint8_t* gray, const uint8_t* thresholds, uint8_t* packed, size_t width)
+	{
+		static const uint8_t weightValues[8] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+		const uint8x8_t weights = vld1_u8(weightValues);
+		size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			uint8x16_t dark = vcltq_u8(vld1q_u8(gray + x), vld1q_u8(thresholds + x));
+			// Three pairwise additions sum each group of 8 weighted lanes into one byte.
+			uint8x8_t sums = vpadd_u8(vand_u8(vget_low_u8(dark), weights), vand_u8(vget_high_u8(dark), weights));
+			sums = vpadd_u8(sums, sums);
+			sums = vpadd_u8(sums, sums);
+			packed[x / 8] = vget_lane_u8(sums, 0);
+			packed[x / 8 + 1] = vget_lane_u8(sums, 1);
+		}
+		packThresholdScalar(gray + x, thresholds + x, packed + x / 8, width - x);
+	}
+
+	inline bool anyNonZeroNeon(uint8x16_t value)
+	{
+		uint64x2_t words = vreinterpretq_u64_u8(value);
+		return (vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1)) != 0;
+	}
+
+	size_t findNonZeroNeon(const uint8_t* data, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 64 <= size; i += 64)
+		{
+			uint8x16_t any = vorrq_u8(vorrq_u8(vld1q_u8(data + i), vld1q_u8(data + i + 16)),
+				vorrq_u8(vld1q_u8(data + i + 32), vld1q_u8(data + i + 48)));
+			if (anyNonZeroNeon(any))
+			{
+				break;
+			}
+		}
+		return i + findNonZeroScalar(data + i, size - i);
+	}
+
+	size_t findLastNonZeroNeon(const uint8_t* data, size_t size)
+	{
+		size_t end = size;
+		for (; end >= 64; end -= 64)
+		{
+			const uint8_t* block = data + end - 64;
+			uint8x16_t any = vorrq_u8(vorrq_u8(vld1q_u8(block), vld1q_u8(block + 16)),
+				vorrq_u8(vld1q_u8(block + 32), vld1q_u8(block + 48)));
+			if (anyNonZeroNeon(any))
+			{
+				break;
+			}
+		}
+		size_t found = findLastNonZeroScalar(data, end);
+		return found == end ? size : found;
+	}
+#endif
+}
+
+yhkcatprint::SimdLevel yhkcatprint::detectSimdLevel()
+{
+#if defined(RASTER_X86)
+	static const SimdLevel level = detectX86();
+	return level;
+#elif defined(RASTER_NEON)
+	return SIMD_NEON;
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+bool yhkcatprint::isSimdLevelSupported(SimdLevel level)
+{
+	switch (level)
+	{
+	case SIMD_SCALAR:
+		return true;
+	case SIMD_SSE2:
+	case SIMD_AVX2:
+#if defined(RASTER_X86)
+		return level <= detectSimdLevel();
+#else
+		return false;
+#endif
+	case SIMD_NEON:
+		return detectSimdLevel() == SIMD_NEON;
+	default:
+		return false;
+	}
+}
+
+const char* yhkcatprint::simdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SIMD_SSE2:
+		return "sse2";
+	case SIMD_AVX2:
+		return "avx2";
+	case SIMD_NEON:
+		return "neon";
+	default:
+		return "scalar";
+	}
+}
+
+void yhkcatprint::rgbaToGray(const uint8_t* rgba, uint8_t* gray, size_t count, SimdLevel level)
+{
+	switch (level)
+	{
+#if defined(RASTER_X86)
+	case SIMD_SSE2:
+		rgbaToGraySse2(rgba, gray, count);
+		return;
+	case SIMD_AVX2:
+		rgbaToGrayAvx2(rgba, gray, count);
+		return;
+#endif
+#if defined(RASTER_NEON)
+	case SIMD_NEON:
+		rgbaToGrayNeon(rgba, gray, count);
+		return;
+#endif
+	default:
+		rgbaToGrayScalar(rgba, gray, count);
+		return;
+	}
+}
+
+void yhkcatprint::packThreshold(const uint8_t* gray, const uint8_t* thresholds, uint8_t* packed, size_t width, SimdLevel level)
+{
+	switch (level)
+	{
+#if defined(RASTER_X86)
+	case SIMD_SSE2:
+		packThresholdSse2(gray, thresholds, packed, width);
+		return;
+	case SIMD_AVX2:
+		packThresholdAvx2(gray, thresholds, packed, width);
+		return;
+#endif
+#if defined(RASTER_NEON)
+	case SIMD_NEON:
+		packThresholdNeon(gray, thresholds, packed, width);
+		return;
+#endif
+	default:
+		packThresholdScalar(gray, thresholds, packed, width);
+		return;
+	}
+}
+
+size_t yhkcatprint::findNonZero(const uint8_t* data, size_t size, SimdLevel level)
+{
+	switch (level)
+	{
+#if defined(RASTER_X86)
+	case SIMD_SSE2:
+		return findNonZeroSse2(data, size);
+	case SIMD_AVX2:
+		return findNonZeroAvx2(data, size);
+#endif
+#if defined(RASTER_NEON)
+	case SIMD_NEON:
+		return findNonZeroNeon(data, size);
+#endif
+	default:
+		return findNonZeroScalar(data, size);
+	}
+}
+
+size_t yhkcatprint::findLastNonZero(const uint8_t* data, size_t size, SimdLevel level)
+{
+	switch (level)
+	{
+#if defined(RASTER_X86)
+	case SIMD_SSE2:
+		return findLastNonZeroSse2(data, size);
+	case SIMD_AVX2:
+		return findLastNonZeroAvx2(data, size);
+#endif
+#if defined(RASTER_NEON)
+	case SIMD_NEON:
+		return findLastNonZeroNeon(data, size);
+#endif
+	default:
+		return findLastNonZeroScalar(data, size);
+	}
+}
@@ -0,0 +1,122 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterKernels.h
+
+Abstract:
+	Vectorized pixel kernels used by the rasterizer.
+
+--*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RasterKernels.h
+ * @brief Vectorized pixel kernels used by the rasterizer.
+ *
+ * Every kernel has a scalar implementation and SSE2, AVX2 or NEON variants,
+ * depending on the target architecture. All variants produce bit-identical
+ * results, so the instruction set can be chosen at run time.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Instruction set used by the pixel kernels.
+	 */
+	enum SimdLevel
+	{
+		/**
+		 * @brief Portable scalar code.
+		 */
+		SIMD_SCALAR = 0,
+		/**
+		 * @brief x86 SSE2, 16 bytes per operation.
+		 */
+		SIMD_SSE2 = 1,
+		/**
+		 * @brief x86 AVX2, 32 bytes per operation.
+		 */
+		SIMD_AVX2 = 2,
+		/**
+		 * @brief ARM NEON, 16 bytes per operation.
+		 */
+		SIMD_NEON = 3
+	};
+
+	/**
+	 * @brief Detects the best instruction set supported by the CPU.
+	 *
+	 * @return Best supported level; the result is computed once and cached.
+	 */
+	SimdLevel detectSimdLevel();
+
+	/**
+	 * @brief Checks whether the CPU and the build support an instruction set.
+	 *
+	 * @param level Instruction set to check.
+	 * @return true if kernels can run at this level.
+	 */
+	bool isSimdLevelSupported(SimdLevel level);
+
+	/**
+	 * @brief Returns a short lowercase name of an instruction set, e.g. "avx2".
+	 */
+	const char* simdLevelName(SimdLevel level);
+
+	/**
+	 * @brief Converts RGBA pixels to 8-bit luma composited over white paper.
+	 *
+	 * Luma uses BT.601 weights. Transparent pixels become white, so images
+	 * with an alpha channel print the way they look on a white background.
+	 *
+	 * @param rgba Source pixels, 4 bytes each in R, G, B, A order.
+	 * @param gray Destination, one byte per pixel.
+	 * @param count Number of pixels.
+	 * @param level Instruction set to use; must be supported.
+	 */
+	void rgbaToGray(const uint8_t* rgba, uint8_t* gray, size_t count, SimdLevel level);
+
+	/**
+	 * @brief Thresholds a row of luma and packs it to 1 bit per pixel.
+	 *
+	 * A pixel becomes a black dot, bit value 1, when it is darker than its
+	 * threshold. Bits are packed most significant first, as the printer
+	 * expects. Bits past width in the last byte are cleared.
+	 *
+	 * @param gray Luma row.
+	 * @param thresholds Per-pixel thresholds, same length as the row.
+	 * @param packed Destination, (width + 7) / 8 bytes.
+	 * @param width Number of pixels.
+	 * @param level Instruction set to use; must be supported.
+	 */
+	void packThreshold(const uint8_t* gray, const uint8_t* thresholds, uint8_t* packed, size_t width, SimdLevel level);
+
+	/**
+	 * @brief Finds the first non-zero byte, i.e. the first black dot of a raster.
+	 *
+	 * The vector variants test whole cache lines at a time and stop at the
+	 * first one with a dot set, so blank regions are scanned at close to
+	 * memory read speed.
+	 *
+	 * @param data Bytes to scan.
+	 * @param size Number of bytes.
+	 * @param level Instruction set to use; must be supported.
+	 * @return Offset of the first non-zero byte, or size if all bytes are zero.
+	 */
+	size_t findNonZero(const uint8_t* data, size_t size, SimdLevel level);
+
+	/**
+	 * @brief Finds the last non-zero byte, scanning backwards from the end.
+	 *
+	 * @param data Bytes to scan.
+	 * @param size Number of bytes.
+	 * @param level Instruction set to use; must be supported.
+	 * @return Offset of the last non-zero byte, or size if all bytes are zero.
+	 */
+	size_t findLastNonZero(const uint8_t* data, size_t size, SimdLevel level);
+}
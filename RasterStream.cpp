@@ -0,0 +1,116 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterStream.cpp
+
+Abstract:
+	Implementation of RasterStream methods.
+
+--*/
+
+#include "RasterStream.h"
+#include <stdexcept>
+
+yhkcatprint::RasterStream::RasterStream(const RASTER_OPTIONS& options, const IMAGE_DESC& image, size_t bandRows, size_t bandCount)
+	: m_rasterizer(options), m_bandRows(bandRows), m_rows(0), m_free(bandCount), m_ready(bandCount)
+{
+	if (bandRows == 0 || bandCount < 2)
+	{
+		throw std::invalid_argument("A stream needs at least 2 bands of at least 1 row");
+	}
+
+	// Validate on the caller's thread so bad input fails here rather than in next().
+	m_rasterizer.begin(image);
+	m_rows = m_rasterizer.rows();
+
+	for (size_t i = 0; i < bandCount; ++i)
+	{
+		PooledBuffer buffer = BufferPool::instance().acquire(bandRows * m_rasterizer.rowBytes());
+		m_free.tryPush(buffer);
+	}
+
+	m_worker = std::thread(&RasterStream::run, this);
+}
+
+yhkcatprint::RasterStream::~RasterStream()
+{
+	cancel();
+	if (m_worker.joinable())
+	{
+		m_worker.join();
+	}
+}
+
+size_t yhkcatprint::RasterStream::rowBytes() const
+{
+	return m_rasterizer.rowBytes();
+}
+
+uint32_t yhkcatprint::RasterStream::rows() const
+{
+	return m_rows;
+}
+
+std::span<const uint8_t> yhkcatprint::RasterStream::next()
+{
+	if (m_current.has_value())
+	{
+		m_free.tryPush(m_current->buffer);
+		m_current.reset();
+	}
+
+	std::optional<Band> band = m_ready.pop();
+	if (!band.has_value())
+	{
+		// The render thread is finishing or already done; joining makes m_error safe to read.
+		if (m_worker.joinable())
+		{
+			m_worker.join();
+		}
+		if (m_error)
+		{
+			std::rethrow_exception(m_error);
+		}
+		return {};
+	}
+
+	m_current = std::move(band);
+	return { m_current->buffer.data(), m_current->size };
+}
+
+void yhkcatprint::RasterStream::cancel()
+{
+	m_free.close();
+	m_ready.close();
+}
+
+void yhkcatprint::RasterStream::run()
+{
+	try
+	{
+		while (m_rasterizer.remaining() > 0)
+		{
+			std::optional<PooledBuffer> buffer = m_free.pop();
+			if (!buffer.has_value())
+			{
+				break;
+			}
+
+			Band band;
+			band.buffer = std::move(*buffer);
+			band.size = m_rasterizer.render(band.buffer.data(), m_bandRows) * m_rasterizer.rowBytes();
+			if (!m_ready.push(band))
+			{
+				break;
+			}
+		}
+	}
+	catch (...)
+	{
+		m_error = std::current_exception();
+	}
+
+	m_ready.close();
+}
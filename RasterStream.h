@@ -0,0 +1,163 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterStream.h
+
+Abstract:
+	Banded rasterization on a background thread.
+
+--*/
+
+#pragma once
+#include "BoundedQueue.h"
+#include "BufferPool.h"
+#include "Raster.h"
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <span>
+#include <thread>
+
+/**
+ * @file RasterStream.h
+ * @brief Banded rasterization on a background thread.
+ *
+ * This header defines RasterStream, which renders an image in fixed-height
+ * bands on a render thread while the caller sends the bands already done.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Image rasterized in bands on a background thread.
+	 *
+	 * A fixed set of band buffers circulates between the render thread and
+	 * the consumer: the render thread fills a free buffer and queues it,
+	 * the consumer takes it with next() and hands it back on the following
+	 * call. Memory use is therefore bandCount * bandRows rows regardless of
+	 * the image length, and the first band can be sent as soon as it is
+	 * rendered. With three buffers, one band can be rendered while another
+	 * is being sent and a third waits ready.
+	 *
+	 * @note next() must be called from one thread at a time.
+	 */
+	class RasterStream
+	{
+	public:
+		/**
+		 * @brief Default band height in rows.
+		 */
+		static constexpr size_t DEFAULT_BAND_ROWS = 64;
+
+		/**
+		 * @brief Default number of band buffers, for triple buffering.
+		 */
+		static constexpr size_t DEFAULT_BAND_COUNT = 3;
+
+		/**
+		 * @brief Constructs a RasterStream and starts rendering.
+		 *
+		 * @param options Rasterization options.
+		 * @param image Source image; its pixels must stay valid until the stream is destroyed.
+		 * @param bandRows Rows per band.
+		 * @param bandCount Number of band buffers, at least 2.
+		 *
+		 * @throws std::invalid_argument if the options or the image are invalid.
+		 */
+		RasterStream(const RASTER_OPTIONS& options, const IMAGE_DESC& image,
+			size_t bandRows = DEFAULT_BAND_ROWS, size_t bandCount = DEFAULT_BAND_COUNT);
+
+		/**
+		 * @brief Destructor. Stops rendering and joins the render thread.
+		 */
+		~RasterStream();
+
+		// Disable copy semantics
+		RasterStream(const RasterStream&) = delete;
+		RasterStream& operator=(const RasterStream&) = delete;
+
+		/**
+		 * @brief Returns the size of one output row in bytes.
+		 */
+		size_t rowBytes() const;
+
+		/**
+		 * @brief Returns the total number of output rows.
+		 */
+		uint32_t rows() const;
+
+		/**
+		 * @brief Waits for the next rendered band.
+		 *
+		 * The band returned by the previous call is recycled and must no
+		 * longer be used.
+		 *
+		 * @return Packed rows of the band, or an empty span once the image is finished.
+		 *
+		 * @throws std::exception rethrown from the render thread if rendering failed.
+		 */
+		std::span<const uint8_t> next();
+
+		/**
+		 * @brief Stops rendering; next() then returns the bands already queued.
+		 */
+		void cancel();
+
+	private:
+		/**
+		 * @brief Rendered band.
+		 */
+		struct Band
+		{
+			/**
+			 * @brief Band buffer from the BufferPool, sized for bandRows rows.
+			 */
+			PooledBuffer buffer;
+			/**
+			 * @brief Number of bytes rendered into the buffer.
+			 */
+			size_t size;
+		};
+
+		/**
+		 * @brief Render thread body.
+		 */
+		void run();
+
+		/**
+		 * @brief Rasterizer, used only by the render thread once started.
+		 */
+		Rasterizer m_rasterizer;
+		/**
+		 * @brief Rows per band.
+		 */
+		size_t m_bandRows;
+		/**
+		 * @brief Total number of output rows.
+		 */
+		uint32_t m_rows;
+		/**
+		 * @brief Buffers waiting to be rendered into.
+		 */
+		BoundedQueue<PooledBuffer> m_free;
+		/**
+		 * @brief Bands waiting to be consumed, in image order.
+		 */
+		BoundedQueue<Band> m_ready;
+		/**
+		 * @brief Band last returned by next().
+		 */
+		std::optional<Band> m_current;
+		/**
+		 * @brief Error raised by the render thread; read only after joining it.
+		 */
+		std::exception_ptr m_error;
+		/**
+		 * @brief Render thread.
+		 */
+		std::thread m_worker;
+	};
+}
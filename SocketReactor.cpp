@@ -0,0 +1,531 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	SocketReactor.cpp
+
+Abstract:
+	Implementation of SocketReactor methods.
+
+--*/
+
+#include "SocketReactor.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+// Link with Ws2_32.lib
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Tokens of watched sockets start after the one reserved for wake-ups.
+	const uint64_t wakeToken = 0;
+}
+
+/**
+ * Waits on the native handles with epoll on Linux and WSAPoll on Windows.
+ * A wake-up handle in the same wait set interrupts the wait when sockets
+ * are added or removed, when the reactor stops, and when a socket without
+ * a native handle signals readiness.
+ */
+class yhkcatprint::SocketReactor::Poller
+{
+public:
+	Poller()
+	{
+#ifdef _WIN32
+		WSADATA wsaData;
+		if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+			throw std::runtime_error("WSAStartup failed");
+		}
+
+		// WSAPoll only waits on sockets, so wake-ups are datagrams the socket sends to itself.
+		m_wakeSocket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		int length = sizeof(address);
+		u_long nonBlocking = 1;
+		if (m_wakeSocket == INVALID_SOCKET
+			|| ::bind(m_wakeSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR
+			|| ::getsockname(m_wakeSocket, reinterpret_cast<sockaddr*>(&m_wakeAddress), &length) == SOCKET_ERROR
+			|| ::ioctlsocket(m_wakeSocket, FIONBIO, &nonBlocking) == SOCKET_ERROR) {
+			int error = WSAGetLastError();
+			if (m_wakeSocket != INVALID_SOCKET) {
+				::closesocket(m_wakeSocket);
+			}
+			WSACleanup();
+			throw std::runtime_error("Failed to create reactor wake-up socket, error: " + std::to_string(error));
+		}
+#else
+		m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		m_wakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.u64 = wakeToken;
+		if (m_epoll < 0 || m_wakeFd < 0 || ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeFd, &event) < 0) {
+			int error = errno;
+			if (m_wakeFd >= 0) {
+				::close(m_wakeFd);
+			}
+			if (m_epoll >= 0) {
+				::close(m_epoll);
+			}
+			throw std::runtime_error("Failed to create epoll instance, errno: " + std::to_string(error));
+		}
+#endif
+	}
+
+	~Poller()
+	{
+#ifdef _WIN32
+		::closesocket(m_wakeSocket);
+		WSACleanup();
+#else
+		::close(m_wakeFd);
+		::close(m_epoll);
+#endif
+	}
+
+	Poller(const Poller&) = delete;
+	Poller& operator=(const Poller&) = delete;
+
+	void add(intptr_t handle, uint64_t token)
+	{
+#ifdef _WIN32
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			WSAPOLLFD fd = {};
+			fd.fd = static_cast<SOCKET>(handle);
+			fd.events = POLLRDNORM;
+			m_fds.push_back(fd);
+			m_fdTokens.push_back(token);
+		}
+		// The reactor thread may be waiting on the old set.
+		wake();
+#else
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLRDHUP;
+		event.data.u64 = token;
+		if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, static_cast<int>(handle), &event) < 0) {
+			throw std::runtime_error("Failed to watch socket, errno: " + std::to_string(errno));
+		}
+#endif
+	}
+
+	void remove(intptr_t handle) noexcept
+	{
+#ifdef _WIN32
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (size_t i = 0; i < m_fds.size(); ++i) {
+				if (m_fds[i].fd == static_cast<SOCKET>(handle)) {
+					m_fds.erase(m_fds.begin() + i);
+					m_fdTokens.erase(m_fdTokens.begin() + i);
+					break;
+				}
+			}
+		}
+		wake();
+#else
+		// Fails harmlessly if the owner already closed the descriptor, which removes it too.
+		::epoll_ctl(m_epoll, EPOLL_CTL_DEL, static_cast<int>(handle), nullptr);
+#endif
+	}
+
+	void signal(uint64_t token)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_signalled.push_back(token);
+		}
+		wake();
+	}
+
+	void wake() noexcept
+	{
+#ifdef _WIN32
+		const char byte = 0;
+		::sendto(m_wakeSocket, &byte, 1, 0, reinterpret_cast<const sockaddr*>(&m_wakeAddress), sizeof(m_wakeAddress));
+#else
+		uint64_t one = 1;
+		ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+		(void)written;
+#endif
+	}
+
+	/**
+	 * Blocks until a socket is readable or wake() is called, and appends the
+	 * tokens of the ready and signalled sockets, possibly with duplicates.
+	 */
+	void wait(std::vector<uint64_t>& ready)
+	{
+#ifdef _WIN32
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_waitFds.assign(m_fds.begin(), m_fds.end());
+			m_waitTokens.assign(m_fdTokens.begin(), m_fdTokens.end());
+		}
+		WSAPOLLFD wakeFd = {};
+		wakeFd.fd = m_wakeSocket;
+		wakeFd.events = POLLRDNORM;
+		m_waitFds.push_back(wakeFd);
+		m_waitTokens.push_back(wakeToken);
+
+		if (WSAPoll(m_waitFds.data(), static_cast<ULONG>(m_waitFds.size()), -1) == SOCKET_ERROR) {
+			throw std::runtime_error("WSAPoll failed, error: " + std::to_string(WSAGetLastError()));
+		}
+		for (size_t i = 0; i < m_waitFds.size(); ++i) {
+			if (m_waitFds[i].revents == 0) {
+				continue;
+			}
+			if (m_waitTokens[i] == wakeToken) {
+				char discard[64];
+				while (::recv(m_wakeSocket, discard, sizeof(discard), 0) > 0) {
+				}
+				continue;
+			}
+			ready.push_back(m_waitTokens[i]);
+		}
+#else
+		epoll_event events[64];
+		int count = ::epoll_wait(m_epoll, events, 64, -1);
+		if (count < 0 && errno != EINTR) {
+			throw std::runtime_error("epoll_wait failed, errno: " + std::to_string(errno));
+		}
+		for (int i = 0; i < count; ++i) {
+			if (events[i].data.u64 == wakeToken) {
+				uint64_t value;
+				ssize_t drained = ::read(m_wakeFd, &value, sizeof(value));
+				(void)drained;
+				continue;
+			}
+			ready.push_back(events[i].data.u64);
+		}
+#endif
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ready.insert(ready.end(), m_signalled.begin(), m_signalled.end());
+		m_signalled.clear();
+	}
+
+private:
+	// Guards m_signalled, and m_fds and m_fdTokens on Windows.
+	std::mutex m_mutex;
+	std::vector<uint64_t> m_signalled;
+#ifdef _WIN32
+	SOCKET m_wakeSocket;
+	sockaddr_in m_wakeAddress = {};
+	std::vector<WSAPOLLFD> m_fds;
+	std::vector<uint64_t> m_fdTokens;
+	// Copies taken for one wait, reused so waiting does not allocate.
+	std::vector<WSAPOLLFD> m_waitFds;
+	std::vector<uint64_t> m_waitTokens;
+#else
+	int m_epoll;
+	int m_wakeFd;
+#endif
+};
+
+yhkcatprint::SocketReactor::SocketReactor()
+	: m_poller(std::make_shared<Poller>()), m_nextToken(wakeToken + 1), m_dispatching(false), m_rounds(0), m_stopping(false)
+{
+	m_thread = std::thread(&SocketReactor::run, this);
+}
+
+yhkcatprint::SocketReactor::~SocketReactor()
+{
+	stop();
+}
+
+void yhkcatprint::SocketReactor::watch(std::shared_ptr<IRfcommSocket> socket, std::shared_ptr<IEventListener> listener)
+{
+	if (socket == nullptr || listener == nullptr)
+	{
+		throw std::invalid_argument("Socket and listener are required");
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_stopping)
+	{
+		throw std::runtime_error("Socket reactor stopped");
+	}
+	if (m_tokens.find(socket.get()) != m_tokens.end())
+	{
+		throw std::invalid_argument("Socket already watched");
+	}
+
+	auto watch = std::make_shared<Watch>();
+	watch->token = m_nextToken++;
+	watch->socket = socket;
+	watch->listener = std::move(listener);
+	watch->handle = socket->nativeHandle();
+	watch->active = true;
+
+	if (watch->handle != IRfcommSocket::NO_NATIVE_HANDLE)
+	{
+		m_poller->add(watch->handle, watch->token);
+	}
+	else
+	{
+		// The callback may outlive the reactor, so it holds the poller rather than the reactor.
+		std::shared_ptr<Poller> poller = m_poller;
+		uint64_t token = watch->token;
+		if (!socket->setReadableCallback([poller, token] { poller->signal(token); }))
+		{
+			throw std::runtime_error("Socket can be neither polled nor notify readiness");
+		}
+		// Bytes that arrived before the callback was set would otherwise wait for the next write.
+		m_poller->signal(token);
+	}
+
+	m_watches[watch->token] = watch;
+	m_tokens[socket.get()] = watch->token;
+}
+
+bool yhkcatprint::SocketReactor::unwatch(const IRfcommSocket& socket)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto token = m_tokens.find(&socket);
+	if (token == m_tokens.end())
+	{
+		return false;
+	}
+	remove(m_watches[token->second]);
+
+	// A listener calling this from the reactor thread is itself the callback under way.
+	if (std::this_thread::get_id() != m_thread.get_id())
+	{
+		uint64_t round = m_rounds;
+		m_idle.wait(lock, [this, round] { return !m_dispatching || m_rounds != round; });
+	}
+	return true;
+}
+
+bool yhkcatprint::SocketReactor::isWatching(const IRfcommSocket& socket) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_tokens.find(&socket) != m_tokens.end();
+}
+
+size_t yhkcatprint::SocketReactor::watchedCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_watches.size();
+}
+
+void yhkcatprint::SocketReactor::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_poller->wake();
+
+	if (m_thread.joinable())
+	{
+		if (std::this_thread::get_id() == m_thread.get_id())
+		{
+			m_thread.detach();
+		}
+		else
+		{
+			m_thread.join();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	while (!m_watches.empty())
+	{
+		remove(m_watches.begin()->second);
+	}
+}
+
+void yhkcatprint::SocketReactor::run()
+{
+	std::vector<uint64_t> ready;
+	std::vector<std::shared_ptr<Watch>> watches;
+	std::vector<Event> events;
+
+	while (true)
+	{
+		ready.clear();
+		try
+		{
+			m_poller->wait(ready);
+		}
+		catch (const std::exception& ex)
+		{
+			std::cerr << "Socket reactor stopped: " << ex.what() << std::endl;
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+			break;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_stopping)
+			{
+				break;
+			}
+
+			std::sort(ready.begin(), ready.end());
+			ready.erase(std::unique(ready.begin(), ready.end()), ready.end());
+			for (uint64_t token : ready)
+			{
+				auto watch = m_watches.find(token);
+				if (watch != m_watches.end())
+				{
+					watches.push_back(watch->second);
+				}
+			}
+			if (watches.empty())
+			{
+				continue;
+			}
+			m_dispatching = true;
+		}
+
+		// Every ready socket is drained before any listener runs.
+		for (const auto& watch : watches)
+		{
+			read(watch, events);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (Event& event : events)
+			{
+				event.deliver = event.watch->active;
+				if (event.closed && event.watch->active)
+				{
+					// Dropped before its listener hears of it, so isWatching() is already false in onSocketClosed.
+					remove(event.watch);
+				}
+			}
+		}
+
+		for (Event& event : events)
+		{
+			if (event.deliver)
+			{
+				IEventListener& listener = *event.watch->listener;
+				try
+				{
+					if (!event.closed)
+					{
+						listener.onSocketDateReceived(*event.watch->socket, event.buffer.get(), event.size);
+					}
+					else
+					{
+						if (!event.error.empty())
+						{
+							listener.onError({ -1, event.error });
+						}
+						listener.onSocketClosed(*event.watch->socket);
+					}
+				}
+				catch (const std::exception& ex)
+				{
+					std::cerr << "Socket listener failed: " << ex.what() << std::endl;
+				}
+			}
+			if (event.buffer != nullptr)
+			{
+				m_freeBuffers.push_back(std::move(event.buffer));
+			}
+		}
+		events.clear();
+		watches.clear();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_dispatching = false;
+			m_rounds++;
+		}
+		m_idle.notify_all();
+	}
+}
+
+void yhkcatprint::SocketReactor::read(const std::shared_ptr<Watch>& watch, std::vector<Event>& events)
+{
+	IRfcommSocket& socket = *watch->socket;
+	try
+	{
+		for (size_t reads = 0; reads < MAX_READS_PER_WAKE; ++reads)
+		{
+			// Readable also means closed by the peer, which receive() reports as 0 bytes.
+			if (!socket.available())
+			{
+				return;
+			}
+
+			std::unique_ptr<uint8_t[]> buffer;
+			if (m_freeBuffers.empty())
+			{
+				buffer.reset(new uint8_t[BUFFER_SIZE]);
+			}
+			else
+			{
+				buffer = std::move(m_freeBuffers.back());
+				m_freeBuffers.pop_back();
+			}
+
+			size_t received = socket.receive(buffer.get(), BUFFER_SIZE);
+			if (received == 0)
+			{
+				m_freeBuffers.push_back(std::move(buffer));
+				events.push_back({ watch, nullptr, 0, true, {}, false });
+				return;
+			}
+			events.push_back({ watch, std::move(buffer), received, false, {}, false });
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		events.push_back({ watch, nullptr, 0, true, ex.what(), false });
+		return;
+	}
+
+	// Sockets without a native handle are not reported again until the next write, so the rest is read next round.
+	if (watch->handle == IRfcommSocket::NO_NATIVE_HANDLE)
+	{
+		m_poller->signal(watch->token);
+	}
+}
+
+void yhkcatprint::SocketReactor::remove(std::shared_ptr<Watch> watch)
+{
+	watch->active = false;
+	m_tokens.erase(watch->socket.get());
+	m_watches.erase(watch->token);
+
+	if (watch->handle != IRfcommSocket::NO_NATIVE_HANDLE)
+	{
+		m_poller->remove(watch->handle);
+		return;
+	}
+
+	try
+	{
+		watch->socket->setReadableCallback({});
+	}
+	catch (const std::exception&)
+	{
+		// A socket that is no longer connected has no callback to remove.
+	}
+}
@@ -0,0 +1,251 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	SocketReactor.h
+
+Abstract:
+	Background thread delivering data received on many sockets to listeners.
+
+--*/
+
+#pragma once
+#include "IEventListener.h"
+#include "IRfcommSocket.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file SocketReactor.h
+ * @brief Background thread delivering data received on many sockets to listeners.
+ *
+ * This header defines SocketReactor, which waits on all watched sockets at
+ * once on a single thread and passes whatever they receive to
+ * IEventListener::onSocketDateReceived, so that monitoring many printers
+ * does not need a blocked thread per link.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Background thread delivering data received on many sockets to listeners.
+	 *
+	 * Sockets with a native handle are waited on with epoll on Linux and
+	 * WSAPoll on Windows; sockets without one, such as loopback sockets,
+	 * report readiness through IRfcommSocket::setReadableCallback. When
+	 * sockets become readable, the reactor first drains all of them into
+	 * receive buffers and only then calls the listeners, so a slow listener
+	 * does not hold up reading the other links. Receive buffers are pooled
+	 * and reused, so receiving does not allocate once the pool has grown to
+	 * the number of buffers in flight.
+	 *
+	 * A socket whose peer closes the connection, or whose receive fails, is
+	 * dropped: the listener gets onError for a failure and then
+	 * onSocketClosed. While a socket is watched the reactor owns its reads;
+	 * the owner may keep sending but must not receive.
+	 *
+	 * @note All public methods are thread-safe. Listener callbacks run on the
+	 *       reactor thread; the data pointer is valid only during the call.
+	 */
+	class SocketReactor
+	{
+	public:
+		/**
+		 * @brief Size of one receive buffer.
+		 */
+		static constexpr size_t BUFFER_SIZE = 4096;
+
+		/**
+		 * @brief Most buffers read from one socket per wake-up, so that a busy link cannot starve the others.
+		 */
+		static constexpr size_t MAX_READS_PER_WAKE = 16;
+
+		/**
+		 * @brief Constructs a SocketReactor and starts its thread.
+		 *
+		 * @throws std::runtime_error if the system wait facility cannot be created.
+		 */
+		SocketReactor();
+
+		/**
+		 * @brief Destructor. Stops the reactor.
+		 */
+		~SocketReactor();
+
+		// Disable copy semantics
+		SocketReactor(const SocketReactor&) = delete;
+		SocketReactor& operator=(const SocketReactor&) = delete;
+
+		/**
+		 * @brief Starts delivering data received on a socket.
+		 *
+		 * @param socket Connected socket; the reactor keeps it alive while watching.
+		 * @param listener Listener for the socket's data, closure and errors.
+		 *
+		 * @throws std::invalid_argument if the socket or listener is nullptr, or the socket is already watched.
+		 * @throws std::runtime_error if the socket can be neither polled nor notify readiness, or the reactor is stopped.
+		 */
+		void watch(std::shared_ptr<IRfcommSocket> socket, std::shared_ptr<IEventListener> listener);
+
+		/**
+		 * @brief Stops delivering data received on a socket.
+		 *
+		 * When called from outside the reactor thread, waits until callbacks
+		 * already under way have returned, so no callback for the socket runs
+		 * after this returns. A listener must therefore not wait for a thread
+		 * that is calling unwatch().
+		 *
+		 * @param socket Watched socket.
+		 * @return true if the socket was watched.
+		 */
+		bool unwatch(const IRfcommSocket& socket);
+
+		/**
+		 * @brief Checks whether a socket is watched; false once its connection has closed.
+		 */
+		bool isWatching(const IRfcommSocket& socket) const;
+
+		/**
+		 * @brief Returns the number of watched sockets.
+		 */
+		size_t watchedCount() const;
+
+		/**
+		 * @brief Stops the reactor thread and drops all sockets without notifying their listeners.
+		 */
+		void stop();
+
+	private:
+		/**
+		 * @brief System facility waiting on many sockets at once.
+		 */
+		class Poller;
+
+		/**
+		 * @brief Watched socket.
+		 */
+		struct Watch
+		{
+			/**
+			 * @brief Key the poller reports readiness with.
+			 */
+			uint64_t token;
+			/**
+			 * @brief Watched socket.
+			 */
+			std::shared_ptr<IRfcommSocket> socket;
+			/**
+			 * @brief Listener for the socket.
+			 */
+			std::shared_ptr<IEventListener> listener;
+			/**
+			 * @brief Native handle registered with the poller, or IRfcommSocket::NO_NATIVE_HANDLE.
+			 */
+			intptr_t handle;
+			/**
+			 * @brief Whether the socket is still watched; cleared under m_mutex.
+			 */
+			bool active;
+		};
+
+		/**
+		 * @brief Data, closure or failure read from a socket, to be delivered.
+		 */
+		struct Event
+		{
+			/**
+			 * @brief Socket the event belongs to.
+			 */
+			std::shared_ptr<Watch> watch;
+			/**
+			 * @brief Received bytes, or nullptr for closure.
+			 */
+			std::unique_ptr<uint8_t[]> buffer;
+			/**
+			 * @brief Number of received bytes.
+			 */
+			size_t size;
+			/**
+			 * @brief Whether the connection closed or failed; closure is the socket's last event.
+			 */
+			bool closed;
+			/**
+			 * @brief Receive failure, empty if none.
+			 */
+			std::string error;
+			/**
+			 * @brief Whether the socket was still watched when the reading finished.
+			 */
+			bool deliver;
+		};
+
+		/**
+		 * @brief Waits for readiness and delivers events until stop() is called.
+		 */
+		void run();
+
+		/**
+		 * @brief Reads what a ready socket has received into events.
+		 */
+		void read(const std::shared_ptr<Watch>& watch, std::vector<Event>& events);
+
+		/**
+		 * @brief Removes a socket from the maps and the poller; m_mutex must be held.
+		 *
+		 * @param watch Watched socket, taken by value because it may be the one held in m_watches.
+		 */
+		void remove(std::shared_ptr<Watch> watch);
+
+		/**
+		 * @brief System wait facility, shared with readiness callbacks that may outlive the reactor.
+		 */
+		std::shared_ptr<Poller> m_poller;
+		/**
+		 * @brief Watched sockets by token.
+		 */
+		std::unordered_map<uint64_t, std::shared_ptr<Watch>> m_watches;
+		/**
+		 * @brief Tokens of watched sockets by socket.
+		 */
+		std::unordered_map<const IRfcommSocket*, uint64_t> m_tokens;
+		/**
+		 * @brief Token of the next watched socket.
+		 */
+		uint64_t m_nextToken;
+		/**
+		 * @brief Whether the reactor thread is reading or delivering.
+		 */
+		bool m_dispatching;
+		/**
+		 * @brief Number of finished rounds of reading and delivering.
+		 */
+		uint64_t m_rounds;
+		/**
+		 * @brief Whether the reactor thread should stop.
+		 */
+		bool m_stopping;
+		/**
+		 * @brief Guards the watches, m_nextToken, m_dispatching, m_rounds and m_stopping.
+		 */
+		mutable std::mutex m_mutex;
+		/**
+		 * @brief Signalled when the reactor thread finishes delivering.
+		 */
+		std::condition_variable m_idle;
+		/**
+		 * @brief Receive buffers not in use; only the reactor thread touches it.
+		 */
+		std::vector<std::unique_ptr<uint8_t[]>> m_freeBuffers;
+		/**
+		 * @brief Reactor thread.
+		 */
+		std::thread m_thread;
+	};
+}
@@ -0,0 +1,159 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	AddressBenchmark.cpp
+
+Abstract:
+	Bluetooth address parsing, formatting and lookup benchmark cases.
+
+--*/
+
+#include "Benchmark.h"
+#include "../BluetoothAddress.h"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+	// About as many devices as a busy office has paired, looked up many times each.
+	const size_t addressCount = 64;
+	const size_t operationsPerSample = 100000;
+	const size_t defaultIterations = 20;
+
+	using Clock = std::chrono::steady_clock;
+
+	// The stream-based conversions the adapters and sockets used before BluetoothAddress.
+	uint64_t parseWithStream(const std::string& address)
+	{
+		uint64_t btAddr = 0;
+		std::istringstream iss(address);
+		std::string byteStr;
+		for (int i = 0; i < 6; ++i)
+		{
+			if (!std::getline(iss, byteStr, ':'))
+			{
+				throw std::invalid_argument("Invalid Bluetooth address format");
+			}
+			uint8_t byte = static_cast<uint8_t>(std::stoul(byteStr, nullptr, 16));
+			btAddr |= (static_cast<uint64_t>(byte) << (8 * (5 - i)));
+		}
+		return btAddr;
+	}
+
+	std::string formatWithStream(uint64_t value)
+	{
+		std::ostringstream oss;
+		oss << std::hex << std::setfill('0');
+		for (int i = 5; i >= 0; --i)
+		{
+			oss << std::setw(2) << ((value >> (i * 8)) & 0xFF);
+			if (i != 0)
+				oss << ":";
+		}
+		return oss.str();
+	}
+
+	std::vector<uint64_t> makeAddresses()
+	{
+		std::vector<uint64_t> addresses;
+		addresses.reserve(addressCount);
+		uint64_t state = 12345;
+		for (size_t i = 0; i < addressCount; ++i)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			addresses.push_back(state >> 16);
+		}
+		return addresses;
+	}
+
+	/**
+	 * Times operationsPerSample calls of the function per sample and returns
+	 * nanoseconds per call. The function returns a value that is summed, so
+	 * the compiler cannot drop the work.
+	 */
+	template<typename Function>
+	std::vector<double> measure(size_t iterations, uint64_t& sink, Function function)
+	{
+		std::vector<double> samples;
+		samples.reserve(iterations);
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			Clock::time_point start = Clock::now();
+			for (size_t op = 0; op < operationsPerSample; ++op)
+			{
+				sink += function(op % addressCount);
+			}
+			samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operationsPerSample);
+		}
+		return samples;
+	}
+}
+
+std::vector<yhkcatprint::BENCH_RESULT> yhkcatprint::runAddressBenchmarks(const BENCH_OPTIONS& options)
+{
+	const size_t iterations = options.iterations > 0 ? options.iterations : defaultIterations;
+
+	std::vector<uint64_t> values = makeAddresses();
+	std::vector<std::string> texts;
+	std::unordered_map<std::string, size_t> byText;
+	std::unordered_map<BluetoothAddress, size_t> byAddress;
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		texts.push_back(formatWithStream(values[i]));
+		byText[texts.back()] = i;
+		byAddress[BluetoothAddress(values[i])] = i;
+	}
+
+	std::vector<BENCH_RESULT> results;
+	uint64_t sink = 0;
+
+	// Each pair runs the old code first, so the new one can report its speedup over it.
+	auto run = [&](const std::string& name, double baseline, auto function) {
+		if (name.find(options.filter) == std::string::npos)
+		{
+			return 0.0;
+		}
+
+		std::vector<double> samples = measure(iterations, sink, function);
+		double median = percentile(samples, 50.0);
+		results.push_back({ name, {
+			{ "operations", static_cast<double>(operationsPerSample) },
+			{ "iterations", static_cast<double>(iterations) },
+			{ "p50_ns_per_op", median },
+			{ "speedup", baseline > 0.0 && median > 0.0 ? baseline / median : 0.0 },
+		} });
+		return median;
+	};
+
+	double parseStream = run("address/parse/stream", 0.0, [&](size_t i) {
+		return parseWithStream(texts[i]);
+	});
+	run("address/parse/constexpr", parseStream, [&](size_t i) {
+		return BluetoothAddress::fromString(texts[i]).value();
+	});
+
+	double formatStream = run("address/format/stream", 0.0, [&](size_t i) {
+		return static_cast<uint64_t>(formatWithStream(values[i])[16]);
+	});
+	run("address/format/chars", formatStream, [&](size_t i) {
+		return static_cast<uint64_t>(BluetoothAddress(values[i]).toChars()[16]);
+	});
+
+	double lookupText = run("address/lookup/string", 0.0, [&](size_t i) {
+		return static_cast<uint64_t>(byText.find(texts[i])->second);
+	});
+	run("address/lookup/value", lookupText, [&](size_t i) {
+		return static_cast<uint64_t>(byAddress.find(BluetoothAddress::fromString(texts[i]))->second);
+	});
+
+	// Publishing the sum keeps the measured calls from being optimized away.
+	volatile uint64_t observed = sink;
+	(void)observed;
+	return results;
+}
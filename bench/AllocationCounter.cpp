@@ -0,0 +1,155 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	AllocationCounter.cpp
+
+Abstract:
+	Replacement of the global allocation functions that counts heap allocations per thread.
+
+--*/
+
+#include "Benchmark.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local uint64_t allocations = 0;
+
+	void* allocate(std::size_t size)
+	{
+		allocations++;
+		void* memory = std::malloc(size > 0 ? size : 1);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+
+	void* allocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		allocations++;
+		std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+		void* memory = ::_aligned_malloc(size > 0 ? size : 1, align);
+#else
+		void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+
+	void deallocateAligned(void* memory) noexcept
+	{
+#ifdef _WIN32
+		::_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+}
+
+uint64_t yhkcatprint::threadAllocations() noexcept
+{
+	return allocations;
+}
+
+void* operator new(std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return allocate(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return allocate(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return allocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	deallocateAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	deallocateAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	deallocateAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	deallocateAligned(memory);
+}
@@ -0,0 +1,113 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Benchmark.cpp
+
+Abstract:
+	Statistics and JSON reporting shared by benchmark cases.
+
+--*/
+
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+
+namespace
+{
+	std::string escapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text)
+		{
+			switch (c)
+			{
+			case '"':
+				escaped += "\\\"";
+				break;
+			case '\\':
+				escaped += "\\\\";
+				break;
+			default:
+				escaped += c;
+				break;
+			}
+		}
+		return escaped;
+	}
+
+	void writeNumber(std::ostream& out, double value)
+	{
+		// JSON has no representation for infinities or NaN.
+		if (!std::isfinite(value))
+		{
+			out << "null";
+		}
+		else if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0)
+		{
+			out << static_cast<long long>(value);
+		}
+		else
+		{
+			out << value;
+		}
+	}
+}
+
+double yhkcatprint::percentile(std::vector<double>& samples, double percentile)
+{
+	if (samples.empty())
+	{
+		return 0.0;
+	}
+
+	size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * samples.size()));
+	size_t index = std::clamp<size_t>(rank, 1, samples.size()) - 1;
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return samples[index];
+}
+
+void yhkcatprint::writeJson(std::ostream& out, const BENCH_OPTIONS& options, const std::vector<BENCH_RESULT>& results)
+{
+	const EMULATOR_CONFIG& emulator = options.emulator;
+	std::time_t now = std::time(nullptr);
+	std::tm utc = {};
+#ifdef _WIN32
+	gmtime_s(&utc, &now);
+#else
+	gmtime_r(&now, &utc);
+#endif
+
+	out << std::setprecision(6);
+	out << "{\n";
+	out << "  \"timestamp\": \"" << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ") << "\",\n";
+	out << "  \"transport\": \"" << escapeJson(options.transport) << "\",\n";
+	out << "  \"emulator\": {\n";
+	out << "    \"bandwidth\": " << emulator.bandwidth << ",\n";
+	out << "    \"latency_us\": " << emulator.latency.count() << ",\n";
+	out << "    \"packet_size\": " << emulator.packetSize << ",\n";
+	out << "    \"buffer_size\": " << emulator.bufferSize << ",\n";
+	out << "    \"feed_rate\": " << emulator.feedRate << ",\n";
+	out << "    \"connect_ms\": " << emulator.connectDelay.count() << "\n";
+	out << "  },\n";
+	out << "  \"results\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		out << (i == 0 ? "\n" : ",\n");
+		out << "    { \"name\": \"" << escapeJson(results[i].name) << "\"";
+		for (const auto& [metric, value] : results[i].metrics)
+		{
+			out << ", \"" << escapeJson(metric) << "\": ";
+			writeNumber(out, value);
+		}
+		out << " }";
+	}
+
+	out << "\n  ]\n";
+	out << "}\n";
+}
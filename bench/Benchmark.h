@@ -0,0 +1,186 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Benchmark.h
+
+Abstract:
+	End-to-end benchmark cases and result reporting.
+
+--*/
+
+#pragma once
+#include "../emulator/PrinterEmulator.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file Benchmark.h
+ * @brief End-to-end benchmark cases and result reporting.
+ *
+ * Benchmarks run the production print path against PrinterEmulator, or
+ * the rasterizer on synthetic images, and report named metrics. Results are written as JSON, one object per case,
+ * so that runs of different releases can be compared mechanically.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Benchmark run options.
+	 */
+	typedef struct _BENCH_OPTIONS
+	{
+		/**
+		 * @brief Transport to the emulator, "loop" or "tcp".
+		 */
+		std::string transport = "loop";
+		/**
+		 * @brief Nominal raster sizes in bytes; each is rounded down to whole rows.
+		 */
+		std::vector<size_t> sizes = { 1 << 10, 4 << 10, 16 << 10, 64 << 10, 256 << 10, 1 << 20, 4 << 20, 8 << 20 };
+		/**
+		 * @brief Jobs per case, 0 to scale the count with the raster size.
+		 */
+		size_t iterations = 0;
+		/**
+		 * @brief Case name filter; only cases whose name contains it run.
+		 */
+		std::string filter;
+		/**
+		 * @brief Emulated printer configuration.
+		 */
+		EMULATOR_CONFIG emulator;
+	} BENCH_OPTIONS;
+
+	/**
+	 * @brief Result of one benchmark case.
+	 */
+	typedef struct _BENCH_RESULT
+	{
+		/**
+		 * @brief Case name, e.g. "print/session/65536".
+		 */
+		std::string name;
+		/**
+		 * @brief Named metrics in reporting order.
+		 */
+		std::vector<std::pair<std::string, double>> metrics;
+	} BENCH_RESULT;
+
+	/**
+	 * @brief Runs the end-to-end print cases.
+	 *
+	 * Three scenarios run for every raster size: "oneshot" opens a session,
+	 * prints and closes it for each job; "pooled" does the same with the
+	 * links kept in a ConnectionPool, like NativePrinter.printBuffer, and
+	 * also reports how many connects it needed; "session" prints all jobs
+	 * over one persistent session. Each connect takes 200 ms unless the
+	 * emulator options set a connect delay, and the emulator ends a job on
+	 * its end-of-job feed rather than after an idle gap. The image cases
+	 * print a grayscale image over one session, either rasterized in full
+	 * before sending ("prerender") or sent in bands while it is rendered
+	 * ("stream"), and also report the raster memory held. The receipt cases
+	 * print text-like raster sent raw, with blank rows encoded as paper
+	 * feeds, or also with the blank bottom trimmed, check the printed raster
+	 * and report the bytes sent. The fleet cases route jobs through a
+	 * PrintScheduler to the least loaded of three emulated printers, one
+	 * of them slower, and report how many jobs each printed. The flow cases
+	 * print, up to 256 KB, on a printer that prints 2000 rows per second
+	 * unless set otherwise, drops data arriving at its full buffer and
+	 * reports its buffer filling up: with the default FlowControl, which
+	 * sends unpaced while the print speed is unknown ("off"), paced by
+	 * FlowControl trusting the emulator's status ("on"), and paced while the printer runs out of paper halfway through
+	 * each job ("pause"); they report the jobs printed intact, the bytes
+	 * dropped and the print speed FlowControl learned. Only "on" fails on
+	 * lost data, since a printer that empties its buffer faster than a
+	 * status can stop the sends drops what was on the way at the outage. The status cases,
+	 * run once rather than per size, time reading the printer's state by
+	 * querying it over the link ("query") against reading the state the
+	 * session cached ("cached"), and count the reads that decoded; "split"
+	 * times handshakes with a printer that sends its replies in pieces and
+	 * counts those that decoded both replies. Timings are
+	 * taken from the submission on the caller side to the moment the
+	 * emulator received the first raster byte and printed the last row.
+	 *
+	 * @param options Run options.
+	 * @return One result per scenario and size, and one per status case.
+	 *
+	 * @throws std::runtime_error if the emulator cannot be started or a job does not finish.
+	 */
+	std::vector<BENCH_RESULT> runPrintBenchmarks(const BENCH_OPTIONS& options);
+
+	/**
+	 * @brief Runs the rasterization cases.
+	 *
+	 * The gray and threshold kernels are timed at every instruction set the
+	 * CPU supports and report their speedup over the scalar code. The blank
+	 * scan cases time the zero scan over a buffer larger than the caches
+	 * and compare it with copying the buffer. The image
+	 * cases time the whole Rasterizer on a photo-sized RGBA image with each
+	 * dithering method.
+	 *
+	 * @param options Run options; only iterations and filter apply.
+	 * @return One result per kernel and instruction set, and per dithering method.
+	 */
+	std::vector<BENCH_RESULT> runRasterBenchmarks(const BENCH_OPTIONS& options);
+
+	/**
+	 * @brief Runs the Bluetooth address cases.
+	 *
+	 * Parsing and formatting with BluetoothAddress are timed against the
+	 * stream-based conversions it replaced, and a device lookup keyed by
+	 * BluetoothAddress against one keyed by the address text. Each case
+	 * reports nanoseconds per operation and its speedup over the old code.
+	 *
+	 * @param options Run options; only iterations and filter apply.
+	 * @return One result per operation and implementation.
+	 */
+	std::vector<BENCH_RESULT> runAddressBenchmarks(const BENCH_OPTIONS& options);
+
+	/**
+	 * @brief Runs the receive delivery cases.
+	 *
+	 * Emulated printers on 1, 16 and 256 loopback links send status-sized
+	 * messages, which the host receives either with a blocking thread per
+	 * link ("threads") or through one SocketReactor ("reactor"). Each case
+	 * reports the receive threads used, the delivery latency and the
+	 * message throughput.
+	 *
+	 * @param options Run options; iterations sets the messages per link, and filter applies.
+	 * @return One result per receive model and link count.
+	 *
+	 * @throws std::runtime_error if the messages are not delivered.
+	 */
+	std::vector<BENCH_RESULT> runReactorBenchmarks(const BENCH_OPTIONS& options);
+
+	/**
+	 * @brief Returns the given percentile of the samples using nearest rank.
+	 *
+	 * @param samples Samples, reordered in place.
+	 * @param percentile Percentile between 0 and 100.
+	 * @return Percentile value, 0 if there are no samples.
+	 */
+	double percentile(std::vector<double>& samples, double percentile);
+
+	/**
+	 * @brief Returns the number of heap allocations the calling thread has made.
+	 *
+	 * AllocationCounter.cpp replaces the global allocation functions to count
+	 * them, so that bench cases and unit tests can check how many allocations
+	 * a loop makes.
+	 */
+	uint64_t threadAllocations() noexcept;
+
+	/**
+	 * @brief Writes results as a JSON document.
+	 *
+	 * @param out Output stream.
+	 * @param options Options the results were produced with.
+	 * @param results Results to write.
+	 */
+	void writeJson(std::ostream& out, const BENCH_OPTIONS& options, const std::vector<BENCH_RESULT>& results);
+}
@@ -0,0 +1,774 @@
+﻿/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintBenchmark.cpp
+
+Abstract:
+	End-to-end print throughput and latency benchmark cases.
+
+--*/
+
+#include "Benchmark.h"
+#include "../ConnectionPool.h"
+#include "../EscPos.h"
+#include "../LoopbackPipe.h"
+#include "../PrinterSession.h"
+#include "../PrinterStatus.h"
+#include "../ProtoDevice.h"
+#include "../PrintScheduler.h"
+#include "../RasterStream.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+	const char* const loopbackName = "yhkcatprint-bench";
+	const uint8_t benchChannel = 2;
+	const std::chrono::seconds jobTimeout{ 120 };
+	// Setting up an RFCOMM link to a paired printer, paid by every connect unless --connect-ms sets it.
+	const std::chrono::milliseconds printConnectDelay{ 200 };
+	// The oneshot scenario connects for every job, so it runs fewer of them.
+	const size_t oneshotIterations = 20;
+	const char* const fleetGroup = "bench";
+	const size_t fleetSize = 3;
+	// Flow cases print at a real printer's pace, so they are kept to a few jobs of moderate size.
+	const double flowFeedRate = 2000.0;
+	const size_t flowMaxSize = 256u << 10;
+	const size_t flowIterations = 3;
+	const std::chrono::milliseconds flowPause{ 100 };
+	const double flowInitialRate = 8192.0;
+	// Sends wait on a printer that is still being learned for longer than the session cases' job gap.
+	const std::chrono::milliseconds flowJobGap{ 1000 };
+	const std::chrono::seconds flowSettle{ 2 };
+	const size_t statusIterations = 200;
+	// Split replies take a few milliseconds to arrive, so fewer handshakes are timed.
+	const size_t splitIterations = 20;
+	const size_t splitFragment = 5;
+
+	using Clock = std::chrono::steady_clock;
+
+	std::string listen(yhkcatprint::PrinterEmulator& emulator, const std::string& transport, const std::string& name)
+	{
+		if (transport == "tcp")
+		{
+			return "tcp://127.0.0.1:" + std::to_string(emulator.listenTcp(0));
+		}
+		if (transport == "loop")
+		{
+			emulator.listenLoopback(name);
+			return std::string(yhkcatprint::LoopbackListener::SCHEME) + name;
+		}
+		throw std::invalid_argument("Unknown transport: " + transport);
+	}
+
+	std::vector<uint8_t> makeRaster(size_t size, size_t rowBytes)
+	{
+		// A non-uniform pattern keeps rows from ever looking like the end-of-job feed.
+		std::vector<uint8_t> raster(size / rowBytes * rowBytes);
+		for (size_t i = 0; i < raster.size(); ++i)
+		{
+			raster[i] = static_cast<uint8_t>(i * 131 + 7);
+		}
+		return raster;
+	}
+
+	size_t iterationsFor(const yhkcatprint::BENCH_OPTIONS& options, size_t size)
+	{
+		if (options.iterations > 0)
+		{
+			return options.iterations;
+		}
+		// Roughly 32 MB per case, but enough samples for a meaningful p99 on small jobs.
+		return std::clamp<size_t>((32u << 20) / std::max<size_t>(size, 1), 5, 200);
+	}
+
+	/**
+	 * Returns the heap allocations the calling thread made per job since the first of the given jobs finished.
+	 */
+	double allocationsPerJob(uint64_t afterFirstJob, size_t jobs)
+	{
+		return jobs > 1 ? static_cast<double>(yhkcatprint::threadAllocations() - afterFirstJob) / static_cast<double>(jobs - 1) : 0.0;
+	}
+
+	double milliseconds(Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	std::vector<uint8_t> makeGrayImage(size_t width, size_t height)
+	{
+		// Smooth gradients with noise, so that dithering does real work on every row.
+		std::vector<uint8_t> pixels(width * height);
+		uint32_t state = 12345;
+		for (size_t y = 0; y < height; ++y)
+		{
+			for (size_t x = 0; x < width; ++x)
+			{
+				state = state * 1664525 + 1013904223;
+				pixels[y * width + x] = static_cast<uint8_t>((x + y) % 256 / 2 + (state >> 25));
+			}
+		}
+		return pixels;
+	}
+
+	std::vector<uint8_t> makeReceipt(size_t size, size_t rowBytes)
+	{
+		// Lines of 24-row glyphs over part of the width with 8 blank rows between them, like printed text,
+		// and a blank bottom quarter, like a fixed-height canvas that was not filled.
+		const size_t lineRows = 24;
+		const size_t gapRows = 8;
+		std::vector<uint8_t> raster(size / rowBytes * rowBytes);
+		uint32_t state = 54321;
+		for (size_t row = 0; row < raster.size() / rowBytes * 3 / 4; ++row)
+		{
+			size_t line = row / (lineRows + gapRows);
+			if (row % (lineRows + gapRows) >= lineRows)
+			{
+				continue;
+			}
+
+			size_t textBytes = rowBytes / 2 + line * 7 % (rowBytes / 2);
+			for (size_t i = 0; i < textBytes; ++i)
+			{
+				state = state * 1664525 + 1013904223;
+				raster[row * rowBytes + i] = static_cast<uint8_t>(state >> 24);
+			}
+		}
+		return raster;
+	}
+
+	/**
+	 * Checks that a job printed the first printed bytes of the raster followed only by blank rows.
+	 */
+	bool printedIntact(const std::vector<uint8_t>& raster, size_t printed, const yhkcatprint::EMULATOR_JOB& job, size_t rowBytes)
+	{
+		return job.raster.size() >= printed && std::equal(raster.begin(), raster.begin() + printed, job.raster.begin())
+			&& yhkcatprint::countBlankRows(job.raster.data() + printed, (job.raster.size() - printed) / rowBytes, rowBytes) * rowBytes
+				== job.raster.size() - printed;
+	}
+
+	yhkcatprint::BENCH_RESULT summarize(const std::string& name, size_t size, const std::vector<Clock::time_point>& submitted,
+		const std::vector<yhkcatprint::EMULATOR_JOB>& jobs)
+	{
+		if (jobs.size() != submitted.size())
+		{
+			throw std::runtime_error("Emulator saw " + std::to_string(jobs.size()) + " jobs in " + name);
+		}
+
+		std::vector<double> firstByte;
+		std::vector<double> completion;
+		for (size_t i = 0; i < submitted.size(); ++i)
+		{
+			firstByte.push_back(milliseconds(jobs[i].firstByte - submitted[i]));
+			completion.push_back(milliseconds(jobs[i].finished - submitted[i]));
+		}
+		double iterations = static_cast<double>(submitted.size());
+		double seconds = std::chrono::duration<double>(jobs.back().finished - submitted.front()).count();
+		double bytes = static_cast<double>(size) * iterations;
+
+		return { name, {
+			{ "size", static_cast<double>(size) },
+			{ "iterations", iterations },
+			{ "jobs_per_sec", iterations / seconds },
+			{ "bytes_per_sec", bytes / seconds },
+			{ "ttfb_p50_ms", yhkcatprint::percentile(firstByte, 50.0) },
+			{ "ttfb_p99_ms", yhkcatprint::percentile(firstByte, 99.0) },
+			{ "completion_p50_ms", yhkcatprint::percentile(completion, 50.0) },
+			{ "completion_p99_ms", yhkcatprint::percentile(completion, 99.0) },
+		} };
+	}
+}
+
+std::vector<yhkcatprint::BENCH_RESULT> yhkcatprint::runPrintBenchmarks(const BENCH_OPTIONS& options)
+{
+	EMULATOR_CONFIG config = options.emulator;
+	// Raw jobs end on their end-of-job feed, which makeRaster rows never begin with; the gap only
+	// ends jobs cut off mid-row.
+	config.endOnTrailer = true;
+	config.jobGap = std::min(config.jobGap, std::chrono::milliseconds(50));
+
+	// Only this printer models the connect, which is what the pooled scenario saves over oneshot.
+	EMULATOR_CONFIG printConfig = config;
+	if (printConfig.connectDelay == std::chrono::milliseconds::zero())
+	{
+		printConfig.connectDelay = printConnectDelay;
+	}
+	PrinterEmulator emulator(printConfig);
+	std::string address = listen(emulator, options.transport, loopbackName);
+
+	std::vector<BENCH_RESULT> results;
+	size_t finished = 0;
+
+	for (const char* scenario : { "oneshot", "pooled", "session" })
+	{
+		const bool persistent = std::string(scenario) == "session";
+		std::shared_ptr<ConnectionPool> pool = std::string(scenario) == "pooled" ? std::make_shared<ConnectionPool>() : nullptr;
+
+		for (size_t size : options.sizes)
+		{
+			std::string name = std::string("print/") + scenario + "/" + std::to_string(size);
+			if (name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> raster = makeRaster(size, config.rowBytes);
+			size_t iterations = iterationsFor(options, size);
+			if (std::string(scenario) == "oneshot" && options.iterations == 0)
+			{
+				iterations = std::min(iterations, oneshotIterations);
+			}
+			std::vector<Clock::time_point> submitted;
+			submitted.reserve(iterations);
+			emulator.clearJobs();
+
+			double steadyAllocations = 0.0;
+			if (persistent)
+			{
+				PrinterSession session(address, benchChannel);
+				session.open();
+				uint64_t allocationsBefore = 0;
+				for (size_t i = 0; i < iterations; ++i)
+				{
+					submitted.push_back(Clock::now());
+					session.print(raster.data(), raster.size());
+					if (i == 0)
+					{
+						allocationsBefore = threadAllocations();
+					}
+				}
+				// Reported only; the print_allocation unit tests fail the build on any allocation.
+				steadyAllocations = allocationsPerJob(allocationsBefore, iterations);
+				finished += iterations;
+				if (!emulator.waitForJobs(finished, jobTimeout))
+				{
+					throw std::runtime_error("Emulator did not finish " + name);
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < iterations; ++i)
+				{
+					submitted.push_back(Clock::now());
+					PrinterSession session(address, benchChannel, pool);
+					session.open();
+					session.print(raster.data(), raster.size());
+					session.close();
+
+					// The emulator serves one connection at a time, like the printer.
+					if (!emulator.waitForJobs(++finished, jobTimeout))
+					{
+						throw std::runtime_error("Emulator did not finish " + name);
+					}
+				}
+			}
+
+			BENCH_RESULT result = summarize(name, raster.size(), submitted, emulator.jobs());
+			if (persistent)
+			{
+				result.metrics.push_back({ "allocs_per_job", steadyAllocations });
+			}
+			if (!persistent)
+			{
+				result.metrics.push_back({ "connect_ms", static_cast<double>(printConfig.connectDelay.count()) });
+			}
+			if (pool != nullptr)
+			{
+				POOL_STATS poolStats = pool->stats();
+				result.metrics.push_back({ "connects", static_cast<double>(poolStats.connected) });
+				result.metrics.push_back({ "reused", static_cast<double>(poolStats.reused) });
+			}
+			results.push_back(result);
+		}
+
+		if (pool != nullptr)
+		{
+			pool->clear();
+		}
+	}
+
+	// Image jobs print a grayscale image at the dot width, dithered with Floyd-Steinberg.
+	// "prerender" rasterizes the whole image before sending, "stream" sends bands as they are rendered.
+	RASTER_OPTIONS rasterOptions;
+	rasterOptions.dotWidth = static_cast<uint32_t>(config.rowBytes * 8);
+
+	for (const char* scenario : { "prerender", "stream" })
+	{
+		const bool streaming = std::string(scenario) == "stream";
+
+		for (size_t size : options.sizes)
+		{
+			std::string name = std::string("image/") + scenario + "/" + std::to_string(size);
+			if (name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			size_t rows = std::max<size_t>(size / config.rowBytes, 1);
+			std::vector<uint8_t> pixels = makeGrayImage(rasterOptions.dotWidth, rows);
+			IMAGE_DESC image;
+			image.pixels = pixels.data();
+			image.width = rasterOptions.dotWidth;
+			image.height = static_cast<uint32_t>(rows);
+			image.format = PIXEL_FORMAT_GRAY;
+
+			size_t iterations = iterationsFor(options, size);
+			std::vector<Clock::time_point> submitted;
+			submitted.reserve(iterations);
+			size_t peakRaster = 0;
+			emulator.clearJobs();
+
+			PrinterSession session(address, benchChannel);
+			session.open();
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				submitted.push_back(Clock::now());
+				if (streaming)
+				{
+					RasterStream stream(rasterOptions, image);
+					session.print(stream);
+					peakRaster = RasterStream::DEFAULT_BAND_ROWS * RasterStream::DEFAULT_BAND_COUNT * config.rowBytes;
+				}
+				else
+				{
+					Rasterizer rasterizer(rasterOptions);
+					std::vector<uint8_t> raster = rasterizer.rasterize(image);
+					session.print(raster.data(), raster.size());
+					peakRaster = raster.size();
+				}
+			}
+			finished += iterations;
+			if (!emulator.waitForJobs(finished, jobTimeout))
+			{
+				throw std::runtime_error("Emulator did not finish " + name);
+			}
+
+			BENCH_RESULT result = summarize(name, rows * config.rowBytes, submitted, emulator.jobs());
+			result.metrics.push_back({ "peak_raster_bytes", static_cast<double>(peakRaster) });
+			results.push_back(result);
+		}
+	}
+
+	// Receipt jobs print text-like raster over one session, sent as it is ("raw"), with blank rows
+	// replaced by paper feeds ("image") or also without the blank bottom ("trim"), and check what was printed.
+	for (const char* scenario : { "raw", "image", "trim" })
+	{
+		const RasterEncoding encoding = std::string(scenario) == "raw" ? RASTER_ENCODING_RAW : RASTER_ENCODING_IMAGE;
+		const bool trim = std::string(scenario) == "trim";
+
+		for (size_t size : options.sizes)
+		{
+			std::string name = std::string("receipt/") + scenario + "/" + std::to_string(size);
+			if (name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> raster = makeReceipt(size, config.rowBytes);
+			size_t iterations = iterationsFor(options, size);
+			std::vector<Clock::time_point> submitted;
+			submitted.reserve(iterations);
+			ENCODE_STATS stats;
+			emulator.clearJobs();
+
+			PrinterSession session(address, benchChannel);
+			session.setEncoding(encoding);
+			session.setTrimming(trim);
+			session.open();
+			uint64_t allocationsBefore = 0;
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				submitted.push_back(Clock::now());
+				stats = session.print(raster.data(), raster.size());
+				if (i == 0)
+				{
+					allocationsBefore = threadAllocations();
+				}
+			}
+			// Reported only, as in the session cases.
+			double steadyAllocations = allocationsPerJob(allocationsBefore, iterations);
+			finished += iterations;
+			if (!emulator.waitForJobs(finished, jobTimeout))
+			{
+				throw std::runtime_error("Emulator did not finish " + name);
+			}
+
+			// The printed raster is the input without the trimmed rows, followed by the end-of-job feed.
+			size_t printed = raster.size() - stats.trimmedRows * config.rowBytes;
+			std::vector<EMULATOR_JOB> jobs = emulator.jobs();
+			for (const EMULATOR_JOB& job : jobs)
+			{
+				if (!printedIntact(raster, printed, job, config.rowBytes))
+				{
+					throw std::runtime_error("Emulator printed a different raster in " + name);
+				}
+			}
+
+			BENCH_RESULT result = summarize(name, raster.size(), submitted, jobs);
+			result.metrics.push_back({ "sent_bytes", static_cast<double>(stats.encodedBytes) });
+			result.metrics.push_back({ "compression_ratio", static_cast<double>(stats.rasterBytes) / static_cast<double>(stats.encodedBytes) });
+			result.metrics.push_back({ "trimmed_rows", static_cast<double>(stats.trimmedRows) });
+			result.metrics.push_back({ "allocs_per_job", steadyAllocations });
+			results.push_back(result);
+		}
+	}
+
+	// Status cases read the printer's state by asking it over the link ("query"), as a health check had
+	// to before the state was cached, and from the session's last known state ("cached").
+	for (const char* mode : { "query", "cached" })
+	{
+		std::string name = std::string("status/") + mode;
+		if (name.find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		const size_t iterations = options.iterations > 0 ? options.iterations : statusIterations;
+		std::vector<double> samples;
+		samples.reserve(iterations);
+		size_t decoded = 0;
+		const uint8_t expectedBattery = config.status[escpos::STATUS_BATTERY] & static_cast<uint8_t>(~escpos::BATTERY_CHARGING);
+
+		if (std::string(mode) == "query")
+		{
+			constexpr auto getStatusCmd = escpos::getStatus();
+			ProtoDevice device(address, address);
+			std::shared_ptr<IRfcommSocket> socket = device.createRfcommSocket(benchChannel, TIMEOUT_DEFAULT);
+			uint8_t reply[escpos::STATUS_SIZE];
+			// The first query also waits for the emulated link to come up, so it is not timed.
+			for (size_t i = 0; i <= iterations; ++i)
+			{
+				Clock::time_point start = Clock::now();
+				socket->send(getStatusCmd.data(), getStatusCmd.size());
+				size_t received = 0;
+				while (received < sizeof(reply))
+				{
+					received += socket->receive(reply + received, sizeof(reply) - received, PrinterSession::RESPONSE_TIMEOUT);
+				}
+				if (i == 0)
+				{
+					continue;
+				}
+				std::optional<PRINTER_STATUS> status = decodeStatus(reply);
+				samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+				decoded += status && status->battery == expectedBattery ? 1 : 0;
+			}
+			socket->close();
+		}
+		else
+		{
+			PrinterSession session(address, benchChannel);
+			session.open();
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				Clock::time_point start = Clock::now();
+				PRINTER_STATE state = session.printerState();
+				samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+				decoded += state.hasStatus && state.hasIdentity && state.status.battery == expectedBattery ? 1 : 0;
+			}
+			session.close();
+		}
+
+		results.push_back({ name, {
+			{ "iterations", static_cast<double>(iterations) },
+			{ "decoded", static_cast<double>(decoded) },
+			{ "p50_us", percentile(samples, 50.0) },
+			{ "p99_us", percentile(samples, 99.0) },
+		} });
+	}
+
+	// The split case opens sessions to a printer that sends its replies in pieces, as RFCOMM may deliver
+	// them, and counts the handshakes that decoded both replies.
+	if (std::string("status/split").find(options.filter) != std::string::npos)
+	{
+		EMULATOR_CONFIG splitConfig = config;
+		splitConfig.replyFragment = splitFragment;
+		PrinterEmulator splitEmulator(splitConfig);
+		std::string splitAddress = listen(splitEmulator, options.transport, std::string(loopbackName) + "-split");
+
+		const size_t iterations = options.iterations > 0 ? std::min(options.iterations, splitIterations) : splitIterations;
+		const size_t serialLength = std::find(splitConfig.serial.begin(), splitConfig.serial.end(), 0) - splitConfig.serial.begin();
+		std::vector<double> samples;
+		size_t decoded = 0;
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			PrinterSession session(splitAddress, benchChannel);
+			Clock::time_point start = Clock::now();
+			session.open();
+			samples.push_back(milliseconds(Clock::now() - start));
+			PRINTER_STATE state = session.printerState();
+			decoded += state.hasStatus && state.hasIdentity && state.identity.serialLength == serialLength ? 1 : 0;
+			session.close();
+		}
+		splitEmulator.stop();
+
+		results.push_back({ "status/split", {
+			{ "iterations", static_cast<double>(iterations) },
+			{ "fragment", static_cast<double>(splitFragment) },
+			{ "decoded", static_cast<double>(decoded) },
+			{ "handshake_p50_ms", percentile(samples, 50.0) },
+			{ "handshake_p99_ms", percentile(samples, 99.0) },
+		} });
+	}
+
+	emulator.stop();
+
+	// Flow jobs print on a printer that drops data arriving at its full buffer and reports its buffer
+	// filling up. "off" sends with the default flow control, "on" paces sends to the reports, and "pause" also runs the printer
+	// out of paper halfway through each job. Each case checks what was printed and reports the data lost.
+	EMULATOR_CONFIG flowConfig = config;
+	flowConfig.dropOnOverflow = true;
+	flowConfig.reportBufferFull = true;
+	flowConfig.jobGap = flowJobGap;
+	if (flowConfig.feedRate <= 0.0)
+	{
+		flowConfig.feedRate = flowFeedRate;
+	}
+
+	PrinterEmulator flowEmulator(flowConfig);
+	std::string flowAddress = listen(flowEmulator, options.transport, std::string(loopbackName) + "-flow");
+	size_t flowFinished = 0;
+
+	for (const char* scenario : { "off", "on", "pause" })
+	{
+		const bool paced = std::string(scenario) != "off";
+		const bool pausing = std::string(scenario) == "pause";
+
+		for (size_t size : options.sizes)
+		{
+			std::string name = std::string("flow/") + scenario + "/" + std::to_string(size);
+			if (size > flowMaxSize || name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> raster = makeRaster(size, flowConfig.rowBytes);
+			size_t iterations = options.iterations > 0 ? options.iterations : flowIterations;
+			auto printTime = std::chrono::duration<double>(raster.size() / flowConfig.rowBytes / flowConfig.feedRate);
+			flowEmulator.clearJobs();
+
+			// "off" keeps the defaults, which send unpaced while the print speed is unknown. The emulated
+			// printer reports its buffer in the status layout it defines, so the paced cases trust it, and
+			// start at once from a slow printer's speed.
+			FLOW_CONTROL_CONFIG flow;
+			flow.printerBuffer = flowConfig.bufferSize;
+			if (paced)
+			{
+				flow.pauseOnStatus = true;
+				flow.initialDrainRate = flowInitialRate;
+			}
+			PrinterSession session(flowAddress, benchChannel);
+			session.setFlowControl(flow);
+			session.open();
+
+			Clock::time_point started = Clock::now();
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				std::thread outage;
+				if (pausing)
+				{
+					outage = std::thread([&flowEmulator, printTime]
+					{
+						std::this_thread::sleep_for(printTime / 2);
+						flowEmulator.setCondition(escpos::CONDITION_PAPER_OUT);
+						std::this_thread::sleep_for(flowPause);
+						flowEmulator.setCondition(0);
+					});
+				}
+
+				try
+				{
+					session.print(raster.data(), raster.size());
+				}
+				catch (...)
+				{
+					if (outage.joinable())
+					{
+						outage.join();
+					}
+					throw;
+				}
+				if (outage.joinable())
+				{
+					outage.join();
+				}
+			}
+
+			// Once the last send returns, at most a full buffer is left to print, so the wait scales with the feed rate.
+			auto drainTime = std::chrono::duration<double>(flowConfig.bufferSize / flowConfig.rowBytes / flowConfig.feedRate);
+			auto flowWait = std::chrono::duration_cast<std::chrono::nanoseconds>(2 * (drainTime + flowPause) + flowJobGap + flowSettle);
+
+			// Unpaced jobs may lose their print start and merge, so only paced ones are counted on. A printer fast
+			// enough to empty its buffer before a status can stop the sends may still drop what was on the way when
+			// the paper runs out, so "pause" reports its losses instead.
+			const bool checked = paced && !pausing;
+			if (!flowEmulator.waitForJobs(flowFinished + iterations, paced ? flowWait : flowSettle) && checked)
+			{
+				throw std::runtime_error("Emulator did not finish " + name);
+			}
+			std::vector<EMULATOR_JOB> jobs = flowEmulator.jobs();
+			flowFinished += jobs.size();
+
+			size_t intact = 0;
+			size_t dropped = 0;
+			Clock::duration paused{};
+			Clock::time_point finishedAt = started;
+			for (const EMULATOR_JOB& job : jobs)
+			{
+				intact += printedIntact(raster, raster.size(), job, flowConfig.rowBytes) ? 1 : 0;
+				dropped += job.dropped;
+				paused += job.paused;
+				finishedAt = std::max(finishedAt, job.finished);
+			}
+			if (checked && intact != iterations)
+			{
+				throw std::runtime_error("Emulator printed a different raster in " + name);
+			}
+
+			double seconds = std::chrono::duration<double>(finishedAt - started).count();
+			FLOW_STATS flowStats = session.flowStats();
+			results.push_back({ name, {
+				{ "size", static_cast<double>(raster.size()) },
+				{ "iterations", static_cast<double>(iterations) },
+				{ "intact_jobs", static_cast<double>(intact) },
+				{ "dropped_bytes", static_cast<double>(dropped) },
+				{ "bytes_per_sec", seconds > 0.0 ? static_cast<double>(raster.size() * intact) / seconds : 0.0 },
+				{ "print_bytes_per_sec", flowConfig.feedRate * static_cast<double>(flowConfig.rowBytes) },
+				{ "drain_rate", flowStats.drainRate },
+				{ "throttles", static_cast<double>(flowStats.throttles) },
+				{ "buffer_full", static_cast<double>(flowStats.bufferFull) },
+				{ "pauses", static_cast<double>(flowStats.pauses) },
+				{ "paused_ms", milliseconds(paused) },
+			} });
+		}
+	}
+
+	flowEmulator.stop();
+
+	// Fleet jobs are routed to the least loaded of three printers, the last of which has a quarter of the
+	// link bandwidth and feed rate. Jobs are fed as the fleet takes them, like a shop printing orders.
+	std::vector<std::unique_ptr<PrinterEmulator>> fleet;
+	std::vector<PRINTER_CONFIG> printers;
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		EMULATOR_CONFIG printerConfig = config;
+		if (i == fleetSize - 1)
+		{
+			printerConfig.bandwidth /= 4;
+			printerConfig.feedRate /= 4;
+		}
+		fleet.push_back(std::make_unique<PrinterEmulator>(printerConfig));
+
+		PRINTER_CONFIG printer;
+		printer.name = i == fleetSize - 1 ? "slow" : "fast" + std::to_string(i);
+		printer.address = listen(*fleet.back(), options.transport, std::string(loopbackName) + "-" + printer.name);
+		printer.channel = benchChannel;
+		printer.group = fleetGroup;
+		printers.push_back(printer);
+	}
+
+	for (size_t size : options.sizes)
+	{
+		std::string name = "fleet/" + std::to_string(size);
+		if (name.find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		std::vector<uint8_t> raster = makeRaster(size, config.rowBytes);
+		size_t iterations = iterationsFor(options, size) * fleetSize;
+		for (auto& printer : fleet)
+		{
+			printer->clearJobs();
+		}
+
+		PrintScheduler scheduler(nullptr);
+		for (PRINTER_CONFIG printer : printers)
+		{
+			printer.capacity = iterations;
+			scheduler.addPrinter(printer);
+		}
+
+		Clock::time_point started = Clock::now();
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			// Two jobs per printer in flight keep every link busy while leaving the routing decision open.
+			while (true)
+			{
+				size_t pending = 0;
+				for (const PRINTER_STATS& stats : scheduler.stats())
+				{
+					pending += stats.queue.pending;
+				}
+				if (pending < fleetSize * 2)
+				{
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			scheduler.submitToGroup(fleetGroup, raster);
+		}
+
+		std::vector<PRINTER_STATS> stats;
+		while (true)
+		{
+			stats = scheduler.stats();
+			uint64_t done = 0;
+			for (const PRINTER_STATS& printer : stats)
+			{
+				if (printer.queue.failed > 0)
+				{
+					throw std::runtime_error("Printer " + printer.name + " failed a job in " + name);
+				}
+				done += printer.queue.completed;
+			}
+			if (done == iterations)
+			{
+				break;
+			}
+			if (Clock::now() - started > jobTimeout)
+			{
+				throw std::runtime_error("Fleet did not finish " + name);
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		Clock::time_point finishedAt = started;
+		for (size_t i = 0; i < fleetSize; ++i)
+		{
+			if (!fleet[i]->waitForJobs(stats[i].queue.completed, jobTimeout))
+			{
+				throw std::runtime_error("Emulator did not finish " + name);
+			}
+			for (const EMULATOR_JOB& job : fleet[i]->jobs())
+			{
+				finishedAt = std::max(finishedAt, job.finished);
+			}
+		}
+		scheduler.close();
+
+		double seconds = std::chrono::duration<double>(finishedAt - started).count();
+		BENCH_RESULT result = { name, {
+			{ "size", static_cast<double>(raster.size()) },
+			{ "iterations", static_cast<double>(iterations) },
+			{ "jobs_per_sec", static_cast<double>(iterations) / seconds },
+			{ "bytes_per_sec", static_cast<double>(raster.size() * iterations) / seconds },
+		} };
+		for (const PRINTER_STATS& printer : stats)
+		{
+			result.metrics.push_back({ "jobs_" + printer.name, static_cast<double>(printer.queue.completed) });
+		}
+		results.push_back(result);
+	}
+
+	for (auto& printer : fleet)
+	{
+		printer->stop();
+	}
+	return results;
+}
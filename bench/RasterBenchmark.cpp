@@ -0,0 +1,208 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterBenchmark.cpp
+
+Abstract:
+	Rasterization kernel and pipeline benchmark cases.
+
+--*/
+
+#include "Benchmark.h"
+#include "../Raster.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	// A 384-dot wide, 4096-row image: a long receipt at the printer's native width.
+	const uint32_t kernelWidth = 384;
+	const uint32_t kernelHeight = 4096;
+	// A typical photo that has to be scaled down to the dot width.
+	const uint32_t imageWidth = 1200;
+	const uint32_t imageHeight = 1600;
+	const size_t defaultIterations = 20;
+	// Larger than the caches, so zero scans and copies run from memory.
+	const size_t scanBytes = 32u << 20;
+
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<uint8_t> makeImage(uint32_t width, uint32_t height)
+	{
+		std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+		uint32_t state = 12345;
+		for (size_t i = 0; i < pixels.size(); ++i)
+		{
+			state = state * 1664525 + 1013904223;
+			pixels[i] = static_cast<uint8_t>(state >> 24);
+		}
+		return pixels;
+	}
+
+	template<typename Function>
+	std::vector<double> measure(size_t iterations, Function function)
+	{
+		std::vector<double> samples;
+		samples.reserve(iterations);
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			Clock::time_point start = Clock::now();
+			function();
+			samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+		return samples;
+	}
+}
+
+std::vector<yhkcatprint::BENCH_RESULT> yhkcatprint::runRasterBenchmarks(const BENCH_OPTIONS& options)
+{
+	const size_t iterations = options.iterations > 0 ? options.iterations : defaultIterations;
+	const size_t pixelCount = static_cast<size_t>(kernelWidth) * kernelHeight;
+
+	std::vector<uint8_t> rgba = makeImage(kernelWidth, kernelHeight);
+	std::vector<uint8_t> gray(pixelCount);
+	std::vector<uint8_t> thresholds(kernelWidth, 128);
+	std::vector<uint8_t> packed(pixelCount / 8);
+
+	// Only the last byte is set, so every scan has to read the whole buffer.
+	std::vector<uint8_t> blank(scanBytes);
+	std::vector<uint8_t> copy(scanBytes);
+	blank.back() = 1;
+	double copyRate = 0.0;
+
+	std::vector<BENCH_RESULT> results;
+	double grayScalar = 0.0;
+	double thresholdScalar = 0.0;
+
+	// Scalar runs first so the vector cases can report their speedup over it.
+	for (SimdLevel level : { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_NEON })
+	{
+		if (!isSimdLevelSupported(level))
+		{
+			continue;
+		}
+
+		std::string grayName = std::string("raster/gray/") + simdLevelName(level);
+		if (grayName.find(options.filter) != std::string::npos)
+		{
+			std::vector<double> samples = measure(iterations, [&]() {
+				rgbaToGray(rgba.data(), gray.data(), pixelCount, level);
+			});
+			double median = percentile(samples, 50.0);
+			double rate = pixelCount / (median / 1000.0);
+			if (level == SIMD_SCALAR)
+			{
+				grayScalar = rate;
+			}
+			results.push_back({ grayName, {
+				{ "pixels", static_cast<double>(pixelCount) },
+				{ "iterations", static_cast<double>(iterations) },
+				{ "p50_ms", median },
+				{ "pixels_per_sec", rate },
+				{ "speedup", grayScalar > 0.0 ? rate / grayScalar : 0.0 },
+			} });
+		}
+
+		std::string thresholdName = std::string("raster/threshold/") + simdLevelName(level);
+		if (thresholdName.find(options.filter) != std::string::npos)
+		{
+			rgbaToGray(rgba.data(), gray.data(), pixelCount, SIMD_SCALAR);
+			std::vector<double> samples = measure(iterations, [&]() {
+				for (uint32_t y = 0; y < kernelHeight; ++y)
+				{
+					packThreshold(gray.data() + y * kernelWidth, thresholds.data(), packed.data() + y * (kernelWidth / 8), kernelWidth, level);
+				}
+			});
+			double median = percentile(samples, 50.0);
+			double rate = pixelCount / (median / 1000.0);
+			if (level == SIMD_SCALAR)
+			{
+				thresholdScalar = rate;
+			}
+			results.push_back({ thresholdName, {
+				{ "pixels", static_cast<double>(pixelCount) },
+				{ "iterations", static_cast<double>(iterations) },
+				{ "p50_ms", median },
+				{ "pixels_per_sec", rate },
+				{ "speedup", thresholdScalar > 0.0 ? rate / thresholdScalar : 0.0 },
+			} });
+		}
+
+		std::string scanName = std::string("raster/blankscan/") + simdLevelName(level);
+		if (scanName.find(options.filter) != std::string::npos)
+		{
+			if (copyRate == 0.0)
+			{
+				std::vector<double> copySamples = measure(iterations, [&]() {
+					std::memcpy(copy.data(), blank.data(), scanBytes);
+				});
+				copyRate = scanBytes / (percentile(copySamples, 50.0) / 1000.0);
+			}
+
+			size_t found = 0;
+			std::vector<double> samples = measure(iterations, [&]() {
+				found = findNonZero(blank.data(), scanBytes, level);
+			});
+			if (found != scanBytes - 1)
+			{
+				throw std::runtime_error(scanName + " missed the last byte");
+			}
+			double median = percentile(samples, 50.0);
+			double rate = scanBytes / (median / 1000.0);
+			results.push_back({ scanName, {
+				{ "bytes", static_cast<double>(scanBytes) },
+				{ "iterations", static_cast<double>(iterations) },
+				{ "p50_ms", median },
+				{ "bytes_per_sec", rate },
+				{ "memcpy_bytes_per_sec", copyRate },
+				{ "vs_memcpy", rate / copyRate },
+			} });
+		}
+	}
+
+	std::vector<uint8_t> photo = makeImage(imageWidth, imageHeight);
+	IMAGE_DESC image;
+	image.pixels = photo.data();
+	image.width = imageWidth;
+	image.height = imageHeight;
+
+	const std::pair<const char*, DitherMethod> methods[] = {
+		{ "threshold", DITHER_THRESHOLD },
+		{ "bayer", DITHER_BAYER },
+		{ "floyd-steinberg", DITHER_FLOYD_STEINBERG },
+		{ "atkinson", DITHER_ATKINSON },
+	};
+
+	for (const auto& method : methods)
+	{
+		std::string name = std::string("raster/image/") + method.first;
+		if (name.find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		RASTER_OPTIONS rasterOptions;
+		rasterOptions.dither = method.second;
+		Rasterizer rasterizer(rasterOptions);
+		size_t rows = 0;
+		std::vector<double> samples = measure(iterations, [&]() {
+			rows = rasterizer.rasterize(image).size() / rasterizer.rowBytes();
+		});
+		double median = percentile(samples, 50.0);
+
+		results.push_back({ name, {
+			{ "width", static_cast<double>(imageWidth) },
+			{ "height", static_cast<double>(imageHeight) },
+			{ "iterations", static_cast<double>(iterations) },
+			{ "p50_ms", median },
+			{ "p99_ms", percentile(samples, 99.0) },
+			{ "rows_per_sec", rows / (median / 1000.0) },
+		} });
+	}
+
+	return results;
+}
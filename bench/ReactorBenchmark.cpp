@@ -0,0 +1,250 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	ReactorBenchmark.cpp
+
+Abstract:
+	Receive delivery benchmark cases for the socket reactor.
+
+--*/
+
+#include "Benchmark.h"
+#include "../IEventListener.h"
+#include "../LoopbackPipe.h"
+#include "../LoopbackSocket.h"
+#include "../SocketReactor.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// From a single printer up to a fleet far larger than anyone would give a thread each.
+	const size_t linkCounts[] = { 1, 16, 256 };
+	const size_t defaultIterations = 200;
+	// About the size of a status reply.
+	const size_t messageSize = 38;
+	const std::chrono::seconds deliveryTimeout{ 30 };
+
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Collects the delivery latency of messages stamped with their send time.
+	 */
+	class LatencyRecorder
+	{
+	public:
+		explicit LatencyRecorder(size_t expected)
+			: m_expected(expected)
+		{
+			m_samples.reserve(expected);
+		}
+
+		void record(const uint8_t* message)
+		{
+			Clock::rep sent;
+			std::memcpy(&sent, message, sizeof(sent));
+			double latency = std::chrono::duration<double, std::micro>(Clock::now() - Clock::time_point(Clock::duration(sent))).count();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_samples.push_back(latency);
+			if (m_samples.size() == m_expected)
+			{
+				m_done.notify_all();
+			}
+		}
+
+		std::vector<double> wait()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (!m_done.wait_for(lock, deliveryTimeout, [this] { return m_samples.size() >= m_expected; }))
+			{
+				throw std::runtime_error("Messages were not delivered in time");
+			}
+			return m_samples;
+		}
+
+	private:
+		size_t m_expected;
+		std::vector<double> m_samples;
+		std::mutex m_mutex;
+		std::condition_variable m_done;
+	};
+
+	/**
+	 * Reassembles messages from the chunks the reactor delivers for one link.
+	 */
+	class ReactorListener : public yhkcatprint::IEventListener
+	{
+	public:
+		explicit ReactorListener(LatencyRecorder& recorder)
+			: m_recorder(recorder), m_pending(0), m_message{}
+		{
+		}
+
+		void onDeviceConnected(const yhkcatprint::DEVICE_INFO&) override {}
+		void onDeviceDisconnected(const yhkcatprint::DEVICE_INFO&) override {}
+		void onSocketClosed(const yhkcatprint::IRfcommSocket&) override {}
+		void onError(yhkcatprint::ERROR_INFO) override {}
+		void onJobCompleted(const yhkcatprint::JOB_INFO&) override {}
+		void onJobFailed(const yhkcatprint::JOB_INFO&, yhkcatprint::ERROR_INFO) override {}
+
+		void onSocketDateReceived(const yhkcatprint::IRfcommSocket&, const uint8_t* data, size_t size) override
+		{
+			while (size > 0)
+			{
+				size_t chunk = std::min(size, messageSize - m_pending);
+				std::memcpy(m_message + m_pending, data, chunk);
+				m_pending += chunk;
+				data += chunk;
+				size -= chunk;
+				if (m_pending == messageSize)
+				{
+					m_recorder.record(m_message);
+					m_pending = 0;
+				}
+			}
+		}
+
+	private:
+		LatencyRecorder& m_recorder;
+		size_t m_pending;
+		uint8_t m_message[messageSize];
+	};
+
+	struct Link
+	{
+		std::shared_ptr<yhkcatprint::LoopbackSocket> printer;
+		std::shared_ptr<yhkcatprint::LoopbackSocket> host;
+	};
+
+	std::vector<Link> connectLinks(yhkcatprint::LoopbackListener& listener, const std::string& address, size_t count)
+	{
+		std::vector<Link> links;
+		for (size_t i = 0; i < count; ++i)
+		{
+			Link link;
+			link.host = std::make_shared<yhkcatprint::LoopbackSocket>(address, 0);
+			link.host->connect();
+			link.printer = std::make_shared<yhkcatprint::LoopbackSocket>(listener.accept(std::chrono::seconds(5)));
+			links.push_back(std::move(link));
+		}
+		return links;
+	}
+
+	/**
+	 * Has every printer send the given number of stamped messages, round robin, from one thread.
+	 */
+	void sendMessages(std::vector<Link>& links, size_t messages)
+	{
+		uint8_t message[messageSize] = {};
+		for (size_t i = 0; i < messages; ++i)
+		{
+			for (Link& link : links)
+			{
+				Clock::rep now = Clock::now().time_since_epoch().count();
+				std::memcpy(message, &now, sizeof(now));
+				link.printer->send(message, sizeof(message));
+			}
+			// Paced like status replies, so latency is measured on an idle reactor rather than a backlog.
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+
+	/**
+	 * Receives on every link with a blocking thread each, as before the reactor.
+	 */
+	std::vector<double> runThreadPerLink(std::vector<Link>& links, size_t messages)
+	{
+		LatencyRecorder recorder(links.size() * messages);
+		std::vector<std::thread> readers;
+		for (Link& link : links)
+		{
+			readers.emplace_back([&recorder, &link, messages] {
+				uint8_t message[messageSize];
+				for (size_t i = 0; i < messages; ++i)
+				{
+					size_t received = 0;
+					while (received < messageSize)
+					{
+						received += link.host->receive(message + received, messageSize - received);
+					}
+					recorder.record(message);
+				}
+			});
+		}
+
+		sendMessages(links, messages);
+		std::vector<double> samples = recorder.wait();
+		for (std::thread& reader : readers)
+		{
+			reader.join();
+		}
+		return samples;
+	}
+
+	/**
+	 * Receives on every link through one reactor thread.
+	 */
+	std::vector<double> runReactor(std::vector<Link>& links, size_t messages)
+	{
+		LatencyRecorder recorder(links.size() * messages);
+		yhkcatprint::SocketReactor reactor;
+		for (Link& link : links)
+		{
+			reactor.watch(link.host, std::make_shared<ReactorListener>(recorder));
+		}
+
+		sendMessages(links, messages);
+		std::vector<double> samples = recorder.wait();
+		reactor.stop();
+		return samples;
+	}
+}
+
+std::vector<yhkcatprint::BENCH_RESULT> yhkcatprint::runReactorBenchmarks(const BENCH_OPTIONS& options)
+{
+	const size_t messages = options.iterations > 0 ? options.iterations : defaultIterations;
+	std::vector<BENCH_RESULT> results;
+
+	for (size_t count : linkCounts)
+	{
+		for (const char* mode : { "threads", "reactor" })
+		{
+			std::string name = std::string("reactor/") + mode + "/" + std::to_string(count);
+			if (name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			std::string endpoint = "bench-reactor-" + std::to_string(count);
+			LoopbackListener listener(endpoint);
+			std::vector<Link> links = connectLinks(listener, LoopbackListener::SCHEME + endpoint, count);
+
+			Clock::time_point start = Clock::now();
+			std::vector<double> samples = std::string(mode) == "threads"
+				? runThreadPerLink(links, messages)
+				: runReactor(links, messages);
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			results.push_back({ name, {
+				{ "links", static_cast<double>(count) },
+				{ "messages", static_cast<double>(samples.size()) },
+				{ "receive_threads", std::string(mode) == "threads" ? static_cast<double>(count) : 1.0 },
+				{ "p50_latency_us", percentile(samples, 50.0) },
+				{ "p99_latency_us", percentile(samples, 99.0) },
+				{ "messages_per_s", seconds > 0.0 ? samples.size() / seconds : 0.0 },
+			} });
+		}
+	}
+
+	return results;
+}
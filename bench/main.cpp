@@ -0,0 +1,180 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	main.cpp
+
+Abstract:
+	Command-line runner for the benchmark suite.
+
+--*/
+
+#include "Benchmark.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+namespace
+{
+	/**
+	 * Discards everything written to it; used to keep session logging out of the JSON output.
+	 */
+	class NullBuffer : public std::streambuf
+	{
+	protected:
+		int overflow(int c) override
+		{
+			return traits_type::not_eof(c);
+		}
+	};
+
+	void printUsage()
+	{
+		std::cerr
+			<< "Usage: YHKCatPrintBench [options]\n"
+			<< "  --transport loop|tcp  transport to the emulated printer (default loop)\n"
+			<< "  --sizes A,B,...       raster sizes in bytes (default 1 KB to 8 MB)\n"
+			<< "  --iterations N        jobs per case (default scales with size)\n"
+			<< "  --filter TEXT         run only cases whose name contains TEXT\n"
+			<< "  --bandwidth B         emulated link throughput in bytes per second\n"
+			<< "  --latency-us US       emulated one-way latency per packet\n"
+			<< "  --packet BYTES        emulated link packet size\n"
+			<< "  --buffer BYTES        emulated printer receive buffer size\n"
+			<< "  --feed-rate ROWS      emulated rows printed per second\n"
+			<< "  --connect-ms MS       emulated link setup time per connection\n"
+			<< "  --out FILE            write JSON to FILE instead of standard output\n";
+	}
+
+	std::vector<size_t> parseSizes(const std::string& value)
+	{
+		std::vector<size_t> sizes;
+		std::istringstream iss(value);
+		std::string item;
+		while (std::getline(iss, item, ','))
+		{
+			sizes.push_back(std::stoul(item));
+		}
+		return sizes;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	yhkcatprint::BENCH_OPTIONS options;
+	std::string outputPath;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string option = argv[i];
+			if (option == "--help" || option == "-h")
+			{
+				printUsage();
+				return 0;
+			}
+			if (i + 1 >= argc)
+			{
+				throw std::invalid_argument("Missing value for " + option);
+			}
+			std::string value = argv[++i];
+
+			if (option == "--transport")
+			{
+				options.transport = value;
+			}
+			else if (option == "--sizes")
+			{
+				options.sizes = parseSizes(value);
+			}
+			else if (option == "--iterations")
+			{
+				options.iterations = std::stoul(value);
+			}
+			else if (option == "--filter")
+			{
+				options.filter = value;
+			}
+			else if (option == "--bandwidth")
+			{
+				options.emulator.bandwidth = std::stod(value);
+			}
+			else if (option == "--latency-us")
+			{
+				options.emulator.latency = std::chrono::microseconds(std::stoll(value));
+			}
+			else if (option == "--packet")
+			{
+				options.emulator.packetSize = std::stoul(value);
+			}
+			else if (option == "--buffer")
+			{
+				options.emulator.bufferSize = std::stoul(value);
+			}
+			else if (option == "--feed-rate")
+			{
+				options.emulator.feedRate = std::stod(value);
+			}
+			else if (option == "--connect-ms")
+			{
+				options.emulator.connectDelay = std::chrono::milliseconds(std::stoll(value));
+			}
+			else if (option == "--out")
+			{
+				outputPath = value;
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown option " + option);
+			}
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+
+	std::vector<yhkcatprint::BENCH_RESULT> results;
+	NullBuffer nullBuffer;
+	std::streambuf* console = std::cout.rdbuf(&nullBuffer);
+	try
+	{
+		results = yhkcatprint::runPrintBenchmarks(options);
+		std::vector<yhkcatprint::BENCH_RESULT> raster = yhkcatprint::runRasterBenchmarks(options);
+		results.insert(results.end(), raster.begin(), raster.end());
+		std::vector<yhkcatprint::BENCH_RESULT> address = yhkcatprint::runAddressBenchmarks(options);
+		results.insert(results.end(), address.begin(), address.end());
+		std::vector<yhkcatprint::BENCH_RESULT> reactor = yhkcatprint::runReactorBenchmarks(options);
+		results.insert(results.end(), reactor.begin(), reactor.end());
+	}
+	catch (const std::exception& ex)
+	{
+		std::cout.rdbuf(console);
+		std::cerr << "Benchmark failed: " << ex.what() << std::endl;
+		return 1;
+	}
+	std::cout.rdbuf(console);
+
+	if (outputPath.empty())
+	{
+		yhkcatprint::writeJson(std::cout, options, results);
+	}
+	else
+	{
+		std::ofstream file(outputPath);
+		yhkcatprint::writeJson(file, options, results);
+		if (!file)
+		{
+			std::cerr << "Failed to write " << outputPath << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
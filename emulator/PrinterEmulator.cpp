@@ -0,0 +1,711 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrinterEmulator.cpp
+
+Abstract:
+	Implementation of PrinterEmulator methods.
+
+--*/
+
+#include "PrinterEmulator.h"
+#include "../EscPos.h"
+#include "../LoopbackSocket.h"
+#ifdef _WIN32
+#include "../ProtoTcpListener.h"
+#endif
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+	namespace escpos = yhkcatprint::escpos;
+
+	constexpr auto initCmd = escpos::initialize();
+	constexpr auto getStatusCmd = escpos::getStatus();
+	constexpr auto getSerialCmd = escpos::getSerial();
+	constexpr auto startPrintCmd = escpos::startPrint();
+	constexpr auto endPrintCmd = escpos::END_PRINT;
+	constexpr auto rasterImageCmd = escpos::RASTER_IMAGE;
+	constexpr auto feedDotsCmd = escpos::FEED_DOTS;
+	constexpr size_t rasterImageHeaderSize = escpos::RASTER_HEADER_SIZE;
+	constexpr uint8_t lineFeedCmd = escpos::LINE_FEED[0];
+	// Long enough for every piece of a split reply to reach the host on its own.
+	const std::chrono::milliseconds fragmentPause{ 1 };
+
+	/**
+	 * Compares the bytes at data with a command. Returns 1 on a match, 0 if
+	 * the available bytes are a proper prefix of the command, -1 otherwise.
+	 */
+	template<size_t N>
+	int matchCommand(const uint8_t* data, size_t available, const escpos::Command<N>& command)
+	{
+		size_t compared = std::min(available, N);
+		if (!std::equal(data, data + compared, command.begin()))
+		{
+			return -1;
+		}
+		return compared == N ? 1 : 0;
+	}
+}
+
+struct yhkcatprint::PrinterEmulator::Connection
+{
+	IRfcommSocket& socket;
+	std::vector<uint8_t> pending;
+	size_t position = 0;
+	std::chrono::steady_clock::time_point now{};
+	std::chrono::steady_clock::time_point headFree{};
+	bool printing = false;
+	bool graphics = false;
+	int64_t stallMark = 0;
+	int64_t dropMark = 0;
+	EMULATOR_JOB job{};
+};
+
+yhkcatprint::PrinterEmulator::PrinterEmulator(EMULATOR_CONFIG config)
+	: m_config(std::move(config)), m_stopping(false), m_stalledNanos(0), m_droppedBytes(0), m_bufferedBytes(0), m_condition(0), m_reportedFull(false),
+	m_statusPending(false), m_connectionEnded(false), m_lastJobId(0), m_finishedCount(0)
+{
+	if (m_config.rowBytes == 0 || m_config.packetSize == 0)
+	{
+		throw std::invalid_argument("Row and packet sizes must be greater than zero");
+	}
+}
+
+yhkcatprint::PrinterEmulator::~PrinterEmulator()
+{
+	stop();
+}
+
+void yhkcatprint::PrinterEmulator::listenLoopback(const std::string& name)
+{
+	auto listener = std::make_shared<LoopbackListener>(name, m_config.bufferSize);
+	startListening(
+		[listener] { return std::make_shared<LoopbackSocket>(listener->accept()); },
+		[listener] { listener->close(); });
+}
+
+uint16_t yhkcatprint::PrinterEmulator::listenTcp(uint16_t port)
+{
+#ifdef _WIN32
+	auto listener = std::make_shared<ProtoTcpListener>(port);
+	startListening(
+		[listener] { return listener->accept(); },
+		[listener] { listener->close(); });
+	return listener->port();
+#else
+	throw std::runtime_error("TCP transport is only available on Windows");
+#endif
+}
+
+void yhkcatprint::PrinterEmulator::serve(std::shared_ptr<IRfcommSocket> socket)
+{
+	// Models the RFCOMM connection setup, which the client sees as a slow first reply.
+	std::this_thread::sleep_for(m_config.connectDelay);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_active = socket;
+		m_reportedFull = false;
+		m_statusPending = false;
+		m_connectionEnded = false;
+	}
+	m_bufferedBytes = 0;
+
+	// The receive buffer is counted in packets; bulk raster arrives in full packets.
+	// A dropping buffer limits the bytes itself, so it must not stall on small packets first.
+	BoundedQueue<Packet> buffer(m_config.dropOnOverflow ? std::max<size_t>(m_config.bufferSize, 1) : (m_config.bufferSize + m_config.packetSize - 1) / m_config.packetSize);
+	std::thread link([this, &socket, &buffer] { runLink(*socket, buffer); });
+	std::thread notifier([this, &socket] { runNotifier(*socket); });
+
+	Connection connection{ *socket, {} };
+	try
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if (m_condition & escpos::CONDITION_HEAD_STOPPED)
+				{
+					// The head stops until paper or heat return; the data keeps queueing behind it.
+					auto stoppedAt = std::chrono::steady_clock::now();
+					m_statusChanged.wait(lock, [this, &buffer]
+					{
+						return !(m_condition & escpos::CONDITION_HEAD_STOPPED) || m_stopping || buffer.isClosed();
+					});
+					auto resumedAt = std::chrono::steady_clock::now();
+					if (connection.printing || connection.graphics)
+					{
+						connection.job.paused += resumedAt - stoppedAt;
+					}
+					connection.headFree = std::max(connection.headFree, resumedAt);
+				}
+			}
+
+			auto packet = connection.printing || connection.graphics ? buffer.pop(m_config.jobGap) : buffer.pop();
+			if (!packet)
+			{
+				if (buffer.isClosed())
+				{
+					break;
+				}
+				finishJob(connection, true);
+				continue;
+			}
+			m_bufferedBytes -= packet->data.size();
+			updateBufferReport();
+
+			std::this_thread::sleep_until(packet->deliveredAt);
+			connection.now = packet->deliveredAt;
+			connection.pending.insert(connection.pending.end(), packet->data.begin(), packet->data.end());
+			process(connection);
+
+			// While the print head is busy, the receive buffer fills up and eventually stalls the link.
+			std::this_thread::sleep_until(connection.headFree);
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Emulator connection failed: " << ex.what() << std::endl;
+	}
+
+	finishJob(connection, true);
+	socket->close();
+	buffer.close();
+	link.join();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_connectionEnded = true;
+	}
+	m_statusChanged.notify_all();
+	notifier.join();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_active.reset();
+}
+
+void yhkcatprint::PrinterEmulator::stop()
+{
+	m_stopping = true;
+
+	std::function<void()> closeListener;
+	std::shared_ptr<IRfcommSocket> active;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		closeListener = std::move(m_closeListener);
+		active = m_active;
+	}
+	m_statusChanged.notify_all();
+
+	if (closeListener)
+	{
+		closeListener();
+	}
+	if (active != nullptr)
+	{
+		active->close();
+	}
+	if (m_acceptThread.joinable())
+	{
+		m_acceptThread.join();
+	}
+}
+
+void yhkcatprint::PrinterEmulator::setJobCallback(JobCallback callback)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_callback = std::move(callback);
+}
+
+void yhkcatprint::PrinterEmulator::setCondition(uint8_t condition)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_condition = condition & (escpos::CONDITION_HEAD_STOPPED | escpos::CONDITION_PAPER_LOW);
+		m_statusPending = true;
+	}
+	m_statusChanged.notify_all();
+}
+
+bool yhkcatprint::PrinterEmulator::waitForJobs(size_t count, std::chrono::nanoseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_jobFinished.wait_for(lock, timeout, [this, count] { return m_finishedCount >= count; });
+}
+
+std::vector<yhkcatprint::EMULATOR_JOB> yhkcatprint::PrinterEmulator::jobs() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_jobs;
+}
+
+void yhkcatprint::PrinterEmulator::clearJobs()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_jobs.clear();
+}
+
+void yhkcatprint::PrinterEmulator::writePbm(const std::string& path, const std::vector<uint8_t>& raster, size_t rowBytes)
+{
+	size_t rows = raster.size() / rowBytes;
+
+	std::ofstream file(path, std::ios::binary);
+	file << "P4\n" << rowBytes * 8 << " " << rows << "\n";
+	file.write(reinterpret_cast<const char*>(raster.data()), static_cast<std::streamsize>(rows * rowBytes));
+	if (!file)
+	{
+		throw std::runtime_error("Failed to write image: " + path);
+	}
+}
+
+void yhkcatprint::PrinterEmulator::startListening(std::function<std::shared_ptr<IRfcommSocket>()> accept, std::function<void()> close)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_acceptThread.joinable())
+	{
+		close();
+		throw std::runtime_error("Emulator already listening");
+	}
+
+	m_stopping = false;
+	m_closeListener = std::move(close);
+	m_acceptThread = std::thread([this, accept = std::move(accept)]
+	{
+		while (!m_stopping)
+		{
+			std::shared_ptr<IRfcommSocket> socket;
+			try
+			{
+				socket = accept();
+			}
+			catch (const std::exception&)
+			{
+				// The listener was closed by stop().
+				break;
+			}
+			serve(socket);
+		}
+	});
+}
+
+void yhkcatprint::PrinterEmulator::runLink(IRfcommSocket& socket, BoundedQueue<Packet>& buffer)
+{
+	std::vector<uint8_t> chunk(m_config.packetSize);
+	auto linkFree = std::chrono::steady_clock::now();
+
+	try
+	{
+		while (!m_stopping)
+		{
+			size_t received = socket.receive(chunk.data(), chunk.size());
+			if (received == 0)
+			{
+				break;
+			}
+
+			// Packets are serialized back to back at the link bandwidth; latency
+			// delays delivery without reducing throughput.
+			auto now = std::chrono::steady_clock::now();
+			linkFree = std::max(linkFree, now);
+			if (m_config.bandwidth > 0.0)
+			{
+				linkFree += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+					std::chrono::duration<double>(received / m_config.bandwidth));
+				std::this_thread::sleep_until(linkFree);
+			}
+
+			Packet packet{ std::vector<uint8_t>(chunk.begin(), chunk.begin() + received), linkFree + m_config.latency };
+
+			if (m_config.dropOnOverflow)
+			{
+				if (m_bufferedBytes + received > m_config.bufferSize)
+				{
+					m_droppedBytes += static_cast<int64_t>(received);
+					continue;
+				}
+				// Counted before the push, so the serving thread never takes out more than was put in.
+				m_bufferedBytes += received;
+				updateBufferReport();
+				if (!buffer.push(packet))
+				{
+					break;
+				}
+				continue;
+			}
+
+			m_bufferedBytes += received;
+			updateBufferReport();
+			auto blockedSince = std::chrono::steady_clock::now();
+			if (!buffer.push(packet))
+			{
+				break;
+			}
+			m_stalledNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - blockedSince).count();
+		}
+	}
+	catch (const std::exception&)
+	{
+		// A receive error ends the connection the same way as an orderly close.
+	}
+
+	buffer.close();
+	{
+		// Wakes the serving thread if it waits on a stopped head.
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+	m_statusChanged.notify_all();
+}
+
+void yhkcatprint::PrinterEmulator::runNotifier(IRfcommSocket& socket)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_statusChanged.wait(lock, [this] { return m_statusPending || m_connectionEnded; });
+		if (m_connectionEnded)
+		{
+			break;
+		}
+		m_statusPending = false;
+		lock.unlock();
+
+		// Changes made while this report is sent are coalesced into the next one.
+		auto status = currentStatus();
+		try
+		{
+			sendReply(socket, status.data(), status.size());
+		}
+		catch (const std::exception&)
+		{
+			// The connection is closing; the serving thread ends it.
+			lock.lock();
+			break;
+		}
+		lock.lock();
+	}
+}
+
+void yhkcatprint::PrinterEmulator::updateBufferReport()
+{
+	if (!m_config.reportBufferFull)
+	{
+		return;
+	}
+
+	bool notify = false;
+	{
+		// Read under the lock, so that the link and serving threads report in the order the count changed.
+		std::lock_guard<std::mutex> lock(m_mutex);
+		size_t buffered = m_bufferedBytes;
+		if (!m_reportedFull && buffered * 4 >= m_config.bufferSize * 3)
+		{
+			m_reportedFull = true;
+			m_statusPending = notify = true;
+		}
+		else if (m_reportedFull && buffered * 4 <= m_config.bufferSize)
+		{
+			m_reportedFull = false;
+			m_statusPending = notify = true;
+		}
+	}
+	if (notify)
+	{
+		m_statusChanged.notify_all();
+	}
+}
+
+std::array<uint8_t, 38> yhkcatprint::PrinterEmulator::currentStatus()
+{
+	std::array<uint8_t, 38> status = m_config.status;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	status[escpos::STATUS_CONDITION] |= m_condition;
+	if (m_reportedFull)
+	{
+		status[escpos::STATUS_CONDITION] |= escpos::CONDITION_BUFFER_FULL;
+	}
+	return status;
+}
+
+void yhkcatprint::PrinterEmulator::sendReply(IRfcommSocket& socket, const uint8_t* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_replyMutex);
+	if (m_config.replyFragment == 0)
+	{
+		socket.send(data, size);
+		return;
+	}
+
+	for (size_t offset = 0; offset < size; offset += m_config.replyFragment)
+	{
+		if (offset > 0)
+		{
+			std::this_thread::sleep_for(fragmentPause);
+		}
+		socket.send(data + offset, std::min(m_config.replyFragment, size - offset));
+	}
+}
+
+void yhkcatprint::PrinterEmulator::process(Connection& connection)
+{
+	const auto rowDuration = m_config.feedRate > 0.0
+		? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / m_config.feedRate))
+		: std::chrono::steady_clock::duration::zero();
+
+	auto& pending = connection.pending;
+	auto& position = connection.position;
+
+	while (position < pending.size())
+	{
+		const uint8_t* data = pending.data() + position;
+		size_t available = pending.size() - position;
+
+		if (connection.printing)
+		{
+			if (connection.job.firstByte == std::chrono::steady_clock::time_point{})
+			{
+				connection.job.firstByte = connection.now;
+			}
+
+			// At a row boundary, the end-of-job feed followed by a command closes the job.
+			if (matchCommand(data, available, endPrintCmd) >= 0)
+			{
+				if (m_config.endOnTrailer && available == endPrintCmd.size())
+				{
+					position += endPrintCmd.size();
+					finishJob(connection, false);
+					continue;
+				}
+				if (available < endPrintCmd.size() + startPrintCmd.size())
+				{
+					break;
+				}
+				const uint8_t* next = data + endPrintCmd.size();
+				size_t rest = available - endPrintCmd.size();
+				if (matchCommand(next, rest, initCmd) > 0 || matchCommand(next, rest, getStatusCmd) > 0
+					|| matchCommand(next, rest, getSerialCmd) > 0 || matchCommand(next, rest, startPrintCmd) > 0)
+				{
+					position += endPrintCmd.size();
+					finishJob(connection, false);
+					continue;
+				}
+			}
+
+			if (available < m_config.rowBytes)
+			{
+				break;
+			}
+
+			connection.job.raster.insert(connection.job.raster.end(), data, data + m_config.rowBytes);
+			connection.job.bytes += m_config.rowBytes;
+			connection.job.rows++;
+			connection.headFree = std::max(connection.headFree, connection.now) + rowDuration;
+			position += m_config.rowBytes;
+			continue;
+		}
+
+		// Raster images and dot feeds print without a print start; consecutive ones form one job.
+		int match = std::max(matchCommand(data, available, rasterImageCmd), matchCommand(data, available, feedDotsCmd));
+		if (match == 0)
+		{
+			break;
+		}
+		if (match > 0)
+		{
+			size_t consumed = data[0] == rasterImageCmd[0] ? printRasterImage(connection, data, available, rowDuration) : feedDots(connection, data, available, rowDuration);
+			if (consumed == 0)
+			{
+				break;
+			}
+			position += consumed;
+			continue;
+		}
+		if (connection.graphics)
+		{
+			finishJob(connection, false);
+			continue;
+		}
+
+		if ((match = matchCommand(data, available, initCmd)) > 0)
+		{
+			position += initCmd.size();
+		}
+		else if (match == 0)
+		{
+			break;
+		}
+		else if ((match = matchCommand(data, available, getStatusCmd)) > 0)
+		{
+			auto status = currentStatus();
+			sendReply(connection.socket, status.data(), status.size());
+			position += getStatusCmd.size();
+		}
+		else if (match == 0)
+		{
+			break;
+		}
+		else if ((match = matchCommand(data, available, getSerialCmd)) > 0)
+		{
+			sendReply(connection.socket, m_config.serial.data(), m_config.serial.size());
+			position += getSerialCmd.size();
+		}
+		else if (match == 0)
+		{
+			break;
+		}
+		else if ((match = matchCommand(data, available, startPrintCmd)) > 0)
+		{
+			position += startPrintCmd.size();
+			startJob(connection);
+			connection.printing = true;
+		}
+		else if (match == 0)
+		{
+			break;
+		}
+		else
+		{
+			// Line feeds between jobs and unknown bytes only move paper.
+			if (data[0] == lineFeedCmd)
+			{
+				connection.headFree = std::max(connection.headFree, connection.now) + rowDuration;
+			}
+			position += 1;
+		}
+	}
+
+	pending.erase(pending.begin(), pending.begin() + position);
+	position = 0;
+}
+
+void yhkcatprint::PrinterEmulator::startJob(Connection& connection)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	connection.job = {};
+	connection.job.id = ++m_lastJobId;
+	connection.job.started = connection.now;
+	connection.stallMark = m_stalledNanos;
+	connection.dropMark = m_droppedBytes;
+}
+
+size_t yhkcatprint::PrinterEmulator::printRasterImage(Connection& connection, const uint8_t* data, size_t available, std::chrono::steady_clock::duration rowDuration)
+{
+	if (available < rasterImageHeaderSize)
+	{
+		return 0;
+	}
+
+	size_t widthBytes = data[4] | (static_cast<size_t>(data[5]) << 8);
+	size_t height = data[6] | (static_cast<size_t>(data[7]) << 8);
+	size_t total = rasterImageHeaderSize + widthBytes * height;
+	if (available < total)
+	{
+		return 0;
+	}
+
+	if (!connection.graphics)
+	{
+		startJob(connection);
+		connection.graphics = true;
+		connection.job.firstByte = connection.now;
+	}
+
+	// Images narrower than the head are padded with white, wider ones are cut off.
+	const uint8_t* row = data + rasterImageHeaderSize;
+	size_t copied = std::min(widthBytes, m_config.rowBytes);
+	for (size_t y = 0; y < height; ++y, row += widthBytes)
+	{
+		connection.job.raster.insert(connection.job.raster.end(), row, row + copied);
+		connection.job.raster.insert(connection.job.raster.end(), m_config.rowBytes - copied, 0);
+		connection.headFree = std::max(connection.headFree, connection.now) + rowDuration;
+	}
+	connection.job.rows += height;
+	connection.job.bytes += total;
+	return total;
+}
+
+size_t yhkcatprint::PrinterEmulator::feedDots(Connection& connection, const uint8_t* data, size_t available, std::chrono::steady_clock::duration rowDuration)
+{
+	if (available < feedDotsCmd.size() + 1)
+	{
+		return 0;
+	}
+
+	if (!connection.graphics)
+	{
+		startJob(connection);
+		connection.graphics = true;
+		connection.job.firstByte = connection.now;
+	}
+
+	// Fed dot rows are recorded as blank rows, so the job image keeps its proportions.
+	size_t rows = data[feedDotsCmd.size()];
+	connection.job.raster.insert(connection.job.raster.end(), rows * m_config.rowBytes, 0);
+	connection.job.rows += rows;
+	connection.job.bytes += feedDotsCmd.size() + 1;
+	connection.headFree = std::max(connection.headFree, connection.now) + rowDuration * static_cast<int64_t>(rows);
+	return feedDotsCmd.size() + 1;
+}
+
+void yhkcatprint::PrinterEmulator::finishJob(Connection& connection, bool truncated)
+{
+	if (!connection.printing && !connection.graphics)
+	{
+		return;
+	}
+	connection.printing = false;
+	connection.graphics = false;
+
+	EMULATOR_JOB& job = connection.job;
+	if (job.firstByte == std::chrono::steady_clock::time_point{})
+	{
+		job.firstByte = connection.now;
+	}
+
+	// An incomplete trailing row is the end-of-job feed or a cut-off job; it is counted but not printed.
+	if (truncated)
+	{
+		job.bytes += connection.pending.size() - connection.position;
+		connection.position = connection.pending.size();
+	}
+
+	job.finished = std::max(connection.headFree, connection.now);
+	job.stalled = std::chrono::nanoseconds(m_stalledNanos - connection.stallMark);
+	job.dropped = static_cast<size_t>(m_droppedBytes - connection.dropMark);
+
+	if (!m_config.outputDirectory.empty())
+	{
+		auto path = std::filesystem::path(m_config.outputDirectory) / ("job_" + std::to_string(job.id) + ".pbm");
+		try
+		{
+			writePbm(path.string(), job.raster, m_config.rowBytes);
+			job.image = path.string();
+		}
+		catch (const std::exception& ex)
+		{
+			std::cerr << ex.what() << std::endl;
+		}
+	}
+
+	JobCallback callback;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+		m_finishedCount++;
+		callback = m_callback;
+	}
+	m_jobFinished.notify_all();
+
+	if (callback)
+	{
+		callback(job);
+	}
+}
@@ -0,0 +1,449 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrinterEmulator.h
+
+Abstract:
+	Software emulator of a YHK cat printer.
+
+--*/
+
+#pragma once
+#include "../BoundedQueue.h"
+#include "../IRfcommSocket.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file PrinterEmulator.h
+ * @brief Software emulator of a YHK cat printer.
+ *
+ * This header defines PrinterEmulator, which speaks the command set used by
+ * PrinterSession over any IRfcommSocket and models the timing of a real
+ * printer: link bandwidth, per-packet latency, a bounded receive buffer that
+ * stalls the sender when full, and the paper feed speed of the print head.
+ * Paper-out and overheat conditions can be raised at run time, and the
+ * printer can report them and its buffer filling up as it happens.
+ */
+
+namespace yhkcatprint
+{
+	/**
+	 * @brief Emulator configuration.
+	 *
+	 * Zero bandwidth, latency or feed rate disables the corresponding limit.
+	 */
+	typedef struct _EMULATOR_CONFIG
+	{
+		/**
+		 * @brief Raster bytes per printed row, 384 dots on YHK printers.
+		 */
+		size_t rowBytes = 48;
+		/**
+		 * @brief Link throughput in bytes per second.
+		 */
+		double bandwidth = 0.0;
+		/**
+		 * @brief One-way delay added to every packet.
+		 */
+		std::chrono::microseconds latency{ 0 };
+		/**
+		 * @brief Largest packet carried by the link, roughly the RFCOMM frame size.
+		 */
+		size_t packetSize = 990;
+		/**
+		 * @brief Receive buffer of the printer; the link stalls once it is full.
+		 */
+		size_t bufferSize = 4096;
+		/**
+		 * @brief Drop packets that arrive at a full receive buffer instead of stalling the link,
+		 *        like printers that grant the link more credit than they can hold.
+		 */
+		bool dropOnOverflow = false;
+		/**
+		 * @brief Report the buffer full once three quarters of it are taken, and ready again once it has drained to a quarter.
+		 */
+		bool reportBufferFull = false;
+		/**
+		 * @brief Largest piece a reply is sent in, 0 to send replies whole.
+		 *
+		 * The pieces follow each other after a short pause, like a reply that
+		 * RFCOMM delivers across several frames.
+		 */
+		size_t replyFragment = 0;
+		/**
+		 * @brief Rows the print head prints per second.
+		 */
+		double feedRate = 0.0;
+		/**
+		 * @brief Idle time after which a raster stream counts as a finished job.
+		 */
+		std::chrono::milliseconds jobGap{ 200 };
+		/**
+		 * @brief End a raw job as soon as its end-of-job feed has arrived at a row boundary, without
+		 *        waiting for the next command or for jobGap.
+		 *
+		 * Only for hosts whose raster rows never begin with the feed's line feeds, since such a row
+		 * split right after them would otherwise end the job early.
+		 */
+		bool endOnTrailer = false;
+		/**
+		 * @brief Time a new link takes to come up; nothing is answered before it has passed.
+		 */
+		std::chrono::milliseconds connectDelay{ 0 };
+		/**
+		 * @brief Reply to the status query: ready, head at 30 C, battery full, firmware 1.0.
+		 */
+		std::array<uint8_t, 38> status{ 0x00, 30, 100, 1, 0 };
+		/**
+		 * @brief Reply to the serial number query.
+		 */
+		std::array<uint8_t, 21> serial{ 'Y', 'H', 'K', '-', 'E', 'M', 'U', 'L', 'A', 'T', 'O', 'R', '-', '0', '0', '0', '0', '0', '0', '1' };
+		/**
+		 * @brief Directory receiving a PBM image per job, empty to keep images in memory only.
+		 */
+		std::string outputDirectory;
+	} EMULATOR_CONFIG;
+
+	/**
+	 * @brief Record of one job printed by the emulator.
+	 */
+	typedef struct _EMULATOR_JOB
+	{
+		/**
+		 * @brief Sequential job number, starting at 1.
+		 */
+		uint64_t id;
+		/**
+		 * @brief Job bytes received: raw raster including any incomplete trailing row, or raster image and feed commands.
+		 */
+		size_t bytes;
+		/**
+		 * @brief Complete rows printed.
+		 */
+		size_t rows;
+		/**
+		 * @brief When the print start command was delivered.
+		 */
+		std::chrono::steady_clock::time_point started;
+		/**
+		 * @brief When the first raster byte was delivered.
+		 */
+		std::chrono::steady_clock::time_point firstByte;
+		/**
+		 * @brief When the print head finished the last row.
+		 */
+		std::chrono::steady_clock::time_point finished;
+		/**
+		 * @brief Time the link spent blocked on a full receive buffer during the job.
+		 */
+		std::chrono::nanoseconds stalled;
+		/**
+		 * @brief Bytes dropped at a full receive buffer during the job.
+		 */
+		size_t dropped;
+		/**
+		 * @brief Time the print head spent stopped for lack of paper or heat during the job.
+		 */
+		std::chrono::nanoseconds paused;
+		/**
+		 * @brief Decoded raster, rowBytes per row, most significant bit leftmost.
+		 */
+		std::vector<uint8_t> raster;
+		/**
+		 * @brief Path of the PBM image, empty if none was written.
+		 */
+		std::string image;
+	} EMULATOR_JOB;
+
+	/**
+	 * @brief Software emulator of a YHK cat printer.
+	 *
+	 * Understands the init (1b 40), status (1e 47 03), serial number
+	 * (1d 67 39) and print start (1d 49 f0 19) commands. After a print start
+	 * everything is raster data until the link stays idle for jobGap, the
+	 * connection closes, or a row boundary holds the 0a 0a 0a 0a end-of-job
+	 * feed followed by another command.
+	 *
+	 * Jobs can also be sent as GS v 0 raster images (1d 76 30) and ESC J dot
+	 * feeds (1b 4a n) without a print start. A run of these commands forms
+	 * one job, which ends at the first other byte, such as the end-of-job
+	 * feed, or when the link stays idle for jobGap.
+	 *
+	 * The status reply carries the condition set with setCondition() and,
+	 * with reportBufferFull, whether the buffer is full. Whenever either
+	 * changes, the status is also sent unprompted. A host that does not read
+	 * it never blocks the printer: unsent reports are merged into the latest.
+	 *
+	 * Connections are served one at a time, like a real printer.
+	 *
+	 * @note All public methods are thread-safe.
+	 */
+	class PrinterEmulator
+	{
+	public:
+		/**
+		 * @brief Callback invoked on the serving thread after each finished job.
+		 */
+		using JobCallback = std::function<void(const EMULATOR_JOB&)>;
+
+		/**
+		 * @brief Constructs an idle PrinterEmulator.
+		 *
+		 * @param config Timing and reply configuration.
+		 */
+		explicit PrinterEmulator(EMULATOR_CONFIG config);
+
+		/**
+		 * @brief Destructor. Stops serving.
+		 */
+		~PrinterEmulator();
+
+		// Disable copy semantics
+		PrinterEmulator(const PrinterEmulator&) = delete;
+		PrinterEmulator& operator=(const PrinterEmulator&) = delete;
+
+		/**
+		 * @brief Starts accepting in-process connections at "loop://name".
+		 *
+		 * @throws std::runtime_error if already listening or the name is taken.
+		 */
+		void listenLoopback(const std::string& name);
+
+		/**
+		 * @brief Starts accepting TCP connections on the loopback interface.
+		 *
+		 * @param port TCP port, 0 to let the system pick one.
+		 * @return Port the emulator listens on.
+		 *
+		 * @throws std::runtime_error if already listening, the port cannot be bound or, outside Windows, always.
+		 */
+		uint16_t listenTcp(uint16_t port);
+
+		/**
+		 * @brief Serves a single connection until it is closed.
+		 *
+		 * @param socket Connected socket.
+		 */
+		void serve(std::shared_ptr<IRfcommSocket> socket);
+
+		/**
+		 * @brief Stops listening and closes the active connection.
+		 */
+		void stop();
+
+		/**
+		 * @brief Sets the callback invoked after each finished job.
+		 */
+		void setJobCallback(JobCallback callback);
+
+		/**
+		 * @brief Raises or clears the paper-out, overheat and paper-low conditions and reports the change.
+		 *
+		 * While paper-out or overheat is raised the print head stops and the
+		 * job waits; it does not end at the idle gap. Paper-low is only
+		 * reported.
+		 *
+		 * @param condition escpos::CONDITION_PAPER_OUT, escpos::CONDITION_OVERHEATED and escpos::CONDITION_PAPER_LOW bits; other bits are ignored.
+		 */
+		void setCondition(uint8_t condition);
+
+		/**
+		 * @brief Waits until at least the given number of jobs have finished.
+		 *
+		 * @param count Number of jobs to wait for, counted since construction.
+		 * @param timeout Maximum duration to wait.
+		 * @return true if the jobs finished in time.
+		 */
+		bool waitForJobs(size_t count, std::chrono::nanoseconds timeout);
+
+		/**
+		 * @brief Returns the records of all finished jobs.
+		 */
+		std::vector<EMULATOR_JOB> jobs() const;
+
+		/**
+		 * @brief Forgets the records of finished jobs, keeping the job numbering.
+		 */
+		void clearJobs();
+
+		/**
+		 * @brief Writes a raster as a binary PBM (P4) image.
+		 *
+		 * @param path Output file path.
+		 * @param raster Raster data, rowBytes per row.
+		 * @param rowBytes Bytes per row.
+		 *
+		 * @throws std::runtime_error on failure to write the file.
+		 */
+		static void writePbm(const std::string& path, const std::vector<uint8_t>& raster, size_t rowBytes);
+
+	private:
+		/**
+		 * @brief Bytes delivered by the link at one point in time.
+		 */
+		struct Packet
+		{
+			std::vector<uint8_t> data;
+			std::chrono::steady_clock::time_point deliveredAt;
+		};
+
+		/**
+		 * @brief Parser and timing state of one connection.
+		 */
+		struct Connection;
+
+		/**
+		 * @brief Starts the accept thread.
+		 */
+		void startListening(std::function<std::shared_ptr<IRfcommSocket>()> accept, std::function<void()> close);
+
+		/**
+		 * @brief Reads the socket at link speed and fills the receive buffer.
+		 */
+		void runLink(IRfcommSocket& socket, BoundedQueue<Packet>& buffer);
+
+		/**
+		 * @brief Sends the status whenever a report is pending, until the connection ends.
+		 */
+		void runNotifier(IRfcommSocket& socket);
+
+		/**
+		 * @brief Updates the reported buffer state after bytes entered or left the receive buffer.
+		 */
+		void updateBufferReport();
+
+		/**
+		 * @brief Returns the status reply with the current condition.
+		 */
+		std::array<uint8_t, 38> currentStatus();
+
+		/**
+		 * @brief Sends a reply, keeping it whole among replies sent by other threads.
+		 */
+		void sendReply(IRfcommSocket& socket, const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Interprets all complete commands and rows held by the connection.
+		 */
+		void process(Connection& connection);
+
+		/**
+		 * @brief Opens a new job record.
+		 */
+		void startJob(Connection& connection);
+
+		/**
+		 * @brief Prints a GS v 0 raster image, opening a job if none is open.
+		 *
+		 * @return Bytes consumed, 0 if the image is not complete yet.
+		 */
+		size_t printRasterImage(Connection& connection, const uint8_t* data, size_t available, std::chrono::steady_clock::duration rowDuration);
+
+		/**
+		 * @brief Feeds paper by ESC J dot rows, opening a job if none is open.
+		 *
+		 * @return Bytes consumed, 0 if the command is not complete yet.
+		 */
+		size_t feedDots(Connection& connection, const uint8_t* data, size_t available, std::chrono::steady_clock::duration rowDuration);
+
+		/**
+		 * @brief Closes the current job, if any, and publishes its record.
+		 *
+		 * @param truncated true if the job ended by idle gap or disconnect; unparsed bytes then belong to the job.
+		 */
+		void finishJob(Connection& connection, bool truncated);
+
+		/**
+		 * @brief Configuration.
+		 */
+		const EMULATOR_CONFIG m_config;
+		/**
+		 * @brief Thread accepting and serving connections.
+		 */
+		std::thread m_acceptThread;
+		/**
+		 * @brief Closes the listener to unblock the accept thread.
+		 */
+		std::function<void()> m_closeListener;
+		/**
+		 * @brief Connection currently served, if any.
+		 */
+		std::shared_ptr<IRfcommSocket> m_active;
+		/**
+		 * @brief Set once stop() has been called.
+		 */
+		std::atomic<bool> m_stopping;
+		/**
+		 * @brief Total time the link spent blocked on a full receive buffer.
+		 */
+		std::atomic<int64_t> m_stalledNanos;
+		/**
+		 * @brief Total bytes dropped at a full receive buffer.
+		 */
+		std::atomic<int64_t> m_droppedBytes;
+		/**
+		 * @brief Bytes in the receive buffer of the active connection.
+		 */
+		std::atomic<size_t> m_bufferedBytes;
+		/**
+		 * @brief Raised paper-out and overheat condition bits.
+		 */
+		uint8_t m_condition;
+		/**
+		 * @brief Whether the buffer was last reported full.
+		 */
+		bool m_reportedFull;
+		/**
+		 * @brief Whether the status has changed since it was last sent unprompted.
+		 */
+		bool m_statusPending;
+		/**
+		 * @brief Set when the active connection ends, to stop its notifier.
+		 */
+		bool m_connectionEnded;
+		/**
+		 * @brief Number of the most recently started job.
+		 */
+		uint64_t m_lastJobId;
+		/**
+		 * @brief Number of jobs finished since construction.
+		 */
+		size_t m_finishedCount;
+		/**
+		 * @brief Records of finished jobs.
+		 */
+		std::vector<EMULATOR_JOB> m_jobs;
+		/**
+		 * @brief Callback invoked after each finished job.
+		 */
+		JobCallback m_callback;
+		/**
+		 * @brief Guards all state above.
+		 */
+		mutable std::mutex m_mutex;
+		/**
+		 * @brief Signalled when a job finishes.
+		 */
+		std::condition_variable m_jobFinished;
+		/**
+		 * @brief Signalled when the condition or the status to report changes, or the connection ends.
+		 */
+		std::condition_variable m_statusChanged;
+		/**
+		 * @brief Serializes replies sent by the serving and notifier threads.
+		 */
+		std::mutex m_replyMutex;
+	};
+}
@@ -0,0 +1,179 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	main.cpp
+
+Abstract:
+	Command-line host for PrinterEmulator.
+
+--*/
+
+#include "PrinterEmulator.h"
+#include "../EscPos.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cerr
+			<< "Usage: YHKCatPrintEmulator [options]\n"
+			<< "  --port N             TCP port to listen on (default 9100, 0 picks one)\n"
+			<< "  --bandwidth B        link throughput in bytes per second (default unlimited)\n"
+			<< "  --latency-us US      one-way latency per packet in microseconds (default 0)\n"
+			<< "  --packet BYTES       link packet size (default 990)\n"
+			<< "  --buffer BYTES       printer receive buffer size (default 4096)\n"
+			<< "  --feed-rate ROWS     rows printed per second (default unlimited)\n"
+			<< "  --job-gap-ms MS      idle time that ends a job (default 200)\n"
+			<< "  --drop-overflow 0|1  drop data arriving at a full buffer instead of stalling (default 0)\n"
+			<< "  --report-buffer 0|1  report the buffer full and drained in the status (default 0)\n"
+			<< "  --reply-split BYTES  send replies in pieces of at most BYTES (default whole)\n"
+			<< "  --out DIR            write a PBM image of every job to DIR\n"
+			<< "While running, enter paper-out, paper-low, overheat or ready to change the printer's condition,\n"
+			<< "or an empty line to stop.\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	yhkcatprint::EMULATOR_CONFIG config;
+	uint16_t port = 9100;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string option = argv[i];
+			if (option == "--help" || option == "-h")
+			{
+				printUsage();
+				return 0;
+			}
+			if (i + 1 >= argc)
+			{
+				throw std::invalid_argument("Missing value for " + option);
+			}
+			std::string value = argv[++i];
+
+			if (option == "--port")
+			{
+				port = static_cast<uint16_t>(std::stoul(value));
+			}
+			else if (option == "--bandwidth")
+			{
+				config.bandwidth = std::stod(value);
+			}
+			else if (option == "--latency-us")
+			{
+				config.latency = std::chrono::microseconds(std::stoll(value));
+			}
+			else if (option == "--packet")
+			{
+				config.packetSize = std::stoul(value);
+			}
+			else if (option == "--buffer")
+			{
+				config.bufferSize = std::stoul(value);
+			}
+			else if (option == "--feed-rate")
+			{
+				config.feedRate = std::stod(value);
+			}
+			else if (option == "--job-gap-ms")
+			{
+				config.jobGap = std::chrono::milliseconds(std::stoll(value));
+			}
+			else if (option == "--drop-overflow")
+			{
+				config.dropOnOverflow = std::stoi(value) != 0;
+			}
+			else if (option == "--report-buffer")
+			{
+				config.reportBufferFull = std::stoi(value) != 0;
+			}
+			else if (option == "--reply-split")
+			{
+				config.replyFragment = std::stoul(value);
+			}
+			else if (option == "--out")
+			{
+				config.outputDirectory = value;
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown option " + option);
+			}
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+
+	try
+	{
+		yhkcatprint::PrinterEmulator emulator(config);
+		emulator.setJobCallback([](const yhkcatprint::EMULATOR_JOB& job)
+		{
+			double seconds = std::chrono::duration<double>(job.finished - job.started).count();
+			double firstByte = std::chrono::duration<double>(job.firstByte - job.started).count();
+			double stalled = std::chrono::duration<double>(job.stalled).count();
+			double paused = std::chrono::duration<double>(job.paused).count();
+			std::cout << "job " << job.id
+				<< ": " << job.bytes << " bytes, " << job.rows << " rows"
+				<< ", " << seconds << " s"
+				<< ", first byte " << firstByte << " s"
+				<< ", stalled " << stalled << " s"
+				<< ", paused " << paused << " s"
+				<< ", dropped " << job.dropped << " bytes"
+				<< ", " << (seconds > 0.0 ? job.bytes / seconds : 0.0) << " B/s";
+			if (!job.image.empty())
+			{
+				std::cout << ", " << job.image;
+			}
+			std::cout << std::endl;
+		});
+
+		port = emulator.listenTcp(port);
+		std::cout << "Emulating printer at tcp://127.0.0.1:" << port << ", press Enter to stop." << std::endl;
+
+		std::string line;
+		while (std::getline(std::cin, line) && !line.empty())
+		{
+			if (line == "paper-out")
+			{
+				emulator.setCondition(yhkcatprint::escpos::CONDITION_PAPER_OUT);
+			}
+			else if (line == "paper-low")
+			{
+				emulator.setCondition(yhkcatprint::escpos::CONDITION_PAPER_LOW);
+			}
+			else if (line == "overheat")
+			{
+				emulator.setCondition(yhkcatprint::escpos::CONDITION_OVERHEATED);
+			}
+			else if (line == "ready")
+			{
+				emulator.setCondition(0);
+			}
+			else
+			{
+				std::cerr << "Unknown command " << line << std::endl;
+			}
+		}
+		emulator.stop();
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << "Emulator failed: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	linux_rfcomm.cpp
+
+Abstract:
+	Implementation of RfcommSocketLinux methods.
+
+--*/
+
+module;
+
+#include "LinuxSocket.h"
+#include <sys/socket.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/rfcomm.h>
+
+module yhkcatprint.linux;
+
+import std;
+
+/**
+ * @file linux_rfcomm.cpp
+ * @brief Implementation of RfcommSocketLinux methods.
+ * 
+ * This file adapts LinuxSocket, which waits for readiness with epoll, to
+ * BlueZ RFCOMM addressing and the IRfcommSocket interface.
+ */
+
+namespace yhkcatprint
+{
+	struct RfcommSocketLinux::Impl
+	{
+		sockaddr_rc addr;
+		LinuxSocket socket;
+
+		static bdaddr_t strToBdAddr(const std::string& address)
+		{
+			// BlueZ stores addresses little-endian, so the first octet of the
+			// string goes to the last byte.
+			BluetoothAddress parsed = BluetoothAddress::fromString(address);
+			bdaddr_t bdAddr = {};
+			for (size_t i = 0; i < 6; ++i) {
+				bdAddr.b[5 - i] = parsed.octet(i);
+			}
+			return bdAddr;
+		}
+
+		Impl(const std::string& address, std::uint8_t channel)
+			: addr{}, socket(AF_BLUETOOTH, SOCK_STREAM, BTPROTO_RFCOMM)
+		{
+			addr.rc_family = AF_BLUETOOTH;
+			addr.rc_bdaddr = strToBdAddr(address);
+			addr.rc_channel = channel;
+		}
+
+		explicit Impl(int fd)
+			: addr{}, socket(fd)
+		{
+		}
+
+		const sockaddr* address() const
+		{
+			return reinterpret_cast<const sockaddr*>(&addr);
+		}
+	};
+
+	RfcommSocketLinux::RfcommSocketLinux(const std::string& address, std::uint8_t channel)
+		: m_impl(std::make_unique<Impl>(address, channel))
+	{
+	}
+
+	RfcommSocketLinux::RfcommSocketLinux(int fd)
+		: m_impl(std::make_unique<Impl>(fd))
+	{
+	}
+
+	RfcommSocketLinux::~RfcommSocketLinux() = default;
+
+	RfcommSocketLinux::RfcommSocketLinux(RfcommSocketLinux&& other) noexcept = default;
+	RfcommSocketLinux& RfcommSocketLinux::operator=(RfcommSocketLinux&& other) noexcept = default;
+
+	void RfcommSocketLinux::connect()
+	{
+		m_impl->socket.connect(m_impl->address(), sizeof(m_impl->addr));
+	}
+
+	void RfcommSocketLinux::connect(std::chrono::nanoseconds timeout)
+	{
+		m_impl->socket.connect(m_impl->address(), sizeof(m_impl->addr), timeout);
+	}
+
+	size_t RfcommSocketLinux::send(const std::uint8_t* data, size_t size)
+	{
+		return m_impl->socket.send(data, size);
+	}
+
+	size_t RfcommSocketLinux::send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+	{
+		return m_impl->socket.send(data, size, timeout);
+	}
+
+	size_t RfcommSocketLinux::send(std::span<const std::span<const std::uint8_t>> buffers)
+	{
+		return m_impl->socket.send(buffers);
+	}
+
+	size_t RfcommSocketLinux::receive(std::uint8_t* buffer, size_t size)
+	{
+		return m_impl->socket.receive(buffer, size);
+	}
+
+	size_t RfcommSocketLinux::receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+	{
+		return m_impl->socket.receive(buffer, size, timeout);
+	}
+
+	size_t RfcommSocketLinux::available()
+	{
+		return m_impl->socket.available();
+	}
+
+	void RfcommSocketLinux::close()
+	{
+		if (m_impl) {
+			m_impl->socket.close();
+		}
+	}
+}
@@ -0,0 +1,117 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	loopback.cpp
+
+Abstract:
+	Implementation of LoopbackSocket methods.
+
+--*/
+
+module;
+
+#include "LoopbackPipe.h"
+
+module yhkcatprint;
+
+import std;
+
+/**
+ * @file loopback.cpp
+ * @brief Implementation of LoopbackSocket methods.
+ * 
+ * This file adapts the in-process loopback pipes to the IRfcommSocket interface.
+ */
+
+namespace yhkcatprint
+{
+	LoopbackSocket::LoopbackSocket(const std::string& address, std::uint8_t channel)
+		: m_address(address)
+	{
+	}
+
+	LoopbackSocket::LoopbackSocket(LOOPBACK_ENDPOINT endpoint)
+		: m_endpoint(std::move(endpoint))
+	{
+	}
+
+	LoopbackSocket::~LoopbackSocket()
+	{
+		close();
+	}
+
+	void LoopbackSocket::connect()
+	{
+		if (m_endpoint.rx != nullptr) {
+			throw std::runtime_error("Socket already connected");
+		}
+		m_endpoint = LoopbackListener::connect(m_address);
+	}
+
+	void LoopbackSocket::connect(std::chrono::nanoseconds timeout)
+	{
+		connect();
+	}
+
+	size_t LoopbackSocket::send(const std::uint8_t* data, size_t size)
+	{
+		if (m_endpoint.tx == nullptr) {
+			throw std::runtime_error("Socket not connected");
+		}
+		return m_endpoint.tx->write(data, size);
+	}
+
+	size_t LoopbackSocket::send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+	{
+		if (m_endpoint.tx == nullptr) {
+			throw std::runtime_error("Socket not connected");
+		}
+		return m_endpoint.tx->write(data, size, std::chrono::steady_clock::now() + timeout);
+	}
+
+	size_t LoopbackSocket::send(std::span<const std::span<const std::uint8_t>> buffers)
+	{
+		if (m_endpoint.tx == nullptr) {
+			throw std::runtime_error("Socket not connected");
+		}
+		size_t total = 0;
+		for (const auto& buffer : buffers) {
+			total += m_endpoint.tx->write(buffer.data(), buffer.size());
+		}
+		return total;
+	}
+
+	size_t LoopbackSocket::receive(std::uint8_t* buffer, size_t size)
+	{
+		if (m_endpoint.rx == nullptr) {
+			throw std::runtime_error("Socket not connected");
+		}
+		return m_endpoint.rx->read(buffer, size);
+	}
+
+	size_t LoopbackSocket::receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+	{
+		if (m_endpoint.rx == nullptr) {
+			throw std::runtime_error("Socket not connected");
+		}
+		return m_endpoint.rx->read(buffer, size, std::chrono::steady_clock::now() + timeout);
+	}
+
+	size_t LoopbackSocket::available()
+	{
+		if (m_endpoint.rx == nullptr) {
+			throw std::runtime_error("Socket not connected");
+		}
+		return m_endpoint.rx->available();
+	}
+
+	void LoopbackSocket::close()
+	{
+		if (m_endpoint.rx != nullptr) {
+			m_endpoint.rx->close();
+			m_endpoint.tx->close();
+		}
+	}
+}
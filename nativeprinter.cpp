@@ -1,22 +1,192 @@
 #include "nativeprinter.h"
+#include <chrono>
 #include <iostream>
 #include <memory>
-#include <ranges>
-#include "IBluetoothManager.h"
-#include "ProtoBluetoothManager.h"
-#include "IAdapter.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BufferPool.h"
+#include "ConnectionPool.h"
+#include "DeviceRegistry.h"
+#include "Metrics.h"
+#include "PrinterSession.h"
 #include "ProtoAdapter.h"
-#include "IDevice.h"
-#include "ProtoDevice.h"
-#include "IRfcommSocket.h"
-#include "ProtoRfcommSocket.h"
-
-using yhkcatprint::IRfcommSocket;
-using yhkcatprint::ProtoRfcommSocket;
-using yhkcatprint::IDevice;
-using yhkcatprint::ProtoDevice;
-using yhkcatprint::IAdapter;
-using yhkcatprint::ProtoAdapter;
+#include "PrintQueue.h"
+#include "PrintScheduler.h"
+#include "Raster.h"
+#include "RasterStream.h"
+#include "SocketReactor.h"
+#include "JniEventListener.h"
+
+using yhkcatprint::ConnectionPool;
+using yhkcatprint::DeviceRegistry;
+using yhkcatprint::PrinterSession;
+using yhkcatprint::PrintQueue;
+using yhkcatprint::PrintScheduler;
+using yhkcatprint::JniEventListener;
+using yhkcatprint::Rasterizer;
+using yhkcatprint::RasterStream;
+using yhkcatprint::SocketReactor;
+
+namespace
+{
+	const char* const defaultPrinterAddress = "24:00:28:00:1e:5b";
+	const uint8_t defaultPrinterChannel = 2;
+
+	// Links outlive sessions, so reprinting to the same printer does not pay the connect again.
+	// A pool's link cap is per adapter: Bluetooth printers share the pool of the system adapter,
+	// while every endpoint scheme, such as tcp:// for network printers, has a pool of its own, so
+	// that printers on one transport do not wait for slots held on another.
+	struct SharedPools
+	{
+		std::mutex mutex;
+		std::unordered_map<std::string, std::shared_ptr<ConnectionPool>> byTransport;
+	};
+
+	SharedPools& sharedPools()
+	{
+		static SharedPools pools;
+		return pools;
+	}
+
+	std::shared_ptr<ConnectionPool> sharedPool(const std::string& address)
+	{
+		size_t scheme = address.find("://");
+		const std::string transport = scheme == std::string::npos ? std::string() : address.substr(0, scheme);
+
+		SharedPools& pools = sharedPools();
+		std::lock_guard<std::mutex> lock(pools.mutex);
+		std::shared_ptr<ConnectionPool>& pool = pools.byTransport[transport];
+		if (pool == nullptr) {
+			pool = std::make_shared<ConnectionPool>();
+		}
+		return pool;
+	}
+
+	// Enumerating paired devices is a system call per device; the cache makes looking up a printer a hash lookup.
+	std::shared_ptr<DeviceRegistry> sharedRegistry()
+	{
+		static const std::shared_ptr<DeviceRegistry> registry = std::make_shared<DeviceRegistry>(std::make_shared<yhkcatprint::ProtoAdapter>());
+		return registry;
+	}
+
+	// One thread waits on the links of all monitored sessions.
+	std::shared_ptr<SocketReactor> sharedReactor()
+	{
+		static const std::shared_ptr<SocketReactor> reactor = std::make_shared<SocketReactor>();
+		return reactor;
+	}
+
+	// A session handle owns one reference to the session; open queues hold others, so
+	// closing the session handle leaves the session alive until its queues are closed.
+	std::shared_ptr<PrinterSession>& sessionRef(jlong handle)
+	{
+		return *reinterpret_cast<std::shared_ptr<PrinterSession>*>(handle);
+	}
+
+	PrinterSession* toSession(jlong handle)
+	{
+		return sessionRef(handle).get();
+	}
+
+	PrintQueue* toQueue(jlong handle)
+	{
+		return reinterpret_cast<PrintQueue*>(handle);
+	}
+
+	PrintScheduler* toScheduler(jlong handle)
+	{
+		return reinterpret_cast<PrintScheduler*>(handle);
+	}
+
+	bool readString(JNIEnv* env, jstring string, std::string& result)
+	{
+		if (string == nullptr) {
+			result.clear();
+			return true;
+		}
+
+		const char* chars = env->GetStringUTFChars(string, nullptr);
+
+		if (chars == nullptr) {
+			std::cerr << "Failed to get string." << std::endl;
+			return false;
+		}
+
+		result.assign(chars);
+		env->ReleaseStringUTFChars(string, chars);
+		return true;
+	}
+
+	// Copies a job out of a Java array, which may move or be reused once the call returns,
+	// into a pooled buffer, so that a stream of jobs reuses the same native memory.
+	bool readJob(JNIEnv* env, jbyteArray buffer, jint length, yhkcatprint::PooledBuffer& data)
+	{
+		jsize capacity = env->GetArrayLength(buffer);
+		if (length < 0 || length > capacity) {
+			std::cerr << "Size parameter exceeds buffer capacity." << std::endl;
+			return false;
+		}
+
+		data = yhkcatprint::BufferPool::instance().acquire(static_cast<size_t>(length));
+		env->GetByteArrayRegion(buffer, 0, length, reinterpret_cast<jbyte*>(data.data()));
+		return true;
+	}
+
+	// Raises IllegalArgumentException in the calling Java code once the native method returns.
+	void throwIllegalArgument(JNIEnv* env, const std::string& message)
+	{
+		jclass exceptionClass = env->FindClass("java/lang/IllegalArgumentException");
+		if (exceptionClass != nullptr) {
+			env->ThrowNew(exceptionClass, message.c_str());
+			env->DeleteLocalRef(exceptionClass);
+		}
+	}
+
+	// Validates rasterization arguments shared by rasterize and printImage. The pixels are
+	// attached by the caller; the palette is small, so a copy is cheaper than pinning a second array.
+	bool readRasterArgs(JNIEnv* env, jbyteArray pixels, jint width, jint height, jint format, jbyteArray palette, jint dotWidth, jint dither, jint threshold,
+		yhkcatprint::IMAGE_DESC& image, std::vector<uint8_t>& paletteData, yhkcatprint::RASTER_OPTIONS& options)
+	{
+		if (width <= 0 || height <= 0 || dotWidth <= 0 || threshold < 0 || threshold > 255) {
+			std::cerr << "Invalid rasterization parameters." << std::endl;
+			return false;
+		}
+
+		// Values outside the enums would select no conversion or dithering branch at all.
+		if (format < yhkcatprint::PIXEL_FORMAT_RGBA || format > yhkcatprint::PIXEL_FORMAT_INDEXED) {
+			throwIllegalArgument(env, "Invalid pixel format: " + std::to_string(format));
+			return false;
+		}
+		if (dither < yhkcatprint::DITHER_THRESHOLD || dither > yhkcatprint::DITHER_ATKINSON) {
+			throwIllegalArgument(env, "Invalid dithering method: " + std::to_string(dither));
+			return false;
+		}
+
+		image.width = static_cast<uint32_t>(width);
+		image.height = static_cast<uint32_t>(height);
+		image.format = static_cast<yhkcatprint::PixelFormat>(format);
+
+		jlong bytesPerPixel = image.format == yhkcatprint::PIXEL_FORMAT_RGBA ? 4 : 1;
+		if (static_cast<jlong>(width) * height * bytesPerPixel > env->GetArrayLength(pixels)) {
+			std::cerr << "Image size exceeds buffer capacity." << std::endl;
+			return false;
+		}
+
+		if (palette != nullptr) {
+			paletteData.resize(static_cast<size_t>(env->GetArrayLength(palette)) / 4 * 4);
+			env->GetByteArrayRegion(palette, 0, static_cast<jsize>(paletteData.size()), reinterpret_cast<jbyte*>(paletteData.data()));
+			image.palette = paletteData.data();
+			image.paletteSize = paletteData.size() / 4;
+		}
+
+		options.dotWidth = static_cast<uint32_t>(dotWidth);
+		options.dither = static_cast<yhkcatprint::DitherMethod>(dither);
+		options.threshold = static_cast<uint8_t>(threshold);
+		return true;
+	}
+}
 
 JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printBuffer(JNIEnv* env, jobject obj, jbyteArray buffer, jint length) {
 	uint8_t* data = reinterpret_cast<uint8_t*>(env->GetByteArrayElements(buffer, nullptr));
@@ -27,80 +197,608 @@ JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printBu
 	}
 
 	jlong capacity = env->GetArrayLength(buffer);
-	if (length > capacity) {
+	if (length < 0 || length > capacity) {
 		std::cerr << "Size parameter exceeds buffer capacity." << std::endl;
-		env->ReleaseByteArrayElements(buffer, reinterpret_cast<jbyte*>(data), 0);
+		env->ReleaseByteArrayElements(buffer, reinterpret_cast<jbyte*>(data), JNI_ABORT);
 		return;
 	}
 
-	auto manager = std::make_unique<yhkcatprint::ProtoBluetoothManager>();
+	try {
+		PrinterSession session(defaultPrinterAddress, defaultPrinterChannel, sharedPool(defaultPrinterAddress), sharedRegistry());
+		// The legacy entry point prints the buffer as given, blank bottom rows included.
+		session.setTrimming(false);
+		session.open();
+		session.print(data, static_cast<size_t>(length));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+	}
 
-	for (auto adapter : manager->listAdapters())
-	{
-		std::cout << "Found adapter: " << adapter.name << " [" << adapter.address << "]" << std::endl;
+	// The buffer is only read, so there is nothing to copy back.
+	env->ReleaseByteArrayElements(buffer, reinterpret_cast<jbyte*>(data), JNI_ABORT);
+}
+
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_openSession(JNIEnv* env, jobject obj, jstring address, jint channel) {
+	const char* chars = env->GetStringUTFChars(address, nullptr);
+
+	if (chars == nullptr) {
+		std::cerr << "Failed to get address string." << std::endl;
+		return 0;
+	}
+
+	std::string addressStr(chars);
+	env->ReleaseStringUTFChars(address, chars);
+
+	if (channel < 1 || channel > 30) {
+		std::cerr << "Invalid RFCOMM channel number: " << channel << std::endl;
+		return 0;
 	}
 
-	auto adapter = std::make_unique<yhkcatprint::ProtoAdapter>();
+	try {
+		auto session = std::make_shared<PrinterSession>(addressStr, static_cast<uint8_t>(channel), sharedPool(addressStr), sharedRegistry());
+		session->open();
+		return reinterpret_cast<jlong>(new std::shared_ptr<PrinterSession>(std::move(session)));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 0;
+	}
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printSession(JNIEnv* env, jobject obj, jlong session, jbyteArray buffer, jint length) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	jsize capacity = env->GetArrayLength(buffer);
+	if (length < 0 || length > capacity) {
+		std::cerr << "Size parameter exceeds buffer capacity." << std::endl;
+		return JNI_FALSE;
+	}
+
+	jbyte* data = env->GetByteArrayElements(buffer, nullptr);
+
+	if (data == nullptr) {
+		std::cerr << "Failed to get byte array elements." << std::endl;
+		return JNI_FALSE;
+	}
+
+	jboolean result = JNI_TRUE;
+	try {
+		toSession(session)->print(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(length));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		result = JNI_FALSE;
+	}
+
+	// The buffer is only read, so there is nothing to copy back.
+	env->ReleaseByteArrayElements(buffer, data, JNI_ABORT);
+	return result;
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printSessionDirect(JNIEnv* env, jobject obj, jlong session, jobject buffer, jint length) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	// The zero-copy path: the session reads the direct buffer in place, and unlike a
+	// pinned or critical array it does not hold off the garbage collector while the
+	// session reconnects, waits for the printer or sends.
+	// Only direct buffers expose their storage; heap buffers return nullptr here.
+	void* data = env->GetDirectBufferAddress(buffer);
+
+	if (data == nullptr) {
+		std::cerr << "Buffer is not a direct ByteBuffer." << std::endl;
+		return JNI_FALSE;
+	}
 
-	auto devices = adapter->getPairedDevices();
+	jlong capacity = env->GetDirectBufferCapacity(buffer);
+	if (length < 0 || length > capacity) {
+		std::cerr << "Size parameter exceeds buffer capacity." << std::endl;
+		return JNI_FALSE;
+	}
 
-	for (const auto& device : devices) {
-		std::cout << "Found paired device: " << device->getInfo().name << " [" << device->getInfo().address << "]" << std::endl;
+	try {
+		toSession(session)->print(static_cast<const uint8_t*>(data), static_cast<size_t>(length));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return JNI_FALSE;
 	}
 
-	auto device = devices.empty() ? nullptr : *(devices
-		| std::views::filter([](const std::shared_ptr<IDevice>& dev) {
-			return dev->getInfo().address == "24:00:28:00:1e:5b";}) 
-		| std::views::take(1) 
-	).begin();
+	return JNI_TRUE;
+}
 
-	if (device == nullptr) {
-		std::cerr << "Target device not found among paired devices." << std::endl;
-		env->ReleaseByteArrayElements(buffer, reinterpret_cast<jbyte*>(data), 0);
+JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeSession(JNIEnv* env, jobject obj, jlong session) {
+	if (session == 0) {
 		return;
 	}
 
-	std::cout << "Connecting to device: " << device->getInfo().name << " [" << device->getInfo().address << "]" << std::endl;
-	auto socket = device->createRfcommSocket(2, yhkcatprint::ConnectOptions::TIMEOUT_NONE);
+	// Drops the handle's reference; a queue still open on the session keeps it
+	// connected until the queue is closed, and the last owner closes the link.
+	delete &sessionRef(session);
+}
+
+JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeIdleConnections(JNIEnv* env, jobject obj) {
+	std::vector<std::shared_ptr<ConnectionPool>> pools;
+	{
+		SharedPools& shared = sharedPools();
+		std::lock_guard<std::mutex> lock(shared.mutex);
+		for (const auto& entry : shared.byTransport) {
+			pools.push_back(entry.second);
+		}
+	}
+
+	// Closing links can block, so it runs without holding the pool map.
+	for (const auto& pool : pools) {
+		pool->clear();
+	}
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_watchDevices(JNIEnv* env, jobject obj, jobject listener, jint intervalMs) {
+	if (intervalMs < 1) {
+		std::cerr << "Invalid refresh interval: " << intervalMs << std::endl;
+		return JNI_FALSE;
+	}
+
+	try {
+		std::shared_ptr<yhkcatprint::IEventListener> eventListener;
+		if (listener != nullptr) {
+			eventListener = std::make_shared<JniEventListener>(env, listener);
+		}
+		sharedRegistry()->startWatching(eventListener, std::chrono::milliseconds(intervalMs));
+		return JNI_TRUE;
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return JNI_FALSE;
+	}
+}
+
+JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_stopWatchingDevices(JNIEnv* env, jobject obj) {
+	sharedRegistry()->stopWatching();
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_setSessionEncoding(JNIEnv* env, jobject obj, jlong session, jint encoding) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	if (encoding != yhkcatprint::RASTER_ENCODING_RAW && encoding != yhkcatprint::RASTER_ENCODING_IMAGE) {
+		std::cerr << "Invalid raster encoding: " << encoding << std::endl;
+		return JNI_FALSE;
+	}
+
+	toSession(session)->setEncoding(static_cast<yhkcatprint::RasterEncoding>(encoding));
+	return JNI_TRUE;
+}
+
+JNIEXPORT jdouble JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getLastCompressionRatio(JNIEnv* env, jobject obj, jlong session) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return 0.0;
+	}
+
+	yhkcatprint::ENCODE_STATS stats = toSession(session)->lastJobStats();
+	if (stats.encodedBytes == 0) {
+		return 0.0;
+	}
+	return static_cast<jdouble>(stats.rasterBytes) / static_cast<jdouble>(stats.encodedBytes);
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_setSessionTrimming(JNIEnv* env, jobject obj, jlong session, jboolean trim) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	toSession(session)->setTrimming(trim == JNI_TRUE);
+	return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_monitorSession(JNIEnv* env, jobject obj, jlong session, jobject listener) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	try {
+		if (listener == nullptr) {
+			toSession(session)->monitor(nullptr, nullptr);
+			return JNI_TRUE;
+		}
+		toSession(session)->monitor(sharedReactor(), std::make_shared<JniEventListener>(env, listener));
+		return JNI_TRUE;
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return JNI_FALSE;
+	}
+}
+
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_openQueue(JNIEnv* env, jobject obj, jlong session, jint capacity, jobject listener) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return 0;
+	}
+
+	if (capacity < 1) {
+		std::cerr << "Invalid queue capacity: " << capacity << std::endl;
+		return 0;
+	}
+
+	try {
+		std::shared_ptr<yhkcatprint::IEventListener> eventListener;
+		if (listener != nullptr) {
+			eventListener = std::make_shared<JniEventListener>(env, listener);
+		}
+		auto queue = std::make_unique<PrintQueue>(sessionRef(session), static_cast<size_t>(capacity), eventListener);
+		return reinterpret_cast<jlong>(queue.release());
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 0;
+	}
+}
 
-	//auto device = std::make_unique<ProtoDevice>("24:00:28:00:1e:5b", "Cat Printer");
-	//auto socket = device->createRfcommSocket(2, yhkcatprint::ConnectOptions::TIMEOUT_NONE);
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitJob(JNIEnv* env, jobject obj, jlong queue, jbyteArray buffer, jint length) {
+	if (queue == 0) {
+		std::cerr << "Invalid queue handle." << std::endl;
+		return 0;
+	}
 
+	yhkcatprint::PooledBuffer data;
+	if (!readJob(env, buffer, length, data)) {
+		return 0;
+	}
 
 	try {
-		const uint8_t initCmd[] = { 0x1b, 0x40 };
-		socket->send(initCmd, sizeof(initCmd));
-		// send \x1e\x47\x03 receive status 38 bytes
-		const uint8_t getStatusCmd[] = { 0x1e, 0x47, 0x03 };
-		socket->send(getStatusCmd, sizeof(getStatusCmd));
-		uint8_t status[38];
-		size_t received = socket->receive(status, sizeof(status));
-		std::cout << "Received " << received << " bytes of status data." << std::endl;
-		std::cout << "Status Data: ";
-		// send \x1D\x67\x39 receive 21 bytes
-		const uint8_t getSerialCmd[] = { 0x1D, 0x67, 0x39 };
-		socket->send(getSerialCmd, sizeof(getSerialCmd));
-		uint8_t serial[21];
-		size_t serialReceived = socket->receive(serial, sizeof(serial));
-		std::cout << "Received " << serialReceived << " bytes of serial number data." << std::endl;
-		std::cout << "Serial Number Data: ";
-		for (size_t i = 0; i < serialReceived; ++i) {
-			std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(serial[i]) << " ";
+		return static_cast<jlong>(toQueue(queue)->submit(std::move(data)));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 0;
+	}
+}
+
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitJobDirect(JNIEnv* env, jobject obj, jlong queue, jobject buffer, jint length) {
+	if (queue == 0) {
+		std::cerr << "Invalid queue handle." << std::endl;
+		return 0;
+	}
+
+	void* data = env->GetDirectBufferAddress(buffer);
+
+	if (data == nullptr) {
+		std::cerr << "Buffer is not a direct ByteBuffer." << std::endl;
+		return 0;
+	}
+
+	jlong capacity = env->GetDirectBufferCapacity(buffer);
+	if (length < 0 || length > capacity) {
+		std::cerr << "Size parameter exceeds buffer capacity." << std::endl;
+		return 0;
+	}
+
+	JavaVM* vm = nullptr;
+	if (env->GetJavaVM(&vm) != JNI_OK) {
+		std::cerr << "Failed to get Java VM." << std::endl;
+		return 0;
+	}
+
+	// Keep the buffer reachable until the I/O thread is done with its storage.
+	jobject bufferRef = env->NewGlobalRef(buffer);
+	auto release = [vm, bufferRef]() {
+		JNIEnv* threadEnv = JniEventListener::currentEnv(vm);
+		if (threadEnv != nullptr) {
+			threadEnv->DeleteGlobalRef(bufferRef);
 		}
-		// send start print sequence \x1d\x49\xf0\x19
-		const uint8_t startPrintCmd[] = { 0x1d, 0x49, 0xf0, 0x19 };
-		socket->send(startPrintCmd, sizeof(startPrintCmd));
-		// send buffer
-		socket->send(data, static_cast<size_t>(length));
-		// send end print sequence \x0a\x0a\x0a\x0a
-		const uint8_t endPrintCmd[] = { 0x0a, 0x0a, 0x0a, 0x0a };
-		socket->send(endPrintCmd, sizeof(endPrintCmd));
+	};
+
+	try {
+		return static_cast<jlong>(toQueue(queue)->submit(static_cast<const uint8_t*>(data), static_cast<size_t>(length), release));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		env->DeleteGlobalRef(bufferRef);
+		return 0;
+	}
+}
+
+JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeQueue(JNIEnv* env, jobject obj, jlong queue) {
+	delete toQueue(queue);
+}
+
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_openScheduler(JNIEnv* env, jobject obj, jobject listener) {
+	try {
+		std::shared_ptr<yhkcatprint::IEventListener> eventListener;
+		if (listener != nullptr) {
+			eventListener = std::make_shared<JniEventListener>(env, listener);
+		}
+		// The scheduler keeps a link per printer in a pool of its own, leaving the shared pools to sessions.
+		auto scheduler = std::make_unique<PrintScheduler>(eventListener, sharedRegistry());
+		return reinterpret_cast<jlong>(scheduler.release());
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 0;
+	}
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_addSchedulerPrinter(JNIEnv* env, jobject obj, jlong scheduler, jstring name, jstring address, jint channel, jstring group, jint capacity) {
+	if (scheduler == 0) {
+		std::cerr << "Invalid scheduler handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	if (channel < 1 || channel > 30) {
+		std::cerr << "Invalid RFCOMM channel number: " << channel << std::endl;
+		return JNI_FALSE;
+	}
+
+	if (capacity < 1) {
+		std::cerr << "Invalid queue capacity: " << capacity << std::endl;
+		return JNI_FALSE;
+	}
+
+	yhkcatprint::PRINTER_CONFIG config;
+	if (!readString(env, name, config.name) || !readString(env, address, config.address) || !readString(env, group, config.group)) {
+		return JNI_FALSE;
+	}
+	config.channel = static_cast<uint8_t>(channel);
+	config.capacity = static_cast<size_t>(capacity);
+
+	try {
+		toScheduler(scheduler)->addPrinter(config);
+		return JNI_TRUE;
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return JNI_FALSE;
+	}
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_removeSchedulerPrinter(JNIEnv* env, jobject obj, jlong scheduler, jstring name) {
+	if (scheduler == 0) {
+		std::cerr << "Invalid scheduler handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	std::string nameStr;
+	if (!readString(env, name, nameStr)) {
+		return JNI_FALSE;
+	}
+
+	return toScheduler(scheduler)->removePrinter(nameStr) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitToPrinter(JNIEnv* env, jobject obj, jlong scheduler, jstring printer, jbyteArray buffer, jint length) {
+	if (scheduler == 0) {
+		std::cerr << "Invalid scheduler handle." << std::endl;
+		return 0;
+	}
+
+	std::string printerStr;
+	yhkcatprint::PooledBuffer data;
+	if (!readString(env, printer, printerStr) || !readJob(env, buffer, length, data)) {
+		return 0;
+	}
+
+	try {
+		return static_cast<jlong>(toScheduler(scheduler)->submit(printerStr, std::move(data)));
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 0;
+	}
+}
+
+JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitToGroup(JNIEnv* env, jobject obj, jlong scheduler, jstring group, jbyteArray buffer, jint length) {
+	if (scheduler == 0) {
+		std::cerr << "Invalid scheduler handle." << std::endl;
+		return 0;
+	}
+
+	std::string groupStr;
+	yhkcatprint::PooledBuffer data;
+	if (!readString(env, group, groupStr) || !readJob(env, buffer, length, data)) {
+		return 0;
+	}
+
+	try {
+		return static_cast<jlong>(toScheduler(scheduler)->submitToGroup(groupStr, std::move(data)));
 	}
 	catch (const std::exception& ex) {
 		std::cerr << "Error: " << ex.what() << std::endl;
-		
-		if (socket) {
-			socket->close();
+		return 0;
+	}
+}
+
+JNIEXPORT jlongArray JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getPrinterStats(JNIEnv* env, jobject obj, jlong scheduler, jstring name) {
+	if (scheduler == 0) {
+		std::cerr << "Invalid scheduler handle." << std::endl;
+		return nullptr;
+	}
+
+	std::string nameStr;
+	if (!readString(env, name, nameStr)) {
+		return nullptr;
+	}
+
+	for (const yhkcatprint::PRINTER_STATS& stats : toScheduler(scheduler)->stats()) {
+		if (stats.name != nameStr) {
+			continue;
+		}
+
+		// Decoded status fields are -1 unless the printer has reported its status in a verified
+		// layout; until then the reply is only available as received, from getPrinterStatusFrame.
+		const yhkcatprint::PRINTER_STATE& state = stats.state;
+		const bool decoded = state.hasStatus && state.status.valid;
+		const jlong statusAge = state.hasStatus
+			? std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - state.updated).count()
+			: -1;
+
+		// pending, pendingBytes, completed, failed, bytes, bytesPerSecond, condition, temperature, battery, charging, statusAgeMs
+		const jlong values[] = {
+			static_cast<jlong>(stats.queue.pending),
+			static_cast<jlong>(stats.queue.pendingBytes),
+			static_cast<jlong>(stats.queue.completed),
+			static_cast<jlong>(stats.queue.failed),
+			static_cast<jlong>(stats.queue.bytes),
+			static_cast<jlong>(stats.bytesPerSecond),
+			decoded ? static_cast<jlong>(state.status.condition) : -1,
+			decoded ? static_cast<jlong>(state.status.temperature) : -1,
+			decoded ? static_cast<jlong>(state.status.battery) : -1,
+			decoded ? static_cast<jlong>(state.status.charging) : -1,
+			statusAge
+		};
+		const jsize count = static_cast<jsize>(sizeof(values) / sizeof(values[0]));
+
+		jlongArray result = env->NewLongArray(count);
+		if (result == nullptr) {
+			std::cerr << "Failed to allocate stats array." << std::endl;
+			return nullptr;
+		}
+		env->SetLongArrayRegion(result, 0, count, values);
+		return result;
+	}
+
+	std::cerr << "Unknown printer: " << nameStr << std::endl;
+	return nullptr;
+}
+
+JNIEXPORT jbyteArray JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getPrinterStatusFrame(JNIEnv* env, jobject obj, jlong scheduler, jstring name) {
+	if (scheduler == 0) {
+		std::cerr << "Invalid scheduler handle." << std::endl;
+		return nullptr;
+	}
+
+	std::string nameStr;
+	if (!readString(env, name, nameStr)) {
+		return nullptr;
+	}
+
+	for (const yhkcatprint::PRINTER_STATS& stats : toScheduler(scheduler)->stats()) {
+		if (stats.name != nameStr) {
+			continue;
+		}
+
+		// The status reply as received, or null until the printer has sent one.
+		if (!stats.state.hasStatus) {
+			return nullptr;
 		}
+
+		const auto& raw = stats.state.status.raw;
+		jbyteArray result = env->NewByteArray(static_cast<jsize>(raw.size()));
+		if (result == nullptr) {
+			std::cerr << "Failed to allocate status array." << std::endl;
+			return nullptr;
+		}
+		env->SetByteArrayRegion(result, 0, static_cast<jsize>(raw.size()), reinterpret_cast<const jbyte*>(raw.data()));
+		return result;
+	}
+
+	std::cerr << "Unknown printer: " << nameStr << std::endl;
+	return nullptr;
+}
+
+JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeScheduler(JNIEnv* env, jobject obj, jlong scheduler) {
+	delete toScheduler(scheduler);
+}
+
+JNIEXPORT jbyteArray JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_rasterize(JNIEnv* env, jobject obj, jbyteArray pixels, jint width, jint height, jint format, jbyteArray palette, jint dotWidth, jint dither, jint threshold) {
+	yhkcatprint::IMAGE_DESC image;
+	yhkcatprint::RASTER_OPTIONS options;
+	std::vector<uint8_t> paletteData;
+	if (!readRasterArgs(env, pixels, width, height, format, palette, dotWidth, dither, threshold, image, paletteData, options)) {
+		return nullptr;
+	}
+
+	jbyte* data = env->GetByteArrayElements(pixels, nullptr);
+
+	if (data == nullptr) {
+		std::cerr << "Failed to get byte array elements." << std::endl;
+		return nullptr;
+	}
+
+	std::vector<uint8_t> raster;
+	try {
+		Rasterizer rasterizer(options);
+		image.pixels = reinterpret_cast<const uint8_t*>(data);
+		raster = rasterizer.rasterize(image);
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		env->ReleaseByteArrayElements(pixels, data, JNI_ABORT);
+		return nullptr;
+	}
+
+	// The pixels are only read, so there is nothing to copy back.
+	env->ReleaseByteArrayElements(pixels, data, JNI_ABORT);
+
+	if (raster.size() > static_cast<size_t>(INT32_MAX)) {
+		std::cerr << "Raster is too large for a Java array." << std::endl;
+		return nullptr;
+	}
+
+	jbyteArray result = env->NewByteArray(static_cast<jsize>(raster.size()));
+	if (result == nullptr) {
+		std::cerr << "Failed to allocate raster array." << std::endl;
+		return nullptr;
+	}
+	env->SetByteArrayRegion(result, 0, static_cast<jsize>(raster.size()), reinterpret_cast<const jbyte*>(raster.data()));
+	return result;
+}
+
+JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printImage(JNIEnv* env, jobject obj, jlong session, jbyteArray pixels, jint width, jint height, jint format, jbyteArray palette, jint dotWidth, jint dither, jint threshold) {
+	if (session == 0) {
+		std::cerr << "Invalid session handle." << std::endl;
+		return JNI_FALSE;
+	}
+
+	yhkcatprint::IMAGE_DESC image;
+	yhkcatprint::RASTER_OPTIONS options;
+	std::vector<uint8_t> paletteData;
+	if (!readRasterArgs(env, pixels, width, height, format, palette, dotWidth, dither, threshold, image, paletteData, options)) {
+		return JNI_FALSE;
+	}
+
+	jbyte* data = env->GetByteArrayElements(pixels, nullptr);
+
+	if (data == nullptr) {
+		std::cerr << "Failed to get byte array elements." << std::endl;
+		return JNI_FALSE;
+	}
+
+	jboolean result = JNI_TRUE;
+	try {
+		// Bands are rendered on a separate thread while earlier ones are sent; the
+		// stream joins that thread before the pixels are released below.
+		image.pixels = reinterpret_cast<const uint8_t*>(data);
+		RasterStream stream(options, image);
+		toSession(session)->print(stream);
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		result = JNI_FALSE;
+	}
+
+	// The pixels are only read, so there is nothing to copy back.
+	env->ReleaseByteArrayElements(pixels, data, JNI_ABORT);
+	return result;
+}
+
+JNIEXPORT jstring JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getMetrics(JNIEnv* env, jobject obj) {
+	try {
+		// Latency summaries and counters of every device, in the Prometheus text format.
+		return env->NewStringUTF(yhkcatprint::MetricsRegistry::instance().toPrometheus().c_str());
+	}
+	catch (const std::exception& ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return nullptr;
 	}
-}
\ No newline at end of file
+}
@@ -10,6 +10,58 @@ extern "C" {
 
 	JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printBuffer(JNIEnv* env, jobject obj, jbyteArray buffer, jint length);
 
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_openSession(JNIEnv* env, jobject obj, jstring address, jint channel);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printSession(JNIEnv* env, jobject obj, jlong session, jbyteArray buffer, jint length);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printSessionDirect(JNIEnv* env, jobject obj, jlong session, jobject buffer, jint length);
+
+	JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeSession(JNIEnv* env, jobject obj, jlong session);
+
+	JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeIdleConnections(JNIEnv* env, jobject obj);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_watchDevices(JNIEnv* env, jobject obj, jobject listener, jint intervalMs);
+
+	JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_stopWatchingDevices(JNIEnv* env, jobject obj);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_setSessionEncoding(JNIEnv* env, jobject obj, jlong session, jint encoding);
+
+	JNIEXPORT jdouble JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getLastCompressionRatio(JNIEnv* env, jobject obj, jlong session);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_setSessionTrimming(JNIEnv* env, jobject obj, jlong session, jboolean trim);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_monitorSession(JNIEnv* env, jobject obj, jlong session, jobject listener);
+
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_openQueue(JNIEnv* env, jobject obj, jlong session, jint capacity, jobject listener);
+
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitJob(JNIEnv* env, jobject obj, jlong queue, jbyteArray buffer, jint length);
+
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitJobDirect(JNIEnv* env, jobject obj, jlong queue, jobject buffer, jint length);
+
+	JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeQueue(JNIEnv* env, jobject obj, jlong queue);
+
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_openScheduler(JNIEnv* env, jobject obj, jobject listener);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_addSchedulerPrinter(JNIEnv* env, jobject obj, jlong scheduler, jstring name, jstring address, jint channel, jstring group, jint capacity);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_removeSchedulerPrinter(JNIEnv* env, jobject obj, jlong scheduler, jstring name);
+
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitToPrinter(JNIEnv* env, jobject obj, jlong scheduler, jstring printer, jbyteArray buffer, jint length);
+
+	JNIEXPORT jlong JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_submitToGroup(JNIEnv* env, jobject obj, jlong scheduler, jstring group, jbyteArray buffer, jint length);
+
+	JNIEXPORT jlongArray JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getPrinterStats(JNIEnv* env, jobject obj, jlong scheduler, jstring name);
+
+	JNIEXPORT jbyteArray JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getPrinterStatusFrame(JNIEnv* env, jobject obj, jlong scheduler, jstring name);
+
+	JNIEXPORT void JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_closeScheduler(JNIEnv* env, jobject obj, jlong scheduler);
+
+	JNIEXPORT jbyteArray JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_rasterize(JNIEnv* env, jobject obj, jbyteArray pixels, jint width, jint height, jint format, jbyteArray palette, jint dotWidth, jint dither, jint threshold);
+
+	JNIEXPORT jboolean JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_printImage(JNIEnv* env, jobject obj, jlong session, jbyteArray pixels, jint width, jint height, jint format, jbyteArray palette, jint dotWidth, jint dither, jint threshold);
+
+	JNIEXPORT jstring JNICALL Java_pl_umamusume_yhkcatprint_utils_NativePrinter_getMetrics(JNIEnv* env, jobject obj);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,88 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BluezStoreTests.cpp
+
+Abstract:
+	Tests of reading paired devices from a BlueZ device store.
+
+--*/
+
+#include "Test.h"
+#include "../Bluez.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	/**
+	 * Directory laid out like /var/lib/bluetooth, removed when the test ends.
+	 */
+	class DeviceStore
+	{
+	public:
+		explicit DeviceStore(const std::string& name)
+			: m_root(std::filesystem::temp_directory_path() / ("yhkcatprint-test-" + std::to_string(::getpid()) + "-" + name))
+		{
+			std::filesystem::remove_all(m_root);
+			std::filesystem::create_directories(m_root);
+		}
+
+		~DeviceStore()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(m_root, ec);
+		}
+
+		// Disable copy semantics
+		DeviceStore(const DeviceStore&) = delete;
+		DeviceStore& operator=(const DeviceStore&) = delete;
+
+		void addDevice(const std::string& adapter, const std::string& device, const std::string& info)
+		{
+			std::filesystem::path path = m_root / adapter / device;
+			std::filesystem::create_directories(path);
+			std::ofstream(path / "info") << info;
+		}
+
+		const std::filesystem::path& root() const
+		{
+			return m_root;
+		}
+
+	private:
+		std::filesystem::path m_root;
+	};
+
+	const BluetoothAddress adapter = BluetoothAddress::fromString("00:1A:7D:DA:71:13");
+}
+
+TEST_CASE(bluez_store, reads_devices_with_a_link_key)
+{
+	DeviceStore store("paired");
+	store.addDevice("00:1A:7D:DA:71:13", "AA:BB:CC:DD:EE:01",
+		"[General]\nName=YHK-8A2F\nTrusted=true\n\n[LinkKey]\nKey=00112233445566778899AABBCCDDEEFF\nType=4\n");
+	store.addDevice("00:1A:7D:DA:71:13", "AA:BB:CC:DD:EE:02",
+		"[General]\nName=Seen but never paired\n");
+	store.addDevice("00:1A:7D:DA:71:13", "cache", "[General]\nName=Not a device\n[LinkKey]\n");
+	store.addDevice("11:22:33:44:55:66", "AA:BB:CC:DD:EE:03", "[General]\nName=Other adapter\n[LinkKey]\n");
+
+	std::vector<bluez::BLUEZ_ENTRY> devices = bluez::readPairedDevices(adapter, store.root());
+	EXPECT(devices.size() == 1);
+	EXPECT(devices[0].address == BluetoothAddress::fromString("aa:bb:cc:dd:ee:01"));
+	EXPECT(devices[0].name == "YHK-8A2F");
+}
+
+TEST_CASE(bluez_store, missing_adapter_has_no_devices)
+{
+	DeviceStore store("empty");
+	EXPECT(bluez::readPairedDevices(adapter, store.root()).empty());
+	EXPECT(bluez::readPairedDevices(adapter, store.root() / "missing").empty());
+}
@@ -0,0 +1,274 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	BufferedIoTests.cpp
+
+Abstract:
+	Tests of BufferedWriter and BufferedReader over links that move a few bytes per call.
+
+--*/
+
+#include "Test.h"
+#include "../BufferedReader.h"
+#include "../BufferedWriter.h"
+#include "../LoopbackPipe.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Socket over a pair of LoopbackPipes that sends and receives at most a few bytes per call,
+	 * like a link whose buffers are nearly full, and can stop accepting or fail after some bytes.
+	 */
+	class ShortSocket
+	{
+	public:
+		explicit ShortSocket(size_t perCall)
+			: m_tx(std::make_shared<LoopbackPipe>(1 << 16)), m_rx(std::make_shared<LoopbackPipe>(1 << 16)), m_perCall(perCall),
+			m_accepted(0), m_limit(std::numeric_limits<size_t>::max()), m_failAtLimit(false)
+		{
+		}
+
+		/**
+		 * Stops accepting data once limit bytes have been sent: sends return 0, or throw if fail is set.
+		 */
+		void stopAfter(size_t limit, bool fail)
+		{
+			m_limit = limit;
+			m_failAtLimit = fail;
+		}
+
+		size_t send(const uint8_t* data, size_t size)
+		{
+			size_t count = std::min({ size, m_perCall, m_limit - m_accepted });
+			if (count == 0 && size > 0)
+			{
+				if (m_failAtLimit)
+				{
+					throw std::runtime_error("Link failed");
+				}
+				return 0;
+			}
+			m_accepted += count;
+			return m_tx->write(data, count);
+		}
+
+		size_t send(std::span<const std::span<const uint8_t>> buffers)
+		{
+			// Vectored sends stop short too, possibly inside a buffer.
+			size_t total = 0;
+			for (const auto& buffer : buffers)
+			{
+				size_t count = send(buffer.data(), buffer.size());
+				total += count;
+				if (count < buffer.size())
+				{
+					break;
+				}
+			}
+			return total;
+		}
+
+		size_t receive(uint8_t* buffer, size_t size)
+		{
+			return m_rx->read(buffer, std::min(size, m_perCall));
+		}
+
+		size_t receive(uint8_t* buffer, size_t size, Clock::duration timeout)
+		{
+			return m_rx->read(buffer, std::min(size, m_perCall), Clock::now() + timeout);
+		}
+
+		bool available()
+		{
+			return m_rx->available() > 0 || m_rx->isClosed();
+		}
+
+		/**
+		 * Pipe carrying what was sent.
+		 */
+		LoopbackPipe& sent()
+		{
+			return *m_tx;
+		}
+
+		/**
+		 * Pipe feeding what is received.
+		 */
+		LoopbackPipe& incoming()
+		{
+			return *m_rx;
+		}
+
+	private:
+		std::shared_ptr<LoopbackPipe> m_tx;
+		std::shared_ptr<LoopbackPipe> m_rx;
+		size_t m_perCall;
+		size_t m_accepted;
+		size_t m_limit;
+		bool m_failAtLimit;
+	};
+
+	std::vector<uint8_t> makeBytes(size_t size, uint8_t seed)
+	{
+		std::vector<uint8_t> bytes(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			bytes[i] = static_cast<uint8_t>(seed + i * 7);
+		}
+		return bytes;
+	}
+
+	std::vector<uint8_t> drain(LoopbackPipe& pipe)
+	{
+		std::vector<uint8_t> bytes(pipe.available());
+		size_t read = 0;
+		while (read < bytes.size())
+		{
+			read += pipe.read(bytes.data() + read, bytes.size() - read);
+		}
+		return bytes;
+	}
+}
+
+TEST_CASE(buffered_io, writer_delivers_every_byte_over_partial_sends)
+{
+	ShortSocket socket(7);
+	BufferedWriter<ShortSocket> writer(socket, 16);
+
+	// Writes below, at and well above the frame size, so that both the buffer and the direct path send.
+	std::vector<uint8_t> expected;
+	for (size_t size : { 3, 13, 16, 40, 5, 100, 1 })
+	{
+		std::vector<uint8_t> data = makeBytes(size, static_cast<uint8_t>(size));
+		writer.write(data.data(), data.size());
+		expected.insert(expected.end(), data.begin(), data.end());
+	}
+	writer.flush();
+
+	EXPECT(drain(socket.sent()) == expected);
+	EXPECT(writer.sent() == expected.size());
+	EXPECT(writer.buffered() == 0);
+}
+
+TEST_CASE(buffered_io, send_all_resumes_vectored_sends_inside_a_buffer)
+{
+	ShortSocket socket(7);
+	std::vector<uint8_t> a = makeBytes(10, 1);
+	std::vector<uint8_t> b = makeBytes(1, 2);
+	std::vector<uint8_t> c = makeBytes(25, 3);
+	const std::span<const uint8_t> parts[] = { a, b, {}, c };
+
+	size_t sent = 0;
+	BufferedWriter<ShortSocket>::sendAll(socket, parts, sent);
+
+	std::vector<uint8_t> expected = a;
+	expected.insert(expected.end(), b.begin(), b.end());
+	expected.insert(expected.end(), c.begin(), c.end());
+	EXPECT(drain(socket.sent()) == expected);
+	EXPECT(sent == expected.size());
+}
+
+TEST_CASE(buffered_io, send_all_counts_bytes_accepted_before_a_failure)
+{
+	ShortSocket socket(7);
+	socket.stopAfter(20, true);
+	std::vector<uint8_t> data = makeBytes(50, 4);
+
+	size_t sent = 0;
+	EXPECT_THROWS(BufferedWriter<ShortSocket>::sendAll(socket, data.data(), data.size(), sent), std::runtime_error);
+	EXPECT(sent == 20);
+
+	// The writer keeps the same count across its own sends.
+	ShortSocket second(7);
+	second.stopAfter(20, true);
+	BufferedWriter<ShortSocket> writer(second, 16);
+	EXPECT_THROWS(writer.write(data.data(), data.size()), std::runtime_error);
+	EXPECT(writer.sent() == 20);
+	EXPECT(writer.buffered() == 0);
+}
+
+TEST_CASE(buffered_io, send_all_throws_when_the_link_stops_accepting)
+{
+	ShortSocket socket(7);
+	socket.stopAfter(9, false);
+	std::vector<uint8_t> data = makeBytes(30, 5);
+
+	size_t sent = 0;
+	EXPECT_THROWS(BufferedWriter<ShortSocket>::sendAll(socket, data.data(), data.size(), sent), std::runtime_error);
+	EXPECT(sent == 9);
+}
+
+TEST_CASE(buffered_io, read_exact_assembles_a_reply_from_short_reads)
+{
+	ShortSocket socket(3);
+	BufferedReader<ShortSocket> reader(socket, 64);
+	std::vector<uint8_t> reply = makeBytes(38, 6);
+	std::vector<uint8_t> next = makeBytes(4, 7);
+
+	// The reply trickles in a few bytes at a time, followed by the start of the next one.
+	std::thread peer([&socket, &reply, &next]
+	{
+		for (size_t offset = 0; offset < reply.size(); offset += 5)
+		{
+			socket.incoming().write(reply.data() + offset, std::min<size_t>(5, reply.size() - offset));
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		socket.incoming().write(next.data(), next.size());
+	});
+
+	std::span<const uint8_t> received = reader.readExact(reply.size(), Clock::now() + std::chrono::seconds(5));
+	EXPECT(std::vector<uint8_t>(received.begin(), received.end()) == reply);
+
+	received = reader.readExact(next.size(), Clock::now() + std::chrono::seconds(5));
+	EXPECT(std::vector<uint8_t>(received.begin(), received.end()) == next);
+	peer.join();
+}
+
+TEST_CASE(buffered_io, read_exact_returns_a_reply_that_wraps_the_ring)
+{
+	ShortSocket socket(3);
+	BufferedReader<ShortSocket> reader(socket, 16);
+	std::vector<uint8_t> first = makeBytes(10, 8);
+	std::vector<uint8_t> second = makeBytes(12, 9);
+
+	socket.incoming().write(first.data(), first.size());
+	std::span<const uint8_t> received = reader.readExact(first.size(), Clock::now() + std::chrono::seconds(5));
+	EXPECT(std::vector<uint8_t>(received.begin(), received.end()) == first);
+
+	// Starts at offset 10 of a 16-byte ring, so it ends past the wrap.
+	socket.incoming().write(second.data(), second.size());
+	received = reader.readExact(second.size(), Clock::now() + std::chrono::seconds(5));
+	EXPECT(std::vector<uint8_t>(received.begin(), received.end()) == second);
+}
+
+TEST_CASE(buffered_io, read_exact_fails_on_timeout_and_on_close)
+{
+	ShortSocket socket(3);
+	BufferedReader<ShortSocket> reader(socket, 64);
+	std::vector<uint8_t> part = makeBytes(5, 10);
+
+	socket.incoming().write(part.data(), part.size());
+	EXPECT_THROWS(reader.readExact(8, Clock::now() + std::chrono::milliseconds(50)), std::runtime_error);
+
+	// What arrived stays buffered; the peer closing before the rest comes ends the wait.
+	socket.incoming().close();
+	EXPECT_THROWS(reader.readExact(8, Clock::now() + std::chrono::seconds(5)), std::runtime_error);
+	EXPECT(reader.buffered() == part.size());
+
+	EXPECT_THROWS(reader.readExact(65, Clock::now() + std::chrono::seconds(5)), std::invalid_argument);
+}
@@ -0,0 +1,118 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	FlowControlTests.cpp
+
+Abstract:
+	Tests of how far FlowControl trusts the printer's status reports.
+
+--*/
+
+#include "Test.h"
+#include "../FlowControl.h"
+#include "../LoopbackPipe.h"
+#include "../LoopbackSocket.h"
+#include <array>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	/**
+	 * Loopback link whose printer side is never read, with room for everything the cases send.
+	 */
+	class Link
+	{
+	public:
+		Link()
+			: m_toPrinter(std::make_shared<LoopbackPipe>(1 << 20)), m_toHost(std::make_shared<LoopbackPipe>(1 << 20)),
+			m_host(LOOPBACK_ENDPOINT{ m_toHost, m_toPrinter })
+		{
+		}
+
+		LoopbackSocket& host()
+		{
+			return m_host;
+		}
+
+	private:
+		std::shared_ptr<LoopbackPipe> m_toPrinter;
+		std::shared_ptr<LoopbackPipe> m_toHost;
+		LoopbackSocket m_host;
+	};
+
+	std::array<uint8_t, escpos::STATUS_SIZE> makeStatus(uint8_t condition)
+	{
+		std::array<uint8_t, escpos::STATUS_SIZE> frame = {};
+		frame[escpos::STATUS_CONDITION] = condition;
+		return frame;
+	}
+
+	/**
+	 * Reports the buffer full and, a little later, drained again.
+	 */
+	void reportFullCycle(FlowControl& flow)
+	{
+		auto full = makeStatus(escpos::CONDITION_BUFFER_FULL);
+		auto drained = makeStatus(0);
+		flow.onReceived(full.data(), full.size());
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		flow.onReceived(drained.data(), drained.size());
+	}
+}
+
+TEST_CASE(flow_control, default_config_sends_unpaced)
+{
+	Link link;
+	FlowControl flow;
+	flow.attach(link.host(), false, nullptr);
+
+	// Without a print speed or trusted status, a job is not cut into pieces above the high-water mark.
+	std::vector<uint8_t> data(8192, 0x55);
+	EXPECT(flow.send(data.data(), data.size()) == data.size());
+	EXPECT(flow.stats().throttles == 0);
+}
+
+TEST_CASE(flow_control, unverified_status_does_not_teach_speed)
+{
+	Link link;
+	FlowControl flow;
+	flow.attach(link.host(), false, nullptr);
+
+	reportFullCycle(flow);
+
+	FLOW_STATS stats = flow.stats();
+	EXPECT(stats.bufferFull == 1);
+	EXPECT(stats.drainRate == 0.0);
+
+	// A buffer-full report does not fill the estimate either, so sending goes on unpaced.
+	auto full = makeStatus(escpos::CONDITION_BUFFER_FULL);
+	flow.onReceived(full.data(), full.size());
+	std::vector<uint8_t> data(4096, 0x55);
+	EXPECT(flow.send(data.data(), data.size()) == data.size());
+}
+
+TEST_CASE(flow_control, trusted_status_teaches_speed)
+{
+	Link link;
+	FLOW_CONTROL_CONFIG config;
+	config.pauseOnStatus = true;
+	FlowControl flow(config);
+	flow.attach(link.host(), false, nullptr);
+
+	// Until a report teaches the speed, pieces fit above the high-water mark.
+	std::vector<uint8_t> data(4096, 0x55);
+	EXPECT(flow.send(data.data(), data.size()) == 1024);
+
+	reportFullCycle(flow);
+
+	FLOW_STATS stats = flow.stats();
+	EXPECT(stats.bufferFull == 1);
+	EXPECT(stats.drainRate > 0.0);
+}
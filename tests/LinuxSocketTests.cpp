@@ -0,0 +1,275 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	LinuxSocketTests.cpp
+
+Abstract:
+	Tests of LinuxSocket over socketpairs and local listening sockets.
+
+--*/
+
+#include "Test.h"
+#include "../LinuxSocket.h"
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	/**
+	 * Both ends of a connected AF_UNIX stream socketpair, standing in for an RFCOMM link.
+	 */
+	std::array<int, 2> makeSocketPair()
+	{
+		std::array<int, 2> fds = {};
+		if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) < 0)
+		{
+			throw std::runtime_error("Failed to create socketpair");
+		}
+		return fds;
+	}
+
+	/**
+	 * Abstract-namespace AF_UNIX address, unique per test so that runs do not collide.
+	 */
+	sockaddr_un makeAddress(const std::string& name, socklen_t& length)
+	{
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		std::string path = "yhkcatprint-test-" + std::to_string(::getpid()) + "-" + name;
+		std::memcpy(address.sun_path + 1, path.data(), path.size());
+		length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + path.size());
+		return address;
+	}
+
+	/**
+	 * AF_UNIX listening socket bound to an abstract address.
+	 */
+	class Listener
+	{
+	public:
+		Listener(const std::string& name, int backlog)
+			: m_address(makeAddress(name, m_length)), m_fd(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0))
+		{
+			if (m_fd < 0
+				|| ::bind(m_fd, reinterpret_cast<const sockaddr*>(&m_address), m_length) < 0
+				|| ::listen(m_fd, backlog) < 0)
+			{
+				throw std::runtime_error("Failed to set up listening socket");
+			}
+		}
+
+		~Listener()
+		{
+			::close(m_fd);
+		}
+
+		// Disable copy semantics
+		Listener(const Listener&) = delete;
+		Listener& operator=(const Listener&) = delete;
+
+		int accept()
+		{
+			return ::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC);
+		}
+
+		const sockaddr* address() const
+		{
+			return reinterpret_cast<const sockaddr*>(&m_address);
+		}
+
+		socklen_t length() const
+		{
+			return m_length;
+		}
+
+	private:
+		socklen_t m_length = 0;
+		sockaddr_un m_address;
+		int m_fd;
+	};
+
+	const uint8_t* bytes(const char* text)
+	{
+		return reinterpret_cast<const uint8_t*>(text);
+	}
+
+	std::string receiveExactly(LinuxSocket& socket, size_t size)
+	{
+		std::string received(size, '\0');
+		size_t total = 0;
+		while (total < size)
+		{
+			size_t count = socket.receive(reinterpret_cast<uint8_t*>(received.data()) + total, size - total, std::chrono::seconds(5));
+			if (count == 0)
+			{
+				break;
+			}
+			total += count;
+		}
+		received.resize(total);
+		return received;
+	}
+}
+
+TEST_CASE(linux_socket, adopts_connected_descriptor)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	EXPECT(a.isConnected());
+	EXPECT(a.nativeHandle() == fds[0]);
+	EXPECT_THROWS(LinuxSocket(-1), std::invalid_argument);
+	// An adopted socket is already connected.
+	EXPECT_THROWS(a.connect(nullptr, 0), std::runtime_error);
+}
+
+TEST_CASE(linux_socket, connects_to_listener)
+{
+	Listener listener("connect", 4);
+
+	LinuxSocket blocking(AF_UNIX, SOCK_STREAM, 0);
+	EXPECT(!blocking.isConnected());
+	blocking.connect(listener.address(), listener.length());
+	EXPECT(blocking.isConnected());
+
+	LinuxSocket timed(AF_UNIX, SOCK_STREAM, 0);
+	timed.connect(listener.address(), listener.length(), std::chrono::seconds(5));
+	EXPECT(timed.isConnected());
+
+	LinuxSocket peer(listener.accept());
+	EXPECT(blocking.send(bytes("ping"), 4) == 4);
+	EXPECT(receiveExactly(peer, 4) == "ping");
+
+	// Still connected, so a second connect is refused.
+	EXPECT_THROWS(timed.connect(listener.address(), listener.length(), std::chrono::seconds(1)), std::runtime_error);
+}
+
+TEST_CASE(linux_socket, connects_again_after_refused_connect)
+{
+	socklen_t length = 0;
+	sockaddr_un nobody = makeAddress("nobody", length);
+
+	LinuxSocket socket(AF_UNIX, SOCK_STREAM, 0);
+	EXPECT_THROWS(socket.connect(reinterpret_cast<const sockaddr*>(&nobody), length, std::chrono::seconds(1)), std::runtime_error);
+	EXPECT(!socket.isConnected());
+	EXPECT(socket.nativeHandle() >= 0);
+
+	// The failed connect replaced the socket, so the same object can connect once someone listens.
+	Listener listener("nobody", 4);
+	socket.connect(listener.address(), listener.length(), std::chrono::seconds(5));
+	EXPECT(socket.isConnected());
+}
+
+TEST_CASE(linux_socket, sends_and_receives)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	EXPECT(a.send(bytes("hello"), 5) == 5);
+	EXPECT(a.send(bytes(" world"), 6, std::chrono::seconds(1)) == 6);
+	EXPECT(receiveExactly(b, 11) == "hello world");
+	EXPECT(b.available() == 0);
+
+	EXPECT(b.send(bytes("reply"), 5) == 5);
+	std::string reply(5, '\0');
+	EXPECT(a.receive(reinterpret_cast<uint8_t*>(reply.data()), reply.size()) == 5);
+	EXPECT(reply == "reply");
+}
+
+TEST_CASE(linux_socket, reports_available_bytes)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	EXPECT(a.send(bytes("0123456789"), 10) == 10);
+	EXPECT(b.available() == 10);
+
+	uint8_t buffer[4];
+	EXPECT(b.receive(buffer, sizeof(buffer)) == 4);
+	EXPECT(b.available() == 6);
+}
+
+TEST_CASE(linux_socket, gathers_buffers_in_one_send)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	const std::span<const uint8_t> buffers[] = {
+		{ bytes("head-"), 5 },
+		{},
+		{ bytes("body-"), 5 },
+		{ bytes("tail"), 4 }
+	};
+	EXPECT(a.send(buffers) == 14);
+	EXPECT(receiveExactly(b, 14) == "head-body-tail");
+
+	EXPECT(a.send(std::span<const std::span<const uint8_t>>()) == 0);
+}
+
+TEST_CASE(linux_socket, leaves_buffers_beyond_the_limit_for_the_next_send)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	// One byte per buffer, more buffers than one send takes: the send is partial.
+	std::string text(LinuxSocket::MAX_SEND_BUFFERS + 4, 'x');
+	std::vector<std::span<const uint8_t>> buffers;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		text[i] = static_cast<char>('a' + i % 26);
+		buffers.push_back({ reinterpret_cast<const uint8_t*>(text.data()) + i, 1 });
+	}
+
+	size_t sent = a.send(buffers);
+	EXPECT(sent == LinuxSocket::MAX_SEND_BUFFERS);
+	sent += a.send(std::span<const std::span<const uint8_t>>(buffers).subspan(sent));
+	EXPECT(sent == text.size());
+	EXPECT(receiveExactly(b, text.size()) == text);
+}
+
+TEST_CASE(linux_socket, close_ends_the_connection)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	a.close();
+	EXPECT(!a.isConnected());
+	EXPECT(a.nativeHandle() == -1);
+	EXPECT_THROWS(a.send(bytes("x"), 1), std::runtime_error);
+	EXPECT_THROWS(a.available(), std::runtime_error);
+	a.close();
+
+	// The peer reads end of stream, after which it no longer counts as connected.
+	uint8_t buffer[1];
+	EXPECT(b.receive(buffer, sizeof(buffer), std::chrono::seconds(1)) == 0);
+	EXPECT(!b.isConnected());
+	EXPECT_THROWS(b.receive(buffer, sizeof(buffer)), std::runtime_error);
+}
+
+TEST_CASE(linux_socket, send_to_closed_peer_throws)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	{
+		LinuxSocket b(fds[1]);
+	}
+
+	// MSG_NOSIGNAL turns the broken pipe into an error rather than SIGPIPE.
+	EXPECT_THROWS(a.send(bytes("x"), 1), std::runtime_error);
+	EXPECT_THROWS(a.send(bytes("x"), 1, std::chrono::milliseconds(100)), std::runtime_error);
+}
@@ -0,0 +1,92 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintAllocationTests.cpp
+
+Abstract:
+	Tests that the steady-state print loop makes no heap allocations.
+
+--*/
+
+#include "Test.h"
+#include "../bench/Benchmark.h"
+#include "../LoopbackPipe.h"
+#include "../PrinterSession.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	const uint8_t channel = 2;
+	const size_t jobs = 20;
+	const std::chrono::seconds jobTimeout(30);
+
+	/**
+	 * Raster with ink on every row but the blank bottom margin, whose rows never begin with line feeds.
+	 */
+	std::vector<uint8_t> makeRaster(size_t rows, size_t blankRows, size_t rowBytes)
+	{
+		std::vector<uint8_t> raster(rows * rowBytes);
+		for (size_t i = 0; i < (rows - blankRows) * rowBytes; ++i)
+		{
+			raster[i] = static_cast<uint8_t>(i * 131 + 7);
+		}
+		return raster;
+	}
+
+	/**
+	 * Prints the same job over one session against the emulator and returns the
+	 * allocations the calling thread made after the first job had set up the buffers.
+	 */
+	uint64_t steadyStateAllocations(const std::string& name, RasterEncoding encoding)
+	{
+		EMULATOR_CONFIG config;
+		config.endOnTrailer = true;
+		PrinterEmulator emulator(config);
+		emulator.listenLoopback(name);
+
+		PrinterSession session(std::string(LoopbackListener::SCHEME) + name, channel);
+		session.setEncoding(encoding);
+		session.open();
+
+		std::vector<uint8_t> raster = makeRaster(256, 32, config.rowBytes);
+		session.print(raster.data(), raster.size());
+
+		uint64_t before = threadAllocations();
+		for (size_t i = 1; i < jobs; ++i)
+		{
+			session.print(raster.data(), raster.size());
+		}
+		uint64_t allocations = threadAllocations() - before;
+
+		EXPECT(emulator.waitForJobs(jobs, jobTimeout));
+		session.close();
+		return allocations;
+	}
+}
+
+TEST_CASE(print_allocation, raw_jobs_do_not_allocate)
+{
+	EXPECT(steadyStateAllocations("alloc-raw", RASTER_ENCODING_RAW) == 0);
+}
+
+TEST_CASE(print_allocation, image_jobs_do_not_allocate)
+{
+	EXPECT(steadyStateAllocations("alloc-image", RASTER_ENCODING_IMAGE) == 0);
+}
+
+TEST_CASE(print_allocation, counter_sees_allocations)
+{
+	// Guards against the counting operator new not being linked in, which would pass the cases above vacuously.
+	// The buffer outlives the case, so the compiler cannot leave the allocation out.
+	static std::vector<std::vector<uint8_t>> kept;
+	kept.reserve(1);
+	uint64_t before = threadAllocations();
+	kept.emplace_back(64);
+	EXPECT(threadAllocations() - before == 1);
+}
@@ -0,0 +1,91 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	PrintSchedulerTests.cpp
+
+Abstract:
+	Tests of routing jobs across a fleet of emulated printers.
+
+--*/
+
+#include "Test.h"
+#include "../emulator/PrinterEmulator.h"
+#include "../LoopbackPipe.h"
+#include "../PrintScheduler.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	const std::chrono::seconds jobTimeout(30);
+}
+
+TEST_CASE(print_scheduler, fleet_larger_than_default_pool_prints_on_every_printer)
+{
+	// More printers than POOL_OPTIONS::maxLinks, each holding its link while registered.
+	const size_t fleetSize = POOL_OPTIONS().maxLinks + 2;
+
+	EMULATOR_CONFIG config;
+	config.endOnTrailer = true;
+	std::vector<std::unique_ptr<PrinterEmulator>> fleet;
+	PrintScheduler scheduler(nullptr);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		std::string name = "fleet-" + std::to_string(i);
+		fleet.push_back(std::make_unique<PrinterEmulator>(config));
+		fleet.back()->listenLoopback(name);
+
+		PRINTER_CONFIG printer;
+		printer.name = name;
+		printer.address = std::string(LoopbackListener::SCHEME) + name;
+		scheduler.addPrinter(printer);
+	}
+
+	std::vector<uint8_t> raster(16 * config.rowBytes, 0xa5);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		scheduler.submit("fleet-" + std::to_string(i), raster);
+	}
+
+	for (const auto& printer : fleet)
+	{
+		EXPECT(printer->waitForJobs(1, jobTimeout));
+	}
+	scheduler.close();
+
+	for (const PRINTER_STATS& stats : scheduler.stats())
+	{
+		EXPECT(stats.queue.failed == 0);
+	}
+}
+
+TEST_CASE(print_scheduler, removed_printer_frees_its_slot)
+{
+	EMULATOR_CONFIG config;
+	config.endOnTrailer = true;
+	PrinterEmulator first(config);
+	PrinterEmulator second(config);
+	first.listenLoopback("slot-first");
+	second.listenLoopback("slot-second");
+
+	PrintScheduler scheduler(nullptr);
+	PRINTER_CONFIG printer;
+	printer.name = "first";
+	printer.address = std::string(LoopbackListener::SCHEME) + "slot-first";
+	scheduler.addPrinter(printer);
+	EXPECT(scheduler.removePrinter("first"));
+
+	printer.name = "second";
+	printer.address = std::string(LoopbackListener::SCHEME) + "slot-second";
+	scheduler.addPrinter(printer);
+
+	std::vector<uint8_t> raster(16 * config.rowBytes, 0xa5);
+	scheduler.submit("second", raster);
+	EXPECT(second.waitForJobs(1, jobTimeout));
+}
@@ -0,0 +1,256 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterEncoderTests.cpp
+
+Abstract:
+	Tests of the commands RasterEncoder writes for raw and image jobs.
+
+--*/
+
+#include "Test.h"
+#include "../EscPos.h"
+#include "../RasterEncoder.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	const size_t rowBytes = 48;
+
+	/**
+	 * Writer collecting everything the encoder writes.
+	 */
+	struct ByteSink
+	{
+		std::vector<uint8_t> bytes;
+
+		void write(const uint8_t* data, size_t size)
+		{
+			bytes.insert(bytes.end(), data, data + size);
+		}
+	};
+
+	/**
+	 * Builds a raster from a row pattern: '#' for a row with dots set, '.' for a blank row.
+	 */
+	std::vector<uint8_t> makeRaster(const char* pattern)
+	{
+		std::vector<uint8_t> raster;
+		for (const char* row = pattern; *row != '\0'; ++row)
+		{
+			uint8_t fill = *row == '#' ? static_cast<uint8_t>(0x80 | (row - pattern)) : 0;
+			raster.insert(raster.end(), rowBytes, fill);
+		}
+		return raster;
+	}
+
+	void append(std::vector<uint8_t>& bytes, const uint8_t* data, size_t size)
+	{
+		bytes.insert(bytes.end(), data, data + size);
+	}
+
+	template<size_t N>
+	void append(std::vector<uint8_t>& bytes, const escpos::Command<N>& command)
+	{
+		append(bytes, command.data(), command.size());
+	}
+
+	/**
+	 * Appends rows of a raster as one GS v 0 image.
+	 */
+	void appendImage(std::vector<uint8_t>& bytes, const std::vector<uint8_t>& raster, size_t firstRow, size_t rows)
+	{
+		append(bytes, escpos::rasterHeader(rowBytes, rows));
+		append(bytes, raster.data() + firstRow * rowBytes, rows * rowBytes);
+	}
+
+	/**
+	 * Appends the end of an image job that feeds the given blank rows before the tear-bar feed.
+	 */
+	void appendEnd(std::vector<uint8_t>& bytes, size_t blankRows)
+	{
+		append(bytes, escpos::feedDots(static_cast<uint8_t>(blankRows + RasterEncoder::END_FEED_ROWS)));
+		append(bytes, escpos::LINE_FEED);
+	}
+
+	std::vector<uint8_t> encodeAll(const std::vector<uint8_t>& raster, RasterEncoding encoding, bool trim, ENCODE_STATS& stats)
+	{
+		ByteSink sink;
+		RasterEncoder encoder(rowBytes, encoding, trim);
+		encoder.encode(raster.data(), raster.size(), sink);
+		encoder.finish(sink);
+		stats = encoder.stats();
+		return sink.bytes;
+	}
+}
+
+TEST_CASE(raster_encoder, raw_trim_drops_only_the_trailing_blank_run)
+{
+	std::vector<uint8_t> raster = makeRaster("#..#...");
+	ENCODE_STATS stats;
+	std::vector<uint8_t> encoded = encodeAll(raster, RASTER_ENCODING_RAW, true, stats);
+
+	// Blank rows between printed rows are still sent as zero rows; only the bottom three go.
+	EXPECT(encoded == std::vector<uint8_t>(raster.begin(), raster.begin() + 4 * rowBytes));
+	EXPECT(stats.trimmedRows == 3);
+	EXPECT(stats.encodedBytes == 4 * rowBytes);
+	EXPECT(stats.rasterBytes == raster.size());
+}
+
+TEST_CASE(raster_encoder, raw_without_trim_passes_raster_through)
+{
+	std::vector<uint8_t> raster = makeRaster("#..#...");
+	ENCODE_STATS stats;
+	EXPECT(encodeAll(raster, RASTER_ENCODING_RAW, false, stats) == raster);
+	EXPECT(stats.trimmedRows == 0);
+}
+
+TEST_CASE(raster_encoder, all_blank_raster_is_trimmed_away)
+{
+	std::vector<uint8_t> raster = makeRaster("..........");
+	ENCODE_STATS stats;
+
+	EXPECT(encodeAll(raster, RASTER_ENCODING_RAW, true, stats).empty());
+	EXPECT(stats.trimmedRows == 10);
+	EXPECT(stats.blankRows == 0);
+	EXPECT(stats.encodedBytes == 0);
+
+	// Image jobs still end with the feed past the tear bar.
+	std::vector<uint8_t> expected;
+	appendEnd(expected, 0);
+	EXPECT(encodeAll(raster, RASTER_ENCODING_IMAGE, true, stats) == expected);
+	EXPECT(stats.trimmedRows == 10);
+	EXPECT(stats.encodedBytes == 0);
+}
+
+TEST_CASE(raster_encoder, image_end_feed_includes_untrimmed_blank_rows)
+{
+	std::vector<uint8_t> raster = makeRaster("##....");
+	ENCODE_STATS stats;
+
+	std::vector<uint8_t> expected;
+	appendImage(expected, raster, 0, 2);
+	appendEnd(expected, 4);
+	EXPECT(encodeAll(raster, RASTER_ENCODING_IMAGE, false, stats) == expected);
+	EXPECT(stats.trimmedRows == 0);
+
+	expected.clear();
+	appendImage(expected, raster, 0, 2);
+	appendEnd(expected, 0);
+	EXPECT(encodeAll(raster, RASTER_ENCODING_IMAGE, true, stats) == expected);
+	EXPECT(stats.trimmedRows == 4);
+}
+
+TEST_CASE(raster_encoder, image_blank_runs_become_feeds)
+{
+	std::vector<uint8_t> raster = makeRaster("#...##");
+	ENCODE_STATS stats;
+
+	std::vector<uint8_t> expected;
+	appendImage(expected, raster, 0, 1);
+	append(expected, escpos::feedDots(3));
+	appendImage(expected, raster, 4, 2);
+	appendEnd(expected, 0);
+	EXPECT(encodeAll(raster, RASTER_ENCODING_IMAGE, false, stats) == expected);
+	EXPECT(stats.blankRows == 3);
+}
+
+TEST_CASE(raster_encoder, long_blank_run_is_split_into_maximal_feeds)
+{
+	std::string pattern = "#" + std::string(RasterEncoder::MAX_FEED_ROWS + 10, '.') + "#";
+	std::vector<uint8_t> raster = makeRaster(pattern.c_str());
+	ENCODE_STATS stats;
+
+	std::vector<uint8_t> expected;
+	appendImage(expected, raster, 0, 1);
+	append(expected, escpos::feedDots(static_cast<uint8_t>(RasterEncoder::MAX_FEED_ROWS)));
+	append(expected, escpos::feedDots(10));
+	appendImage(expected, raster, RasterEncoder::MAX_FEED_ROWS + 11, 1);
+	appendEnd(expected, 0);
+	EXPECT(encodeAll(raster, RASTER_ENCODING_IMAGE, false, stats) == expected);
+}
+
+TEST_CASE(raster_encoder, streamed_bands_match_one_call_and_end_with_partial_row)
+{
+	std::vector<uint8_t> raster = makeRaster("#..##.");
+	// The last band ends 20 bytes into a row, which prints as a narrower image.
+	std::vector<uint8_t> tail(20, 0x5a);
+	std::vector<uint8_t> whole = raster;
+	whole.insert(whole.end(), tail.begin(), tail.end());
+
+	for (RasterEncoding encoding : { RASTER_ENCODING_RAW, RASTER_ENCODING_IMAGE })
+	{
+		ByteSink banded;
+		RasterEncoder encoder(rowBytes, encoding, true);
+		// A blank run crossing a band boundary still comes out as one feed.
+		encoder.encode(whole.data(), 2 * rowBytes, banded);
+		encoder.encode(whole.data() + 2 * rowBytes, 3 * rowBytes, banded);
+		encoder.encode(whole.data() + 5 * rowBytes, whole.size() - 5 * rowBytes, banded);
+		encoder.finish(banded);
+
+		ENCODE_STATS stats;
+		EXPECT(banded.bytes == encodeAll(whole, encoding, true, stats));
+		EXPECT(encoder.stats().rasterBytes == whole.size());
+	}
+
+	std::vector<uint8_t> expected;
+	appendImage(expected, raster, 0, 1);
+	append(expected, escpos::feedDots(2));
+	appendImage(expected, raster, 3, 2);
+	append(expected, escpos::feedDots(1));
+	append(expected, escpos::rasterHeader(tail.size(), 1));
+	append(expected, tail.data(), tail.size());
+	appendEnd(expected, 0);
+
+	ENCODE_STATS stats;
+	EXPECT(encodeAll(whole, RASTER_ENCODING_IMAGE, true, stats) == expected);
+	// The blank row before the partial row is fed, not trimmed, since a printed row follows it.
+	EXPECT(stats.trimmedRows == 0);
+}
+
+TEST_CASE(raster_encoder, tall_ink_run_is_split_into_maximal_images)
+{
+	std::vector<uint8_t> raster((RasterEncoder::MAX_IMAGE_ROWS + 44) * rowBytes, 0xff);
+	ENCODE_STATS stats;
+
+	std::vector<uint8_t> expected;
+	appendImage(expected, raster, 0, RasterEncoder::MAX_IMAGE_ROWS);
+	appendImage(expected, raster, RasterEncoder::MAX_IMAGE_ROWS, 44);
+	appendEnd(expected, 0);
+	EXPECT(encodeAll(raster, RASTER_ENCODING_IMAGE, false, stats) == expected);
+	EXPECT(stats.encodedBytes == raster.size() + 2 * escpos::RASTER_HEADER_SIZE);
+}
+
+TEST_CASE(raster_encoder, image_header_at_dimension_limits)
+{
+	const size_t limit = escpos::MAX_RASTER_DIMENSION;
+
+	auto header = escpos::rasterHeader(limit, limit);
+	EXPECT(header[4] == 0xff && header[5] == 0xff);
+	EXPECT(header[6] == 0xff && header[7] == 0xff);
+
+	header = escpos::rasterHeader(1, 0x100);
+	EXPECT(header[4] == 0x01 && header[5] == 0x00);
+	EXPECT(header[6] == 0x00 && header[7] == 0x01);
+
+	EXPECT_THROWS(escpos::rasterHeader(limit + 1, 1), std::invalid_argument);
+	EXPECT_THROWS(escpos::rasterHeader(1, limit + 1), std::invalid_argument);
+
+	// A row as wide as the limit still encodes; one byte wider does not.
+	std::vector<uint8_t> row(limit + 1, 0x01);
+	ByteSink sink;
+	RasterEncoder widest(limit, RASTER_ENCODING_IMAGE);
+	widest.encode(row.data(), limit, sink);
+	EXPECT(sink.bytes.size() == escpos::RASTER_HEADER_SIZE + limit);
+	EXPECT(sink.bytes[4] == 0xff && sink.bytes[5] == 0xff);
+
+	RasterEncoder tooWide(limit + 1, RASTER_ENCODING_IMAGE);
+	EXPECT_THROWS(tooWide.encode(row.data(), row.size(), sink), std::invalid_argument);
+}
@@ -0,0 +1,125 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	RasterKernelsTests.cpp
+
+Abstract:
+	Tests that every supported SIMD level of the raster kernels matches the scalar code.
+
+--*/
+
+#include "Test.h"
+#include "../RasterKernels.h"
+#include <cstdint>
+#include <vector>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	const SimdLevel vectorLevels[] = { SIMD_SSE2, SIMD_AVX2, SIMD_NEON };
+
+	/**
+	 * Pixel counts around and between the vector widths, so that every kernel runs its tail.
+	 */
+	const size_t widths[] = { 1, 3, 7, 8, 9, 15, 17, 31, 33, 63, 65, 127, 129, 383, 384, 385, 1001 };
+
+	/**
+	 * Deterministic bytes covering the whole range, including the values around the thresholds.
+	 */
+	std::vector<uint8_t> makeBytes(size_t size, uint32_t seed)
+	{
+		std::vector<uint8_t> bytes(size);
+		uint32_t state = seed;
+		for (auto& byte : bytes)
+		{
+			state = state * 1664525u + 1013904223u;
+			byte = static_cast<uint8_t>(state >> 24);
+		}
+		return bytes;
+	}
+}
+
+TEST_CASE(raster_kernels, rgba_to_gray_matches_scalar)
+{
+	for (SimdLevel level : vectorLevels)
+	{
+		if (!isSimdLevelSupported(level))
+		{
+			continue;
+		}
+		for (size_t count : widths)
+		{
+			std::vector<uint8_t> rgba = makeBytes(count * 4, static_cast<uint32_t>(count));
+			// Fully transparent and fully opaque pixels take the edges of the compositing.
+			rgba[3] = 0;
+			rgba[rgba.size() - 1] = 255;
+
+			// One guard byte past the end catches a tail written too far.
+			std::vector<uint8_t> expected(count + 1, 0xcc);
+			std::vector<uint8_t> actual(count + 1, 0xcc);
+			rgbaToGray(rgba.data(), expected.data(), count, SIMD_SCALAR);
+			rgbaToGray(rgba.data(), actual.data(), count, level);
+			EXPECT(actual == expected);
+		}
+	}
+}
+
+TEST_CASE(raster_kernels, pack_threshold_matches_scalar)
+{
+	for (SimdLevel level : vectorLevels)
+	{
+		if (!isSimdLevelSupported(level))
+		{
+			continue;
+		}
+		for (size_t width : widths)
+		{
+			std::vector<uint8_t> gray = makeBytes(width, static_cast<uint32_t>(width) * 7);
+			std::vector<uint8_t> thresholds = makeBytes(width, static_cast<uint32_t>(width) * 13);
+			// Equal luma and threshold is not darker, so it must stay white at every level.
+			gray[0] = thresholds[0];
+
+			size_t bytes = (width + 7) / 8;
+			std::vector<uint8_t> expected(bytes + 1, 0xcc);
+			std::vector<uint8_t> actual(bytes + 1, 0xcc);
+			packThreshold(gray.data(), thresholds.data(), expected.data(), width, SIMD_SCALAR);
+			packThreshold(gray.data(), thresholds.data(), actual.data(), width, level);
+			EXPECT(actual == expected);
+		}
+	}
+}
+
+TEST_CASE(raster_kernels, zero_scans_match_scalar)
+{
+	for (SimdLevel level : vectorLevels)
+	{
+		if (!isSimdLevelSupported(level))
+		{
+			continue;
+		}
+		for (size_t size : widths)
+		{
+			std::vector<uint8_t> data(size, 0);
+			EXPECT(findNonZero(data.data(), size, level) == size);
+			EXPECT(findLastNonZero(data.data(), size, level) == size);
+
+			// A single dot at every position, so each lands once in a vector body and once in a tail.
+			for (size_t position = 0; position < size; ++position)
+			{
+				data[position] = 0x01;
+				EXPECT(findNonZero(data.data(), size, level) == findNonZero(data.data(), size, SIMD_SCALAR));
+				EXPECT(findLastNonZero(data.data(), size, level) == findLastNonZero(data.data(), size, SIMD_SCALAR));
+				data[position] = 0;
+			}
+		}
+	}
+}
+
+TEST_CASE(raster_kernels, scalar_is_always_supported)
+{
+	EXPECT(isSimdLevelSupported(SIMD_SCALAR));
+	EXPECT(isSimdLevelSupported(detectSimdLevel()));
+}
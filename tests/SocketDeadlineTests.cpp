@@ -0,0 +1,188 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	SocketDeadlineTests.cpp
+
+Abstract:
+	Tests of connect, send and receive deadlines against peers that never respond.
+
+--*/
+
+#include "Test.h"
+#include "../LinuxSocket.h"
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace yhkcatprint;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Deadline given to every timed operation.
+	 */
+	constexpr std::chrono::milliseconds timeout(200);
+
+	/**
+	 * Slack allowed past the deadline for scheduling on a loaded machine.
+	 */
+	constexpr std::chrono::milliseconds tolerance(500);
+
+	/**
+	 * Checks that an operation that timed out took the timeout, within tolerance.
+	 */
+	bool withinTolerance(Clock::duration elapsed)
+	{
+		return elapsed >= timeout && elapsed <= timeout + tolerance;
+	}
+
+	/**
+	 * Loopback TCP listener that never accepts, with the smallest backlog.
+	 *
+	 * Once its accept queue is full the kernel drops further SYNs, so a
+	 * connect to it stays pending until the caller gives up.
+	 */
+	class SilentListener
+	{
+	public:
+		SilentListener()
+			: m_address{}, m_fd(::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0))
+		{
+			m_address.sin_family = AF_INET;
+			m_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			m_address.sin_port = 0;
+
+			socklen_t length = sizeof(m_address);
+			if (m_fd < 0
+				|| ::bind(m_fd, reinterpret_cast<const sockaddr*>(&m_address), sizeof(m_address)) < 0
+				|| ::listen(m_fd, 0) < 0
+				|| ::getsockname(m_fd, reinterpret_cast<sockaddr*>(&m_address), &length) < 0)
+			{
+				throw std::runtime_error("Failed to set up listening socket");
+			}
+		}
+
+		~SilentListener()
+		{
+			::close(m_fd);
+		}
+
+		// Disable copy semantics
+		SilentListener(const SilentListener&) = delete;
+		SilentListener& operator=(const SilentListener&) = delete;
+
+		const sockaddr* address() const
+		{
+			return reinterpret_cast<const sockaddr*>(&m_address);
+		}
+
+		socklen_t length() const
+		{
+			return sizeof(m_address);
+		}
+
+	private:
+		sockaddr_in m_address;
+		int m_fd;
+	};
+
+	std::array<int, 2> makeSocketPair()
+	{
+		std::array<int, 2> fds = {};
+		if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) < 0)
+		{
+			throw std::runtime_error("Failed to create socketpair");
+		}
+		return fds;
+	}
+
+	void shrinkBuffers(int sender, int receiver)
+	{
+		int size = 4096;
+		::setsockopt(sender, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+		::setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	}
+}
+
+TEST_CASE(socket_deadline, connect_to_listener_that_never_accepts_times_out)
+{
+	SilentListener listener;
+
+	// Fill the accept queue; the first connect that does not complete is the one under test.
+	std::vector<std::unique_ptr<LinuxSocket>> queued;
+	for (int attempt = 0; attempt < 16; ++attempt)
+	{
+		auto socket = std::make_unique<LinuxSocket>(AF_INET, SOCK_STREAM, 0);
+		auto started = Clock::now();
+		try
+		{
+			socket->connect(listener.address(), listener.length(), timeout);
+		}
+		catch (const std::runtime_error&)
+		{
+			EXPECT(withinTolerance(Clock::now() - started));
+			EXPECT(!socket->isConnected());
+			return;
+		}
+		queued.push_back(std::move(socket));
+	}
+	EXPECT(!"every connect completed although nothing accepts");
+}
+
+TEST_CASE(socket_deadline, receive_from_silent_peer_times_out)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	uint8_t buffer[16];
+	auto started = Clock::now();
+	EXPECT_THROWS(a.receive(buffer, sizeof(buffer), timeout), std::runtime_error);
+	EXPECT(withinTolerance(Clock::now() - started));
+
+	// The timeout leaves the link usable.
+	EXPECT(a.isConnected());
+	EXPECT(b.send(buffer, 1) == 1);
+	EXPECT(a.receive(buffer, sizeof(buffer), timeout) == 1);
+}
+
+TEST_CASE(socket_deadline, send_to_peer_that_never_reads_returns_what_fit)
+{
+	auto fds = makeSocketPair();
+	shrinkBuffers(fds[0], fds[1]);
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	std::vector<uint8_t> data(8 << 20, 0x55);
+	auto started = Clock::now();
+	size_t sent = a.send(data.data(), data.size(), timeout);
+	EXPECT(withinTolerance(Clock::now() - started));
+	EXPECT(sent > 0);
+	EXPECT(sent < data.size());
+
+	// With the buffers full, nothing more fits before the deadline.
+	started = Clock::now();
+	EXPECT_THROWS(a.send(data.data(), data.size(), timeout), std::runtime_error);
+	EXPECT(withinTolerance(Clock::now() - started));
+	EXPECT(a.isConnected());
+}
+
+TEST_CASE(socket_deadline, zero_timeout_does_not_wait)
+{
+	auto fds = makeSocketPair();
+	LinuxSocket a(fds[0]);
+	LinuxSocket b(fds[1]);
+
+	uint8_t buffer[16];
+	auto started = Clock::now();
+	EXPECT_THROWS(a.receive(buffer, sizeof(buffer), std::chrono::nanoseconds::zero()), std::runtime_error);
+	EXPECT(Clock::now() - started < tolerance);
+}
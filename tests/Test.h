@@ -0,0 +1,117 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	Test.h
+
+Abstract:
+	Minimal test registry and assertions for the unit tests.
+
+--*/
+
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file Test.h
+ * @brief Minimal test registry and assertions for the unit tests.
+ *
+ * Test cases register themselves by name at static initialization and are
+ * run by main.cpp, optionally filtered by name, so that CTest can run each
+ * group as a separate test. An assertion that fails throws TestFailure,
+ * which ends the case and is reported with the file and line.
+ */
+
+namespace yhkcatprint::test
+{
+	/**
+	 * @brief Registered test case.
+	 */
+	typedef struct _TEST_CASE
+	{
+		/**
+		 * @brief Case name, "group/name".
+		 */
+		std::string name;
+		/**
+		 * @brief Case body.
+		 */
+		void (*run)();
+	} TEST_CASE;
+
+	/**
+	 * @brief Error thrown by a failed assertion.
+	 */
+	class TestFailure : public std::runtime_error
+	{
+	public:
+		TestFailure(const char* file, int line, const std::string& message)
+			: std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": " + message)
+		{
+		}
+	};
+
+	/**
+	 * @brief Returns every registered test case, in registration order within each file.
+	 */
+	inline std::vector<TEST_CASE>& registry()
+	{
+		static std::vector<TEST_CASE> cases;
+		return cases;
+	}
+
+	/**
+	 * @brief Registers a test case on construction.
+	 */
+	struct Registration
+	{
+		Registration(const char* group, const char* name, void (*run)())
+		{
+			registry().push_back({ std::string(group) + "/" + name, run });
+		}
+	};
+}
+
+/**
+ * @brief Defines and registers a test case named "group/name".
+ */
+#define TEST_CASE(group, name) \
+	static void group##_##name(); \
+	static const ::yhkcatprint::test::Registration group##_##name##_registration(#group, #name, &group##_##name); \
+	static void group##_##name()
+
+/**
+ * @brief Fails the test case unless the condition holds.
+ */
+#define EXPECT(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			throw ::yhkcatprint::test::TestFailure(__FILE__, __LINE__, "Expected " #condition); \
+		} \
+	} while (false)
+
+/**
+ * @brief Fails the test case unless the expression throws an exception of the given type.
+ */
+#define EXPECT_THROWS(expression, exception) \
+	do \
+	{ \
+		bool thrown = false; \
+		try \
+		{ \
+			(void)(expression); \
+		} \
+		catch (const exception&) \
+		{ \
+			thrown = true; \
+		} \
+		if (!thrown) \
+		{ \
+			throw ::yhkcatprint::test::TestFailure(__FILE__, __LINE__, "Expected " #expression " to throw " #exception); \
+		} \
+	} while (false)
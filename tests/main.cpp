@@ -0,0 +1,64 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	main.cpp
+
+Abstract:
+	Command-line runner for the unit tests.
+
+--*/
+
+#include "Test.h"
+#include <exception>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Usage: yhkcatprint_tests [--filter TEXT]" << std::endl;
+			return 2;
+		}
+	}
+
+	size_t run = 0;
+	size_t failed = 0;
+	for (const yhkcatprint::test::TEST_CASE& test : yhkcatprint::test::registry())
+	{
+		if (test.name.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		run++;
+		try
+		{
+			test.run();
+			std::cout << "PASS " << test.name << std::endl;
+		}
+		catch (const std::exception& ex)
+		{
+			failed++;
+			std::cout << "FAIL " << test.name << ": " << ex.what() << std::endl;
+		}
+	}
+
+	std::cout << run - failed << " of " << run << " test cases passed" << std::endl;
+	if (run == 0)
+	{
+		std::cerr << "No test cases match the filter." << std::endl;
+		return 1;
+	}
+	return failed == 0 ? 0 : 1;
+}
@@ -67,30 +67,12 @@ namespace yhkcatprint
 				throw std::runtime_error("Failed to get Bluetooth radio info.");
 			}
 			ADAPTER_INFO info;
-			info.address = formatBthAddr(radioInfo.address.ullLong);
+			info.bluetoothAddress = BluetoothAddress(radioInfo.address.ullLong);
+			info.address = info.bluetoothAddress.toString();
 			info.name = wideStringToString(radioInfo.szName);
 			return info;
 		}
 
-		/**
-		 * @brief Formats a Bluetooth address from ULONGLONG to string.
-		 *
-		 * @param ullLong Bluetooth address as ULONGLONG.
-		 * @return Formatted Bluetooth address as string in "XX:XX:XX:XX:XX:XX" format.
-		 */
-		static std::string formatBthAddr(ULONGLONG ullLong)
-		{
-			std::ostringstream oss;
-			oss << std::hex << std::setfill('0');
-			for (int i = 5; i >= 0; --i)
-			{
-				oss << std::setw(2) << ((ullLong >> (i * 8)) & 0xFF);
-				if (i != 0)
-					oss << ":";
-			}
-			return oss.str();
-		}
-
 		/**
 		 * @brief Converts a wide string (std::wstring) to a standard string (std::string).
 		 * @param wideStr The wide string to convert.
@@ -146,7 +128,7 @@ namespace yhkcatprint
 		}
 		do
 		{
-			std::string address = m_impl->formatBthAddr(deviceInfo.Address.ullLong);
+			std::string address = BluetoothAddress(deviceInfo.Address.ullLong).toString();
 			std::string name = m_impl->wideStringToString(deviceInfo.szName);
 			devices.push_back(std::make_shared<TDevice>(address, name));
 		} while (BluetoothFindNextDevice(hFind, &deviceInfo));
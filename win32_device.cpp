@@ -14,6 +14,7 @@ module yhkcatprint.win32:device;
 
 import std;
 import yhkcatprint;
+import :tcp;
 
 /**
  * @file win32_device.cpp
@@ -37,18 +38,31 @@ namespace yhkcatprint
 		DEVICE_INFO info;
 		info.address = deviceAddress;
 		info.name = deviceName;
+		info.bluetoothAddress = BluetoothAddress::parse(deviceAddress).value_or(BluetoothAddress());
 		return info;
 	}
 
 	template<std::derived_from<IRfcommSocket> TSocket>
-	std::shared_ptr<TSocket> DeviceWin32<TSocket>::createRfcommSocket(std::uint8_t channel, ConnectOptions options)
+	std::shared_ptr<IRfcommSocket> DeviceWin32<TSocket>::createRfcommSocket(std::uint8_t channel, ConnectOptions options)
 	{
-		if (channel < 1 || channel > 30)
+		std::shared_ptr<IRfcommSocket> socket;
+
+		if (deviceAddress.starts_with("tcp://"))
 		{
-			throw std::invalid_argument("Invalid RFCOMM channel number");
+			socket = std::make_shared<TcpSocketWin32>(deviceAddress, channel);
+		}
+		else if (deviceAddress.starts_with("loop://"))
+		{
+			socket = std::make_shared<LoopbackSocket>(deviceAddress, channel);
+		}
+		else
+		{
+			if (channel < 1 || channel > 30)
+			{
+				throw std::invalid_argument("Invalid RFCOMM channel number");
+			}
+			socket = std::make_shared<TSocket>(deviceAddress, channel);
 		}
-
-		auto socket = std::make_shared<TSocket>(deviceAddress, channel);
 
 		switch (options)
 		{
@@ -57,6 +71,7 @@ namespace yhkcatprint
 			break;
 		case TIMEOUT_LONG:
 			socket->connect(std::chrono::seconds(30));
+			break;
 		case TIMEOUT_NONE:
 			[[fallthrough]];
 		default:
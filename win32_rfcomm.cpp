@@ -40,17 +40,7 @@ namespace yhkcatprint
 
 		BTH_ADDR strToBthAddr(const std::string& address)
 		{
-			BTH_ADDR btAddr = 0;
-			std::istringstream iss(address);
-			std::string byteStr;
-			for (int i = 0; i < 6; ++i) {
-				if (!std::getline(iss, byteStr, ':')) {
-					throw std::invalid_argument("Invalid Bluetooth address format");
-				}
-				std::uint8_t byte = static_cast<std::uint8_t>(std::stoul(byteStr, nullptr, 16));
-				btAddr |= (static_cast<BTH_ADDR>(byte) << (8 * (5 - i)));
-			}
-			return btAddr;
+			return static_cast<BTH_ADDR>(BluetoothAddress::fromString(address).value());
 		}
 
 		void ensureWinsockInit()
@@ -66,6 +56,60 @@ namespace yhkcatprint
 			}
 		}
 
+		void recreateSocket()
+		{
+			if (socket != INVALID_SOCKET) {
+				::closesocket(socket);
+			}
+			connected = false;
+			socket = ::socket(AF_BTH, SOCK_STREAM, BTHPROTO_RFCOMM);
+			if (socket == INVALID_SOCKET) {
+				throw std::runtime_error("Failed to create socket");
+			}
+		}
+
+		void setNonBlocking(bool enabled)
+		{
+			u_long mode = enabled ? 1 : 0;
+			if (ioctlsocket(socket, FIONBIO, &mode) == SOCKET_ERROR) {
+				throw std::runtime_error("Failed to change socket blocking mode");
+			}
+		}
+
+		bool waitReady(bool write, std::chrono::steady_clock::time_point deadline)
+		{
+			auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+			if (remaining.count() < 0) {
+				remaining = std::chrono::microseconds::zero();
+			}
+			timeval timeout = {
+				static_cast<long>(remaining.count() / 1000000),
+				static_cast<long>(remaining.count() % 1000000)
+			};
+
+			fd_set readyfds;
+			FD_ZERO(&readyfds);
+			FD_SET(socket, &readyfds);
+			// Windows reports a failed non-blocking connect through the exception set.
+			fd_set errorfds;
+			FD_ZERO(&errorfds);
+			FD_SET(socket, &errorfds);
+
+			int result = write
+				? ::select(0, nullptr, &readyfds, &errorfds, &timeout)
+				: ::select(0, &readyfds, nullptr, &errorfds, &timeout);
+			if (result == SOCKET_ERROR) {
+				throw std::runtime_error("Failed to wait for socket");
+			}
+			if (result > 0 && FD_ISSET(socket, &errorfds)) {
+				int error = 0;
+				int length = sizeof(error);
+				::getsockopt(socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+				throw std::runtime_error("Socket error: " + std::to_string(error));
+			}
+			return result > 0;
+		}
+
 		Impl() : socket(INVALID_SOCKET), connected(false)
 		{
 			std::memset(&addr, 0, sizeof(addr));
@@ -108,8 +152,33 @@ namespace yhkcatprint
 
 	void RfcommSocketWin32::connect(std::chrono::nanoseconds timeout)
 	{
-		// For simplicity, ignoring timeout implementation in this example
-		connect();
+		if (m_impl->connected) {
+			throw std::runtime_error("Socket already connected");
+		}
+		auto deadline = std::chrono::steady_clock::now() + timeout;
+
+		m_impl->setNonBlocking(true);
+		if (::connect(m_impl->socket, reinterpret_cast<SOCKADDR*>(&m_impl->addr), sizeof(m_impl->addr)) == SOCKET_ERROR) {
+			if (WSAGetLastError() != WSAEWOULDBLOCK) {
+				m_impl->recreateSocket();
+				throw std::runtime_error("Failed to connect to the device");
+			}
+
+			bool ready = false;
+			try {
+				ready = m_impl->waitReady(true, deadline);
+			}
+			catch (const std::exception&) {
+				m_impl->recreateSocket();
+				throw std::runtime_error("Failed to connect to the device");
+			}
+			if (!ready) {
+				m_impl->recreateSocket();
+				throw std::runtime_error("Timed out connecting to the device");
+			}
+		}
+		m_impl->setNonBlocking(false);
+		m_impl->connected = true;
 	}
 
 	size_t RfcommSocketWin32::send(const std::uint8_t* data, size_t size)
@@ -124,6 +193,81 @@ namespace yhkcatprint
 		return static_cast<size_t>(bytesSent);
 	}
 
+	size_t RfcommSocketWin32::send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		auto deadline = std::chrono::steady_clock::now() + timeout;
+
+		// Non-blocking mode lets a partially accepted buffer return at the deadline
+		// instead of blocking until the whole buffer is queued.
+		size_t total = 0;
+		m_impl->setNonBlocking(true);
+		try {
+			while (total < size) {
+				int chunk = static_cast<int>(std::min<size_t>(size - total, std::numeric_limits<int>::max()));
+				int bytesSent = ::send(m_impl->socket, reinterpret_cast<const char*>(data + total), chunk, 0);
+				if (bytesSent == SOCKET_ERROR) {
+					if (WSAGetLastError() != WSAEWOULDBLOCK) {
+						throw std::runtime_error("Failed to send data");
+					}
+					if (!m_impl->waitReady(true, deadline)) {
+						break;
+					}
+					continue;
+				}
+				total += static_cast<size_t>(bytesSent);
+			}
+		}
+		catch (...) {
+			m_impl->setNonBlocking(false);
+			throw;
+		}
+		m_impl->setNonBlocking(false);
+
+		if (total == 0 && size > 0) {
+			throw std::runtime_error("Timed out sending data");
+		}
+		return total;
+	}
+
+	size_t RfcommSocketWin32::send(std::span<const std::span<const std::uint8_t>> buffers)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+
+		// Buffers beyond the first maxSendBuffers are left for the caller's next call.
+		constexpr DWORD maxSendBuffers = 16;
+		WSABUF wsaBuffers[maxSendBuffers];
+		DWORD count = 0;
+		for (const auto& buffer : buffers) {
+			if (count == maxSendBuffers) {
+				break;
+			}
+			if (buffer.empty()) {
+				continue;
+			}
+			ULONG length = static_cast<ULONG>(std::min<size_t>(buffer.size(), std::numeric_limits<ULONG>::max()));
+			wsaBuffers[count].buf = reinterpret_cast<CHAR*>(const_cast<std::uint8_t*>(buffer.data()));
+			wsaBuffers[count].len = length;
+			count++;
+			if (length < buffer.size()) {
+				break;
+			}
+		}
+		if (count == 0) {
+			return 0;
+		}
+
+		DWORD bytesSent = 0;
+		if (::WSASend(m_impl->socket, wsaBuffers, count, &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+			throw std::runtime_error("Failed to send data");
+		}
+		return static_cast<size_t>(bytesSent);
+	}
+
 	size_t RfcommSocketWin32::receive(std::uint8_t* buffer, size_t size)
 	{
 		if (!m_impl->connected) {
@@ -140,6 +284,17 @@ namespace yhkcatprint
 		return static_cast<size_t>(bytesReceived);
 	}
 
+	size_t RfcommSocketWin32::receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		if (!m_impl->waitReady(false, std::chrono::steady_clock::now() + timeout)) {
+			throw std::runtime_error("Timed out receiving data");
+		}
+		return receive(buffer, size);
+	}
+
 	size_t RfcommSocketWin32::available()
 	{
 		if (!m_impl->connected) {
@@ -149,7 +304,7 @@ namespace yhkcatprint
 		if (ioctlsocket(m_impl->socket, FIONREAD, &bytesAvailable) == SOCKET_ERROR) {
 			throw std::runtime_error("Failed to check available data");
 		}
-		return bytesAvailable > 0;
+		return static_cast<size_t>(bytesAvailable);
 	}
 
 	void RfcommSocketWin32::close()
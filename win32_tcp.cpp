@@ -0,0 +1,361 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	win32_tcp.cpp
+
+Abstract:
+	Implementation of TcpSocketWin32 methods.
+
+--*/
+
+module;
+
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+// Link with ws2_32.lib
+#pragma comment(lib, "ws2_32.lib")
+
+module yhkcatprint.win32;
+
+import std;
+
+/**
+ * @file win32_tcp.cpp
+ * @brief Implementation of TcpSocketWin32 methods.
+ * 
+ * This file provides the Windows implementation of the TcpSocketWin32 class
+ * using the Windows Sockets API.
+ */
+
+namespace yhkcatprint
+{
+	struct TcpSocketWin32::Impl
+	{
+		SOCKET socket;
+		std::string host;
+		std::string port;
+		bool connected;
+
+		void ensureWinsockInit()
+		{
+			static bool initialized = false;
+			if (!initialized) {
+				WSADATA wsaData;
+				int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
+				if (result != 0) {
+					throw std::runtime_error("WSAStartup failed");
+				}
+				initialized = true;
+			}
+		}
+
+		void parseAddress(const std::string& address)
+		{
+			constexpr std::string_view scheme = "tcp://";
+			std::string_view endpoint = address;
+			if (endpoint.starts_with(scheme)) {
+				endpoint.remove_prefix(scheme.size());
+			}
+
+			// Bracketed hosts carry IPv6 literals, whose colons are not port separators.
+			size_t hostEnd = 0;
+			if (endpoint.starts_with('[')) {
+				hostEnd = endpoint.find(']');
+				if (hostEnd == std::string_view::npos) {
+					throw std::invalid_argument("Invalid TCP address format");
+				}
+				host = endpoint.substr(1, hostEnd - 1);
+				hostEnd += 1;
+			}
+			else {
+				hostEnd = endpoint.rfind(':');
+				host = endpoint.substr(0, hostEnd);
+			}
+
+			if (hostEnd < endpoint.size()) {
+				if (endpoint[hostEnd] != ':' || hostEnd + 1 == endpoint.size()) {
+					throw std::invalid_argument("Invalid TCP address format");
+				}
+				port = endpoint.substr(hostEnd + 1);
+			}
+			if (host.empty()) {
+				throw std::invalid_argument("Invalid TCP address format");
+			}
+		}
+
+		void closeSocket()
+		{
+			if (socket != INVALID_SOCKET) {
+				::closesocket(socket);
+				socket = INVALID_SOCKET;
+			}
+			connected = false;
+		}
+
+		void setNonBlocking(bool enabled)
+		{
+			u_long mode = enabled ? 1 : 0;
+			if (ioctlsocket(socket, FIONBIO, &mode) == SOCKET_ERROR) {
+				throw std::runtime_error("Failed to change socket blocking mode");
+			}
+		}
+
+		bool waitReady(bool write, std::chrono::steady_clock::time_point deadline)
+		{
+			auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+			if (remaining.count() < 0) {
+				remaining = std::chrono::microseconds::zero();
+			}
+			timeval timeout = {
+				static_cast<long>(remaining.count() / 1000000),
+				static_cast<long>(remaining.count() % 1000000)
+			};
+
+			fd_set readyfds;
+			FD_ZERO(&readyfds);
+			FD_SET(socket, &readyfds);
+			// Windows reports a failed non-blocking connect through the exception set.
+			fd_set errorfds;
+			FD_ZERO(&errorfds);
+			FD_SET(socket, &errorfds);
+
+			int result = write
+				? ::select(0, nullptr, &readyfds, &errorfds, &timeout)
+				: ::select(0, &readyfds, nullptr, &errorfds, &timeout);
+			if (result == SOCKET_ERROR) {
+				throw std::runtime_error("Failed to wait for socket");
+			}
+			if (result > 0 && FD_ISSET(socket, &errorfds)) {
+				int error = 0;
+				int length = sizeof(error);
+				::getsockopt(socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+				throw std::runtime_error("Socket error: " + std::to_string(error));
+			}
+			return result > 0;
+		}
+
+		void connectUntil(std::optional<std::chrono::steady_clock::time_point> deadline)
+		{
+			if (connected) {
+				throw std::runtime_error("Socket already connected");
+			}
+
+			addrinfo hints = {};
+			hints.ai_family = AF_UNSPEC;
+			hints.ai_socktype = SOCK_STREAM;
+			hints.ai_protocol = IPPROTO_TCP;
+			addrinfo* results = nullptr;
+			if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0 || results == nullptr) {
+				throw std::runtime_error("Failed to resolve host: " + host);
+			}
+
+			bool timedOut = false;
+			for (addrinfo* candidate = results; candidate != nullptr && !connected; candidate = candidate->ai_next) {
+				socket = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+				if (socket == INVALID_SOCKET) {
+					continue;
+				}
+
+				try {
+					if (!deadline) {
+						connected = ::connect(socket, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) != SOCKET_ERROR;
+					}
+					else {
+						setNonBlocking(true);
+						if (::connect(socket, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) != SOCKET_ERROR) {
+							connected = true;
+						}
+						else if (WSAGetLastError() == WSAEWOULDBLOCK) {
+							connected = waitReady(true, *deadline);
+							timedOut = !connected;
+						}
+						if (connected) {
+							setNonBlocking(false);
+						}
+					}
+				}
+				catch (const std::exception&) {
+					connected = false;
+				}
+
+				if (!connected) {
+					closeSocket();
+					if (timedOut) {
+						break;
+					}
+				}
+			}
+			::freeaddrinfo(results);
+
+			if (!connected) {
+				throw std::runtime_error(timedOut ? "Timed out connecting to the device" : "Failed to connect to the device");
+			}
+
+			BOOL noDelay = TRUE;
+			::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+		}
+
+		Impl() : socket(INVALID_SOCKET), port(std::to_string(DEFAULT_PORT)), connected(false)
+		{
+		}
+	};
+
+	TcpSocketWin32::TcpSocketWin32(const std::string& address, std::uint8_t channel)
+		: m_impl(std::make_unique<Impl>())
+	{
+		m_impl->ensureWinsockInit();
+		m_impl->parseAddress(address);
+	}
+
+	TcpSocketWin32::~TcpSocketWin32()
+	{
+		if (m_impl) {
+			close();
+		}
+	}
+
+	TcpSocketWin32::TcpSocketWin32(TcpSocketWin32&& other) noexcept = default;
+	TcpSocketWin32& TcpSocketWin32::operator=(TcpSocketWin32&& other) noexcept = default;
+
+	void TcpSocketWin32::connect()
+	{
+		m_impl->connectUntil(std::nullopt);
+	}
+
+	void TcpSocketWin32::connect(std::chrono::nanoseconds timeout)
+	{
+		m_impl->connectUntil(std::chrono::steady_clock::now() + timeout);
+	}
+
+	size_t TcpSocketWin32::send(const std::uint8_t* data, size_t size)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		int bytesSent = ::send(m_impl->socket, reinterpret_cast<const char*>(data), static_cast<int>(size), 0);
+		if (bytesSent == SOCKET_ERROR) {
+			throw std::runtime_error("Failed to send data");
+		}
+		return static_cast<size_t>(bytesSent);
+	}
+
+	size_t TcpSocketWin32::send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		auto deadline = std::chrono::steady_clock::now() + timeout;
+
+		size_t total = 0;
+		m_impl->setNonBlocking(true);
+		try {
+			while (total < size) {
+				int chunk = static_cast<int>(std::min<size_t>(size - total, std::numeric_limits<int>::max()));
+				int bytesSent = ::send(m_impl->socket, reinterpret_cast<const char*>(data + total), chunk, 0);
+				if (bytesSent == SOCKET_ERROR) {
+					if (WSAGetLastError() != WSAEWOULDBLOCK) {
+						throw std::runtime_error("Failed to send data");
+					}
+					if (!m_impl->waitReady(true, deadline)) {
+						break;
+					}
+					continue;
+				}
+				total += static_cast<size_t>(bytesSent);
+			}
+		}
+		catch (...) {
+			m_impl->setNonBlocking(false);
+			throw;
+		}
+		m_impl->setNonBlocking(false);
+
+		if (total == 0 && size > 0) {
+			throw std::runtime_error("Timed out sending data");
+		}
+		return total;
+	}
+
+	size_t TcpSocketWin32::send(std::span<const std::span<const std::uint8_t>> buffers)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+
+		// Buffers beyond the first maxSendBuffers are left for the caller's next call.
+		constexpr DWORD maxSendBuffers = 16;
+		WSABUF wsaBuffers[maxSendBuffers];
+		DWORD count = 0;
+		for (const auto& buffer : buffers) {
+			if (count == maxSendBuffers) {
+				break;
+			}
+			if (buffer.empty()) {
+				continue;
+			}
+			ULONG length = static_cast<ULONG>(std::min<size_t>(buffer.size(), std::numeric_limits<ULONG>::max()));
+			wsaBuffers[count].buf = reinterpret_cast<CHAR*>(const_cast<std::uint8_t*>(buffer.data()));
+			wsaBuffers[count].len = length;
+			count++;
+			if (length < buffer.size()) {
+				break;
+			}
+		}
+		if (count == 0) {
+			return 0;
+		}
+
+		DWORD bytesSent = 0;
+		if (::WSASend(m_impl->socket, wsaBuffers, count, &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+			throw std::runtime_error("Failed to send data");
+		}
+		return static_cast<size_t>(bytesSent);
+	}
+
+	size_t TcpSocketWin32::receive(std::uint8_t* buffer, size_t size)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		int bytesReceived = ::recv(m_impl->socket, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+		if (bytesReceived == SOCKET_ERROR) {
+			throw std::runtime_error("Failed to receive data");
+		}
+		if (bytesReceived == 0) {
+			// Connection has been closed
+			m_impl->connected = false;
+		}
+		return static_cast<size_t>(bytesReceived);
+	}
+
+	size_t TcpSocketWin32::receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout)
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		if (!m_impl->waitReady(false, std::chrono::steady_clock::now() + timeout)) {
+			throw std::runtime_error("Timed out receiving data");
+		}
+		return receive(buffer, size);
+	}
+
+	size_t TcpSocketWin32::available()
+	{
+		if (!m_impl->connected) {
+			throw std::runtime_error("Socket not connected");
+		}
+		u_long bytesAvailable = 0;
+		if (ioctlsocket(m_impl->socket, FIONREAD, &bytesAvailable) == SOCKET_ERROR) {
+			throw std::runtime_error("Failed to check available data");
+		}
+		return static_cast<size_t>(bytesAvailable);
+	}
+
+	void TcpSocketWin32::close()
+	{
+		m_impl->closeSocket();
+	}
+}
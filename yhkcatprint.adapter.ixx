@@ -13,6 +13,7 @@ Abstract:
 export module yhkcatprint:adapter;
 
 import std;
+import :address;
 import :device;
 
 /**
@@ -38,6 +39,10 @@ export namespace yhkcatprint
 		 * @brief Human-readable name of the adapter.
 		 */
 		std::string name;
+		/**
+		 * @brief Bluetooth address of the adapter.
+		 */
+		BluetoothAddress bluetoothAddress;
 	} ADAPTER_INFO;
 
 	/**
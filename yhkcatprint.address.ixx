@@ -0,0 +1,32 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.address.ixx
+
+Abstract:
+	48-bit Bluetooth device address value type.
+
+--*/
+
+module;
+
+#include "BluetoothAddress.h"
+
+export module yhkcatprint:address;
+
+/**
+ * @file yhkcatprint.address.ixx
+ * @brief 48-bit Bluetooth device address value type.
+ *
+ * This module exports BluetoothAddress, which holds an address as an
+ * integer that is parsed, formatted, compared and hashed without
+ * allocating. Its std::hash and std::formatter specializations come with
+ * the type.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::BluetoothAddress;
+}
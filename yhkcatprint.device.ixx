@@ -13,6 +13,7 @@ Abstract:
 export module yhkcatprint:device;
 
 import std;
+import :address;
 import :rfcomm;
 
 /**
@@ -31,13 +32,18 @@ export namespace yhkcatprint
 	typedef struct _DEVICE_INFO
 	{
 		/**
-		 * @brief Bluetooth address of the device in format "XX:XX:XX:XX:XX:XX".
+		 * @brief Bluetooth address of the device in format "XX:XX:XX:XX:XX:XX",
+		 *        or the endpoint of a network device.
 		 */
 		std::string address;
 		/**
 		 * @brief Human-readable name of the device.
 		 */
 		std::string name;
+		/**
+		 * @brief Bluetooth address of the device, null for network devices.
+		 */
+		BluetoothAddress bluetoothAddress;
 	} DEVICE_INFO;
 
 	/**
@@ -0,0 +1,48 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.escpos.ixx
+
+Abstract:
+	Compile-time builders for the printer's ESC/POS commands.
+
+--*/
+
+module;
+
+#include "EscPos.h"
+
+export module yhkcatprint:escpos;
+
+/**
+ * @file yhkcatprint.escpos.ixx
+ * @brief Compile-time builders for the printer's ESC/POS commands.
+ *
+ * This module exports the escpos namespace, whose constexpr functions
+ * build the printer's commands as fixed-size byte arrays, including the
+ * parameterized feed, density and raster image commands. concat() folds
+ * commands into one array at compile time.
+ */
+
+export namespace yhkcatprint::escpos
+{
+	using yhkcatprint::escpos::Command;
+	using yhkcatprint::escpos::LINE_FEED;
+	using yhkcatprint::escpos::FEED_DOTS;
+	using yhkcatprint::escpos::RASTER_IMAGE;
+	using yhkcatprint::escpos::RASTER_HEADER_SIZE;
+	using yhkcatprint::escpos::MAX_RASTER_DIMENSION;
+	using yhkcatprint::escpos::concat;
+	using yhkcatprint::escpos::initialize;
+	using yhkcatprint::escpos::getStatus;
+	using yhkcatprint::escpos::getSerial;
+	using yhkcatprint::escpos::startPrint;
+	using yhkcatprint::escpos::feedLines;
+	using yhkcatprint::escpos::feedDots;
+	using yhkcatprint::escpos::setDensity;
+	using yhkcatprint::escpos::rasterHeader;
+	using yhkcatprint::escpos::HANDSHAKE;
+	using yhkcatprint::escpos::END_PRINT;
+}
@@ -18,7 +18,16 @@ export module yhkcatprint;
  * This library provides interfaces and implementations for interacting with YHK Bluetooth Cat Printers.
  */
 
+export import :address;
 export import :rfcomm;
 export import :device;
 export import :adapter;
-export import :manager;
\ No newline at end of file
+export import :manager;
+export import :loopback;
+export import :writer;
+export import :reader;
+export import :memory;
+export import :raster;
+export import :escpos;
+export import :status;
+export import :metrics;
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.linux.adapter.ixx
+
+Abstract:
+	Linux implementation of IAdapter interface.
+
+--*/
+
+module;
+
+#include "Bluez.h"
+
+export module yhkcatprint.linux:adapter;
+
+import std;
+import yhkcatprint;
+
+/**
+ * @file yhkcatprint.linux.adapter.ixx
+ * @brief Linux implementation of IAdapter interface.
+ * 
+ * This module provides a Linux-specific implementation of the IAdapter
+ * interface on top of the kernel HCI interface and the BlueZ device store,
+ * read through the helpers in Bluez.h.
+ */
+
+export namespace yhkcatprint
+{
+	namespace bluez
+	{
+		using yhkcatprint::bluez::BLUEZ_ENTRY;
+		using yhkcatprint::bluez::listHciDevices;
+		using yhkcatprint::bluez::readHciDeviceInfo;
+		using yhkcatprint::bluez::readPairedDevices;
+	}
+
+	/**
+	 * @brief Linux implementation of IAdapter interface.
+	 * 
+	 * This class implements the IAdapter interface for a local HCI device.
+	 * 
+	 * @tparam TDevice Type of Bluetooth device to use, must derive from IDevice
+	 * and be constructible from an address string and a name.
+	 */
+	template<std::derived_from<IDevice> TDevice>
+	class AdapterLinux : public IAdapter
+	{
+	public:
+		/**
+		 * @brief Constructs an AdapterLinux.
+		 * 
+		 * @param deviceId HCI device identifier, e.g. 0 for hci0.
+		 */
+		explicit AdapterLinux(int deviceId)
+			: m_deviceId(deviceId)
+		{
+		}
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~AdapterLinux() = default;
+
+		/**
+		 * @brief Retrieves information about the Bluetooth adapter.
+		 *
+		 * @return ADAPTER_INFO structure containing the adapter's address and name.
+		 */
+		ADAPTER_INFO getInfo() override
+		{
+			if (!m_info)
+			{
+				bluez::BLUEZ_ENTRY entry = bluez::readHciDeviceInfo(m_deviceId);
+				m_info = ADAPTER_INFO{ entry.address.toString(), entry.name, entry.address };
+			}
+			return *m_info;
+		}
+
+		/**
+		 * @brief Retrieves a list of paired Bluetooth devices.
+		 *
+		 * @return Vector of shared pointers to IDevice representing paired devices.
+		 */
+		std::vector<std::shared_ptr<IDevice>> getPairedDevices() override
+		{
+			std::vector<std::shared_ptr<IDevice>> devices;
+			for (const bluez::BLUEZ_ENTRY& entry : bluez::readPairedDevices(getInfo().bluetoothAddress))
+			{
+				devices.push_back(std::make_shared<TDevice>(entry.address.toString(), entry.name));
+			}
+			return devices;
+		}
+
+	private:
+		/**
+		 * @brief HCI device identifier.
+		 */
+		int m_deviceId;
+
+		/**
+		 * @brief Cached adapter information.
+		 */
+		std::optional<ADAPTER_INFO> m_info;
+	};
+}
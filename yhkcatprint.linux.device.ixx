@@ -0,0 +1,113 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.linux.device.ixx
+
+Abstract:
+	Linux implementation of IDevice interface.
+
+--*/
+
+export module yhkcatprint.linux:device;
+
+import std;
+import yhkcatprint;
+
+/**
+ * @file yhkcatprint.linux.device.ixx
+ * @brief Linux implementation of IDevice interface.
+ * 
+ * This module provides a Linux-specific implementation of the IDevice
+ * interface for devices known to BlueZ.
+ */
+
+export namespace yhkcatprint
+{
+	/**
+	 * @brief Linux implementation of IDevice interface.
+	 * 
+	 * This class implements the IDevice interface for a remote device paired
+	 * through BlueZ.
+	 * 
+	 * @tparam TSocket Type of RFCOMM socket to use, must derive from IRfcommSocket
+	 * and be constructible from an address string and a channel number.
+	 */
+	template<std::derived_from<IRfcommSocket> TSocket>
+	class DeviceLinux : public IDevice
+	{
+	public:
+		/**
+		 * @brief Constructs a DeviceLinux.
+		 * 
+		 * @param address Bluetooth MAC address of the device.
+		 * @param name Human-readable device name.
+		 */
+		DeviceLinux(const std::string& address, const std::string& name)
+			: deviceAddress(address), deviceName(name)
+		{
+		}
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~DeviceLinux() = default;
+
+		/**
+		 * @brief Retrieves information about the Bluetooth device.
+		 * @return DEVICE_INFO structure containing device's address and name.
+		 */
+		DEVICE_INFO getInfo() noexcept override
+		{
+			return { deviceAddress, deviceName, BluetoothAddress::parse(deviceAddress).value_or(BluetoothAddress()) };
+		}
+
+		/**
+		 * @brief Creates an RFCOMM socket to the device on the specified channel.
+		 * 
+		 * @param channel RFCOMM channel number to connect to.
+		 * @param options Connection options (e.g., timeout settings).
+		 * @return Shared pointer to the created IRfcommSocket.
+		 * 
+		 * @throws std::invalid_argument if the channel number is out of range.
+		 * @throws std::runtime_error on failure to create or connect the socket.
+		 */
+		std::shared_ptr<IRfcommSocket> createRfcommSocket(std::uint8_t channel, ConnectOptions options) override
+		{
+			if (channel < 1 || channel > 30)
+			{
+				throw std::invalid_argument("Invalid RFCOMM channel number");
+			}
+
+			auto socket = std::make_shared<TSocket>(deviceAddress, channel);
+
+			switch (options)
+			{
+			case TIMEOUT_DEFAULT:
+				socket->connect(std::chrono::seconds(5));
+				break;
+			case TIMEOUT_LONG:
+				socket->connect(std::chrono::seconds(30));
+				break;
+			case TIMEOUT_NONE:
+				[[fallthrough]];
+			default:
+				socket->connect();
+				break;
+			}
+
+			return socket;
+		}
+
+	private:
+		/**
+		 * @brief Device bluetooth MAC address
+		 */
+		std::string deviceAddress;
+		/**
+		 * @brief Human-readable name of the device.
+		 */
+		std::string deviceName;
+	};
+}
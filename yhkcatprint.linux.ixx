@@ -0,0 +1,18 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.linux.ixx
+
+Abstract:
+	Linux (BlueZ) implementation of the yhkcatprint module.
+
+--*/
+
+export module yhkcatprint.linux;
+
+export import :rfcomm;
+export import :device;
+export import :adapter;
+export import :manager;
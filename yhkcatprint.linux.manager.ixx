@@ -0,0 +1,126 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.linux.manager.ixx
+
+Abstract:
+	Linux implementation of IBluetoothManager interface.
+
+--*/
+
+export module yhkcatprint.linux:manager;
+
+import std;
+import yhkcatprint;
+import :adapter;
+
+/**
+ * @file yhkcatprint.linux.manager.ixx
+ * @brief Linux implementation of IBluetoothManager interface.
+ * 
+ * This module provides a Linux-specific implementation of the IBluetoothManager
+ * interface that enumerates adapters through the kernel HCI interface.
+ */
+
+export namespace yhkcatprint
+{
+	/**
+	 * @brief Linux implementation of IBluetoothManager interface.
+	 * 
+	 * Enumerates HCI devices once, on construction. A machine without a
+	 * Bluetooth radio yields a manager with no adapters.
+	 * 
+	 * @tparam TAdapter Type of Bluetooth adapter to use, must derive from IAdapter
+	 * and be constructible from an HCI device identifier.
+	 */
+	template<std::derived_from<IAdapter> TAdapter>
+	class BluetoothManagerLinux : public IBluetoothManager
+	{
+	public:
+		/**
+		 * @brief Constructs a BluetoothManagerLinux.
+		 */
+		BluetoothManagerLinux()
+		{
+			try
+			{
+				for (int deviceId : bluez::listHciDevices())
+				{
+					adapters.push_back(std::make_shared<TAdapter>(deviceId));
+				}
+			}
+			catch (const std::runtime_error& ex)
+			{
+				std::cerr << "No Bluetooth adapters found on this device: " << ex.what() << std::endl;
+			}
+		}
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~BluetoothManagerLinux() = default;
+
+		/**
+		 * @brief Lists available Bluetooth adapters.
+		 *
+		 * @return Vector of ADAPTER_INFO structures for each available adapter.
+		 */
+		std::vector<ADAPTER_INFO> listAdapters() override
+		{
+			std::vector<ADAPTER_INFO> adapterInfos;
+			for (const auto& adapter : adapters)
+			{
+				adapterInfos.push_back(adapter->getInfo());
+			}
+			return adapterInfos;
+		}
+
+		/**
+		 * @brief Retrieves the default Bluetooth adapter.
+		 *
+		 * @return Shared pointer to the first adapter, or nullptr if there is none.
+		 */
+		std::shared_ptr<IAdapter> getAdapter() override
+		{
+			return adapters.empty() ? nullptr : adapters.front();
+		}
+
+		/**
+		 * @brief Retrieves a Bluetooth adapter by its address.
+		 *
+		 * @param adapterAddress The Bluetooth address of the adapter in format "XX:XX:XX:XX:XX:XX".
+		 * @return Shared pointer to the requested adapter, or nullptr if not found.
+		 */
+		std::shared_ptr<IAdapter> getAdapter(const std::string& adapterAddress) override
+		{
+			std::optional<BluetoothAddress> target = BluetoothAddress::parse(adapterAddress);
+			if (!target)
+			{
+				return nullptr;
+			}
+
+			auto result = std::ranges::find_if(adapters, [&](const std::shared_ptr<IAdapter>& adapter)
+				{
+					return adapter->getInfo().bluetoothAddress == *target;
+				});
+
+			return result != std::ranges::end(adapters) ? *result : nullptr;
+		}
+
+		/**
+		 * @brief Shuts down the Bluetooth manager and releases resources.
+		 */
+		void shutdown() override
+		{
+			adapters.clear();
+		}
+
+	private:
+		/**
+		 * @brief List of managed adapters.
+		 */
+		std::vector<std::shared_ptr<IAdapter>> adapters;
+	};
+}
@@ -0,0 +1,188 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.linux.rfcomm.ixx
+
+Abstract:
+	Linux implementation of IRfcommSocket interface.
+
+--*/
+
+export module yhkcatprint.linux:rfcomm;
+
+import std;
+import yhkcatprint;
+
+/**
+ * @file yhkcatprint.linux.rfcomm.ixx
+ * @brief Linux implementation of IRfcommSocket interface.
+ * 
+ * This module provides a Linux-specific implementation of the IRfcommSocket
+ * interface using BlueZ AF_BLUETOOTH/BTPROTO_RFCOMM sockets.
+ */
+
+export namespace yhkcatprint
+{
+	/**
+	 * @brief Linux implementation of IRfcommSocket interface.
+	 * 
+	 * This class implements the IRfcommSocket interface using BlueZ RFCOMM
+	 * sockets. Readiness for timed operations is waited on with epoll.
+	 * 
+	 * @note Not thread-safe; a socket must not be used from several threads at once.
+	 */
+	class RfcommSocketLinux : public IRfcommSocket
+	{
+	public:
+		/**
+		 * @brief Constructs an RfcommSocketLinux.
+		 * 
+		 * @param address Bluetooth address of the remote device in format "XX:XX:XX:XX:XX:XX".
+		 * @param channel RFCOMM channel number to connect to.
+		 * 
+		 * @throws std::runtime_error on failure to create the socket.
+		 * @throws std::invalid_argument if the address format is invalid.
+		 */
+		RfcommSocketLinux(const std::string& address, std::uint8_t channel);
+
+		/**
+		 * @brief Constructs an RfcommSocketLinux from an already connected stream socket.
+		 * 
+		 * The socket takes ownership of the descriptor. Any connected stream socket
+		 * works, which lets one end of a socketpair() stand in for an RFCOMM link
+		 * on machines without a Bluetooth radio.
+		 * 
+		 * @param fd Connected stream socket descriptor.
+		 * 
+		 * @throws std::runtime_error on failure to set up readiness polling.
+		 */
+		explicit RfcommSocketLinux(int fd);
+
+		/**
+		 * @brief Destructor. Closes the socket if open.
+		 */
+		virtual ~RfcommSocketLinux();
+
+		// Disable copy semantics
+		RfcommSocketLinux(const RfcommSocketLinux&) = delete;
+		RfcommSocketLinux& operator=(const RfcommSocketLinux&) = delete;
+
+		// Enable move semantics
+		RfcommSocketLinux(RfcommSocketLinux&&) noexcept;
+		RfcommSocketLinux& operator=(RfcommSocketLinux&&) noexcept;
+
+		/**
+		 * @brief Establishes a connection to the remote RFCOMM device.
+		 * 
+		 * Blocks until the connection is established or fails.
+		 *
+		 * @pre The socket is not currently connected.
+		 * @post On success, the socket is connected and ready for I/O.
+		 * 
+		 * @throws std::runtime_error on failure to connect.
+		 */
+		void connect() override;
+
+		/**
+		 * @brief Establishes a connection to the remote RFCOMM device with a timeout.
+		 * 
+		 * @param timeout Maximum duration to wait for the connection to be established.
+		 *
+		 * @pre The socket is not currently connected.
+		 * @post On success, the socket is connected and ready for I/O.
+		 * 
+		 * @throws std::runtime_error on failure to connect or timeout.
+		 */
+		void connect(std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends data over the RFCOMM connection.
+		 * 
+		 * @param data Pointer to the data to send.
+		 * @param size Number of bytes to send.
+		 * @return Number of bytes actually sent.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure.
+		 */
+		size_t send(const std::uint8_t* data, size_t size) override;
+
+		/**
+		 * @brief Sends data over the RFCOMM connection within a deadline.
+		 * 
+		 * @param data Pointer to the data to send.
+		 * @param size Number of bytes to send.
+		 * @param timeout Maximum duration to wait for the connection to accept data.
+		 * @return Number of bytes actually sent.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure or timeout.
+		 */
+		size_t send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends several buffers in one operation, without copying them together.
+		 * 
+		 * @param buffers Buffers to send, in order.
+		 * @return Number of bytes actually sent, counted across all buffers.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure.
+		 */
+		size_t send(std::span<const std::span<const std::uint8_t>> buffers) override;
+
+		/**
+		 * @brief Receives data from the RFCOMM connection.
+		 * 
+		 * @param buffer Pointer to the buffer to store received data.
+		 * @param size Maximum number of bytes to receive.
+		 * @return Number of bytes actually received.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on receive failure.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size) override;
+
+		/**
+		 * @brief Receives data from the RFCOMM connection within a deadline.
+		 * 
+		 * @param buffer Pointer to the buffer to store received data.
+		 * @param size Maximum number of bytes to receive.
+		 * @param timeout Maximum duration to wait for data to arrive.
+		 * @return Number of bytes actually received.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on receive failure or timeout.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Returns the number of bytes available to read without blocking.
+		 * 
+		 * @return Number of bytes available to read.
+		 * 
+		 * @pre The socket is connected.
+		 */
+		size_t available() override;
+
+		/**
+		 * @brief Closes the RFCOMM socket.
+		 * 
+		 * @post The socket is closed and no longer connected.
+		 */
+		void close() override;
+
+	private:
+		/**
+		 * @brief Implementation struct to hide platform-specific details.
+		 */
+		struct Impl;
+
+		/**
+		 * @brief Pointer to the implementation.
+		 */
+		std::unique_ptr<Impl> m_impl;
+	};
+}
@@ -0,0 +1,140 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.loopback.ixx
+
+Abstract:
+	Loopback implementation of IRfcommSocket interface.
+
+--*/
+
+module;
+
+#include "LoopbackPipe.h"
+
+export module yhkcatprint:loopback;
+
+import std;
+import :rfcomm;
+
+/**
+ * @file yhkcatprint.loopback.ixx
+ * @brief Loopback implementation of IRfcommSocket interface.
+ * 
+ * This module provides a platform-independent IRfcommSocket that connects to
+ * an in-process LoopbackListener, addressed as "loop://name". The listener
+ * registry is shared with the header API, so a printer emulator started from
+ * either side is reachable from both.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::LoopbackPipe;
+	using yhkcatprint::LoopbackListener;
+	using yhkcatprint::LOOPBACK_ENDPOINT;
+
+	/**
+	 * @brief Loopback implementation of IRfcommSocket interface.
+	 * 
+	 * The RFCOMM channel number is ignored. Send and receive are safe to call
+	 * concurrently from different threads.
+	 */
+	class LoopbackSocket : public IRfcommSocket
+	{
+	public:
+		/**
+		 * @brief Constructs an unconnected client LoopbackSocket.
+		 * 
+		 * @param address Endpoint address in format "loop://name".
+		 * @param channel RFCOMM channel number, ignored.
+		 */
+		LoopbackSocket(const std::string& address, std::uint8_t channel);
+
+		/**
+		 * @brief Constructs a connected LoopbackSocket from an accepted endpoint.
+		 * 
+		 * @param endpoint Endpoint returned by LoopbackListener::accept().
+		 */
+		explicit LoopbackSocket(LOOPBACK_ENDPOINT endpoint);
+
+		/**
+		 * @brief Destructor. Closes the socket if open.
+		 */
+		virtual ~LoopbackSocket();
+
+		// Disable copy semantics
+		LoopbackSocket(const LoopbackSocket&) = delete;
+		LoopbackSocket& operator=(const LoopbackSocket&) = delete;
+
+		/**
+		 * @brief Connects to the listener registered under the address.
+		 * 
+		 * @throws std::runtime_error if no listener is registered.
+		 */
+		void connect() override;
+
+		/**
+		 * @brief Connects to the listener registered under the address.
+		 * 
+		 * Connecting to an in-process listener never blocks, so the timeout is unused.
+		 * 
+		 * @throws std::runtime_error if no listener is registered.
+		 */
+		void connect(std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends data, blocking until all of it is buffered.
+		 * 
+		 * @throws std::runtime_error if the peer has closed the connection.
+		 */
+		size_t send(const std::uint8_t* data, size_t size) override;
+
+		/**
+		 * @brief Sends as much data as the peer accepts before the timeout.
+		 * 
+		 * @throws std::runtime_error if the peer has closed the connection or nothing was sent.
+		 */
+		size_t send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends several buffers in order, blocking until all of them are buffered.
+		 * 
+		 * @throws std::runtime_error if the peer has closed the connection.
+		 */
+		size_t send(std::span<const std::span<const std::uint8_t>> buffers) override;
+
+		/**
+		 * @brief Receives data, returning 0 once the peer has closed the connection.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size) override;
+
+		/**
+		 * @brief Receives data within a deadline.
+		 * 
+		 * @throws std::runtime_error if no data arrived before the timeout.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Returns the number of bytes available to read without blocking.
+		 */
+		size_t available() override;
+
+		/**
+		 * @brief Closes both directions of the connection.
+		 */
+		void close() override;
+
+	private:
+		/**
+		 * @brief Endpoint address.
+		 */
+		std::string m_address;
+		/**
+		 * @brief Pipes of the connection, empty until connected.
+		 */
+		LOOPBACK_ENDPOINT m_endpoint;
+	};
+}
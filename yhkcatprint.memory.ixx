@@ -0,0 +1,37 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.memory.ixx
+
+Abstract:
+	Pooled buffers and arena allocation.
+
+--*/
+
+module;
+
+#include "Arena.h"
+#include "BufferPool.h"
+
+export module yhkcatprint:memory;
+
+/**
+ * @file yhkcatprint.memory.ixx
+ * @brief Pooled buffers and arena allocation.
+ *
+ * This module exports BufferPool, which recycles byte buffers by size class
+ * with per-thread caches, PooledBuffer, which returns its buffer to the pool
+ * when destroyed, and Arena, which carves scratch memory out of pooled
+ * blocks. Buffers from either can serve as the storage of a BufferedWriter
+ * or BufferedReader.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::BUFFER_POOL_STATS;
+	using yhkcatprint::PooledBuffer;
+	using yhkcatprint::BufferPool;
+	using yhkcatprint::Arena;
+}
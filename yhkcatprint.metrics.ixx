@@ -0,0 +1,39 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.metrics.ixx
+
+Abstract:
+	Per-device latency histograms and counters of the print path.
+
+--*/
+
+module;
+
+#include "Metrics.h"
+
+export module yhkcatprint:metrics;
+
+/**
+ * @file yhkcatprint.metrics.ixx
+ * @brief Per-device latency histograms and counters of the print path.
+ *
+ * This module exports the process-wide MetricsRegistry, the per-device
+ * metrics sessions record into, the lock-free Histogram behind them and
+ * the snapshot structs they are read as.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::MetricPhase;
+	using yhkcatprint::MetricCounter;
+	using yhkcatprint::MetricEnumeration;
+	using yhkcatprint::HISTOGRAM_SNAPSHOT;
+	using yhkcatprint::Histogram;
+	using yhkcatprint::DEVICE_METRICS_SNAPSHOT;
+	using yhkcatprint::METRICS_SNAPSHOT;
+	using yhkcatprint::DeviceMetrics;
+	using yhkcatprint::MetricsRegistry;
+}
@@ -0,0 +1,69 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.raster.ixx
+
+Abstract:
+	Conversion of images to the printer's 1-bit raster format.
+
+--*/
+
+module;
+
+#include "Raster.h"
+#include "RasterEncoder.h"
+#include "RasterStream.h"
+
+export module yhkcatprint:raster;
+
+/**
+ * @file yhkcatprint.raster.ixx
+ * @brief Conversion of images to the printer's 1-bit raster format.
+ * 
+ * This module exports Rasterizer, which scales RGBA, grayscale or indexed
+ * images to the printer's dot width, dithers them and packs them into the
+ * rows sent after the print start command, together with the vectorized
+ * pixel kernels it is built on. RasterStream renders an image in bands on
+ * a background thread, so that printing can start before it is finished.
+ * RasterEncoder turns the rows into printer commands, replacing blank
+ * rows with paper feeds.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::PixelFormat;
+	using yhkcatprint::PIXEL_FORMAT_RGBA;
+	using yhkcatprint::PIXEL_FORMAT_GRAY;
+	using yhkcatprint::PIXEL_FORMAT_INDEXED;
+	using yhkcatprint::DitherMethod;
+	using yhkcatprint::DITHER_THRESHOLD;
+	using yhkcatprint::DITHER_BAYER;
+	using yhkcatprint::DITHER_FLOYD_STEINBERG;
+	using yhkcatprint::DITHER_ATKINSON;
+	using yhkcatprint::IMAGE_DESC;
+	using yhkcatprint::RASTER_OPTIONS;
+	using yhkcatprint::Rasterizer;
+	using yhkcatprint::RasterStream;
+	using yhkcatprint::RasterEncoding;
+	using yhkcatprint::RASTER_ENCODING_RAW;
+	using yhkcatprint::RASTER_ENCODING_IMAGE;
+	using yhkcatprint::ENCODE_STATS;
+	using yhkcatprint::RasterEncoder;
+	using yhkcatprint::countBlankRows;
+	using yhkcatprint::countInkRows;
+	using yhkcatprint::countTrailingBlankRows;
+	using yhkcatprint::SimdLevel;
+	using yhkcatprint::SIMD_SCALAR;
+	using yhkcatprint::SIMD_SSE2;
+	using yhkcatprint::SIMD_AVX2;
+	using yhkcatprint::SIMD_NEON;
+	using yhkcatprint::detectSimdLevel;
+	using yhkcatprint::isSimdLevelSupported;
+	using yhkcatprint::simdLevelName;
+	using yhkcatprint::rgbaToGray;
+	using yhkcatprint::packThreshold;
+	using yhkcatprint::findNonZero;
+	using yhkcatprint::findLastNonZero;
+}
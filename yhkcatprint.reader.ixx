@@ -0,0 +1,33 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.reader.ixx
+
+Abstract:
+	Receive ring buffer for IRfcommSocket.
+
+--*/
+
+module;
+
+#include "BufferedReader.h"
+
+export module yhkcatprint:reader;
+
+/**
+ * @file yhkcatprint.reader.ixx
+ * @brief Receive ring buffer for IRfcommSocket.
+ *
+ * This module exports BufferedReader, which receives as many bytes as
+ * available() reports into a ring buffer and hands out replies of an exact
+ * size however the link fragmented them. Use it as
+ * BufferedReader<IRfcommSocket>, or let the constructor deduce the socket
+ * type.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::BufferedReader;
+}
@@ -80,6 +80,39 @@ export namespace yhkcatprint
 		 */
 		virtual size_t send(const std::uint8_t* data, size_t size) = 0;
 
+		/**
+		 * @brief Sends data over the RFCOMM connection within a deadline.
+		 *
+		 * Sends as much of the buffer as the connection accepts before the
+		 * timeout elapses.
+		 *
+		 * @param data Pointer to the data buffer to send.
+		 * @param size Number of bytes to send from the buffer.
+		 * @param timeout Maximum duration to wait for the connection to accept data.
+		 * @return Number of bytes actually sent.
+		 *
+		 * @pre The socket is connected.
+		 *
+		 * @throws std::runtime_error on failure to send data or if no data could be sent before the timeout.
+		 */
+		virtual size_t send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout) = 0;
+
+		/**
+		 * @brief Sends several buffers over the RFCOMM connection in one operation.
+		 *
+		 * The buffers are sent in order as one contiguous stream, without
+		 * copying them into a single allocation first. Like the single-buffer
+		 * overload, this may send fewer bytes than requested.
+		 *
+		 * @param buffers Buffers to send, in order.
+		 * @return Number of bytes actually sent, counted across all buffers.
+		 *
+		 * @pre The socket is connected.
+		 *
+		 * @throws std::runtime_error on failure to send data.
+		 */
+		virtual size_t send(std::span<const std::span<const std::uint8_t>> buffers) = 0;
+
 		/**
 		 * @brief Receives data from the RFCOMM connection.
 		 *
@@ -93,6 +126,20 @@ export namespace yhkcatprint
 		 */
 		virtual size_t receive(std::uint8_t* buffer, size_t size) = 0;
 
+		/**
+		 * @brief Receives data from the RFCOMM connection within a deadline.
+		 *
+		 * @param buffer Pointer to the buffer to store received data.
+		 * @param size Maximum number of bytes to receive.
+		 * @param timeout Maximum duration to wait for data to arrive.
+		 * @return Number of bytes actually received.
+		 *
+		 * @pre The socket is connected.
+		 *
+		 * @throws std::runtime_error on failure to receive data or if no data arrived before the timeout.
+		 */
+		virtual size_t receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) = 0;
+
 		/**
 		 * @brief Returns the number of bytes available to read without blocking.
 		 *
@@ -0,0 +1,36 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.status.ixx
+
+Abstract:
+	Decoding of the printer's status and serial number replies.
+
+--*/
+
+module;
+
+#include "PrinterStatus.h"
+
+export module yhkcatprint:status;
+
+/**
+ * @file yhkcatprint.status.ixx
+ * @brief Decoding of the printer's status and serial number replies.
+ *
+ * This module exports the structs holding the fields of the status and
+ * serial number replies and the constexpr functions that decode them in
+ * place, without allocating.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::PaperState;
+	using yhkcatprint::PRINTER_STATUS;
+	using yhkcatprint::PRINTER_IDENTITY;
+	using yhkcatprint::PRINTER_STATE;
+	using yhkcatprint::decodeStatus;
+	using yhkcatprint::decodeIdentity;
+}
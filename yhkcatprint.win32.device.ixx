@@ -40,7 +40,7 @@ export namespace yhkcatprint
 		/**
 		 * @brief Constructs a DeviceWin32.
 		 * 
-		 * @param address Bluetooth MAC address of the device.
+		 * @param address Bluetooth MAC address of the device, or a "tcp://" or "loop://" endpoint.
 		 * @param name Human-readable device name.
 		 */
 		DeviceWin32(const std::string& address, const std::string& name);
@@ -59,13 +59,17 @@ export namespace yhkcatprint
 		/**
 		 * @brief Creates an RFCOMM socket to the device on the specified channel.
 		 * 
+		 * The transport is selected by the address scheme: "tcp://host:port"
+		 * creates a TcpSocketWin32, "loop://name" a LoopbackSocket, and a plain
+		 * Bluetooth address a TSocket. The channel is ignored for the former two.
+		 * 
 		 * @param channel RFCOMM channel number to connect to.
 		 * @param options Connection options (e.g., timeout settings).
 		 * @return Shared pointer to the created IRfcommSocket.
 		 * 
 		 * @throws std::runtime_error on failure to create the socket.
 		 */
-		std::shared_ptr<TSocket> createRfcommSocket(std::uint8_t channel, ConnectOptions options) override;
+		std::shared_ptr<IRfcommSocket> createRfcommSocket(std::uint8_t channel, ConnectOptions options) override;
 
 	private:
 		/**
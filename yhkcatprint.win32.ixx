@@ -13,4 +13,5 @@ Abstract:
 export module yhkcatprint.win32;
 
 export import :rfcomm;
-export import :device;
\ No newline at end of file
+export import :device;
+export import :tcp;
\ No newline at end of file
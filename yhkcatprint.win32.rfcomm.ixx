@@ -95,6 +95,30 @@ export namespace yhkcatprint
 		 */
 		size_t send(const std::uint8_t* data, size_t size) override;
 
+		/**
+		 * @brief Sends data over the RFCOMM connection within a deadline.
+		 * 
+		 * @param data Pointer to the data to send.
+		 * @param size Number of bytes to send.
+		 * @param timeout Maximum duration to wait for the connection to accept data.
+		 * @return Number of bytes actually sent.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure or timeout.
+		 */
+		size_t send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends several buffers in one operation, without copying them together.
+		 * 
+		 * @param buffers Buffers to send, in order.
+		 * @return Number of bytes actually sent, counted across all buffers.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure.
+		 */
+		size_t send(std::span<const std::span<const std::uint8_t>> buffers) override;
+
 		/**
 		 * @brief Receives data from the RFCOMM connection.
 		 * 
@@ -107,6 +131,19 @@ export namespace yhkcatprint
 		 */
 		size_t receive(std::uint8_t* buffer, size_t size) override;
 
+		/**
+		 * @brief Receives data from the RFCOMM connection within a deadline.
+		 * 
+		 * @param buffer Pointer to the buffer to store received data.
+		 * @param size Maximum number of bytes to receive.
+		 * @param timeout Maximum duration to wait for data to arrive.
+		 * @return Number of bytes actually received.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on receive failure or timeout.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
+
 		/**
 		 * @brief Returns the number of bytes available to read without blocking.
 		 * 
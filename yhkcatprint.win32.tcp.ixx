@@ -0,0 +1,151 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.win32.tcp.ixx
+
+Abstract:
+	Win32 TCP implementation of IRfcommSocket interface.
+
+--*/
+
+export module yhkcatprint.win32:tcp;
+
+import std;
+import yhkcatprint;
+
+/**
+ * @file yhkcatprint.win32.tcp.ixx
+ * @brief Win32 TCP implementation of IRfcommSocket interface.
+ * 
+ * This module provides an IRfcommSocket that speaks the printer protocol over
+ * a TCP stream, addressed as "tcp://host:port", using the Windows Sockets API.
+ * It serves network printers and printer emulators running in another process.
+ */
+
+export namespace yhkcatprint
+{
+	/**
+	 * @brief Win32 TCP implementation of IRfcommSocket interface.
+	 * 
+	 * The RFCOMM channel number is ignored. Nagle's algorithm is disabled,
+	 * since the protocol relies on short request/response exchanges.
+	 */
+	class TcpSocketWin32 : public IRfcommSocket
+	{
+	public:
+		/**
+		 * @brief Port used when the address does not specify one.
+		 */
+		static constexpr std::uint16_t DEFAULT_PORT = 9100;
+
+		/**
+		 * @brief Constructs a TcpSocketWin32.
+		 * 
+		 * @param address Endpoint address in format "tcp://host:port"; IPv6 hosts are bracketed.
+		 * @param channel RFCOMM channel number, ignored.
+		 * 
+		 * @throws std::runtime_error on failure to initialize Winsock.
+		 * @throws std::invalid_argument if the address format is invalid.
+		 */
+		TcpSocketWin32(const std::string& address, std::uint8_t channel);
+
+		/**
+		 * @brief Destructor. Closes the socket if open.
+		 */
+		virtual ~TcpSocketWin32();
+
+		// Disable copy semantics
+		TcpSocketWin32(const TcpSocketWin32&) = delete;
+		TcpSocketWin32& operator=(const TcpSocketWin32&) = delete;
+
+		// Enable move semantics
+		TcpSocketWin32(TcpSocketWin32&&) noexcept;
+		TcpSocketWin32& operator=(TcpSocketWin32&&) noexcept;
+
+		/**
+		 * @brief Resolves the host and connects, blocking until done.
+		 * 
+		 * @throws std::runtime_error on failure to resolve or connect.
+		 */
+		void connect() override;
+
+		/**
+		 * @brief Resolves the host and connects within a timeout.
+		 * 
+		 * @param timeout Maximum duration to wait for the connection to be established.
+		 * 
+		 * @throws std::runtime_error on failure to connect or timeout.
+		 */
+		void connect(std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends data over the TCP connection.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure.
+		 */
+		size_t send(const std::uint8_t* data, size_t size) override;
+
+		/**
+		 * @brief Sends data over the TCP connection within a deadline.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure or timeout.
+		 */
+		size_t send(const std::uint8_t* data, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Sends several buffers in one operation, without copying them together.
+		 * 
+		 * @param buffers Buffers to send, in order.
+		 * @return Number of bytes actually sent, counted across all buffers.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on send failure.
+		 */
+		size_t send(std::span<const std::span<const std::uint8_t>> buffers) override;
+
+		/**
+		 * @brief Receives data from the TCP connection.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on receive failure.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size) override;
+
+		/**
+		 * @brief Receives data from the TCP connection within a deadline.
+		 * 
+		 * @pre The socket is connected.
+		 * @throws std::runtime_error on receive failure or timeout.
+		 */
+		size_t receive(std::uint8_t* buffer, size_t size, std::chrono::nanoseconds timeout) override;
+
+		/**
+		 * @brief Returns the number of bytes available to read without blocking.
+		 * 
+		 * @pre The socket is connected.
+		 */
+		size_t available() override;
+
+		/**
+		 * @brief Closes the TCP socket.
+		 * 
+		 * @post The socket is closed and no longer connected.
+		 */
+		void close() override;
+
+	private:
+		/**
+		 * @brief Implementation struct to hide platform-specific details.
+		 */
+		struct Impl;
+
+		/**
+		 * @brief Pointer to the implementation.
+		 */
+		std::unique_ptr<Impl> m_impl;
+	};
+}
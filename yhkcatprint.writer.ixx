@@ -0,0 +1,32 @@
+/*++
+
+Copyright (C) 2026 Umamusume Polska
+
+Module Name:
+	yhkcatprint.writer.ixx
+
+Abstract:
+	Write-coalescing output buffer for IRfcommSocket.
+
+--*/
+
+module;
+
+#include "BufferedWriter.h"
+
+export module yhkcatprint:writer;
+
+/**
+ * @file yhkcatprint.writer.ixx
+ * @brief Write-coalescing output buffer for IRfcommSocket.
+ * 
+ * This module exports BufferedWriter, which gathers small writes into
+ * frame-sized sends and repeats partial sends until every byte is delivered.
+ * Use it as BufferedWriter<IRfcommSocket>, or let the constructor deduce the
+ * socket type.
+ */
+
+export namespace yhkcatprint
+{
+	using yhkcatprint::BufferedWriter;
+}